@@ -13,4 +13,97 @@
 #define CFG_WIFI_SSID      "mrrb_dev"
 #define CFG_WIFI_PASSWORD  "WhatTimeIsIt?AdventureTime!-_-"
 #define CFG_WIFI_HOSTNAME  "ESP-thermal-cam"
-#define CFG_WIFI_MAX_RETRY 5
+#define CFG_WIFI_BACKOFF_MIN_MS 250   /* First reconnection delay, doubled after every failure */
+#define CFG_WIFI_BACKOFF_MAX_MS 30000
+
+/* Streaming */
+#define CFG_STREAM_HOST   "192.168.1.100"
+#define CFG_STREAM_PORT   5005
+#define CFG_SENSOR_ID     0
+#define CFG_STREAM_KEY_INTERVAL 10 /* Delta frames between keyframes, 0 for keyframes only */
+
+/* Live view, up to 4 TCP or WebSocket (ws://<ip>:8080/raw|packed|color) viewers next to the UDP stream */
+#define CFG_LIVE_ENABLE   1
+#define CFG_LIVE_PORT     8080
+#define CFG_LIVE_STACK    4096
+#define CFG_LIVE_CORE     0
+#define CFG_LIVE_PRIO     4 /* Below processing, a slow viewer never holds a frame back */
+
+/* I2C */
+#define CFG_I2C_SDA_PIN 21
+#define CFG_I2C_SCL_PIN 22
+#define CFG_I2C1_SDA_PIN 18 /* Second port, sensor array only */
+#define CFG_I2C1_SCL_PIN 19
+#define CFG_I2C_FREQ_HZ 400000
+#define CFG_I2C_TIMEOUT 20 /* ms per transaction, what a held-down bus costs before it is recovered */
+#define CFG_I2C_INIT_RETRY_MS 1000 /* Bus setup retried at this period instead of rebooting */
+
+/* AMG88 */
+#define CFG_AMG88_ADDR    0x68
+#define CFG_AMG88_INT_PIN 4
+#define CFG_AMG88_AVE     AMG88_AVE_OFF /* AMG88_AVE_TWICE for the sensor twice moving average */
+#define CFG_AMG88_BURSTS    8              /* One row per burst, a glitch costs a row instead of the frame */
+#define CFG_AMG88_RETRIES   2              /* Extra attempts per burst, the second one after a bus recovery */
+#define CFG_AMG88_BUDGET_US 30000          /* No retry starts past this, well inside the 100 ms frame period */
+
+/* Per-pixel temporal filter, streamed frames carry the filtered values */
+#define CFG_FILTER_ENABLE       1
+#define CFG_FILTER_MODE         TFILTER_KALMAN /* or TFILTER_IIR */
+#define CFG_FILTER_IIR_SHIFT    2          /* IIR: 1/4 of the way per frame */
+#define CFG_FILTER_Q            16         /* Kalman: 1/16 LSB^2 drift per frame, steady gain ~1/4 */
+#define CFG_FILTER_R            256        /* Kalman: 1 LSB^2 of read noise */
+#define CFG_FILTER_STEP         8          /* Readings 2 degrees away restart the pixel */
+
+/* Calibration, loaded from NVS at boot, frames are decoded uncorrected when none is stored */
+#define CFG_CALIB_NVS_NAMESPACE "calib"
+#define CFG_CALIB_NVS_KEY       "table"
+
+/* Flash recorder, frames are kept in a flash partition while WiFi is down and backfilled once it is back */
+#define CFG_REC_ENABLE          1
+#define CFG_REC_PARTITION       "framelog" /* See partitions.csv */
+#define CFG_REC_NVS_NAMESPACE   "recorder"
+#define CFG_REC_CORE            0
+#define CFG_REC_PRIO            3          /* Below the pipeline, backfill only uses spare time */
+
+/* Metrics, exported while WiFi is up, see METRICS_ENABLE in CMakeLists.txt to compile them out */
+#define CFG_METRICS_PERIOD_MS   10000
+#define CFG_METRICS_PRIO        2
+
+/* Activity governor, 10 FPS while the scene moves, 1 FPS and then stand-by once it is static */
+#define CFG_GOV_ENABLE          1
+#define CFG_GOV_PIXEL_DELTA     6          /* 1.5 degrees, a few times the pixel noise */
+#define CFG_GOV_ON_PIXELS       2          /* Changed pixels that make a frame active */
+#define CFG_GOV_OFF_PIXELS      0          /* Changed pixels that make a frame static */
+#define CFG_GOV_IDLE_MS         10000
+#define CFG_GOV_STANDBY_MS      60000      /* 0 to stay at 1 FPS */
+
+/* On-device detection, blob events (STREAM_TYPE_BLOBS) sent next to or instead of the frames */
+#define CFG_DETECT_ENABLE       1
+#define CFG_DETECT_FRAMES       1          /* 0 to only send the events while the link is up */
+#define CFG_DETECT_BG_SHIFT     6          /* Background time constant, 2^6 frames (6.4 s at 10 FPS) */
+#define CFG_DETECT_FG_SHIFT     10         /* Under blobs, ~100 s at 10 FPS before a still person fades */
+#define CFG_DETECT_THRESHOLD    6          /* 1.5 degrees above the background */
+#define CFG_DETECT_MIN_PIXELS   1
+#define CFG_DETECT_WARMUP       20         /* Frames learnt before reporting */
+
+/* Hotspot tracking on the detector excess, track events (STREAM_TYPE_TRACKS), needs CFG_DETECT_ENABLE */
+#define CFG_TRACK_ENABLE        1
+#define CFG_TRACK_THRESHOLD     CFG_DETECT_THRESHOLD
+#define CFG_TRACK_REFINE        TRACK_REFINE_QUADRATIC
+#define CFG_TRACK_GATE          (2 << 8)   /* 2 pixels between a prediction and its match */
+#define CFG_TRACK_ALPHA         128        /* Position gain, 0.5 */
+#define CFG_TRACK_BETA          32         /* Velocity gain, 0.125 */
+#define CFG_TRACK_CONFIRM_HITS  3
+#define CFG_TRACK_MAX_MISSES    3          /* Frames a confirmed track coasts without a match */
+
+/* Sensor array, up to two sensors (0x68/0x69) on each I2C port, stitched in a 2x2 grid */
+#define CFG_ARRAY_ENABLE  0 /* 1 to run the array instead of the single sensor pipeline */
+#define CFG_ARRAY_SENSORS 4
+
+/* Pipeline */
+#define CFG_ACQ_PERIOD_MS 100 /* Sensor frame period when CFG_ACQ_SYNC is set */
+#define CFG_ACQ_SYNC      1   /* Phase-lock reads to the sensor updates, drop duplicate and torn frames */
+#define CFG_ACQ_CORE      1
+#define CFG_ACQ_PRIO      10
+#define CFG_PROC_CORE     0
+#define CFG_PROC_PRIO     5
@@ -9,14 +9,169 @@
 #include "amg88.h"
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include "amg88_defs.h"
 
+/**
+ * \brief           Shadowed registers that can share a burst, a burst never crosses RST, STAT/SCLR or the
+ *                  reserved addresses. AVE needs its own write sequence, so it is never bridged.
+ */
+static const uint8_t shadow_runs[][2] = {
+    { AMG88_REG_PCTL,  AMG88_REG_PCTL },
+    { AMG88_REG_FPSC,  AMG88_REG_INTC },
+    { AMG88_REG_AVE,   AMG88_REG_AVE },
+    { AMG88_REG_INTHL, AMG88_REG_IHYSH },
+};
+
+#define SHADOW_BIT(reg) (1U << (reg))
+
+
+/* AVE only takes a write between the unlock sequence and the lock, the lock goes out even after a failure */
+static amg88_err_t
+amg88_shadow_flush_ave(amg88_dev_t* p_dev) {
+    static const uint8_t unlock[] = AMG88_AVE_UNLOCK;
+    amg88_shadow_t* p_sh = &p_dev->shadow;
+    uint8_t lock = 0x00;
+    amg88_err_t ret = AMG88_OK, ret_lock;
+
+    for (size_t i = 0; i < sizeof(unlock) && ret == AMG88_OK; ++i) {
+        ret = p_dev->write(p_dev->bus, p_dev->addr, AMG88_REG_AVE_KEY, 1, (uint8_t*) &unlock[i]);
+    }
+    if (ret == AMG88_OK) {
+        ret = p_dev->write(p_dev->bus, p_dev->addr, AMG88_REG_AVE, 1, &p_sh->regs[AMG88_REG_AVE]);
+    }
+    ret_lock = p_dev->write(p_dev->bus, p_dev->addr, AMG88_REG_AVE_KEY, 1, &lock);
+    if (ret != AMG88_OK) {
+        return ret;
+    }
+    p_sh->dirty &= (uint16_t) ~SHADOW_BIT(AMG88_REG_AVE);
+
+    return ret_lock;
+}
+
+/* Write the dirty registers of [first, last], bridging clean known registers between them */
+static amg88_err_t
+amg88_shadow_flush_run(amg88_dev_t* p_dev, uint8_t first, uint8_t last) {
+    amg88_shadow_t* p_sh = &p_dev->shadow;
+    uint8_t start, end;
+    amg88_err_t ret;
+
+    for (uint8_t reg = first; reg <= last; ++reg) {
+        if (!(p_sh->dirty & SHADOW_BIT(reg))) {
+            continue;
+        }
+
+        start = end = reg;
+        for (uint8_t n = reg + 1; n <= last && (p_sh->valid & SHADOW_BIT(n)); ++n) {
+            if (p_sh->dirty & SHADOW_BIT(n)) {
+                end = n;
+            }
+        }
+
+        ret = p_dev->write(p_dev->bus, p_dev->addr, start, end - start + 1, &p_sh->regs[start]);
+        if (ret != AMG88_OK) {
+            return ret;
+        }
+        p_sh->dirty &= (uint16_t) ~(((1U << (end - start + 1)) - 1) << start);
+        reg = end;
+    }
+
+    return AMG88_OK;
+}
+
+static amg88_err_t
+amg88_shadow_flush(amg88_dev_t* p_dev) {
+    amg88_shadow_t* p_sh = &p_dev->shadow;
+    bool sleep_last;
+    amg88_err_t ret;
+
+    if (p_sh->dirty == 0) {
+        return AMG88_OK;
+    }
+
+    /* Once asleep the sensor takes no register write but PCTL, the others would be lost: PCTL goes first
+       when it wakes the sensor up (first run), last when it puts it to sleep */
+    sleep_last = (p_sh->dirty & SHADOW_BIT(AMG88_REG_PCTL)) && p_sh->regs[AMG88_REG_PCTL] == AMG88_OP_SLEEP;
+
+    for (size_t i = sleep_last ? 1 : 0; i < sizeof(shadow_runs) / sizeof(shadow_runs[0]); ++i) {
+        if (shadow_runs[i][0] == AMG88_REG_AVE) {
+            ret = (p_sh->dirty & SHADOW_BIT(AMG88_REG_AVE)) ? amg88_shadow_flush_ave(p_dev) : AMG88_OK;
+        } else {
+            ret = amg88_shadow_flush_run(p_dev, shadow_runs[i][0], shadow_runs[i][1]);
+        }
+        if (ret != AMG88_OK) {
+            return ret;
+        }
+    }
+    if (sleep_last) {
+        return amg88_shadow_flush_run(p_dev, AMG88_REG_PCTL, AMG88_REG_PCTL);
+    }
+
+    return AMG88_OK;
+}
+
+/* Stage `len` register values, write them straight away unless batching */
+static amg88_err_t
+amg88_shadow_set(amg88_dev_t* p_dev, uint8_t reg, size_t len, const uint8_t* p_vals) {
+    amg88_shadow_t* p_sh = &p_dev->shadow;
+
+    for (size_t i = 0; i < len; ++i, ++reg) {
+        if ((p_sh->valid & SHADOW_BIT(reg)) && p_sh->regs[reg] == p_vals[i]) {
+            continue;
+        }
+        p_sh->regs[reg] = p_vals[i];
+        p_sh->valid |= SHADOW_BIT(reg);
+        p_sh->dirty |= SHADOW_BIT(reg);
+    }
+
+    return p_sh->batch > 0 ? AMG88_OK : amg88_shadow_flush(p_dev);
+}
+
+/* Shadowed register value, read from the sensor only when unknown */
+static amg88_err_t
+amg88_shadow_get(amg88_dev_t* p_dev, uint8_t reg, uint8_t* p_val) {
+    amg88_shadow_t* p_sh = &p_dev->shadow;
+    amg88_err_t ret;
+
+    if (!(p_sh->valid & SHADOW_BIT(reg))) {
+        ret = p_dev->read(p_dev->bus, p_dev->addr, reg, 1, &p_sh->regs[reg]);
+        if (ret != AMG88_OK) {
+            return ret;
+        }
+        p_sh->valid |= SHADOW_BIT(reg);
+    }
+    *p_val = p_sh->regs[reg];
+
+    return AMG88_OK;
+}
+
+void
+amg88_config_begin(amg88_dev_t* p_dev) {
+    p_dev->shadow.batch++;
+}
+
+amg88_err_t
+amg88_config_commit(amg88_dev_t* p_dev) {
+    if (p_dev->shadow.batch > 0 && --p_dev->shadow.batch > 0) {
+        return AMG88_OK;
+    }
+
+    return amg88_shadow_flush(p_dev);
+}
+
+void
+amg88_config_invalidate(amg88_dev_t* p_dev) {
+    p_dev->shadow.valid = 0;
+    p_dev->shadow.dirty = 0;
+}
+
 amg88_op_mode_t
 amg88_get_op_mode(amg88_dev_t* p_dev) {
     uint8_t read_buff;
 
-    if (p_dev->read(p_dev->addr, AMG88_REG_PCTL, 1, &read_buff) != AMG88_OK) {
+    if (amg88_shadow_get(p_dev, AMG88_REG_PCTL, &read_buff) != AMG88_OK) {
         return AMG88_OP_NOT_VALID;
     } else {
         return (amg88_op_mode_t) read_buff;
@@ -25,43 +180,65 @@ amg88_get_op_mode(amg88_dev_t* p_dev) {
 
 amg88_err_t
 amg88_set_op_mode(amg88_dev_t* p_dev, amg88_op_mode_t mode) {
-    return p_dev->write(p_dev->addr, AMG88_REG_PCTL, 1, (uint8_t*) (&mode));
+    uint8_t val = (uint8_t) mode;
+
+    return amg88_shadow_set(p_dev, AMG88_REG_PCTL, 1, &val);
 }
 
 amg88_err_t
 amg88_reset(amg88_dev_t* p_dev, amg88_reset_t type) {
+    amg88_err_t ret;
+
     if (type != AMG88_RESET_FLAG && type != AMG88_RESET_INITIAL) {
         return AMG88_ERR_INVALID_RESET;
     }
 
-    return p_dev->write(p_dev->addr, AMG88_REG_RST, 1, (uint8_t*) (&type));
+    ret = p_dev->write(p_dev->bus, p_dev->addr, AMG88_REG_RST, 1, (uint8_t*) (&type));
+
+    /* Even a failed initial reset may have reached the sensor */
+    if (type == AMG88_RESET_INITIAL) {
+        amg88_config_invalidate(p_dev);
+    }
+
+    return ret;
 }
 
 amg88_fps_t
 amg88_get_frame_rate(amg88_dev_t* p_dev) {
     uint8_t read_buff = 0;
 
-    if (p_dev->read(p_dev->addr, AMG88_REG_FPSC, 1, &read_buff) != AMG88_OK) {
+    if (amg88_shadow_get(p_dev, AMG88_REG_FPSC, &read_buff) != AMG88_OK) {
         return AMG88_FPS_NOT_VALID;
     } else {
-        return (amg88_op_mode_t) read_buff;
+        return (amg88_fps_t) read_buff;
     }
 }
 
 amg88_err_t
 amg88_set_frame_rate(amg88_dev_t* p_dev, amg88_fps_t mode) {
-    return p_dev->write(p_dev->addr, AMG88_REG_FPSC, 1, (uint8_t*) (&mode));
+    uint8_t val = (uint8_t) mode;
+
+    return amg88_shadow_set(p_dev, AMG88_REG_FPSC, 1, &val);
+}
+
+amg88_err_t
+amg88_get_moving_average(amg88_dev_t* p_dev, uint8_t* p_ave) {
+    return amg88_shadow_get(p_dev, AMG88_REG_AVE, p_ave);
+}
+
+amg88_err_t
+amg88_set_moving_average(amg88_dev_t* p_dev, amg88_ave_t mode) {
+    uint8_t val = (uint8_t) mode;
+
+    return amg88_shadow_set(p_dev, AMG88_REG_AVE, 1, &val);
 }
 
 float
 amg88_get_thermistor(amg88_dev_t* p_dev) {
     uint8_t buff[2] = { 0 };
 
-    if (p_dev->read(p_dev->addr, AMG88_REG_TTHL, 1, buff) != AMG88_OK) {
-        return -99.99;
-    }
-    if (p_dev->read(p_dev->addr, AMG88_REG_TTHH, 1, buff + 1) != AMG88_OK) {
-        return -99.99;
+    if (p_dev->read(p_dev->bus, p_dev->addr, AMG88_REG_TTHL, 2, buff) != AMG88_OK) {
+        return AMG88_TEMP_INVALID;
     }
 
     return AMG88_THERMISTOR_2_TEMP(buff);
@@ -72,14 +249,11 @@ amg88_get_pixel(amg88_dev_t* p_dev, uint8_t row, uint8_t col) {
     uint8_t buff[2] = { 0 };
 
     if (row >= 8 || col >= 8) {
-        return -99.99;
+        return AMG88_TEMP_INVALID;
     }
 
-    if (p_dev->read(p_dev->addr, AMG88_REG_TL + 2 * (row * 8 + col), 1, buff) != AMG88_OK) {
-        return -99.99;
-    }
-    if (p_dev->read(p_dev->addr, AMG88_REG_TH + 2 * (row * 8 + col), 1, buff + 1) != AMG88_OK) {
-        return -99.99;
+    if (p_dev->read(p_dev->bus, p_dev->addr, AMG88_REG_TL + 2 * (row * 8 + col), 2, buff) != AMG88_OK) {
+        return AMG88_TEMP_INVALID;
     }
 
     return AMG88_PIXEL_2_TEMP(buff);
@@ -87,13 +261,285 @@ amg88_get_pixel(amg88_dev_t* p_dev, uint8_t row, uint8_t col) {
 
 amg88_err_t
 amg88_get_array(amg88_dev_t* p_dev, float* array) {
-    for (size_t r = 0; r < 8; ++r) {
-        for (size_t c = 0; c < 8; ++c) {
-            array[r * 8 + c] = amg88_get_pixel(p_dev, r, c);
+    amg88_frame_raw_t frame;
+    amg88_err_t ret;
+
+    ret = amg88_get_frame_raw(p_dev, &frame, 0);
+    if (ret != AMG88_OK) {
+        return ret;
+    }
+
+    amg88_decode_frame_float(&frame, array);
+
+    return AMG88_OK;
+}
+
+amg88_err_t
+amg88_get_frame_raw(amg88_dev_t* p_dev, amg88_frame_raw_t* p_frame, uint8_t thermistor) {
+    return amg88_get_frame_raw_status(p_dev, p_frame, thermistor, NULL);
+}
+
+/* A budget only counts with a clock to time it */
+static bool
+amg88_has_budget(const amg88_dev_t* p_dev) {
+    return p_dev->retry.budget_us != 0 && p_dev->clock_us != NULL;
+}
+
+/* Past the frame time budget, `start_us` is `0` when there is none */
+static bool
+amg88_over_budget(const amg88_dev_t* p_dev, uint64_t start_us) {
+    return amg88_has_budget(p_dev) && p_dev->clock_us() - start_us >= p_dev->retry.budget_us;
+}
+
+/* One burst under the retry policy, bounded by the attempts and the frame time budget */
+static amg88_err_t
+amg88_read_burst(amg88_dev_t* p_dev, uint8_t reg, size_t len, uint8_t* p_buf, uint64_t start_us,
+                 amg88_frame_status_t* p_status) {
+    const amg88_retry_t* p_retry = &p_dev->retry;
+    amg88_err_t ret = AMG88_OK;
+
+    for (uint8_t attempt = 0; attempt <= p_retry->retries; ++attempt) {
+        if (attempt > 0) {
+            if (amg88_over_budget(p_dev, start_us)) {
+                break;
+            }
+
+            /* A timeout is a bus held down, a second plain failure likely too */
+            if (p_dev->recover != NULL && (ret == AMG88_ERR_TIMEOUT || attempt > 1)) {
+                p_status->recoveries++;
+                p_dev->recover(p_dev->bus);
+            }
+            p_status->retries++;
         }
+
+        ret = p_dev->read(p_dev->bus, p_dev->addr, reg, len, p_buf);
+        if (ret == AMG88_OK) {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+amg88_err_t
+amg88_get_frame_raw_status(amg88_dev_t* p_dev, amg88_frame_raw_t* p_frame, uint8_t thermistor,
+                           amg88_frame_status_t* p_status) {
+    amg88_frame_status_t status = { .err = AMG88_OK };
+    uint64_t start_us = amg88_has_budget(p_dev) ? p_dev->clock_us() : 0;
+    uint8_t bursts = 1, pixels;
+    uint64_t burst_mask;
+    amg88_err_t ret;
+
+    /* Whole rows only, a power of two up to one row per burst */
+    while (bursts * 2 <= p_dev->retry.bursts && bursts * 2 <= AMG88_BURSTS_MAX) {
+        bursts *= 2;
+    }
+    pixels = AMG88_ARRAY_SIZE / bursts;
+    burst_mask = bursts == 1 ? UINT64_MAX : (1ULL << pixels) - 1;
+
+    /* The sensor auto-increments the register address, so 0x80..0xFF can come in one go */
+    for (uint8_t b = 0; b < bursts; ++b) {
+        /* A failing bus past the budget: give up on the rest, the caller gets what made it in time */
+        if (status.err != AMG88_OK && amg88_over_budget(p_dev, start_us)) {
+            break;
+        }
+        ret = amg88_read_burst(p_dev, (uint8_t) (AMG88_REG_TL + b * pixels * AMG88_PIXEL_BYTES),
+                               pixels * AMG88_PIXEL_BYTES, &p_frame->pixels[b * pixels * AMG88_PIXEL_BYTES],
+                               start_us, &status);
+        if (ret == AMG88_OK) {
+            status.valid |= burst_mask << (b * pixels);
+        } else if (status.err == AMG88_OK) {
+            status.err = ret;
+        }
+    }
+
+    if (thermistor && (status.err == AMG88_OK || !amg88_over_budget(p_dev, start_us))) {
+        ret = amg88_read_burst(p_dev, AMG88_REG_TTHL, 2, p_frame->thermistor, start_us, &status);
+        status.thermistor = ret == AMG88_OK;
+        if (ret != AMG88_OK && status.err == AMG88_OK) {
+            status.err = ret;
+        }
+    }
+
+    if (p_status != NULL) {
+        *p_status = status;
+    }
+
+    return status.err;
+}
+
+void
+amg88_decode_frame(const amg88_frame_raw_t* p_frame, int16_t* restrict p_out) {
+    const uint8_t* restrict p_in = p_frame->pixels;
+
+    /* Fixed trip count and no branches, so GCC vectorizes it on the host and unrolls it on the ESP32 */
+#pragma GCC unroll 8
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        uint16_t raw = (uint16_t) (p_in[2 * i] | (p_in[2 * i + 1] << 8));
+
+        /* 12-bit two's complement: move the sign bit to bit 15 and shift it back arithmetically */
+        p_out[i] = (int16_t) (uint16_t) (raw << 4) >> 4;
+    }
+}
+
+void
+amg88_decode_frame_float(const amg88_frame_raw_t* p_frame, float* restrict p_out) {
+    int16_t fixed[AMG88_ARRAY_SIZE];
+
+    amg88_decode_frame(p_frame, fixed);
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_out[i] = AMG88_TEMP_FROM_FIXED(fixed[i]);
+    }
+}
+
+int16_t
+amg88_decode_thermistor(const amg88_frame_raw_t* p_frame) {
+    int16_t mag, neg;
+
+    /* 12-bit sign-magnitude, negated without branching */
+    mag = (int16_t) (p_frame->thermistor[0] | ((p_frame->thermistor[1] & 0x07) << 8));
+    neg = (int16_t) ((p_frame->thermistor[1] >> 3) & 0x01);
+
+    return (int16_t) ((mag ^ -neg) + neg);
+}
+
+amg88_err_t
+amg88_frame_stats(const int16_t* p_frame, size_t len, amg88_stats_t* p_stats, amg88_hist_t* p_hist) {
+    int16_t min, max;
+    uint16_t argmin = 0, argmax = 0;
+    int32_t sum = 0;
+    uint64_t sum_sq = 0;
+    float mean;
+
+    /* Nothing to seed min/max with or divide by, and no last bin to clamp into */
+    if (len == 0 || (p_hist != NULL && (p_hist->bins == NULL || p_hist->n_bins == 0))) {
+        return AMG88_ERR;
+    }
+
+    min = max = p_frame[0];
+
+    if (p_hist != NULL) {
+        memset(p_hist->bins, 0, sizeof(*p_hist->bins) * p_hist->n_bins);
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        int32_t v = p_frame[i];
+
+        if (v < min) {
+            min = v;
+            argmin = i;
+        }
+        if (v > max) {
+            max = v;
+            argmax = i;
+        }
+        sum += v;
+        sum_sq += (uint32_t) (v * v);
+
+        if (p_hist != NULL) {
+            int32_t bin = (v - p_hist->lo) >> p_hist->shift;
+
+            bin = bin < 0 ? 0 : bin;
+            bin = bin >= p_hist->n_bins ? p_hist->n_bins - 1 : bin;
+            p_hist->bins[bin]++;
+        }
+    }
+
+    mean = (float) sum / (float) len;
+
+    p_stats->min = min;
+    p_stats->max = max;
+    p_stats->argmin = argmin;
+    p_stats->argmax = argmax;
+    p_stats->sum = sum;
+    p_stats->sum_sq = sum_sq;
+    p_stats->mean = mean;
+    p_stats->variance = (float) sum_sq / (float) len - mean * mean;
+
+    return AMG88_OK;
+}
+
+amg88_err_t
+amg88_frame_stats_raw(const amg88_frame_raw_t* p_frame, amg88_stats_t* p_stats, amg88_hist_t* p_hist) {
+    int16_t fixed[AMG88_ARRAY_SIZE];
+
+    amg88_decode_frame(p_frame, fixed);
+
+    return amg88_frame_stats(fixed, AMG88_ARRAY_SIZE, p_stats, p_hist);
+}
+
+uint16_t
+amg88_temp_to_reg(float temp) {
+    int32_t q;
+
+    q = (int32_t) (temp * (1 << AMG88_TEMP_FRAC_BITS) + (temp < 0 ? -0.5f : 0.5f));
+    q = q < -2048 ? -2048 : q;
+    q = q > 2047 ? 2047 : q;
+
+    return (uint16_t) q & 0x0FFF;
+}
+
+amg88_err_t
+amg88_set_int_levels(amg88_dev_t* p_dev, float high, float low, float hyst) {
+    uint16_t levels[3];
+    uint8_t buff[6];
+
+    levels[0] = amg88_temp_to_reg(high);
+    levels[1] = amg88_temp_to_reg(low);
+    levels[2] = amg88_temp_to_reg(hyst < 0 ? 0 : hyst);
+
+    /* INTHL..IHYSH are consecutive */
+    for (size_t i = 0; i < 3; ++i) {
+        buff[2 * i] = levels[i] & 0xFF;
+        buff[2 * i + 1] = levels[i] >> 8;
+    }
+
+    return amg88_shadow_set(p_dev, AMG88_REG_INTHL, sizeof(buff), buff);
+}
+
+amg88_err_t
+amg88_enable_int(amg88_dev_t* p_dev, amg88_int_mode_t mode) {
+    uint8_t intc = AMG88_INTC_INTEN | (mode & AMG88_INTC_INTMOD);
+
+    return amg88_shadow_set(p_dev, AMG88_REG_INTC, 1, &intc);
+}
+
+amg88_err_t
+amg88_disable_int(amg88_dev_t* p_dev) {
+    uint8_t intc = 0;
+
+    return amg88_shadow_set(p_dev, AMG88_REG_INTC, 1, &intc);
+}
+
+amg88_err_t
+amg88_get_int_table(amg88_dev_t* p_dev, uint64_t* p_mask) {
+    uint8_t buff[8];
+    uint64_t mask = 0;
+    amg88_err_t ret;
+
+    ret = p_dev->read(p_dev->bus, p_dev->addr, AMG88_REG_INT0, sizeof(buff), buff);
+    if (ret != AMG88_OK) {
+        return ret;
+    }
+
+    for (size_t i = 0; i < sizeof(buff); ++i) {
+        mask |= (uint64_t) buff[i] << (8 * i);
     }
+    *p_mask = mask;
 
     return AMG88_OK;
 }
 
+amg88_err_t
+amg88_get_status(amg88_dev_t* p_dev, uint8_t* p_stat) {
+    return p_dev->read(p_dev->bus, p_dev->addr, AMG88_REG_STAT, 1, p_stat);
+}
 
+amg88_err_t
+amg88_clear_status(amg88_dev_t* p_dev, uint8_t flags) {
+    flags &= AMG88_STAT_ALL;
+
+    return p_dev->write(p_dev->bus, p_dev->addr, AMG88_REG_SCLR, 1, &flags);
+}
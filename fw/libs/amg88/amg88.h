@@ -17,8 +17,6 @@
 extern "C" {
 #endif /* __cplusplus */
 
-// TODO Add interrupts
-
 /**
  * \brief           Calculate the thermistor temperature from the sensor raw data
  * \param[in]       data: Raw thermistor array
@@ -26,14 +24,14 @@ extern "C" {
  * \return          Thermistor temperature
  * \hideinitializer
  */
-#define AMG88_THERMISTOR_2_TEMP_RES(data, res) ({  \
-    float _temp;                                   \
-    uint8_t _neg;                                  \
-    uint16_t _raw_temp;                            \
-    _neg = (data[1] & 0x08) > 1;                   \
-    _raw_temp = data[0] | ((data[1] & 0x07) << 8); \
-    _temp = _raw_temp * res * (_neg ? -1 : 1);     \
-    _temp;                                         \
+#define AMG88_THERMISTOR_2_TEMP_RES(data, res) ({       \
+    float _temp;                                        \
+    uint8_t _neg;                                       \
+    int16_t _raw_temp;                                  \
+    _neg = ((data)[1] & 0x08) > 1;                      \
+    _raw_temp = (data)[0] | (((data)[1] & 0x07) << 8);  \
+    _temp = (_neg ? -_raw_temp : _raw_temp) * (res);    \
+    _temp;                                              \
 })
 
 /**
@@ -46,22 +44,19 @@ extern "C" {
 
 /**
  * \brief           Calculate the IR pixel temperature from the sensor raw data
+ * \note            12-bit two's complement, sign-extended like \ref amg88_decode_frame so both agree bit for bit
  * \param[in]       data: Raw pixel array
  * \param[in]       res: IR sensor resolution
  * \return          IR pixel temperature
  * \hideinitializer
  */
-#define AMG88_PIXEL_2_TEMP_RES(data, res) ({        \
-    float _temp;                                    \
-    uint16_t _raw_temp;                             \
-    _raw_temp = data[0] | ((data[1] & 0x07) << 8);  \
-    if ((data[1] & 0x08) > 1) {                     \
-        _temp = ~(_raw_temp - 1) & 0x7FF;           \
-    } else {                                        \
-        _temp = _raw_temp;                          \
-    }                                               \
-    _temp = _temp * res;                            \
-    _temp;                                          \
+#define AMG88_PIXEL_2_TEMP_RES(data, res) ({             \
+    float _temp;                                         \
+    uint16_t _raw_temp;                                  \
+    _raw_temp = (data)[0] | (((data)[1] & 0x0F) << 8);   \
+    _temp = (int16_t) (uint16_t) (_raw_temp << 4) >> 4;  \
+    _temp = _temp * (res);                               \
+    _temp;                                               \
 })
 
 /**
@@ -72,6 +67,22 @@ extern "C" {
  */
 #define AMG88_PIXEL_2_TEMP(data) (AMG88_PIXEL_2_TEMP_RES(data, AMG88_TEMP_RESOLUTION))
 
+/**
+ * \brief           Convert a fixed-point pixel value (1/4 degree units) to degrees
+ * \param[in]       q: Fixed-point pixel value
+ * \return          Temperature
+ * \hideinitializer
+ */
+#define AMG88_TEMP_FROM_FIXED(q) ((float) (q) * (float) AMG88_TEMP_RESOLUTION)
+
+/**
+ * \brief           Convert a fixed-point thermistor value (1/16 degree units) to degrees
+ * \param[in]       q: Fixed-point thermistor value
+ * \return          Temperature
+ * \hideinitializer
+ */
+#define AMG88_THERMISTOR_FROM_FIXED(q) ((float) (q) * (float) AMG88_THERMISTOR_RESOLUTION)
+
 /**
  * \brief           Find maximum value in the array
  * \param[in]       array: Input array
@@ -80,8 +91,8 @@ extern "C" {
  * \hideinitializer
  */
 #define AMG88_ARRAY_MAX_LEN(array, len) ({  \
-    float _max = -99.99;                    \
-    for (size_t i = 0; i < len; i++) {      \
+    float _max = array[0];                  \
+    for (size_t i = 1; i < len; i++) {      \
         if (array[i] > _max) {              \
             _max = array[i];                \
         }                                   \
@@ -105,8 +116,8 @@ extern "C" {
  * \hideinitializer
  */
 #define AMG88_ARRAY_MIN_LEN(array, len) ({  \
-    float _min = -99.99;                    \
-    for (size_t i = 0; i < len; i++) {      \
+    float _min = array[0];                  \
+    for (size_t i = 1; i < len; i++) {      \
         if (array[i] < _min) {              \
             _min = array[i];                \
         }                                   \
@@ -130,14 +141,11 @@ extern "C" {
  * \hideinitializer
  */
 #define AMG88_ARRAY_MEAN_LEN(array, len) ({         \
-    float _mean, _index;                            \
-    _mean = (float) array[0];                       \
-    for (size_t i = 1; i < len; i++) {              \
-        _index = (float) i;                         \
-        _mean *= (_index / (_index + 1));           \
-        _mean += (float) array[i] / (_index + 1);   \
+    float _sum = 0;                                 \
+    for (size_t i = 0; i < len; i++) {              \
+        _sum += (float) array[i];                   \
     }                                               \
-    _mean;                                          \
+    _sum / (float) (len);                           \
 })
 
 /**
@@ -148,8 +156,69 @@ extern "C" {
  */
 #define AMG88_ARRAY_MEAN(array) AMG88_ARRAY_MEAN_LEN(array, AMG88_ARRAY_SIZE)
 
+/**
+ * \brief           Frame statistics, in the units of the input frame
+ */
+typedef struct {
+    int16_t min;                                /*!< Minimum value */
+    int16_t max;                                /*!< Maximum value */
+    uint16_t argmin;                            /*!< Index of the (first) minimum value */
+    uint16_t argmax;                            /*!< Index of the (first) maximum value */
+    int32_t sum;                                /*!< Sum of all the values */
+    uint64_t sum_sq;                            /*!< Sum of the squared values */
+    float mean;                                 /*!< Mean value */
+    float variance;                             /*!< Population variance */
+} amg88_stats_t;
+
+/**
+ * \brief           Coarse histogram settings and output for \ref amg88_frame_stats
+ * \note            Bin of a value `v` is `(v - lo) >> shift`, values outside are clamped to the first/last bin
+ */
+typedef struct {
+    uint16_t* bins;                             /*!< Caller-owned bins array, cleared by \ref amg88_frame_stats */
+    uint16_t n_bins;                            /*!< Number of bins */
+    int16_t lo;                                 /*!< Value mapped to the beginning of the first bin */
+    uint8_t shift;                              /*!< Bin width, as a power of two */
+} amg88_hist_t;
+
+/**
+ * \brief           Outcome of a frame read, see \ref amg88_get_frame_raw_status
+ */
+typedef struct {
+    amg88_err_t err;                            /*!< First error left unrecovered, \ref AMG88_OK for a full frame */
+    uint64_t valid;                             /*!< Bit `i` set when pixel `i` (row-major) was read */
+    bool thermistor;                            /*!< Thermistor read */
+    uint8_t retries;                            /*!< Burst retries done */
+    uint8_t recoveries;                         /*!< Bus recoveries done */
+} amg88_frame_status_t;
+
+/**
+ * \brief           Start a batch of configuration changes
+ * \note            Setters only update the register shadow until the matching \ref amg88_config_commit.
+ *                  Batches nest, the outermost commit writes.
+ * \param[in]       p_dev: Pointer to sensor handler
+ */
+void amg88_config_begin(amg88_dev_t* p_dev);
+
+/**
+ * \brief           Close a batch and write every changed register in as few bursts as possible
+ * \note            Registers that could not be written stay pending for the next commit. A sleeping sensor
+ *                  ignores every register but PCTL, so a batch that enters sleep mode writes PCTL last
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_config_commit(amg88_dev_t* p_dev);
+
+/**
+ * \brief           Forget the register shadow, the next getters read the sensor again
+ * \note            Pending changes are dropped. Call it after the sensor lost power.
+ * \param[in]       p_dev: Pointer to sensor handler
+ */
+void amg88_config_invalidate(amg88_dev_t* p_dev);
+
 /**
  * \brief           Get sensor operation mode
+ * \note            Served from the register shadow, only the first call after an invalidation reads the sensor
  * \param[in]       p_dev: Pointer to sensor handler
  * \return          Operation mode, \ref AMG88_OP_NOT_VALID on error
  */
@@ -157,6 +226,7 @@ amg88_op_mode_t amg88_get_op_mode(amg88_dev_t* p_dev);
 
 /**
  * \brief           Set sensor operation mode
+ * \note            Skipped when unchanged, deferred inside a \ref amg88_config_begin batch
  * \param[in]       p_dev: Pointer to sensor handler
  * \param[in]       mode: New operation mode
  * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
@@ -165,6 +235,7 @@ amg88_err_t amg88_set_op_mode(amg88_dev_t* p_dev, amg88_op_mode_t mode);
 
 /**
  * \brief           Reset the sensor
+ * \note            \ref AMG88_RESET_INITIAL invalidates the register shadow
  * \param[in]       p_dev: Pointer to sensor handler
  * \param[in]       type: Reset type
  * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
@@ -173,6 +244,7 @@ amg88_err_t amg88_reset(amg88_dev_t* p_dev, amg88_reset_t type);
 
 /**
  * \brief           Get sensor frame rate
+ * \note            Served from the register shadow, only the first call after an invalidation reads the sensor
  * \param[in]       p_dev: Pointer to sensor handler
  * \return          Frame rate, \ref AMG88_FPS_NOT_VALID on error
  */
@@ -180,16 +252,36 @@ amg88_fps_t amg88_get_frame_rate(amg88_dev_t* p_dev);
 
 /**
  * \brief           Set sensor frame rate
+ * \note            Skipped when unchanged, deferred inside a \ref amg88_config_begin batch
  * \param[in]       p_dev: Pointer to sensor handler
  * \param[in]       mode: New frame rate
  * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
  */
 amg88_err_t amg88_set_frame_rate(amg88_dev_t* p_dev, amg88_fps_t mode);
 
+/**
+ * \brief           Get the moving average mode
+ * \note            Served from the register shadow, only the first call after an invalidation reads the sensor
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[out]      p_ave: \ref AMG88_REG_AVE value
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_get_moving_average(amg88_dev_t* p_dev, uint8_t* p_ave);
+
+/**
+ * \brief           Set the moving average mode
+ * \note            Written between the \ref AMG88_AVE_UNLOCK sequence and the lock, the sensor ignores a bare
+ *                  \ref AMG88_REG_AVE write. Skipped when unchanged, deferred inside a \ref amg88_config_begin batch
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[in]       mode: New mode
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_set_moving_average(amg88_dev_t* p_dev, amg88_ave_t mode);
+
 /**
  * \brief           Get internal thermistor value
  * \param[in]       p_dev: Pointer to sensor handler
- * \return          Thermistor temperature
+ * \return          Thermistor temperature, \ref AMG88_TEMP_INVALID on error
  */
 float amg88_get_thermistor(amg88_dev_t* p_dev);
 
@@ -198,7 +290,7 @@ float amg88_get_thermistor(amg88_dev_t* p_dev);
  * \param[in]       p_dev: Pointer to sensor handler
  * \param[in]       row: Pixel row
  * \param[in]       col: Pixel column
- * \return          Pixel temperature
+ * \return          Pixel temperature, \ref AMG88_TEMP_INVALID on error
  */
 float amg88_get_pixel(amg88_dev_t* p_dev, uint8_t row, uint8_t col);
 
@@ -210,6 +302,135 @@ float amg88_get_pixel(amg88_dev_t* p_dev, uint8_t row, uint8_t col);
  */
 amg88_err_t amg88_get_array(amg88_dev_t* p_dev, float* array);
 
+/**
+ * \brief           Read the whole raw frame in a single auto-increment burst
+ * \note            The pixels are read in one transaction, the thermistor (optional) in a second one
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[out]      p_frame: Caller-owned raw frame
+ * \param[in]       thermistor: Set to `1` to also read the thermistor registers
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_get_frame_raw(amg88_dev_t* p_dev, amg88_frame_raw_t* p_frame, uint8_t thermistor);
+
+/**
+ * \brief           Read the raw frame under the device retry policy and tell which pixels made it
+ * \note            The pixels are read in `p_dev->retry.bursts` bursts, a failed one is retried alone. A burst
+ *                  that timed out or failed twice gets a bus recovery (`p_dev->recover`) before its next try.
+ *                  Bursts are still attempted after one gives up, so a glitch costs a few pixels, not the frame.
+ *                  Once an error was seen and `p_dev->retry.budget_us` ran out, the remaining bursts are skipped:
+ *                  a frame never takes much longer than the budget plus one bus timeout
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[out]      p_frame: Caller-owned raw frame, pixels of failed bursts are left untouched
+ * \param[in]       thermistor: Set to `1` to also read the thermistor registers
+ * \param[out]      p_status: Per-frame status, may be `NULL`
+ * \return          \ref AMG88_OK when everything was read, the first error left unrecovered otherwise
+ */
+amg88_err_t amg88_get_frame_raw_status(amg88_dev_t* p_dev, amg88_frame_raw_t* p_frame, uint8_t thermistor,
+                                       amg88_frame_status_t* p_status);
+
+/**
+ * \brief           Decode a raw frame into fixed-point temperatures
+ * \note            Branch-free single pass, output in 1/4 degree units (see \ref AMG88_TEMP_FRAC_BITS)
+ * \param[in]       p_frame: Raw frame
+ * \param[out]      p_out: \ref AMG88_ARRAY_SIZE fixed-point temperatures
+ */
+void amg88_decode_frame(const amg88_frame_raw_t* p_frame, int16_t* p_out);
+
+/**
+ * \brief           Decode a raw frame into temperatures in degrees
+ * \param[in]       p_frame: Raw frame
+ * \param[out]      p_out: \ref AMG88_ARRAY_SIZE temperatures
+ */
+void amg88_decode_frame_float(const amg88_frame_raw_t* p_frame, float* p_out);
+
+/**
+ * \brief           Decode the raw thermistor value of a frame
+ * \param[in]       p_frame: Raw frame
+ * \return          Thermistor temperature in 1/16 degree units (see \ref AMG88_THERMISTOR_FRAC_BITS)
+ */
+int16_t amg88_decode_thermistor(const amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Compute the frame statistics in a single pass
+ * \note            Works on integer frames (e.g. the output of \ref amg88_decode_frame), the only
+ *                  divisions happen once after the loop
+ * \param[in]       p_frame: Integer frame
+ * \param[in]       len: Number of values in the frame
+ * \param[out]      p_stats: Frame statistics, untouched on error
+ * \param[inout]    p_hist: Optional histogram, `NULL` to skip it
+ * \return          \ref AMG88_OK on success, \ref AMG88_ERR when `len` is 0 or the histogram has no bins
+ */
+amg88_err_t amg88_frame_stats(const int16_t* p_frame, size_t len, amg88_stats_t* p_stats, amg88_hist_t* p_hist);
+
+/**
+ * \brief           Compute the statistics of a raw frame, in 1/4 degree units
+ * \param[in]       p_frame: Raw frame
+ * \param[out]      p_stats: Frame statistics
+ * \param[inout]    p_hist: Optional histogram, `NULL` to skip it
+ * \return          \ref AMG88_OK on success, \ref AMG88_ERR when the histogram has no bins
+ */
+amg88_err_t amg88_frame_stats_raw(const amg88_frame_raw_t* p_frame, amg88_stats_t* p_stats, amg88_hist_t* p_hist);
+
+/**
+ * \brief           Encode a temperature into the 12-bit two's complement register format
+ * \param[in]       temp: Temperature, rounded to the nearest 1/4 degree and saturated
+ * \return          Register value (12 bits)
+ */
+uint16_t amg88_temp_to_reg(float temp);
+
+/**
+ * \brief           Set the interrupt levels
+ * \note            All six registers are written in a single burst, skipped when unchanged and deferred
+ *                  inside a \ref amg88_config_begin batch
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[in]       high: Upper level, degrees (or difference in degrees in \ref AMG88_INT_DIFFERENCE mode)
+ * \param[in]       low: Lower level, degrees (or difference in degrees in \ref AMG88_INT_DIFFERENCE mode)
+ * \param[in]       hyst: Hysteresis, degrees
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_set_int_levels(amg88_dev_t* p_dev, float high, float low, float hyst);
+
+/**
+ * \brief           Enable the interrupt output
+ * \note            Skipped when unchanged, deferred inside a \ref amg88_config_begin batch
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[in]       mode: Interrupt mode
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_enable_int(amg88_dev_t* p_dev, amg88_int_mode_t mode);
+
+/**
+ * \brief           Disable the interrupt output
+ * \note            Skipped when unchanged, deferred inside a \ref amg88_config_begin batch
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_disable_int(amg88_dev_t* p_dev);
+
+/**
+ * \brief           Read the triggered pixels table in a single burst
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[out]      p_mask: Bit `n` is set when pixel `n` (`row * 8 + col`) triggered the interrupt
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_get_int_table(amg88_dev_t* p_dev, uint64_t* p_mask);
+
+/**
+ * \brief           Get the status flags
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[out]      p_stat: Combination of \ref amg88_stat_t flags
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_get_status(amg88_dev_t* p_dev, uint8_t* p_stat);
+
+/**
+ * \brief           Clear status flags
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[in]       flags: Combination of \ref amg88_stat_t flags to clear
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t amg88_clear_status(amg88_dev_t* p_dev, uint8_t flags);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,108 @@
+/**
+ * \file            amg88_async.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           AMG88xx non-blocking frame reads, on top of the OSAL
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "amg88_async.h"
+
+#include <string.h>
+
+
+/* The collecting side owns the handle again once it sees DONE, so the user callback goes first */
+static void
+amg88_xfer_finish(amg88_xfer_t* p_xfer, amg88_err_t err) {
+    p_xfer->err = err;
+    if (p_xfer->done != NULL) {
+        p_xfer->done(err, p_xfer->arg);
+    }
+    atomic_store_explicit(&p_xfer->state, AMG88_XFER_DONE, memory_order_release);
+    osal_sem_give(&p_xfer->sem);
+}
+
+/* Pixel burst done, chain the thermistor burst from the bus side when asked for */
+static void
+amg88_xfer_step(amg88_err_t err, void* arg) {
+    amg88_xfer_t* p_xfer = (amg88_xfer_t*) arg;
+    amg88_dev_t* p_dev = p_xfer->p_dev;
+
+    if (err == AMG88_OK && p_xfer->thermistor) {
+        p_xfer->thermistor = 0;
+        err = p_dev->read_async(p_dev->bus, p_dev->addr, AMG88_REG_TTHL, 2, p_xfer->p_frame->thermistor,
+                                amg88_xfer_step, p_xfer);
+        if (err == AMG88_OK) {
+            return;
+        }
+    }
+
+    amg88_xfer_finish(p_xfer, err);
+}
+
+amg88_err_t
+amg88_xfer_init(amg88_xfer_t* p_xfer) {
+    memset(p_xfer, 0, sizeof(*p_xfer));
+    atomic_init(&p_xfer->state, AMG88_XFER_IDLE);
+
+    return osal_sem_init(&p_xfer->sem) == OSAL_OK ? AMG88_OK : AMG88_ERR;
+}
+
+amg88_err_t
+amg88_get_frame_raw_async(amg88_dev_t* p_dev, amg88_xfer_t* p_xfer, amg88_frame_raw_t* p_frame,
+                          uint8_t thermistor, amg88_done_fn done, void* arg) {
+    amg88_err_t ret;
+
+    if (atomic_load_explicit(&p_xfer->state, memory_order_acquire) != AMG88_XFER_IDLE) {
+        return AMG88_ERR;
+    }
+
+    p_xfer->p_dev = p_dev;
+    p_xfer->p_frame = p_frame;
+    p_xfer->thermistor = thermistor;
+    p_xfer->done = done;
+    p_xfer->arg = arg;
+    atomic_store_explicit(&p_xfer->state, AMG88_XFER_BUSY, memory_order_relaxed);
+
+    if (p_dev->read_async == NULL) {
+        amg88_xfer_finish(p_xfer, amg88_get_frame_raw(p_dev, p_frame, thermistor));
+        return AMG88_OK;
+    }
+
+    ret = p_dev->read_async(p_dev->bus, p_dev->addr, AMG88_REG_TL, AMG88_FRAME_RAW_SIZE, p_frame->pixels,
+                            amg88_xfer_step, p_xfer);
+    if (ret != AMG88_OK) {
+        atomic_store_explicit(&p_xfer->state, AMG88_XFER_IDLE, memory_order_relaxed);
+    }
+
+    return ret;
+}
+
+bool
+amg88_xfer_poll(amg88_xfer_t* p_xfer, amg88_err_t* p_err) {
+    if (atomic_load_explicit(&p_xfer->state, memory_order_acquire) != AMG88_XFER_DONE) {
+        return false;
+    }
+
+    /* Consume the give of this transfer, so the next wait does not return early */
+    osal_sem_take(&p_xfer->sem, OSAL_WAIT_FOREVER);
+    *p_err = p_xfer->err;
+    atomic_store_explicit(&p_xfer->state, AMG88_XFER_IDLE, memory_order_relaxed);
+
+    return true;
+}
+
+amg88_err_t
+amg88_xfer_wait(amg88_xfer_t* p_xfer, uint32_t timeout_ms) {
+    if (atomic_load_explicit(&p_xfer->state, memory_order_relaxed) == AMG88_XFER_IDLE) {
+        return AMG88_ERR;
+    }
+    if (osal_sem_take(&p_xfer->sem, timeout_ms) != OSAL_OK) {
+        return AMG88_ERR_TIMEOUT;
+    }
+
+    /* The semaphore orders the result before this read */
+    atomic_store_explicit(&p_xfer->state, AMG88_XFER_IDLE, memory_order_relaxed);
+
+    return p_xfer->err;
+}
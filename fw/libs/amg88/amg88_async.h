@@ -0,0 +1,93 @@
+/**
+ * \file            amg88_async.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           AMG88xx non-blocking frame reads, on top of the OSAL
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef AMG88_ASYNC_H
+#define AMG88_ASYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "amg88.h"
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Non-blocking transfer states
+ */
+typedef enum {
+    AMG88_XFER_IDLE,                            /*!< Nothing running, result collected */
+    AMG88_XFER_BUSY,                            /*!< On the bus */
+    AMG88_XFER_DONE,                            /*!< Finished, result not collected yet */
+} amg88_xfer_state_t;
+
+/**
+ * \brief           Non-blocking frame read handle, see \ref amg88_get_frame_raw_async
+ * \note            One transfer at a time per handle, use two handles to keep a read queued behind another
+ */
+typedef struct {
+    amg88_dev_t* p_dev;                         /*!< Sensor being read */
+    amg88_frame_raw_t* p_frame;                 /*!< Destination frame */
+    uint8_t thermistor;                         /*!< Thermistor read still to chain after the pixels */
+    amg88_done_fn done;                         /*!< User completion callback, `NULL` for none */
+    void* arg;                                  /*!< User callback argument */
+
+    atomic_uint_fast8_t state;                  /*!< A member of \ref amg88_xfer_state_t */
+    amg88_err_t err;                            /*!< Result, valid once done */
+    osal_sem_t sem;                             /*!< Given once per finished transfer */
+} amg88_xfer_t;
+
+/**
+ * \brief           Init a non-blocking frame read handle
+ * \param[out]      p_xfer: Transfer handle
+ * \return          \ref AMG88_OK on success, \ref AMG88_ERR when the semaphore can't be created
+ */
+amg88_err_t amg88_xfer_init(amg88_xfer_t* p_xfer);
+
+/**
+ * \brief           Start reading the raw frame and return before it is on the wire
+ * \note            Same bursts as \ref amg88_get_frame_raw, through `p_dev->read_async`. Without it the read
+ *                  is done right away and the transfer is already finished on return, so callers need no
+ *                  second code path. Collect the result with \ref amg88_xfer_poll or \ref amg88_xfer_wait
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \param[inout]    p_xfer: Idle transfer handle
+ * \param[out]      p_frame: Caller-owned raw frame, not to be touched until the transfer is finished
+ * \param[in]       thermistor: Set to `1` to also read the thermistor registers
+ * \param[in]       done: Called once the transfer is finished, on the context that finished it, `NULL` for none
+ * \param[in]       arg: Callback argument
+ * \return          \ref AMG88_OK when started, an error when the handle is busy or the read could not be
+ *                  queued (no callback then)
+ */
+amg88_err_t amg88_get_frame_raw_async(amg88_dev_t* p_dev, amg88_xfer_t* p_xfer, amg88_frame_raw_t* p_frame,
+                                      uint8_t thermistor, amg88_done_fn done, void* arg);
+
+/**
+ * \brief           Collect the result of a transfer if it is finished, never blocks
+ * \param[inout]    p_xfer: Transfer handle
+ * \param[out]      p_err: Transfer result, set when finished
+ * \return          `true` when finished (the handle is idle again), `false` while on the bus
+ */
+bool amg88_xfer_poll(amg88_xfer_t* p_xfer, amg88_err_t* p_err);
+
+/**
+ * \brief           Wait for a transfer to finish and collect its result
+ * \param[inout]    p_xfer: Transfer handle
+ * \param[in]       timeout_ms: Max time to wait, \ref OSAL_WAIT_FOREVER to block
+ * \return          Transfer result, \ref AMG88_ERR_TIMEOUT if still on the bus after `timeout_ms` (wait again
+ *                  later) and \ref AMG88_ERR when nothing was started
+ */
+amg88_err_t amg88_xfer_wait(amg88_xfer_t* p_xfer, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AMG88_ASYNC_H */
@@ -11,12 +11,18 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 #define AMG88_ARRAY_SIZE 64
+#define AMG88_ARRAY_ROWS 8
+#define AMG88_ARRAY_COLS 8
+
+#define AMG88_PIXEL_BYTES    2
+#define AMG88_FRAME_RAW_SIZE (AMG88_ARRAY_SIZE * AMG88_PIXEL_BYTES)
 
 #define AMG88_I2C_ADDR_LOW  0x68
 #define AMG88_I2C_ADDR_HIGH 0x69
@@ -24,6 +30,12 @@ extern "C" {
 #define AMG88_THERMISTOR_RESOLUTION 0.0625
 #define AMG88_TEMP_RESOLUTION       0.25
 
+#define AMG88_THERMISTOR_FRAC_BITS  4           /*!< Fixed-point thermistor values are in 1/16 degree units */
+#define AMG88_TEMP_FRAC_BITS        2           /*!< Fixed-point pixel values are in 1/4 degree units */
+
+#define AMG88_TEMP_INVALID   -99.99             /*!< Float getters result when the sensor could not be read */
+#define AMG88_BURSTS_MAX     8                  /*!< Max bursts a frame read is split into */
+
 #define AMG88_THERMISTOR_MAX -20
 #define AMG88_THERMISTOR_MIN  80
 
@@ -38,7 +50,8 @@ typedef enum {
     AMG88_REG_STAT  = 0x04,                     /*!< Interrupt Flag, low voltage Flag [R] */
     AMG88_REG_SCLR  = 0x05,                     /*!< Interrupt Flag Clear [W] */
 
-    AMG88_REG_AVE   = 0x07,                     /*!< Moving Average Output Mode [R] */
+    AMG88_REG_AVE   = 0x07,                     /*!< Moving Average Output Mode [R/W], write unlocked by
+                                                     \ref AMG88_REG_AVE_KEY */
     AMG88_REG_INTHL = 0x08,                     /*!< Interrupt upper value（Upper level） [R/W] */
     AMG88_REG_INTHH = 0x09,                     /*!< Interrupt upper value（Upper level） [R/W] */
     AMG88_REG_INTLL = 0x0A,                     /*!< Interrupt lower value（Lower level） [R/W] */
@@ -56,6 +69,8 @@ typedef enum {
     AMG88_REG_INT6  = 0x16,                     /*!< Pixel 49～56 Interrupt Result [R] */
     AMG88_REG_INT7  = 0x17,                     /*!< Pixel 57～64 Interrupt Result [R] */
 
+    AMG88_REG_AVE_KEY = 0x1F,                   /*!< Undocumented, unlocks \ref AMG88_REG_AVE writes [W] */
+
     AMG88_REG_TL    = 0x80,                     /*!< Base addr pixel Output Value (Lower Level) [R] */
     AMG88_REG_TH    = 0x81,                     /*!< Base addr pixel Output Value (Upper Level) [R] */
 } amg88_reg_t;
@@ -91,6 +106,20 @@ typedef enum {
     AMG88_RESET_INITIAL = 0x3F,                 /*!< Returns to initial setting */
 } amg88_reset_t;
 
+/**
+ * \brief           AMG88 moving average modes
+ */
+typedef enum {
+    AMG88_AVE_OFF   = 0x00,                     /*!< Every frame on its own */
+    AMG88_AVE_TWICE = 0x20,                     /*!< Twice moving average (MAMOD bit), lower noise, slower response */
+} amg88_ave_t;
+
+/**
+ * \brief           \ref AMG88_REG_AVE_KEY sequence around an \ref AMG88_REG_AVE write, locked again with `0x00`
+ * \hideinitializer
+ */
+#define AMG88_AVE_UNLOCK    { 0x50, 0x45, 0x57 }
+
 /**
  * \brief           AMG88 frame rate
  */
@@ -101,24 +130,132 @@ typedef enum {
     AMG88_FPS_NOT_VALID = 0xFF,                 /*!< Obtained frame rate not valid */
 } amg88_fps_t;
  
+/**
+ * \brief           AMG88 interrupt modes
+ */
+typedef enum {
+    AMG88_INT_DIFFERENCE = 0x00,                /*!< Triggered by the difference against the previous frame */
+    AMG88_INT_ABSOLUTE   = 0x02,                /*!< Triggered by the absolute pixel temperature */
+} amg88_int_mode_t;
+
+#define AMG88_INTC_INTEN    0x01                /*!< \ref AMG88_REG_INTC interrupt output enable bit */
+#define AMG88_INTC_INTMOD   0x02                /*!< \ref AMG88_REG_INTC interrupt mode bit */
+
+/**
+ * \brief           AMG88 status flags (\ref AMG88_REG_STAT), also used to clear them (\ref AMG88_REG_SCLR)
+ */
+typedef enum {
+    AMG88_STAT_INT      = 0x02,                 /*!< Interrupt outbreak */
+    AMG88_STAT_OVF_IRS  = 0x04,                 /*!< Temperature output overflow */
+    AMG88_STAT_OVF_THS  = 0x08,                 /*!< Thermistor output overflow */
+
+    AMG88_STAT_ALL      = 0x0E,                 /*!< All the flags */
+} amg88_stat_t;
+
 /**
  * \brief           I2C abstraction function definition
+ * \param[in]       bus: I2C bus (controller) the sensor hangs from
  * \param[in]       addr: I2C address
  * \param[in]       reg_addr: Sensor register address
  * \param[in]       len: Data bytes to read/write
  * \param[inout]    data_buf: Buffer that stores the data
  * \return          Error code
  */
-typedef amg88_err_t (*amg88_i2c_fn)(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+typedef amg88_err_t (*amg88_i2c_fn)(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+/**
+ * \brief           I2C bus recovery function definition
+ * \note            Frees a bus a slave holds down (e.g. SCL clocking until SDA is released, then a driver
+ *                  re-init), must return within a bounded time
+ * \param[in]       bus: I2C bus (controller)
+ * \return          Error code
+ */
+typedef amg88_err_t (*amg88_recover_fn)(uint8_t bus);
+
+/**
+ * \brief           Monotonic clock function definition
+ * \return          Current time in microseconds
+ */
+typedef uint64_t (*amg88_clock_fn)(void);
+
+/**
+ * \brief           Completion callback of a non-blocking transfer
+ * \note            Runs on whatever context finished the transfer (e.g. a bus worker task), keep it short
+ * \param[in]       err: Transfer result
+ * \param[in]       arg: User argument
+ */
+typedef void (*amg88_done_fn)(amg88_err_t err, void* arg);
+
+/**
+ * \brief           Non-blocking I2C read function definition
+ * \note            Queues the transfer and returns, `done` is called exactly once when it is accepted
+ * \param[in]       bus: I2C bus (controller) the sensor hangs from
+ * \param[in]       addr: I2C address
+ * \param[in]       reg_addr: Sensor register address
+ * \param[in]       len: Data bytes to read
+ * \param[out]      data_buf: Buffer that stores the data, untouched by the caller until `done`
+ * \param[in]       done: Completion callback
+ * \param[in]       arg: Callback argument
+ * \return          \ref AMG88_OK when queued, an error (and no callback) otherwise
+ */
+typedef amg88_err_t (*amg88_i2c_async_fn)(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len,
+                                          uint8_t* data_buf, amg88_done_fn done, void* arg);
+
+/**
+ * \brief           Raw sensor frame, as stored in the output registers
+ */
+typedef struct {
+    uint8_t pixels[AMG88_FRAME_RAW_SIZE];       /*!< Pixel registers (\ref AMG88_REG_TL onwards), low byte first */
+    uint8_t thermistor[2];                      /*!< Thermistor registers (\ref AMG88_REG_TTHL, \ref AMG88_REG_TTHH) */
+} amg88_frame_raw_t;
+
+#define AMG88_SHADOW_SIZE (AMG88_REG_IHYSH + 1)  /*!< Shadowed register window, \ref AMG88_REG_PCTL onwards */
+
+/**
+ * \brief           Shadowed registers: PCTL, FPSC, INTC, AVE and INTHL..IHYSH
+ * \hideinitializer
+ */
+#define AMG88_SHADOW_MASK ((1U << AMG88_REG_PCTL) | (1U << AMG88_REG_FPSC) | (1U << AMG88_REG_INTC)    \
+                           | (1U << AMG88_REG_AVE) | (0x3FU << AMG88_REG_INTHL))
+
+/**
+ * \brief           Host copy of the writable config registers
+ * \note            An all-zero struct is a valid, empty cache
+ */
+typedef struct {
+    uint8_t regs[AMG88_SHADOW_SIZE];            /*!< Register values, indexed by register address */
+    uint16_t valid;                             /*!< Bit `reg` set when `regs[reg]` is known */
+    uint16_t dirty;                             /*!< Bit `reg` set when `regs[reg]` still has to be written */
+    uint8_t batch;                              /*!< Open \ref amg88_config_begin calls */
+} amg88_shadow_t;
+
+/**
+ * \brief           Frame read retry policy
+ * \note            An all-zero struct keeps a single burst and no retries
+ */
+typedef struct {
+    uint8_t bursts;                             /*!< Bursts the pixels are read in, 1, 2, 4 or \ref AMG88_BURSTS_MAX.
+                                                     Only a failed burst is read again */
+    uint8_t retries;                            /*!< Extra attempts per burst */
+    uint32_t budget_us;                         /*!< Past this time from the frame start no retry starts, nor a
+                                                     burst after a failure. `0` for no limit, it needs `clock_us`
+                                                     in the sensor handler */
+} amg88_retry_t;
 
 /**
  * \brief           Sensor handler
  */
 typedef struct {
+    uint8_t bus;                                /*!< I2C bus (controller) */
     uint8_t addr;                               /*!< I2C sensor address */
+    amg88_shadow_t shadow;                      /*!< Config registers cache */
 
     amg88_i2c_fn read;                          /*!< I2C read function */
     amg88_i2c_fn write;                         /*!< I2C write function */
+    amg88_i2c_async_fn read_async;              /*!< Non-blocking I2C read function, `NULL` when the HAL has none */
+    amg88_recover_fn recover;                   /*!< Bus recovery function, `NULL` when the HAL has none */
+    amg88_clock_fn clock_us;                    /*!< Time source of the retry budget, `NULL` for no budget */
+    amg88_retry_t retry;                        /*!< Frame read retry policy */
 } amg88_dev_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,302 @@
+/**
+ * \file            calib.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Per-pixel offset/gain/drift calibration, fused into the frame decode
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "calib.h"
+
+#include <string.h>
+
+#include "amg88/amg88.h"
+#include "crc32/crc32.h"
+
+/* Pixels (2 fractional bits) times gain land on this many fractional bits, so do offset and drift */
+#define CALIB_ACC_BITS  (AMG88_TEMP_FRAC_BITS + CALIB_GAIN_BITS)
+#define CALIB_TH_REF    (25 << AMG88_THERMISTOR_FRAC_BITS)
+
+
+static void
+calib_put16(uint8_t* p, int16_t v) {
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) ((uint16_t) v >> 8);
+}
+
+static int16_t
+calib_get16(const uint8_t* p) {
+    return (int16_t) (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static void
+calib_put32(uint8_t* p, uint32_t v) {
+    for (size_t i = 0; i < 4; ++i) {
+        p[i] = (uint8_t) (v >> (8 * i));
+    }
+}
+
+static uint32_t
+calib_get32(const uint8_t* p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/* Round to fixed-point, `false` when it does not fit an int16 */
+static bool
+calib_to_fixed(float v, uint8_t bits, int16_t* p_out) {
+    float q = v * (float) (1 << bits);
+
+    q += q < 0 ? -0.5f : 0.5f;
+    if (q < -32768.0f || q > 32767.0f) {
+        return false;
+    }
+    *p_out = (int16_t) q;
+
+    return true;
+}
+
+static float
+calib_mean_pixel(const calib_acc_t* p_acc, size_t i) {
+    return (float) p_acc->sum[i] / p_acc->n * (float) AMG88_TEMP_RESOLUTION;
+}
+
+static float
+calib_mean_th(const calib_acc_t* p_acc) {
+    return (float) p_acc->th_sum / p_acc->n;
+}
+
+/* Offsets so that pixel `i` reads `p_target[i]` (or `target` for all) on the accumulated frames */
+static calib_err_t
+calib_set_offsets(calib_table_t* p_table, const calib_acc_t* p_acc, const float* p_target, float target) {
+    int16_t offset[AMG88_ARRAY_SIZE];
+    float dth;
+
+    if (p_acc->n == 0) {
+        return CALIB_ERR_RANGE;
+    }
+
+    dth = (calib_mean_th(p_acc) - p_table->th_ref) / (1 << AMG88_THERMISTOR_FRAC_BITS);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        float gain = (float) p_table->gain[i] / (1 << CALIB_GAIN_BITS);
+        float drift = (float) p_table->drift[i] / (1 << CALIB_DRIFT_BITS);
+        float off = (p_target != NULL ? p_target[i] : target) - gain * calib_mean_pixel(p_acc, i) - drift * dth;
+
+        if (!calib_to_fixed(off, CALIB_OFFSET_BITS, &offset[i])) {
+            return CALIB_ERR_RANGE;
+        }
+    }
+    memcpy(p_table->offset, offset, sizeof(offset));
+
+    return CALIB_OK;
+}
+
+void
+calib_init(calib_table_t* p_table) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_table->gain[i] = 1 << CALIB_GAIN_BITS;
+        p_table->offset[i] = 0;
+        p_table->drift[i] = 0;
+    }
+    p_table->th_ref = CALIB_TH_REF;
+}
+
+void
+calib_decode_frame(const calib_table_t* p_table, const amg88_frame_raw_t* p_frame, int16_t* restrict p_out) {
+    const uint8_t* restrict p_in = p_frame->pixels;
+    const int16_t* restrict p_gain = p_table->gain;
+    const int16_t* restrict p_offset = p_table->offset;
+    const int16_t* restrict p_drift = p_table->drift;
+    int32_t dth;
+
+    /* Once per frame: thermistor distance to the reference, 1/16 degree, times drift lands on CALIB_ACC_BITS */
+    dth = amg88_decode_thermistor(p_frame) - p_table->th_ref;
+
+    /* Same shape as amg88_decode_frame, the correction is three multiply-adds on the decoded value */
+#pragma GCC unroll 8
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        uint16_t raw = (uint16_t) (p_in[2 * i] | (p_in[2 * i + 1] << 8));
+        int32_t px = (int16_t) (uint16_t) (raw << 4) >> 4;
+        int32_t acc;
+
+        acc = px * p_gain[i]
+              + p_offset[i] * (1 << (CALIB_ACC_BITS - CALIB_OFFSET_BITS))
+              + p_drift[i] * dth
+              + (1 << (CALIB_GAIN_BITS - 1));
+        p_out[i] = (int16_t) (acc >> CALIB_GAIN_BITS);
+    }
+}
+
+void
+calib_pack_frame(const int16_t* p_temp, amg88_frame_raw_t* p_frame) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        int16_t v = p_temp[i];
+
+        v = v < -2048 ? -2048 : (v > 2047 ? 2047 : v);
+        p_frame->pixels[2 * i] = (uint8_t) v;
+        p_frame->pixels[2 * i + 1] = (uint8_t) (((uint16_t) v >> 8) & 0x0F);
+    }
+}
+
+void
+calib_acc_reset(calib_acc_t* p_acc) {
+    memset(p_acc, 0, sizeof(*p_acc));
+}
+
+void
+calib_acc_add(calib_acc_t* p_acc, const amg88_frame_raw_t* p_frame) {
+    int16_t px[AMG88_ARRAY_SIZE];
+
+    amg88_decode_frame(p_frame, px);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_acc->sum[i] += px[i];
+    }
+    p_acc->th_sum += amg88_decode_thermistor(p_frame);
+    p_acc->n++;
+}
+
+calib_err_t
+calib_capture_flat(calib_table_t* p_table, const calib_acc_t* p_acc) {
+    float mean = 0;
+
+    if (p_acc->n == 0) {
+        return CALIB_ERR_RANGE;
+    }
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        mean += (float) p_table->gain[i] / (1 << CALIB_GAIN_BITS) * calib_mean_pixel(p_acc, i);
+    }
+
+    return calib_set_offsets(p_table, p_acc, NULL, mean / AMG88_ARRAY_SIZE);
+}
+
+calib_err_t
+calib_capture_point(calib_table_t* p_table, const calib_acc_t* p_acc, float temp) {
+    return calib_set_offsets(p_table, p_acc, NULL, temp);
+}
+
+calib_err_t
+calib_capture_two_point(calib_table_t* p_table, const calib_acc_t* p_lo, float t_lo,
+                        const calib_acc_t* p_hi, float t_hi) {
+    int16_t gain[AMG88_ARRAY_SIZE];
+    calib_table_t tmp;
+
+    if (p_lo->n == 0 || p_hi->n == 0 || t_hi - t_lo < 1.0f) {
+        return CALIB_ERR_RANGE;
+    }
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        float span = calib_mean_pixel(p_hi, i) - calib_mean_pixel(p_lo, i);
+
+        /* A dead or saturated pixel does not follow the blackbody, refuse the capture */
+        if (span <= 0 || !calib_to_fixed((t_hi - t_lo) / span, CALIB_GAIN_BITS, &gain[i]) || gain[i] <= 0) {
+            return CALIB_ERR_RANGE;
+        }
+    }
+
+    memcpy(&tmp, p_table, sizeof(tmp));
+    memcpy(tmp.gain, gain, sizeof(gain));
+    if (calib_set_offsets(&tmp, p_lo, NULL, t_lo) != CALIB_OK) {
+        return CALIB_ERR_RANGE;
+    }
+    memcpy(p_table, &tmp, sizeof(tmp));
+
+    return CALIB_OK;
+}
+
+calib_err_t
+calib_capture_drift(calib_table_t* p_table, const calib_acc_t* p_a, const calib_acc_t* p_b) {
+    float target[AMG88_ARRAY_SIZE];
+    calib_table_t tmp;
+    float th_a, dth;
+
+    if (p_a->n == 0 || p_b->n == 0) {
+        return CALIB_ERR_RANGE;
+    }
+
+    th_a = calib_mean_th(p_a);
+    dth = (calib_mean_th(p_b) - th_a) / (1 << AMG88_THERMISTOR_FRAC_BITS);
+    if (dth > -1.0f && dth < 1.0f) {
+        return CALIB_ERR_RANGE;
+    }
+
+    memcpy(&tmp, p_table, sizeof(tmp));
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        float gain = (float) tmp.gain[i] / (1 << CALIB_GAIN_BITS);
+        float drift = (float) tmp.drift[i] / (1 << CALIB_DRIFT_BITS);
+
+        /* Keep what the current table reads at `p_a`, and make `p_b` read the same */
+        target[i] = gain * calib_mean_pixel(p_a, i) + (float) tmp.offset[i] / (1 << CALIB_OFFSET_BITS)
+                    + drift * (th_a - tmp.th_ref) / (1 << AMG88_THERMISTOR_FRAC_BITS);
+        drift = -gain * (calib_mean_pixel(p_b, i) - calib_mean_pixel(p_a, i)) / dth;
+        if (!calib_to_fixed(drift, CALIB_DRIFT_BITS, &tmp.drift[i])) {
+            return CALIB_ERR_RANGE;
+        }
+    }
+    tmp.th_ref = (int16_t) (th_a + (th_a < 0 ? -0.5f : 0.5f));
+
+    if (calib_set_offsets(&tmp, p_a, target, 0) != CALIB_OK) {
+        return CALIB_ERR_RANGE;
+    }
+    memcpy(p_table, &tmp, sizeof(tmp));
+
+    return CALIB_OK;
+}
+
+size_t
+calib_serialize(const calib_table_t* p_table, uint8_t* p_buf, size_t len) {
+    uint8_t* p = p_buf;
+
+    if (len < CALIB_BLOB_SIZE) {
+        return 0;
+    }
+
+    calib_put32(p, CALIB_MAGIC);
+    p[4] = CALIB_VERSION;
+    p[5] = AMG88_ARRAY_SIZE;
+    calib_put16(&p[6], p_table->th_ref);
+    p += CALIB_HDR_SIZE;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        calib_put16(p, p_table->gain[i]);
+    }
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        calib_put16(p, p_table->offset[i]);
+    }
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        calib_put16(p, p_table->drift[i]);
+    }
+    calib_put32(p, crc32_update(CRC32_INIT, p_buf, (size_t) (p - p_buf)));
+
+    return CALIB_BLOB_SIZE;
+}
+
+calib_err_t
+calib_parse(const uint8_t* p_buf, size_t len, calib_table_t* p_table) {
+    const uint8_t* p = p_buf + CALIB_HDR_SIZE;
+
+    if (len < CALIB_BLOB_SIZE) {
+        return CALIB_ERR_LEN;
+    }
+    if (calib_get32(p_buf) != CALIB_MAGIC) {
+        return CALIB_ERR_MAGIC;
+    }
+    if (p_buf[4] != CALIB_VERSION || p_buf[5] != AMG88_ARRAY_SIZE) {
+        return CALIB_ERR_VERSION;
+    }
+    if (calib_get32(&p_buf[CALIB_BLOB_SIZE - 4]) != crc32_update(CRC32_INIT, p_buf, CALIB_BLOB_SIZE - 4)) {
+        return CALIB_ERR_CRC;
+    }
+
+    p_table->th_ref = calib_get16(&p_buf[6]);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        p_table->gain[i] = calib_get16(p);
+    }
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        p_table->offset[i] = calib_get16(p);
+    }
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p += 2) {
+        p_table->drift[i] = calib_get16(p);
+    }
+
+    return CALIB_OK;
+}
@@ -0,0 +1,158 @@
+/**
+ * \file            calib.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Per-pixel offset/gain/drift calibration, fused into the frame decode
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef CALIB_H
+#define CALIB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define CALIB_MAGIC         0x4C414354          /*!< "TCAL" */
+#define CALIB_VERSION       1
+#define CALIB_GAIN_BITS     14                  /*!< Gain fractional bits, `1 << 14` is unity */
+#define CALIB_OFFSET_BITS   8                   /*!< Offset fractional bits, 1/256 degree units */
+#define CALIB_DRIFT_BITS    12                  /*!< Drift fractional bits, degrees per thermistor degree */
+#define CALIB_HDR_SIZE      8                   /*!< magic, version, pixels, thermistor reference */
+#define CALIB_BLOB_SIZE     (CALIB_HDR_SIZE + 3 * AMG88_ARRAY_SIZE * 2 + 4) /*!< Serialized table size */
+
+/**
+ * \brief           Errors
+ */
+typedef enum {
+    CALIB_OK = 0,                               /*!< Everything OK */
+    CALIB_ERR_LEN,                              /*!< Buffer too small or blob truncated */
+    CALIB_ERR_MAGIC,                            /*!< Not a calibration blob */
+    CALIB_ERR_VERSION,                          /*!< Unsupported version or pixel count */
+    CALIB_ERR_CRC,                              /*!< Corrupted blob */
+    CALIB_ERR_RANGE,                            /*!< Capture data out of range (e.g. equal blackbody points) */
+} calib_err_t;
+
+/**
+ * \brief           Correction table, `T = gain * raw + offset + drift * (thermistor - th_ref)`
+ */
+typedef struct {
+    int16_t gain[AMG88_ARRAY_SIZE];             /*!< Gain, \ref CALIB_GAIN_BITS fractional bits */
+    int16_t offset[AMG88_ARRAY_SIZE];           /*!< Offset, \ref CALIB_OFFSET_BITS fractional bits */
+    int16_t drift[AMG88_ARRAY_SIZE];            /*!< Thermistor drift, \ref CALIB_DRIFT_BITS fractional bits */
+    int16_t th_ref;                             /*!< Thermistor reference, 1/16 degree units */
+} calib_table_t;
+
+/**
+ * \brief           Frame accumulator used by the capture routines
+ */
+typedef struct {
+    int32_t sum[AMG88_ARRAY_SIZE];              /*!< Sum of the raw pixels, 1/4 degree units */
+    int32_t th_sum;                             /*!< Sum of the thermistor, 1/16 degree units */
+    uint16_t n;                                 /*!< Accumulated frames */
+} calib_acc_t;
+
+/**
+ * \brief           Init an identity table (unity gain, no offset, no drift)
+ * \param[out]      p_table: Table
+ */
+void calib_init(calib_table_t* p_table);
+
+/**
+ * \brief           Decode a raw frame and correct it in the same pass
+ * \param[in]       p_table: Table
+ * \param[in]       p_frame: Raw frame, with the thermistor registers read
+ * \param[out]      p_out: Corrected pixels, 1/4 degree units like \ref amg88_decode_frame
+ */
+void calib_decode_frame(const calib_table_t* p_table, const amg88_frame_raw_t* p_frame, int16_t* p_out);
+
+/**
+ * \brief           Write decoded temperatures back as pixel registers, so corrected frames can be streamed
+ * \note            Values are saturated to the 12-bit register range, the thermistor registers are kept
+ * \param[in]       p_temp: \ref AMG88_ARRAY_SIZE temperatures, 1/4 degree units
+ * \param[out]      p_frame: Frame whose pixel registers are overwritten
+ */
+void calib_pack_frame(const int16_t* p_temp, amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Clear an accumulator
+ * \param[out]      p_acc: Accumulator
+ */
+void calib_acc_reset(calib_acc_t* p_acc);
+
+/**
+ * \brief           Add a frame to an accumulator
+ * \param[in]       p_acc: Accumulator
+ * \param[in]       p_frame: Raw frame, with the thermistor registers read
+ */
+void calib_acc_add(calib_acc_t* p_acc, const amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Flat-field: equalize the pixels looking at a uniform scene (lens cap, shutter)
+ * \note            Sets the offsets so every pixel reads the array mean, gains are kept
+ * \param[inout]    p_table: Table
+ * \param[in]       p_acc: Frames of the uniform scene
+ * \return          \ref CALIB_OK on success, a member of \ref calib_err_t otherwise
+ */
+calib_err_t calib_capture_flat(calib_table_t* p_table, const calib_acc_t* p_acc);
+
+/**
+ * \brief           One-point blackbody: sets the offsets so every pixel reads `temp`, gains are kept
+ * \param[inout]    p_table: Table
+ * \param[in]       p_acc: Frames of the blackbody
+ * \param[in]       temp: Blackbody temperature, degrees
+ * \return          \ref CALIB_OK on success, a member of \ref calib_err_t otherwise
+ */
+calib_err_t calib_capture_point(calib_table_t* p_table, const calib_acc_t* p_acc, float temp);
+
+/**
+ * \brief           Two-point blackbody: sets gains and offsets
+ * \param[inout]    p_table: Table
+ * \param[in]       p_lo: Frames of the colder blackbody
+ * \param[in]       t_lo: Colder blackbody temperature, degrees
+ * \param[in]       p_hi: Frames of the hotter blackbody
+ * \param[in]       t_hi: Hotter blackbody temperature, degrees
+ * \return          \ref CALIB_OK on success, a member of \ref calib_err_t otherwise
+ */
+calib_err_t calib_capture_two_point(calib_table_t* p_table, const calib_acc_t* p_lo, float t_lo,
+                                    const calib_acc_t* p_hi, float t_hi);
+
+/**
+ * \brief           Thermistor drift: the same scene captured at two sensor (thermistor) temperatures
+ * \note            Run it after the gains are set, the thermistor reference becomes the one of `p_a`
+ * \param[inout]    p_table: Table
+ * \param[in]       p_a: Frames at the first sensor temperature
+ * \param[in]       p_b: Frames at the second sensor temperature
+ * \return          \ref CALIB_OK on success, a member of \ref calib_err_t otherwise
+ */
+calib_err_t calib_capture_drift(calib_table_t* p_table, const calib_acc_t* p_a, const calib_acc_t* p_b);
+
+/**
+ * \brief           Serialize a table, little endian with a trailing CRC-32
+ * \param[in]       p_table: Table
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       len: Output buffer size, at least \ref CALIB_BLOB_SIZE
+ * \return          Blob size, `0` if the buffer is too small
+ */
+size_t calib_serialize(const calib_table_t* p_table, uint8_t* p_buf, size_t len);
+
+/**
+ * \brief           Parse and check a serialized table
+ * \param[in]       p_buf: Blob
+ * \param[in]       len: Blob size
+ * \param[out]      p_table: Table, untouched on error
+ * \return          \ref CALIB_OK on success, a member of \ref calib_err_t otherwise
+ */
+calib_err_t calib_parse(const uint8_t* p_buf, size_t len, calib_table_t* p_table);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CALIB_H */
@@ -0,0 +1,30 @@
+/**
+ * \file            crc32.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           CRC-32 (IEEE 802.3, as zlib)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "crc32.h"
+
+/* Reflected 0xEDB88320, one nibble at a time: 64 bytes of table instead of 1 KiB */
+static const uint32_t crc32_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+
+uint32_t
+crc32_update(uint32_t crc, const void* p_data, size_t len) {
+    const uint8_t* p = (const uint8_t*) p_data;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0F];
+    }
+
+    return ~crc;
+}
@@ -0,0 +1,36 @@
+/**
+ * \file            crc32.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           CRC-32 (IEEE 802.3, as zlib)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define CRC32_INIT 0x00000000                   /*!< Value to start a new CRC with */
+
+/**
+ * \brief           Feed data into a CRC
+ * \note            Chunks can be fed one after the other, `crc32_update(crc32_update(CRC32_INIT, a), b)`
+ *                  equals the CRC of `a` followed by `b`
+ * \param[in]       crc: CRC so far, \ref CRC32_INIT for the first chunk
+ * \param[in]       p_data: Data
+ * \param[in]       len: Data length
+ * \return          Updated CRC
+ */
+uint32_t crc32_update(uint32_t crc, const void* p_data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CRC32_H */
@@ -0,0 +1,205 @@
+/**
+ * \file            detect.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           On-device motion/occupancy analytics: background model, foreground, connected blobs
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "detect.h"
+
+#include <string.h>
+
+#define DETECT_PROV_MAX   0xFD                  /* Provisional labels, 1 onwards */
+#define DETECT_PROV_SPILL 0xFE                  /* Components found once the provisional labels ran out */
+
+
+/* Breadth-first fill from `seed`, the queue keeps the pixels of the component for the caller */
+static size_t
+detect_fill(const int16_t* p_temp, const int16_t* p_excess, size_t width, size_t height, size_t seed,
+            uint8_t label, uint8_t* p_labels, uint16_t* p_queue, detect_blob_t* p_blob) {
+    int64_t sx = 0, sy = 0;
+    size_t head = 0, tail = 0;
+
+    memset(p_blob, 0, sizeof(*p_blob));
+    p_blob->peak = INT16_MIN;
+    p_blob->x0 = 0xFF;
+    p_blob->y0 = 0xFF;
+
+    p_labels[seed] = label;
+    p_queue[tail++] = (uint16_t) seed;
+    while (head < tail) {
+        size_t idx = p_queue[head++];
+        uint8_t x = (uint8_t) (idx % width), y = (uint8_t) (idx / width);
+        uint32_t w = p_excess[idx] > 0 ? (uint32_t) p_excess[idx] : 1;
+
+        p_blob->heat += w;
+        sx += (int64_t) x * w;
+        sy += (int64_t) y * w;
+        if (p_temp[idx] > p_blob->peak) {
+            p_blob->peak = p_temp[idx];
+            p_blob->peak_idx = (uint16_t) idx;
+        }
+        p_blob->x0 = x < p_blob->x0 ? x : p_blob->x0;
+        p_blob->y0 = y < p_blob->y0 ? y : p_blob->y0;
+        p_blob->x1 = x > p_blob->x1 ? x : p_blob->x1;
+        p_blob->y1 = y > p_blob->y1 ? y : p_blob->y1;
+
+        /* 8 neighbours, marked on push so nothing is queued twice */
+        for (int8_t dy = -1; dy <= 1; ++dy) {
+            for (int8_t dx = -1; dx <= 1; ++dx) {
+                int16_t nx = (int16_t) (x + dx), ny = (int16_t) (y + dy);
+                size_t n;
+
+                if (nx < 0 || ny < 0 || nx >= (int16_t) width || ny >= (int16_t) height) {
+                    continue;
+                }
+                n = (size_t) ny * width + (size_t) nx;
+                if (p_labels[n] == DETECT_LABEL_FG) {
+                    p_labels[n] = label;
+                    p_queue[tail++] = (uint16_t) n;
+                }
+            }
+        }
+    }
+
+    p_blob->pixels = (uint16_t) tail;
+    p_blob->cx_q8 = (uint16_t) ((sx << DETECT_BG_FRAC_BITS) / p_blob->heat);
+    p_blob->cy_q8 = (uint16_t) ((sy << DETECT_BG_FRAC_BITS) / p_blob->heat);
+
+    return tail;
+}
+
+uint8_t
+detect_label(const int16_t* p_temp, const int16_t* p_excess, size_t width, size_t height,
+             int16_t threshold, uint16_t min_pixels, uint8_t* p_labels, uint16_t* p_stack,
+             detect_blob_t* p_blobs, uint8_t max_blobs, uint8_t* p_overflow) {
+    uint8_t slot_prov[DETECT_PROV_MAX + 1];     /* Provisional label of every stored blob */
+    uint8_t map[256];                           /* Provisional label to final label */
+    size_t n = width * height;
+    uint8_t n_blobs = 0, prov = 0, overflow = 0;
+    detect_blob_t blob;
+
+    for (size_t i = 0; i < n; ++i) {
+        p_labels[i] = p_excess[i] > threshold ? DETECT_LABEL_FG : DETECT_LABEL_NONE;
+    }
+    memset(map, DETECT_LABEL_FG, sizeof(map));
+    map[DETECT_LABEL_NONE] = DETECT_LABEL_NONE;
+
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t slot;
+
+        if (p_labels[i] != DETECT_LABEL_FG) {
+            continue;
+        }
+
+        /* Out of labels: the rest is still filled, so it is not counted pixel by pixel */
+        if (prov == DETECT_PROV_MAX) {
+            detect_fill(p_temp, p_excess, width, height, i, DETECT_PROV_SPILL, p_labels, p_stack, &blob);
+            if (blob.pixels >= min_pixels && overflow < UINT8_MAX) {
+                ++overflow;
+            }
+            continue;
+        }
+        detect_fill(p_temp, p_excess, width, height, i, ++prov, p_labels, p_stack, &blob);
+        if (blob.pixels < min_pixels) {
+            continue;
+        }
+
+        /* Keep the largest ones, a smaller newcomer or the smallest stored one is left out */
+        if (n_blobs < max_blobs) {
+            slot = n_blobs++;
+        } else {
+            slot = 0;
+            for (uint8_t s = 1; s < n_blobs; ++s) {
+                slot = p_blobs[s].pixels < p_blobs[slot].pixels ? s : slot;
+            }
+            if (overflow < UINT8_MAX) {
+                ++overflow;
+            }
+            if (max_blobs == 0 || p_blobs[slot].pixels >= blob.pixels) {
+                continue;
+            }
+        }
+        p_blobs[slot] = blob;
+        slot_prov[slot] = prov;
+    }
+
+    /* Largest first, insertion sort on a handful of entries */
+    for (uint8_t s = 1; s < n_blobs; ++s) {
+        detect_blob_t tmp = p_blobs[s];
+        uint8_t tmp_prov = slot_prov[s];
+        uint8_t j = s;
+
+        while (j > 0 && p_blobs[j - 1].pixels < tmp.pixels) {
+            p_blobs[j] = p_blobs[j - 1];
+            slot_prov[j] = slot_prov[j - 1];
+            --j;
+        }
+        p_blobs[j] = tmp;
+        slot_prov[j] = tmp_prov;
+    }
+    for (uint8_t s = 0; s < n_blobs; ++s) {
+        map[slot_prov[s]] = (uint8_t) (s + 1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        p_labels[i] = map[p_labels[i]];
+    }
+
+    if (p_overflow != NULL) {
+        *p_overflow = overflow;
+    }
+
+    return n_blobs;
+}
+
+void
+detect_init(detect_t* p_det, const detect_cfg_t* p_cfg) {
+    memset(p_det, 0, sizeof(*p_det));
+    p_det->cfg = *p_cfg;
+}
+
+uint8_t
+detect_update(detect_t* p_det, const int16_t* p_temp) {
+    const int32_t half = 1 << (DETECT_BG_FRAC_BITS - 1);
+
+    if (p_det->frames++ == 0) {
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            p_det->bg[i] = (int32_t) p_temp[i] * (1 << DETECT_BG_FRAC_BITS);
+        }
+    }
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_det->excess[i] = (int16_t) (p_temp[i] - ((p_det->bg[i] + half) >> DETECT_BG_FRAC_BITS));
+    }
+
+    if (p_det->frames > p_det->cfg.warmup) {
+        p_det->n_blobs = detect_label(p_temp, p_det->excess, AMG88_ARRAY_COLS, AMG88_ARRAY_ROWS,
+                                      p_det->cfg.threshold, p_det->cfg.min_pixels, p_det->labels, p_det->stack,
+                                      p_det->blobs, DETECT_MAX_BLOBS, &p_det->overflow);
+    } else {
+        memset(p_det->labels, DETECT_LABEL_NONE, sizeof(p_det->labels));
+        p_det->n_blobs = 0;
+        p_det->overflow = 0;
+    }
+
+    /* Selective update: what is foreground now only leaks into the background slowly */
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        uint8_t shift = p_det->labels[i] == DETECT_LABEL_NONE ? p_det->cfg.bg_shift : p_det->cfg.fg_shift;
+
+        if (shift > 0) {
+            p_det->bg[i] += ((int32_t) p_temp[i] * (1 << DETECT_BG_FRAC_BITS) - p_det->bg[i]) >> shift;
+        }
+    }
+
+    return p_det->n_blobs;
+}
+
+void
+detect_background(const detect_t* p_det, int16_t* p_out) {
+    const int32_t half = 1 << (DETECT_BG_FRAC_BITS - 1);
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_out[i] = (int16_t) ((p_det->bg[i] + half) >> DETECT_BG_FRAC_BITS);
+    }
+}
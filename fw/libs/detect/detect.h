@@ -0,0 +1,121 @@
+/**
+ * \file            detect.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           On-device motion/occupancy analytics: background model, foreground, connected blobs
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef DETECT_H
+#define DETECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define DETECT_MAX_BLOBS    8                   /*!< Blobs reported per frame */
+#define DETECT_BG_FRAC_BITS 8                   /*!< Fractional bits of the background model */
+
+#define DETECT_LABEL_NONE   0x00                /*!< Background pixel */
+#define DETECT_LABEL_FG     0xFF                /*!< Foreground pixel not (yet) in a reported blob */
+
+/**
+ * \brief           Detector settings, temperatures in 1/4 degree units
+ */
+typedef struct {
+    uint8_t bg_shift;                           /*!< Background adaptation, moves `1 / 2^shift` of the way per frame */
+    uint8_t fg_shift;                           /*!< Same under foreground pixels, slower so a still person is not
+                                                     absorbed right away, `0` to freeze them */
+    int16_t threshold;                          /*!< Foreground when warmer than the background by more than this */
+    uint8_t min_pixels;                         /*!< Smaller components are dropped as noise */
+    uint16_t warmup;                            /*!< Frames only learnt, without reporting, after init */
+} detect_cfg_t;
+
+/**
+ * \brief           Connected foreground component
+ */
+typedef struct {
+    uint16_t pixels;                            /*!< Size */
+    int16_t peak;                               /*!< Warmest temperature */
+    uint16_t peak_idx;                          /*!< Index of the warmest pixel, row-major */
+    uint16_t cx_q8;                             /*!< Centroid column weighted by the excess over the background,
+                                                     \ref DETECT_BG_FRAC_BITS fractional bits */
+    uint16_t cy_q8;                             /*!< Centroid row, same format */
+    uint32_t heat;                              /*!< Sum of the excess over the background */
+    uint8_t x0;                                 /*!< Bounding box, first column */
+    uint8_t y0;                                 /*!< Bounding box, first row */
+    uint8_t x1;                                 /*!< Bounding box, last column */
+    uint8_t y1;                                 /*!< Bounding box, last row */
+} detect_blob_t;
+
+/**
+ * \brief           Detector handler, sensor grid, no dynamic memory
+ */
+typedef struct {
+    detect_cfg_t cfg;                           /*!< Settings */
+    int32_t bg[AMG88_ARRAY_SIZE];               /*!< Background, \ref DETECT_BG_FRAC_BITS fractional bits */
+    int16_t excess[AMG88_ARRAY_SIZE];           /*!< Last frame minus the background */
+    uint8_t labels[AMG88_ARRAY_SIZE];           /*!< Last frame labels, blob `i` is `i + 1` */
+    uint16_t stack[AMG88_ARRAY_SIZE];           /*!< Labeling scratch */
+    uint32_t frames;                            /*!< Frames seen */
+
+    detect_blob_t blobs[DETECT_MAX_BLOBS];      /*!< Last frame blobs, largest first */
+    uint8_t n_blobs;                            /*!< Blobs in `blobs` */
+    uint8_t overflow;                           /*!< Components left out of `blobs` for lack of room */
+} detect_t;
+
+/**
+ * \brief           Init a detector, the first frame becomes the background
+ * \param[out]      p_det: Detector handler
+ * \param[in]       p_cfg: Settings, copied
+ */
+void detect_init(detect_t* p_det, const detect_cfg_t* p_cfg);
+
+/**
+ * \brief           Run a frame through the detector and update the background
+ * \note            Input is \ref amg88_decode_frame output, the fixed-point form of \ref amg88_get_array
+ * \param[inout]    p_det: Detector handler
+ * \param[in]       p_temp: \ref AMG88_ARRAY_SIZE temperatures, 1/4 degree units
+ * \return          Blobs found, `0` while warming up
+ */
+uint8_t detect_update(detect_t* p_det, const int16_t* p_temp);
+
+/**
+ * \brief           Current background, rounded
+ * \param[in]       p_det: Detector handler
+ * \param[out]      p_out: \ref AMG88_ARRAY_SIZE temperatures, 1/4 degree units
+ */
+void detect_background(const detect_t* p_det, int16_t* p_out);
+
+/**
+ * \brief           Label the foreground of any grid and describe its components (8-connectivity)
+ * \note            Building block of \ref detect_update, also usable on an upscaled frame and background
+ *                  (see interp). Bounded: every pixel is queued at most once
+ * \param[in]       p_temp: Temperatures, row-major
+ * \param[in]       p_excess: Temperatures minus the background
+ * \param[in]       width: Grid width, at most 255
+ * \param[in]       height: Grid height, at most 255
+ * \param[in]       threshold: Foreground when the excess is above this
+ * \param[in]       min_pixels: Smaller components are left as \ref DETECT_LABEL_FG
+ * \param[out]      p_labels: `width * height` labels
+ * \param[out]      p_stack: `width * height` scratch entries
+ * \param[out]      p_blobs: Components, largest first
+ * \param[in]       max_blobs: Room in `p_blobs`, at most 254
+ * \param[out]      p_overflow: Components found beyond `max_blobs`, may be `NULL`
+ * \return          Components stored in `p_blobs`
+ */
+uint8_t detect_label(const int16_t* p_temp, const int16_t* p_excess, size_t width, size_t height,
+                     int16_t threshold, uint16_t min_pixels, uint8_t* p_labels, uint16_t* p_stack,
+                     detect_blob_t* p_blobs, uint8_t max_blobs, uint8_t* p_overflow);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* DETECT_H */
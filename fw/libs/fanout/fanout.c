@@ -0,0 +1,161 @@
+/**
+ * \file            fanout.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Encode-once fan-out of reference-counted buffers to several clients, newest frame wins
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "fanout.h"
+
+#include <string.h>
+
+
+osal_err_t
+fanout_init(fanout_t* p_fan) {
+    memset(p_fan, 0, sizeof(*p_fan));
+
+    for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        atomic_init(&p_fan->clients[i].pending, NULL);
+        if (osal_sem_init(&p_fan->clients[i].ready) != OSAL_OK) {
+            return OSAL_ERR;
+        }
+    }
+    if (osal_sem_init(&p_fan->lock) != OSAL_OK) {
+        return OSAL_ERR;
+    }
+    osal_sem_give(&p_fan->lock);
+
+    return OSAL_OK;
+}
+
+void
+fanout_add_format(fanout_t* p_fan, uint8_t format, void* p_storage, size_t size, uint8_t n_bufs) {
+    fanout_format_t* p_fmt = &p_fan->formats[format];
+
+    p_fmt->size = size;
+    p_fmt->n_bufs = n_bufs < FANOUT_MAX_BUFS ? n_bufs : FANOUT_MAX_BUFS;
+    for (uint8_t i = 0; i < p_fmt->n_bufs; ++i) {
+        atomic_init(&p_fmt->bufs[i].refs, 0);
+        p_fmt->bufs[i].format = format;
+        p_fmt->bufs[i].p_data = (uint8_t*) p_storage + i * size;
+    }
+}
+
+int8_t
+fanout_subscribe(fanout_t* p_fan, uint8_t format) {
+    int8_t id = -1;
+
+    if (format >= FANOUT_MAX_FORMATS || p_fan->formats[format].n_bufs == 0) {
+        return -1;
+    }
+
+    osal_sem_take(&p_fan->lock, OSAL_WAIT_FOREVER);
+    for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        fanout_client_t* p_client = &p_fan->clients[i];
+
+        if (p_client->used) {
+            continue;
+        }
+        p_client->used = true;
+        p_client->format = format;
+        atomic_store(&p_client->delivered, 0);
+        atomic_store(&p_client->skipped, 0);
+        atomic_fetch_add(&p_fan->formats[format].subscribers, 1);
+        id = (int8_t) i;
+        break;
+    }
+    osal_sem_give(&p_fan->lock);
+
+    return id;
+}
+
+void
+fanout_unsubscribe(fanout_t* p_fan, int8_t id) {
+    fanout_client_t* p_client = &p_fan->clients[id];
+    fanout_buf_t* p_buf;
+
+    osal_sem_take(&p_fan->lock, OSAL_WAIT_FOREVER);
+    p_client->used = false;
+    atomic_fetch_sub(&p_fan->formats[p_client->format].subscribers, 1);
+    p_buf = atomic_exchange(&p_client->pending, NULL);
+    if (p_buf != NULL) {
+        fanout_release(p_buf);
+    }
+    osal_sem_give(&p_fan->lock);
+
+    /* Leftover gives would wake the next owner of the slot for nothing */
+    while (osal_sem_take(&p_client->ready, 0) == OSAL_OK) {}
+}
+
+bool
+fanout_wanted(fanout_t* p_fan, uint8_t format) {
+    return atomic_load_explicit(&p_fan->formats[format].subscribers, memory_order_relaxed) > 0;
+}
+
+fanout_buf_t*
+fanout_alloc(fanout_t* p_fan, uint8_t format) {
+    fanout_format_t* p_fmt = &p_fan->formats[format];
+
+    /* Only the producer turns a free buffer into a used one, so a plain store is enough */
+    for (uint8_t i = 0; i < p_fmt->n_bufs; ++i) {
+        if (atomic_load_explicit(&p_fmt->bufs[i].refs, memory_order_acquire) == 0) {
+            atomic_store_explicit(&p_fmt->bufs[i].refs, 1, memory_order_relaxed);
+            p_fmt->bufs[i].len = 0;
+            return &p_fmt->bufs[i];
+        }
+    }
+    atomic_fetch_add(&p_fmt->starved, 1);
+
+    return NULL;
+}
+
+void
+fanout_publish(fanout_t* p_fan, fanout_buf_t* p_buf) {
+    fanout_buf_t* p_old;
+
+    osal_sem_take(&p_fan->lock, OSAL_WAIT_FOREVER);
+    for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        fanout_client_t* p_client = &p_fan->clients[i];
+
+        if (!p_client->used || p_client->format != p_buf->format) {
+            continue;
+        }
+
+        /* One more reference per client, the release of the swap publishes the contents */
+        atomic_fetch_add_explicit(&p_buf->refs, 1, memory_order_relaxed);
+        p_old = atomic_exchange_explicit(&p_client->pending, p_buf, memory_order_acq_rel);
+        if (p_old != NULL) {
+            atomic_fetch_add(&p_client->skipped, 1);
+            fanout_release(p_old);
+        }
+        osal_sem_give(&p_client->ready);
+    }
+    osal_sem_give(&p_fan->lock);
+
+    atomic_fetch_add(&p_fan->formats[p_buf->format].encoded, 1);
+    fanout_release(p_buf);
+}
+
+fanout_buf_t*
+fanout_take(fanout_t* p_fan, int8_t id, uint32_t timeout_ms) {
+    fanout_client_t* p_client = &p_fan->clients[id];
+    fanout_buf_t* p_buf;
+
+    /* Several publishes may have given the semaphore for a single pending buffer */
+    while (osal_sem_take(&p_client->ready, timeout_ms) == OSAL_OK) {
+        p_buf = atomic_exchange_explicit(&p_client->pending, NULL, memory_order_acq_rel);
+        if (p_buf != NULL) {
+            atomic_fetch_add(&p_client->delivered, 1);
+            return p_buf;
+        }
+    }
+
+    return NULL;
+}
+
+void
+fanout_release(fanout_buf_t* p_buf) {
+    /* Release, so the next producer write to the buffer comes after every read of it */
+    atomic_fetch_sub_explicit(&p_buf->refs, 1, memory_order_release);
+}
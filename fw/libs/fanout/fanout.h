@@ -0,0 +1,152 @@
+/**
+ * \file            fanout.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Encode-once fan-out of reference-counted buffers to several clients, newest frame wins
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FANOUT_MAX_CLIENTS  4                   /*!< Clients subscribed at once */
+#define FANOUT_MAX_FORMATS  4                   /*!< Output formats */
+#define FANOUT_MAX_BUFS     (1 + 2 * FANOUT_MAX_CLIENTS) /*!< Buffers per format so the producer never runs out:
+                                                     the one being filled, plus one pending and one being
+                                                     sent per client */
+
+/**
+ * \brief           Shared buffer, holds one encoded frame
+ */
+typedef struct {
+    atomic_uint_fast8_t refs;                   /*!< References, `0` when free */
+    uint8_t format;                             /*!< Format of the contents */
+    uint32_t seq;                               /*!< Frame sequence number */
+    size_t len;                                 /*!< Bytes used */
+    uint8_t* p_data;                            /*!< Contents, `size` bytes of the format storage */
+} fanout_buf_t;
+
+/**
+ * \brief           Client slot
+ * \note            There is no queue: a publish replaces the pending buffer, so a slow client skips to the
+ *                  newest frame and never holds more than two buffers
+ */
+typedef struct {
+    bool used;                                  /*!< Slot taken, under the fan-out lock */
+    uint8_t format;                             /*!< Subscribed format */
+    _Atomic(fanout_buf_t*) pending;             /*!< Newest buffer not taken yet, `NULL` when none */
+    osal_sem_t ready;                           /*!< Given on every publish */
+    atomic_uint_fast32_t delivered;             /*!< Buffers taken */
+    atomic_uint_fast32_t skipped;               /*!< Buffers replaced before being taken */
+} fanout_client_t;
+
+/**
+ * \brief           Format, a pool of buffers of one size
+ */
+typedef struct {
+    fanout_buf_t bufs[FANOUT_MAX_BUFS];         /*!< Buffers */
+    uint8_t n_bufs;                             /*!< Buffers in use, `0` when the format is not set up */
+    size_t size;                                /*!< Capacity of every buffer */
+    atomic_uint_fast8_t subscribers;            /*!< Clients subscribed */
+    atomic_uint_fast32_t encoded;               /*!< Buffers published */
+    atomic_uint_fast32_t starved;               /*!< Frames not published for lack of a free buffer */
+} fanout_format_t;
+
+/**
+ * \brief           Fan-out handler
+ */
+typedef struct {
+    fanout_format_t formats[FANOUT_MAX_FORMATS]; /*!< Formats */
+    fanout_client_t clients[FANOUT_MAX_CLIENTS]; /*!< Client slots */
+    osal_sem_t lock;                            /*!< Serializes publishing against (un)subscribing */
+} fanout_t;
+
+/**
+ * \brief           Init the fan-out, no format set up
+ * \param[out]      p_fan: Fan-out handler
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t fanout_init(fanout_t* p_fan);
+
+/**
+ * \brief           Set up a format over caller-owned storage
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       format: Format index, below \ref FANOUT_MAX_FORMATS
+ * \param[in]       p_storage: `n_bufs * size` bytes
+ * \param[in]       size: Capacity of a buffer
+ * \param[in]       n_bufs: Buffers, at most \ref FANOUT_MAX_BUFS (fewer may starve the producer)
+ */
+void fanout_add_format(fanout_t* p_fan, uint8_t format, void* p_storage, size_t size, uint8_t n_bufs);
+
+/**
+ * \brief           Subscribe a client
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       format: Format to receive
+ * \return          Client id, `-1` when every slot is taken or the format is not set up
+ */
+int8_t fanout_subscribe(fanout_t* p_fan, uint8_t format);
+
+/**
+ * \brief           Unsubscribe a client, dropping its pending buffer
+ * \note            A buffer the client took is still its own to release
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       id: Client id
+ */
+void fanout_unsubscribe(fanout_t* p_fan, int8_t id);
+
+/**
+ * \brief           Whether a format has subscribers, so it is worth encoding
+ * \param[in]       p_fan: Fan-out handler
+ * \param[in]       format: Format
+ * \return          `true` when at least a client is subscribed
+ */
+bool fanout_wanted(fanout_t* p_fan, uint8_t format);
+
+/**
+ * \brief           Get a free buffer to encode a frame into
+ * \note            Producer side, a single producer. The buffer comes with the producer reference
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       format: Format
+ * \return          Buffer, `NULL` when none is free
+ */
+fanout_buf_t* fanout_alloc(fanout_t* p_fan, uint8_t format);
+
+/**
+ * \brief           Hand a filled buffer to every subscriber of its format and drop the producer reference
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       p_buf: Buffer from \ref fanout_alloc, `len` and `seq` set
+ */
+void fanout_publish(fanout_t* p_fan, fanout_buf_t* p_buf);
+
+/**
+ * \brief           Wait for the newest buffer of a client
+ * \note            Client side, one task per client. Release the buffer once sent
+ * \param[inout]    p_fan: Fan-out handler
+ * \param[in]       id: Client id
+ * \param[in]       timeout_ms: Max time to wait
+ * \return          Buffer, `NULL` on timeout
+ */
+fanout_buf_t* fanout_take(fanout_t* p_fan, int8_t id, uint32_t timeout_ms);
+
+/**
+ * \brief           Drop a reference, the last one frees the buffer
+ * \param[in]       p_buf: Buffer
+ */
+void fanout_release(fanout_buf_t* p_buf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FANOUT_H */
@@ -0,0 +1,356 @@
+/**
+ * \file            flash_log.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Append-only record ring on NOR flash, read back in place through a memory map
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "flash_log.h"
+
+#include <string.h>
+
+#include "crc32/crc32.h"
+
+/* Space taken by a record, padded to the write granularity */
+#define FLASH_LOG_STRIDE(len) ((FLASH_LOG_RECORD_HDR + (len) + FLASH_LOG_ALIGN - 1) & ~(size_t) (FLASH_LOG_ALIGN - 1))
+
+
+static void
+flash_log_put32(uint8_t* p, uint32_t v) {
+    for (size_t i = 0; i < 4; ++i) {
+        p[i] = (uint8_t) (v >> (8 * i));
+    }
+}
+
+static uint32_t
+flash_log_get32(const uint8_t* p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint16_t
+flash_log_get16(const uint8_t* p) {
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static const uint8_t*
+flash_log_sector_ptr(const flash_log_t* p_log, uint16_t sector) {
+    return p_log->io.p_map + (size_t) sector * p_log->io.sector_size;
+}
+
+/* Record CRC: len and id, then the payload */
+static uint32_t
+flash_log_record_crc(const uint8_t* p_hdr, const uint8_t* p_data, size_t len) {
+    return crc32_update(crc32_update(CRC32_INIT, p_hdr + 2, 6), p_data, len);
+}
+
+/* Header of the record at `off`, checked for shape only, `false` past the last record */
+static bool
+flash_log_peek(const flash_log_t* p_log, uint16_t sector, size_t off, uint32_t* p_id, size_t* p_len) {
+    const uint8_t* p = flash_log_sector_ptr(p_log, sector) + off;
+
+    if (off + FLASH_LOG_RECORD_HDR > p_log->io.sector_size || flash_log_get16(p) != FLASH_LOG_RECORD_MAGIC) {
+        return false;
+    }
+    *p_len = flash_log_get16(p + 2);
+    *p_id = flash_log_get32(p + 4);
+
+    return off + FLASH_LOG_RECORD_HDR + *p_len <= p_log->io.sector_size;
+}
+
+static bool
+flash_log_record_ok(const flash_log_t* p_log, uint16_t sector, size_t off, size_t len) {
+    const uint8_t* p = flash_log_sector_ptr(p_log, sector) + off;
+
+    return flash_log_get32(p + 8) == flash_log_record_crc(p, p + FLASH_LOG_RECORD_HDR, len);
+}
+
+static bool
+flash_log_read_hdr(const flash_log_t* p_log, uint16_t sector, flash_log_sector_t* p_entry) {
+    const uint8_t* p = flash_log_sector_ptr(p_log, sector);
+
+    if (flash_log_get32(p) != FLASH_LOG_SECTOR_MAGIC
+        || flash_log_get32(p + 16) != crc32_update(CRC32_INIT, p, 16)) {
+        return false;
+    }
+    p_entry->seq = flash_log_get32(p + 4);
+    p_entry->first_id = flash_log_get32(p + 8);
+    p_entry->erases = flash_log_get32(p + 12);
+
+    return p_entry->seq != 0;
+}
+
+/* Write and read back through the map, a worn cell shows up as a mismatch */
+static flash_log_err_t
+flash_log_program(flash_log_t* p_log, size_t off, const void* p_data, size_t len) {
+    if (p_log->io.write(p_log->io.p_ctx, off, p_data, len) != FLASH_LOG_OK
+        || memcmp(p_log->io.p_map + off, p_data, len) != 0) {
+        p_log->stats.io_errors++;
+        return FLASH_LOG_ERR_IO;
+    }
+
+    return FLASH_LOG_OK;
+}
+
+/* Erase the sector after `head` and write its header, the ring advances even on failure so a bad sector is skipped */
+static flash_log_err_t
+flash_log_open_next(flash_log_t* p_log) {
+    uint16_t sector = (uint16_t) ((p_log->head + 1) % p_log->n_sectors);
+    size_t off = (size_t) sector * p_log->io.sector_size;
+    flash_log_sector_t entry = {
+        .seq = p_log->next_seq,
+        .first_id = p_log->next_id,
+        .erases = p_log->index[sector].erases + 1,
+    };
+    uint8_t hdr[FLASH_LOG_SECTOR_HDR];
+
+    p_log->head = sector;
+    p_log->sealed = true;
+    p_log->index[sector].seq = 0;
+
+    if (p_log->io.erase(p_log->io.p_ctx, off, p_log->io.sector_size) != FLASH_LOG_OK) {
+        p_log->stats.io_errors++;
+        return FLASH_LOG_ERR_IO;
+    }
+    p_log->index[sector].erases = entry.erases;
+    p_log->stats.erases++;
+    if (entry.erases > p_log->stats.max_erases) {
+        p_log->stats.max_erases = entry.erases;
+    }
+
+    flash_log_put32(hdr, FLASH_LOG_SECTOR_MAGIC);
+    flash_log_put32(hdr + 4, entry.seq);
+    flash_log_put32(hdr + 8, entry.first_id);
+    flash_log_put32(hdr + 12, entry.erases);
+    flash_log_put32(hdr + 16, crc32_update(CRC32_INIT, hdr, 16));
+    if (flash_log_program(p_log, off, hdr, sizeof(hdr)) != FLASH_LOG_OK) {
+        return FLASH_LOG_ERR_IO;
+    }
+
+    p_log->index[sector] = entry;
+    p_log->next_seq++;
+    p_log->head_off = FLASH_LOG_SECTOR_HDR;
+    p_log->sealed = false;
+
+    return FLASH_LOG_OK;
+}
+
+/* Valid sector with the lowest seq above `seq`, `n_sectors` when there is none */
+static uint16_t
+flash_log_after(const flash_log_t* p_log, uint32_t seq) {
+    uint16_t best = p_log->n_sectors;
+
+    for (uint16_t s = 0; s < p_log->n_sectors; ++s) {
+        if (p_log->index[s].seq > seq && (best == p_log->n_sectors || p_log->index[s].seq < p_log->index[best].seq)) {
+            best = s;
+        }
+    }
+
+    return best;
+}
+
+/* Point the cursor at its id through the index, then walk the sector */
+static bool
+flash_log_find(const flash_log_t* p_log, flash_log_cursor_t* p_cur) {
+    uint32_t oldest = flash_log_oldest_id(p_log);
+    uint16_t sector = p_log->n_sectors;
+    uint32_t id;
+    size_t off, len;
+
+    if (p_cur->id < oldest) {
+        p_cur->lost += oldest - p_cur->id;
+        p_cur->id = oldest;
+    }
+
+    /* first_id grows with seq: the newest sector starting at or before the id holds it */
+    for (uint16_t s = 0; s < p_log->n_sectors; ++s) {
+        if (p_log->index[s].seq != 0 && p_log->index[s].first_id <= p_cur->id
+            && (sector == p_log->n_sectors || p_log->index[s].seq > p_log->index[sector].seq)) {
+            sector = s;
+        }
+    }
+    if (sector == p_log->n_sectors) {
+        return false;
+    }
+
+    off = FLASH_LOG_SECTOR_HDR;
+    for (uint32_t i = p_log->index[sector].first_id; i < p_cur->id; ++i) {
+        if (!flash_log_peek(p_log, sector, off, &id, &len)) {
+            break;
+        }
+        off += FLASH_LOG_STRIDE(len);
+    }
+
+    p_cur->sector = sector;
+    p_cur->seq = p_log->index[sector].seq;
+    p_cur->off = off;
+
+    return true;
+}
+
+flash_log_err_t
+flash_log_mount(flash_log_t* p_log, const flash_log_io_t* p_io) {
+    const uint8_t* p_head;
+    uint32_t id;
+    size_t off, len;
+
+    if (p_io->sector_size < FLASH_LOG_SECTOR_HDR + FLASH_LOG_RECORD_HDR + FLASH_LOG_ALIGN
+        || p_io->sector_size % FLASH_LOG_ALIGN != 0 || p_io->size % p_io->sector_size != 0
+        || p_io->size / p_io->sector_size < 2 || p_io->size / p_io->sector_size > FLASH_LOG_MAX_SECTORS) {
+        return FLASH_LOG_ERR_GEOMETRY;
+    }
+
+    memset(p_log, 0, sizeof(*p_log));
+    p_log->io = *p_io;
+    p_log->n_sectors = (uint16_t) (p_io->size / p_io->sector_size);
+
+    /* The sector headers are the persistent index, the newest one is the write head */
+    p_log->head = p_log->n_sectors - 1;
+    p_log->sealed = true;
+    for (uint16_t s = 0; s < p_log->n_sectors; ++s) {
+        if (!flash_log_read_hdr(p_log, s, &p_log->index[s])) {
+            memset(&p_log->index[s], 0, sizeof(p_log->index[s]));
+            continue;
+        }
+        if (p_log->index[s].erases > p_log->stats.max_erases) {
+            p_log->stats.max_erases = p_log->index[s].erases;
+        }
+        if (p_log->index[s].seq >= p_log->next_seq) {
+            p_log->next_seq = p_log->index[s].seq;
+            p_log->head = s;
+            p_log->sealed = false;
+        }
+    }
+    p_log->next_seq++;
+    if (p_log->sealed) {
+        return FLASH_LOG_OK;
+    }
+
+    /* Walk the head up to the first record that is not complete */
+    id = p_log->index[p_log->head].first_id;
+    off = FLASH_LOG_SECTOR_HDR;
+    while (true) {
+        uint32_t rec_id;
+
+        if (!flash_log_peek(p_log, p_log->head, off, &rec_id, &len) || rec_id != id
+            || !flash_log_record_ok(p_log, p_log->head, off, len)) {
+            break;
+        }
+        off += FLASH_LOG_STRIDE(len);
+        id++;
+    }
+    p_log->head_off = off;
+    p_log->next_id = id;
+
+    /* Anything programmed past it is an interrupted write, no more records go in this sector */
+    p_head = flash_log_sector_ptr(p_log, p_log->head);
+    for (; off < p_log->io.sector_size; ++off) {
+        if (p_head[off] != 0xFF) {
+            p_log->sealed = true;
+            p_log->stats.recovered++;
+            break;
+        }
+    }
+
+    return FLASH_LOG_OK;
+}
+
+flash_log_err_t
+flash_log_append(flash_log_t* p_log, const void* p_data, size_t len) {
+    uint8_t hdr[FLASH_LOG_RECORD_HDR];
+    size_t off;
+
+    if (len > flash_log_max_record(p_log)) {
+        return FLASH_LOG_ERR_LEN;
+    }
+
+    if (p_log->sealed || p_log->head_off + FLASH_LOG_STRIDE(len) > p_log->io.sector_size) {
+        if (flash_log_open_next(p_log) != FLASH_LOG_OK) {
+            return FLASH_LOG_ERR_IO;
+        }
+    }
+
+    hdr[0] = (uint8_t) FLASH_LOG_RECORD_MAGIC;
+    hdr[1] = (uint8_t) (FLASH_LOG_RECORD_MAGIC >> 8);
+    hdr[2] = (uint8_t) len;
+    hdr[3] = (uint8_t) (len >> 8);
+    flash_log_put32(hdr + 4, p_log->next_id);
+    flash_log_put32(hdr + 8, flash_log_record_crc(hdr, p_data, len));
+
+    /* Header last: until it lands the slot still reads as erased */
+    off = (size_t) p_log->head * p_log->io.sector_size + p_log->head_off;
+    if ((len > 0 && flash_log_program(p_log, off + FLASH_LOG_RECORD_HDR, p_data, len) != FLASH_LOG_OK)
+        || flash_log_program(p_log, off, hdr, sizeof(hdr)) != FLASH_LOG_OK) {
+        p_log->sealed = true;
+        return FLASH_LOG_ERR_IO;
+    }
+
+    p_log->head_off += FLASH_LOG_STRIDE(len);
+    p_log->next_id++;
+    p_log->stats.appended++;
+
+    return FLASH_LOG_OK;
+}
+
+flash_log_err_t
+flash_log_read(flash_log_t* p_log, flash_log_cursor_t* p_cur, const uint8_t** pp_data, size_t* p_len) {
+    uint16_t next;
+    uint32_t id;
+    size_t len;
+
+    while (p_cur->id < p_log->next_id) {
+        /* The cached location is stale once its sector was reused */
+        if (p_cur->seq == 0 || p_log->index[p_cur->sector].seq != p_cur->seq) {
+            if (!flash_log_find(p_log, p_cur)) {
+                break;
+            }
+            continue;
+        }
+
+        if (flash_log_peek(p_log, p_cur->sector, p_cur->off, &id, &len) && id == p_cur->id
+            && flash_log_record_ok(p_log, p_cur->sector, p_cur->off, len)) {
+            *pp_data = flash_log_sector_ptr(p_log, p_cur->sector) + p_cur->off + FLASH_LOG_RECORD_HDR;
+            *p_len = len;
+            p_cur->off += FLASH_LOG_STRIDE(len);
+            p_cur->id++;
+            return FLASH_LOG_OK;
+        }
+
+        /* End of a sector, full or sealed: carry on with the next one */
+        next = flash_log_after(p_log, p_cur->seq);
+        if (next == p_log->n_sectors) {
+            break;
+        }
+        if (p_log->index[next].first_id > p_cur->id) {
+            p_cur->lost += p_log->index[next].first_id - p_cur->id;
+            p_cur->id = p_log->index[next].first_id;
+        }
+        p_cur->sector = next;
+        p_cur->seq = p_log->index[next].seq;
+        p_cur->off = FLASH_LOG_SECTOR_HDR;
+    }
+
+    return FLASH_LOG_ERR_EMPTY;
+}
+
+void
+flash_log_seek(const flash_log_t* p_log, flash_log_cursor_t* p_cur, uint32_t id) {
+    uint32_t oldest = flash_log_oldest_id(p_log);
+
+    memset(p_cur, 0, sizeof(*p_cur));
+    p_cur->id = id < oldest ? oldest : id;
+}
+
+uint32_t
+flash_log_oldest_id(const flash_log_t* p_log) {
+    uint16_t oldest = flash_log_after(p_log, 0);
+
+    return oldest == p_log->n_sectors ? p_log->next_id : p_log->index[oldest].first_id;
+}
+
+size_t
+flash_log_max_record(const flash_log_t* p_log) {
+    size_t max = p_log->io.sector_size - FLASH_LOG_SECTOR_HDR - FLASH_LOG_RECORD_HDR;
+
+    return max > UINT16_MAX ? UINT16_MAX : max;
+}
@@ -0,0 +1,162 @@
+/**
+ * \file            flash_log.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Append-only record ring on NOR flash, read back in place through a memory map
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FLASH_LOG_MAX_SECTORS   256             /*!< Sectors tracked by the index */
+#define FLASH_LOG_SECTOR_MAGIC  0x474C4654      /*!< "TFLG" */
+#define FLASH_LOG_RECORD_MAGIC  0x5AA5
+#define FLASH_LOG_SECTOR_HDR    20              /*!< magic, seq, first_id, erases, CRC-32 */
+#define FLASH_LOG_RECORD_HDR    12              /*!< magic, len, id, CRC-32 */
+#define FLASH_LOG_ALIGN         4               /*!< Record alignment, flash write granularity */
+
+/**
+ * \brief           Errors
+ */
+typedef enum {
+    FLASH_LOG_OK,                               /*!< Everything is Ok */
+    FLASH_LOG_ERR_IO,                           /*!< Erase or write failed, or did not read back */
+    FLASH_LOG_ERR_LEN,                          /*!< Record does not fit in a sector */
+    FLASH_LOG_ERR_GEOMETRY,                     /*!< Bad region or sector size */
+    FLASH_LOG_ERR_EMPTY,                        /*!< No record at or after the cursor */
+} flash_log_err_t;
+
+/**
+ * \brief           Flash access, erase and write go through functions, reads through the map
+ * \note            Erased flash reads 0xFF and a write can only clear bits (NOR)
+ */
+typedef struct {
+    const uint8_t* p_map;                       /*!< Read-only memory map of the whole region */
+    size_t size;                                /*!< Region size, a multiple of sector_size */
+    size_t sector_size;                         /*!< Erase unit */
+    void* p_ctx;                                /*!< Passed to erase and write */
+
+    /** Erase `len` bytes at `off`, both sector aligned */
+    flash_log_err_t (*erase)(void* p_ctx, size_t off, size_t len);
+    /** Program `len` bytes at `off` */
+    flash_log_err_t (*write)(void* p_ctx, size_t off, const void* p_data, size_t len);
+} flash_log_io_t;
+
+/**
+ * \brief           Index entry, one per sector, rebuilt from the sector headers at mount
+ */
+typedef struct {
+    uint32_t seq;                               /*!< Open order, 0 when the sector holds no valid header */
+    uint32_t first_id;                          /*!< Id of the first record written in the sector */
+    uint32_t erases;                            /*!< Erase count, for wear statistics */
+} flash_log_sector_t;
+
+/**
+ * \brief           Log statistics
+ */
+typedef struct {
+    uint32_t appended;                          /*!< Records appended since mount */
+    uint32_t erases;                            /*!< Sectors erased since mount */
+    uint32_t max_erases;                        /*!< Highest erase count of any sector */
+    uint32_t recovered;                         /*!< Sectors sealed at mount after an interrupted write */
+    uint32_t io_errors;                         /*!< Failed erases and writes */
+} flash_log_stats_t;
+
+/**
+ * \brief           Log handler
+ */
+typedef struct {
+    flash_log_io_t io;                          /*!< Flash access */
+    uint16_t n_sectors;                         /*!< Sectors in the region */
+    flash_log_sector_t index[FLASH_LOG_MAX_SECTORS]; /*!< Per sector index */
+
+    bool sealed;                                /*!< `head` takes no more records, the next append opens a sector */
+    uint16_t head;                              /*!< Sector being written */
+    size_t head_off;                            /*!< Write offset in `head` */
+    uint32_t next_seq;                          /*!< Seq of the next opened sector */
+    uint32_t next_id;                           /*!< Id of the next appended record */
+
+    flash_log_stats_t stats;                    /*!< Statistics */
+} flash_log_t;
+
+/**
+ * \brief           Read position, only the id matters, the rest caches its location
+ */
+typedef struct {
+    uint32_t id;                                /*!< Next record to read */
+    uint32_t lost;                              /*!< Records overwritten before they were read */
+    uint16_t sector;                            /*!< Cached sector of `id` */
+    uint32_t seq;                               /*!< Seq of the cached sector, detects reuse */
+    size_t off;                                 /*!< Cached offset of `id` */
+} flash_log_cursor_t;
+
+/**
+ * \brief           Mount a region, rebuilding the index and the write position
+ * \note            A record interrupted by a power loss is dropped and the sector it was in is sealed;
+ *                  every record appended before it is kept. A blank region mounts as an empty log
+ * \param[out]      p_log: Log handler
+ * \param[in]       p_io: Flash access, copied
+ * \return          \ref FLASH_LOG_OK, \ref FLASH_LOG_ERR_GEOMETRY on a bad region
+ */
+flash_log_err_t flash_log_mount(flash_log_t* p_log, const flash_log_io_t* p_io);
+
+/**
+ * \brief           Append a record, erasing the oldest sector when the region is full
+ * \note            The payload goes in before the record header, so a record exists only once complete
+ * \param[inout]    p_log: Log handler
+ * \param[in]       p_data: Payload
+ * \param[in]       len: Payload length, see \ref flash_log_max_record
+ * \return          \ref FLASH_LOG_OK, \ref FLASH_LOG_ERR_LEN or \ref FLASH_LOG_ERR_IO
+ */
+flash_log_err_t flash_log_append(flash_log_t* p_log, const void* p_data, size_t len);
+
+/**
+ * \brief           Read the record at the cursor and advance it
+ * \note            The payload is returned in place, pointing into the map: no copy is made. It stays valid
+ *                  until the sector is reused, that is, until the next append that opens a sector.
+ *                  Records already overwritten are skipped and counted in `lost`
+ * \param[inout]    p_log: Log handler
+ * \param[inout]    p_cur: Cursor
+ * \param[out]      pp_data: Payload
+ * \param[out]      p_len: Payload length
+ * \return          \ref FLASH_LOG_OK, \ref FLASH_LOG_ERR_EMPTY when the cursor caught up with the writer
+ */
+flash_log_err_t flash_log_read(flash_log_t* p_log, flash_log_cursor_t* p_cur, const uint8_t** pp_data,
+                               size_t* p_len);
+
+/**
+ * \brief           Place a cursor
+ * \param[in]       p_log: Log handler
+ * \param[out]      p_cur: Cursor
+ * \param[in]       id: Next record to read, clamped to the oldest record still stored
+ */
+void flash_log_seek(const flash_log_t* p_log, flash_log_cursor_t* p_cur, uint32_t id);
+
+/**
+ * \brief           Id of the oldest record still stored
+ * \param[in]       p_log: Log handler
+ * \return          Oldest id, equal to `next_id` on an empty log
+ */
+uint32_t flash_log_oldest_id(const flash_log_t* p_log);
+
+/**
+ * \brief           Largest payload a record can hold
+ * \param[in]       p_log: Log handler
+ * \return          Length in bytes
+ */
+size_t flash_log_max_record(const flash_log_t* p_log);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FLASH_LOG_H */
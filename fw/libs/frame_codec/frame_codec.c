@@ -0,0 +1,212 @@
+/**
+ * \file            frame_codec.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           12-bit packing and keyframe delta frame codec
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "frame_codec.h"
+
+#include <string.h>
+
+#define FRAME_CODEC_RUN_MAX   128               /* Longest run of a single token */
+#define FRAME_CODEC_SMALL_MAX 64                /* Largest zig-zag value of a one byte token */
+
+/* 12-bit register value (sign extended) of a pixel */
+static inline int16_t
+frame_codec_get(const amg88_frame_raw_t* p_frame, size_t i) {
+    uint16_t raw = (uint16_t) (p_frame->pixels[2 * i] | (p_frame->pixels[2 * i + 1] << 8));
+
+    return (int16_t) (uint16_t) (raw << 4) >> 4;
+}
+
+static inline void
+frame_codec_set(amg88_frame_raw_t* p_frame, size_t i, int16_t val) {
+    p_frame->pixels[2 * i] = (uint8_t) val;
+    p_frame->pixels[2 * i + 1] = (uint8_t) (val >> 8) & 0x0F;
+}
+
+static inline uint16_t
+zigzag_enc(int16_t val) {
+    return (uint16_t) (((uint16_t) val << 1) ^ (uint16_t) (val >> 15));
+}
+
+static inline int16_t
+zigzag_dec(uint16_t val) {
+    return (int16_t) ((val >> 1) ^ -(int16_t) (val & 1));
+}
+
+void
+frame_codec_pack(const amg88_frame_raw_t* p_frame, uint8_t* p_out) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; i += 2, p_out += 3) {
+        uint16_t a = (uint16_t) frame_codec_get(p_frame, i) & 0x0FFF;
+        uint16_t b = (uint16_t) frame_codec_get(p_frame, i + 1) & 0x0FFF;
+
+        p_out[0] = (uint8_t) a;
+        p_out[1] = (uint8_t) ((a >> 8) | (b << 4));
+        p_out[2] = (uint8_t) (b >> 4);
+    }
+}
+
+void
+frame_codec_unpack(const uint8_t* p_in, amg88_frame_raw_t* p_frame) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; i += 2, p_in += 3) {
+        uint16_t a = (uint16_t) (p_in[0] | ((p_in[1] & 0x0F) << 8));
+        uint16_t b = (uint16_t) ((p_in[1] >> 4) | (p_in[2] << 4));
+
+        frame_codec_set(p_frame, i, (int16_t) a);
+        frame_codec_set(p_frame, i + 1, (int16_t) b);
+    }
+}
+
+void
+frame_codec_enc_init(frame_codec_enc_t* p_enc, uint16_t key_interval) {
+    memset(p_enc, 0, sizeof(*p_enc));
+    p_enc->key_interval = key_interval;
+}
+
+void
+frame_codec_enc_force_key(frame_codec_enc_t* p_enc) {
+    p_enc->has_key = false;
+}
+
+/* Delta body, returns 0 when it would not be smaller than a packed frame */
+static size_t
+frame_codec_encode_delta(const frame_codec_enc_t* p_enc, const amg88_frame_raw_t* p_frame, uint8_t* p_out) {
+    size_t len = 0, run = 0, need;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        uint16_t zz = zigzag_enc((int16_t) (frame_codec_get(p_frame, i) - p_enc->key[i]));
+
+        if (zz == 0) {
+            run++;
+            if (run < FRAME_CODEC_RUN_MAX && i + 1 < AMG88_ARRAY_SIZE) {
+                continue;
+            }
+        }
+
+        /* Up to 3 bytes go out below (run + wide delta), give up before writing them once packing is cheaper.
+           The output buffer holds a packed frame and nothing more */
+        need = (run > 0 ? 1 : 0) + (zz == 0 ? 0 : zz <= FRAME_CODEC_SMALL_MAX ? 1 : 2);
+        if (len + need >= FRAME_CODEC_PACKED_SIZE) {
+            return 0;
+        }
+
+        if (run > 0) {
+            p_out[len++] = (uint8_t) (run - 1);
+            run = 0;
+        }
+        if (zz != 0) {
+            if (zz <= FRAME_CODEC_SMALL_MAX) {
+                p_out[len++] = (uint8_t) (0x80 | (zz - 1));
+            } else {
+                p_out[len++] = (uint8_t) (0xC0 | (zz >> 8));
+                p_out[len++] = (uint8_t) zz;
+            }
+        }
+    }
+
+    return len;
+}
+
+size_t
+frame_codec_encode(frame_codec_enc_t* p_enc, const amg88_frame_raw_t* p_frame, uint8_t* p_out) {
+    size_t len = 0;
+
+    p_out[3] = p_frame->thermistor[0];
+    p_out[4] = p_frame->thermistor[1];
+
+    if (p_enc->has_key && p_enc->key_interval > 0 && p_enc->since_key < p_enc->key_interval) {
+        len = frame_codec_encode_delta(p_enc, p_frame, p_out + FRAME_CODEC_HDR_SIZE);
+    }
+
+    if (len > 0) {
+        p_out[0] = FRAME_CODEC_DELTA;
+        p_out[1] = (uint8_t) p_enc->key_id;
+        p_out[2] = (uint8_t) (p_enc->key_id >> 8);
+        p_enc->since_key++;
+        return FRAME_CODEC_HDR_SIZE + len;
+    }
+
+    /* New keyframe, new ID: deltas coded against the previous one can no longer pass for its own */
+    p_enc->key_id++;
+    p_out[0] = FRAME_CODEC_KEY;
+    p_out[1] = (uint8_t) p_enc->key_id;
+    p_out[2] = (uint8_t) (p_enc->key_id >> 8);
+    frame_codec_pack(p_frame, p_out + FRAME_CODEC_HDR_SIZE);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_enc->key[i] = frame_codec_get(p_frame, i);
+    }
+    p_enc->has_key = true;
+    p_enc->since_key = 0;
+
+    return FRAME_CODEC_HDR_SIZE + FRAME_CODEC_PACKED_SIZE;
+}
+
+void
+frame_codec_dec_init(frame_codec_dec_t* p_dec) {
+    memset(p_dec, 0, sizeof(*p_dec));
+}
+
+frame_codec_err_t
+frame_codec_decode(frame_codec_dec_t* p_dec, const uint8_t* p_in, size_t len, amg88_frame_raw_t* p_frame) {
+    size_t pos, px = 0;
+    uint16_t key_id;
+
+    if (len < FRAME_CODEC_HDR_SIZE) {
+        return FRAME_CODEC_ERR_LEN;
+    }
+    key_id = (uint16_t) (p_in[1] | (p_in[2] << 8));
+
+    if (p_in[0] == FRAME_CODEC_KEY) {
+        if (len != FRAME_CODEC_HDR_SIZE + FRAME_CODEC_PACKED_SIZE) {
+            return FRAME_CODEC_ERR_LEN;
+        }
+        frame_codec_unpack(p_in + FRAME_CODEC_HDR_SIZE, p_frame);
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            p_dec->key[i] = frame_codec_get(p_frame, i);
+        }
+        p_dec->key_id = key_id;
+        p_dec->has_key = true;
+    } else if (p_in[0] == FRAME_CODEC_DELTA) {
+        /* Coded against a keyframe that never arrived, the one held would give a wrong frame */
+        if (!p_dec->has_key || key_id != p_dec->key_id) {
+            return FRAME_CODEC_ERR_NO_KEY;
+        }
+
+        for (pos = FRAME_CODEC_HDR_SIZE; pos < len && px < AMG88_ARRAY_SIZE; ++pos) {
+            uint8_t tok = p_in[pos];
+            uint16_t zz;
+
+            if (!(tok & 0x80)) {
+                for (size_t n = (size_t) tok + 1; n > 0 && px < AMG88_ARRAY_SIZE; --n, ++px) {
+                    frame_codec_set(p_frame, px, p_dec->key[px]);
+                }
+                continue;
+            }
+
+            if (!(tok & 0x40)) {
+                zz = (uint16_t) ((tok & 0x3F) + 1);
+            } else {
+                if (++pos >= len) {
+                    return FRAME_CODEC_ERR_CORRUPT;
+                }
+                zz = (uint16_t) (((tok & 0x3F) << 8) | p_in[pos]);
+            }
+            frame_codec_set(p_frame, px, (int16_t) (p_dec->key[px] + zigzag_dec(zz)));
+            px++;
+        }
+
+        if (px != AMG88_ARRAY_SIZE || pos != len) {
+            return FRAME_CODEC_ERR_CORRUPT;
+        }
+    } else {
+        return FRAME_CODEC_ERR_CORRUPT;
+    }
+
+    p_frame->thermistor[0] = p_in[3];
+    p_frame->thermistor[1] = p_in[4];
+
+    return FRAME_CODEC_OK;
+}
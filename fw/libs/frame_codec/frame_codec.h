@@ -0,0 +1,128 @@
+/**
+ * \file            frame_codec.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           12-bit packing and keyframe delta frame codec
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FRAME_CODEC_PACKED_SIZE (AMG88_ARRAY_SIZE * 12 / 8) /*!< 64 pixels, 12 bits each */
+#define FRAME_CODEC_HDR_SIZE    5               /*!< Type (1) + keyframe ID (2) + raw thermistor (2) */
+#define FRAME_CODEC_MAX_SIZE    (FRAME_CODEC_HDR_SIZE + FRAME_CODEC_PACKED_SIZE) /*!< Worst case encoded size */
+
+/**
+ * \brief           Encoded frame types
+ * \note            Every frame carries the ID of its keyframe: a keyframe its own, a delta the one it is coded
+ *                  against. A delta whose keyframe was lost is rejected instead of applied to an older one.
+ * \note            Delta frame tokens, one per pixel run:
+ *                  - `0nnnnnnn`: `n + 1` pixels equal to the keyframe
+ *                  - `10zzzzzz`: zig-zag delta `z + 1` (1..64)
+ *                  - `11zzzzzz zzzzzzzz`: zig-zag delta `z` (14 bits)
+ */
+typedef enum {
+    FRAME_CODEC_KEY   = 0x00,                   /*!< Bit-packed keyframe */
+    FRAME_CODEC_DELTA = 0x01,                   /*!< Run-length coded zig-zag delta against the last keyframe */
+} frame_codec_type_t;
+
+/**
+ * \brief           Codec error codes
+ */
+typedef enum {
+    FRAME_CODEC_OK,                             /*!< Everything is Ok */
+    FRAME_CODEC_ERR_LEN,                        /*!< Buffer too short */
+    FRAME_CODEC_ERR_NO_KEY,                     /*!< Delta frame whose keyframe was not decoded */
+    FRAME_CODEC_ERR_CORRUPT,                    /*!< Malformed encoded frame */
+} frame_codec_err_t;
+
+/**
+ * \brief           Encoder state
+ */
+typedef struct {
+    uint16_t key_interval;                      /*!< Frames between keyframes, `0` to only send keyframes */
+    uint16_t since_key;                         /*!< Frames since the last keyframe */
+    uint16_t key_id;                            /*!< ID of the last keyframe */
+    bool has_key;                               /*!< `key` is valid */
+    int16_t key[AMG88_ARRAY_SIZE];              /*!< Last keyframe pixels */
+} frame_codec_enc_t;
+
+/**
+ * \brief           Decoder state
+ */
+typedef struct {
+    bool has_key;                               /*!< `key` is valid */
+    uint16_t key_id;                            /*!< ID of `key` */
+    int16_t key[AMG88_ARRAY_SIZE];              /*!< Last keyframe pixels */
+} frame_codec_dec_t;
+
+/**
+ * \brief           Pack the 64 pixels of a raw frame, 12 bits each
+ * \param[in]       p_frame: Raw frame
+ * \param[out]      p_out: \ref FRAME_CODEC_PACKED_SIZE bytes
+ */
+void frame_codec_pack(const amg88_frame_raw_t* p_frame, uint8_t* p_out);
+
+/**
+ * \brief           Unpack the 64 pixels of a raw frame
+ * \param[in]       p_in: \ref FRAME_CODEC_PACKED_SIZE bytes
+ * \param[out]      p_frame: Raw frame, the thermistor is left untouched
+ */
+void frame_codec_unpack(const uint8_t* p_in, amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Init the encoder
+ * \param[out]      p_enc: Encoder state
+ * \param[in]       key_interval: Frames between keyframes, `0` to only send keyframes
+ */
+void frame_codec_enc_init(frame_codec_enc_t* p_enc, uint16_t key_interval);
+
+/**
+ * \brief           Make the next encoded frame a keyframe (e.g. after a receiver joins)
+ * \param[in]       p_enc: Encoder state
+ */
+void frame_codec_enc_force_key(frame_codec_enc_t* p_enc);
+
+/**
+ * \brief           Encode a frame
+ * \note            A delta frame that would be larger than a keyframe is sent as a keyframe instead
+ * \param[in]       p_enc: Encoder state
+ * \param[in]       p_frame: Raw frame
+ * \param[out]      p_out: Output buffer, at least \ref FRAME_CODEC_MAX_SIZE bytes
+ * \return          Encoded size
+ */
+size_t frame_codec_encode(frame_codec_enc_t* p_enc, const amg88_frame_raw_t* p_frame, uint8_t* p_out);
+
+/**
+ * \brief           Init the decoder
+ * \param[out]      p_dec: Decoder state
+ */
+void frame_codec_dec_init(frame_codec_dec_t* p_dec);
+
+/**
+ * \brief           Decode a frame
+ * \param[in]       p_dec: Decoder state
+ * \param[in]       p_in: Encoded frame
+ * \param[in]       len: Encoded size
+ * \param[out]      p_frame: Raw frame
+ * \return          \ref FRAME_CODEC_OK on success, a member of \ref frame_codec_err_t otherwise
+ */
+frame_codec_err_t frame_codec_decode(frame_codec_dec_t* p_dec, const uint8_t* p_in, size_t len,
+                                     amg88_frame_raw_t* p_frame);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FRAME_CODEC_H */
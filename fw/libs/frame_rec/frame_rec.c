@@ -0,0 +1,128 @@
+/**
+ * \file            frame_rec.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Raw frame recording format, appended record by record, read back in place through a memory map
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "frame_rec.h"
+
+#include <string.h>
+
+#include "crc32/crc32.h"
+
+#define FRAME_REC_CRC_OFF   (FRAME_REC_RECORD_SIZE - 4) /* CRC-32 offset in a record */
+
+
+static void
+frame_rec_put(uint8_t* p_buf, uint64_t val, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        p_buf[i] = (uint8_t) (val >> (8 * i));
+    }
+}
+
+static uint64_t
+frame_rec_get_le(const uint8_t* p_buf, size_t len) {
+    uint64_t val = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        val |= (uint64_t) p_buf[i] << (8 * i);
+    }
+
+    return val;
+}
+
+static const uint8_t*
+frame_rec_ptr(const frame_rec_t* p_rec, size_t idx) {
+    return p_rec->p_map + FRAME_REC_HDR_SIZE + idx * FRAME_REC_RECORD_SIZE;
+}
+
+size_t
+frame_rec_encode_hdr(uint8_t* p_buf, uint32_t period_us) {
+    frame_rec_put(p_buf, FRAME_REC_MAGIC, 4);
+    frame_rec_put(p_buf + 4, FRAME_REC_VERSION, 2);
+    frame_rec_put(p_buf + 6, FRAME_REC_RECORD_SIZE, 2);
+    frame_rec_put(p_buf + 8, period_us, 4);
+    frame_rec_put(p_buf + 12, crc32_update(CRC32_INIT, p_buf, 12), 4);
+
+    return FRAME_REC_HDR_SIZE;
+}
+
+size_t
+frame_rec_encode(uint8_t* p_buf, uint64_t ts_us, uint32_t seq, const amg88_frame_raw_t* p_frame) {
+    frame_rec_put(p_buf, ts_us, 8);
+    frame_rec_put(p_buf + 8, seq, 4);
+    memcpy(p_buf + 12, p_frame->thermistor, 2);
+    memcpy(p_buf + 14, p_frame->pixels, AMG88_FRAME_RAW_SIZE);
+    frame_rec_put(p_buf + FRAME_REC_CRC_OFF, crc32_update(CRC32_INIT, p_buf, FRAME_REC_CRC_OFF), 4);
+
+    return FRAME_REC_RECORD_SIZE;
+}
+
+frame_rec_err_t
+frame_rec_open(frame_rec_t* p_rec, const uint8_t* p_map, size_t size) {
+    memset(p_rec, 0, sizeof(*p_rec));
+    if (size < FRAME_REC_HDR_SIZE || frame_rec_get_le(p_map, 4) != FRAME_REC_MAGIC
+        || frame_rec_get_le(p_map + 4, 2) != FRAME_REC_VERSION
+        || frame_rec_get_le(p_map + 6, 2) != FRAME_REC_RECORD_SIZE
+        || frame_rec_get_le(p_map + 12, 4) != crc32_update(CRC32_INIT, p_map, 12)) {
+        return FRAME_REC_ERR_FORMAT;
+    }
+
+    p_rec->p_map = p_map;
+    p_rec->period_us = (uint32_t) frame_rec_get_le(p_map + 8, 4);
+    p_rec->n_records = (size - FRAME_REC_HDR_SIZE) / FRAME_REC_RECORD_SIZE;
+    if (p_rec->n_records > 0) {
+        p_rec->first_us = frame_rec_get_le(frame_rec_ptr(p_rec, 0), 8);
+        p_rec->last_us = frame_rec_get_le(frame_rec_ptr(p_rec, p_rec->n_records - 1), 8);
+    }
+
+    return FRAME_REC_OK;
+}
+
+frame_rec_err_t
+frame_rec_get(const frame_rec_t* p_rec, size_t idx, uint64_t* p_ts_us, uint32_t* p_seq,
+              amg88_frame_raw_t* p_frame) {
+    const uint8_t* p;
+
+    if (idx >= p_rec->n_records) {
+        return FRAME_REC_ERR_RANGE;
+    }
+
+    p = frame_rec_ptr(p_rec, idx);
+    if (p_ts_us != NULL) {
+        *p_ts_us = frame_rec_get_le(p, 8);
+    }
+    if (p_seq != NULL) {
+        *p_seq = (uint32_t) frame_rec_get_le(p + 8, 4);
+    }
+    if (p_frame == NULL) {
+        return FRAME_REC_OK;
+    }
+
+    memcpy(p_frame->thermistor, p + 12, 2);
+    memcpy(p_frame->pixels, p + 14, AMG88_FRAME_RAW_SIZE);
+
+    return frame_rec_get_le(p + FRAME_REC_CRC_OFF, 4) == crc32_update(CRC32_INIT, p, FRAME_REC_CRC_OFF)
+               ? FRAME_REC_OK
+               : FRAME_REC_ERR_CRC;
+}
+
+size_t
+frame_rec_find(const frame_rec_t* p_rec, uint64_t ts_us) {
+    size_t lo = 0, hi = p_rec->n_records;
+
+    /* First record past `ts_us`, the one before it is on the sensor output */
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (frame_rec_get_le(frame_rec_ptr(p_rec, mid), 8) <= ts_us) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo > 0 ? lo - 1 : 0;
+}
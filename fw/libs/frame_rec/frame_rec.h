@@ -0,0 +1,113 @@
+/**
+ * \file            frame_rec.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Raw frame recording format, appended record by record, read back in place through a memory map
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FRAME_REC_H
+#define FRAME_REC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Layout, all fields little endian:
+ *
+ *   header   magic "TCRC" (4), version (2), record size (2), frame period us (4), CRC-32 of the above (4)
+ *   record   timestamp us (8), seq (4), thermistor (2), pixels (128), CRC-32 of the above (4)
+ *   record   ...
+ *
+ * Fixed-size records: record `i` is at `HDR_SIZE + i * RECORD_SIZE`, so a recording is indexed without a scan,
+ * and a writer stopped mid-append leaves a short tail that is simply ignored.
+ */
+#define FRAME_REC_MAGIC         0x43524354      /*!< "TCRC" */
+#define FRAME_REC_VERSION       1
+#define FRAME_REC_HDR_SIZE      16              /*!< File header size */
+#define FRAME_REC_RECORD_SIZE   (18 + AMG88_FRAME_RAW_SIZE) /*!< Record size: timestamp, seq, thermistor, pixels,
+                                                     CRC-32 */
+
+/**
+ * \brief           Errors
+ */
+typedef enum {
+    FRAME_REC_OK,                               /*!< Everything is Ok */
+    FRAME_REC_ERR_FORMAT,                       /*!< Not a recording, or an unsupported version */
+    FRAME_REC_ERR_CRC,                          /*!< Record corrupted */
+    FRAME_REC_ERR_RANGE,                        /*!< No such record */
+} frame_rec_err_t;
+
+/**
+ * \brief           Recording reader, over a caller-owned memory map of the whole file
+ */
+typedef struct {
+    const uint8_t* p_map;                       /*!< File contents */
+    size_t n_records;                           /*!< Complete records */
+    uint32_t period_us;                         /*!< Frame period at recording time, informative */
+    uint64_t first_us;                          /*!< Timestamp of the first record */
+    uint64_t last_us;                           /*!< Timestamp of the last record */
+} frame_rec_t;
+
+/**
+ * \brief           Build the file header, written once before the first record
+ * \param[out]      p_buf: \ref FRAME_REC_HDR_SIZE bytes
+ * \param[in]       period_us: Sensor frame period, e.g. 100000 for \ref AMG88_FPS_10
+ * \return          Bytes written, \ref FRAME_REC_HDR_SIZE
+ */
+size_t frame_rec_encode_hdr(uint8_t* p_buf, uint32_t period_us);
+
+/**
+ * \brief           Build a record, to be appended to the file as is
+ * \param[out]      p_buf: \ref FRAME_REC_RECORD_SIZE bytes
+ * \param[in]       ts_us: Acquisition timestamp, non-decreasing along the file
+ * \param[in]       seq: Acquisition sequence number
+ * \param[in]       p_frame: Raw frame, thermistor included
+ * \return          Bytes written, \ref FRAME_REC_RECORD_SIZE
+ */
+size_t frame_rec_encode(uint8_t* p_buf, uint64_t ts_us, uint32_t seq, const amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Open a recording
+ * \note            No copy is made, `p_map` must outlive the reader. A partial last record is left out
+ * \param[out]      p_rec: Reader
+ * \param[in]       p_map: File contents
+ * \param[in]       size: File size
+ * \return          \ref FRAME_REC_OK, \ref FRAME_REC_ERR_FORMAT on a bad header
+ */
+frame_rec_err_t frame_rec_open(frame_rec_t* p_rec, const uint8_t* p_map, size_t size);
+
+/**
+ * \brief           Read a record
+ * \param[in]       p_rec: Reader
+ * \param[in]       idx: Record index
+ * \param[out]      p_ts_us: Timestamp, may be `NULL`
+ * \param[out]      p_seq: Sequence number, may be `NULL`
+ * \param[out]      p_frame: Raw frame, may be `NULL` to only get the timestamp
+ * \return          \ref FRAME_REC_OK, \ref FRAME_REC_ERR_RANGE or \ref FRAME_REC_ERR_CRC, the outputs are
+ *                  still filled in on a CRC error
+ */
+frame_rec_err_t frame_rec_get(const frame_rec_t* p_rec, size_t idx, uint64_t* p_ts_us, uint32_t* p_seq,
+                              amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Find the record on the sensor output at a given time
+ * \note            Binary search on the timestamps, O(log n)
+ * \param[in]       p_rec: Reader
+ * \param[in]       ts_us: Time, in the recording timestamp base
+ * \return          Index of the last record at or before `ts_us`, `0` before the first one
+ */
+size_t frame_rec_find(const frame_rec_t* p_rec, uint64_t ts_us);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FRAME_REC_H */
@@ -0,0 +1,72 @@
+/**
+ * \file            frame_ring.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Lock-free single-producer/single-consumer frame ring, "latest frame wins"
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "frame_ring.h"
+
+#define FRAME_RING_FRESH    0x80                /* Latest slot not consumed yet */
+#define FRAME_RING_IDX_MASK 0x7F
+
+void
+frame_ring_init(frame_ring_t* p_ring, void* p_buf, size_t slot_size) {
+    p_ring->p_buf = (uint8_t*) p_buf;
+    p_ring->slot_size = slot_size;
+
+    p_ring->wr = 0;
+    p_ring->rd = 1;
+    atomic_init(&p_ring->latest, 2);
+
+    atomic_init(&p_ring->published, 0);
+    atomic_init(&p_ring->consumed, 0);
+    atomic_init(&p_ring->overruns, 0);
+}
+
+void*
+frame_ring_write_slot(frame_ring_t* p_ring) {
+    return p_ring->p_buf + p_ring->wr * p_ring->slot_size;
+}
+
+bool
+frame_ring_publish(frame_ring_t* p_ring) {
+    uint_fast8_t prev;
+
+    /* Swap our slot with the latest one, release orders the slot contents before the index */
+    prev = atomic_exchange_explicit(&p_ring->latest, p_ring->wr | FRAME_RING_FRESH, memory_order_acq_rel);
+    p_ring->wr = prev & FRAME_RING_IDX_MASK;
+
+    atomic_fetch_add_explicit(&p_ring->published, 1, memory_order_relaxed);
+    if (prev & FRAME_RING_FRESH) {
+        atomic_fetch_add_explicit(&p_ring->overruns, 1, memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+const void*
+frame_ring_acquire(frame_ring_t* p_ring) {
+    uint_fast8_t prev;
+
+    if (!(atomic_load_explicit(&p_ring->latest, memory_order_relaxed) & FRAME_RING_FRESH)) {
+        return NULL;
+    }
+
+    /* Hand back the slot we were reading and take the latest one */
+    prev = atomic_exchange_explicit(&p_ring->latest, p_ring->rd, memory_order_acq_rel);
+    p_ring->rd = prev & FRAME_RING_IDX_MASK;
+
+    atomic_fetch_add_explicit(&p_ring->consumed, 1, memory_order_relaxed);
+
+    return p_ring->p_buf + p_ring->rd * p_ring->slot_size;
+}
+
+void
+frame_ring_get_stats(frame_ring_t* p_ring, frame_ring_stats_t* p_stats) {
+    p_stats->published = atomic_load_explicit(&p_ring->published, memory_order_relaxed);
+    p_stats->consumed = atomic_load_explicit(&p_ring->consumed, memory_order_relaxed);
+    p_stats->overruns = atomic_load_explicit(&p_ring->overruns, memory_order_relaxed);
+}
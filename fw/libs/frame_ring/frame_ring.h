@@ -0,0 +1,97 @@
+/**
+ * \file            frame_ring.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Lock-free single-producer/single-consumer frame ring, "latest frame wins"
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Number of slots in the ring
+ * \note            One slot is owned by the producer, one by the consumer and one holds the latest
+ *                  published frame, so the producer never has to wait for the consumer
+ */
+#define FRAME_RING_SLOTS 3
+
+/**
+ * \brief           Frame ring handler
+ */
+typedef struct {
+    uint8_t* p_buf;                             /*!< Caller-owned storage, \ref FRAME_RING_SLOTS * slot_size bytes */
+    size_t slot_size;                           /*!< Size of a slot in bytes */
+
+    uint8_t wr;                                 /*!< Slot being written (producer only) */
+    uint8_t rd;                                 /*!< Slot being read (consumer only) */
+    atomic_uint_fast8_t latest;                 /*!< Latest published slot, plus a "not consumed yet" flag */
+
+    atomic_uint_fast32_t published;             /*!< Frames published by the producer */
+    atomic_uint_fast32_t consumed;              /*!< Frames taken by the consumer */
+    atomic_uint_fast32_t overruns;              /*!< Frames replaced by a newer one before being consumed */
+} frame_ring_t;
+
+/**
+ * \brief           Frame ring statistics
+ */
+typedef struct {
+    uint32_t published;                         /*!< Frames published by the producer */
+    uint32_t consumed;                          /*!< Frames taken by the consumer */
+    uint32_t overruns;                          /*!< Frames dropped because the consumer was late */
+} frame_ring_stats_t;
+
+/**
+ * \brief           Init the ring over caller-owned storage
+ * \param[out]      p_ring: Ring handler
+ * \param[in]       p_buf: Storage for \ref FRAME_RING_SLOTS slots
+ * \param[in]       slot_size: Size of a slot in bytes
+ */
+void frame_ring_init(frame_ring_t* p_ring, void* p_buf, size_t slot_size);
+
+/**
+ * \brief           Get the slot the producer has to fill next
+ * \note            Producer side. The slot stays owned by the producer until \ref frame_ring_publish
+ * \param[in]       p_ring: Ring handler
+ * \return          Slot to fill
+ */
+void* frame_ring_write_slot(frame_ring_t* p_ring);
+
+/**
+ * \brief           Publish the slot returned by \ref frame_ring_write_slot
+ * \note            Producer side. Never blocks, an unconsumed previous frame is dropped and counted
+ * \param[in]       p_ring: Ring handler
+ * \return          `true` when an unconsumed frame was dropped
+ */
+bool frame_ring_publish(frame_ring_t* p_ring);
+
+/**
+ * \brief           Take the latest published frame
+ * \note            Consumer side. The slot stays valid (and untouched by the producer) until the next call,
+ *                  no copies are made
+ * \param[in]       p_ring: Ring handler
+ * \return          Latest frame, `NULL` when nothing new was published since the last call
+ */
+const void* frame_ring_acquire(frame_ring_t* p_ring);
+
+/**
+ * \brief           Get the ring statistics
+ * \param[in]       p_ring: Ring handler
+ * \param[out]      p_stats: Statistics
+ */
+void frame_ring_get_stats(frame_ring_t* p_ring, frame_ring_stats_t* p_stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FRAME_RING_H */
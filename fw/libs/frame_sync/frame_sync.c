@@ -0,0 +1,164 @@
+/**
+ * \file            frame_sync.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Phase-locks frame reads to the sensor updates, flags duplicate and torn frames
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "frame_sync.h"
+
+#include <string.h>
+
+#define ROW_BYTES (AMG88_ARRAY_COLS * AMG88_PIXEL_BYTES)
+
+
+static uint32_t
+frame_sync_hash_row(const uint8_t* p_row) {
+    uint32_t w, h = 2166136261u;
+
+    for (size_t i = 0; i < ROW_BYTES; i += sizeof(w)) {
+        memcpy(&w, &p_row[i], sizeof(w));
+        h = (h ^ w) * 16777619u;
+        h ^= h >> 15;
+    }
+
+    return h;
+}
+
+void
+frame_sync_init(frame_sync_t* p_sync, uint32_t period_us, uint64_t now_us) {
+    memset(p_sync, 0, sizeof(*p_sync));
+    p_sync->period_us = period_us;
+    p_sync->guard_us = period_us / FRAME_SYNC_GUARD_DIV;
+    p_sync->retry_us = period_us / FRAME_SYNC_RETRY_DIV;
+    p_sync->next_us = now_us;
+}
+
+/* Update seen at `edge_us` with an uncertainty of a poll step: lock on it and track the period */
+static void
+frame_sync_lock(frame_sync_t* p_sync, uint64_t edge_us) {
+    uint64_t n;
+    int64_t meas;
+
+    /* The first measure replaces the nominal period, the next ones are smoothed */
+    if (p_sync->ref_us != 0) {
+        n = (edge_us - p_sync->ref_us + p_sync->period_us / 2) / p_sync->period_us;
+        if (n > 0 && n <= FRAME_SYNC_PERIOD_SPAN) {
+            meas = (int64_t) ((edge_us - p_sync->ref_us) / n);
+            p_sync->period_us = (uint32_t) (p_sync->period_us
+                                            + ((meas - (int64_t) p_sync->period_us)
+                                               >> (p_sync->measured ? FRAME_SYNC_PERIOD_SHIFT : 0)));
+            p_sync->measured = true;
+        }
+    }
+    if (!p_sync->locked) {
+        p_sync->stats.locks++;
+    }
+
+    p_sync->locked = true;
+    p_sync->since_probe = 0;
+    p_sync->ref_us = edge_us;
+    p_sync->edge_us = edge_us;
+}
+
+/* Plan the read after a new frame */
+static void
+frame_sync_plan(frame_sync_t* p_sync, uint64_t end_us) {
+    if (!p_sync->locked) {
+        p_sync->next_us = end_us + p_sync->retry_us;
+    } else if (++p_sync->since_probe >= FRAME_SYNC_PROBE_EVERY) {
+        p_sync->next_us = p_sync->edge_us + p_sync->period_us - p_sync->retry_us;
+    } else if (!p_sync->measured) {
+        /* Nominal period, the predicted updates drift: read half way between them until the first probe */
+        p_sync->next_us = p_sync->edge_us + p_sync->period_us + p_sync->period_us / 2;
+    } else {
+        p_sync->next_us = p_sync->edge_us + p_sync->period_us + p_sync->guard_us;
+    }
+}
+
+frame_sync_result_t
+frame_sync_check(frame_sync_t* p_sync, const amg88_frame_raw_t* p_frame, uint64_t start_us, uint64_t end_us) {
+    uint32_t hash[AMG88_ARRAY_ROWS];
+    uint8_t changed = 0;
+    uint64_t pred_us, last_us = p_sync->last_us;
+    bool torn, after_torn = p_sync->torn_pending;
+
+    for (size_t r = 0; r < AMG88_ARRAY_ROWS; ++r) {
+        hash[r] = frame_sync_hash_row(&p_frame->pixels[r * ROW_BYTES]);
+        changed |= (uint8_t) ((hash[r] != p_sync->row_hash[r]) << r);
+    }
+    memcpy(p_sync->row_hash, hash, sizeof(hash));
+    p_sync->last_us = start_us;
+
+    /* Nothing to compare the first read against, confirm it with a second one */
+    if (!p_sync->primed) {
+        p_sync->primed = true;
+        p_sync->torn_pending = true;
+        p_sync->torn_us = start_us + (end_us - start_us) / 2;
+        p_sync->next_us = end_us;
+        return FRAME_SYNC_TORN;
+    }
+    p_sync->torn_pending = false;
+
+    /* Latest update predicted before the end of this read */
+    pred_us = p_sync->edge_us;
+    if (p_sync->locked) {
+        while (pred_us + p_sync->period_us <= end_us) {
+            pred_us += p_sync->period_us;
+        }
+    }
+
+    if (changed == 0 && !after_torn) {
+        /* The update is still to come. A lock that keeps missing it for a whole period is lost. */
+        p_sync->stats.duplicates++;
+        p_sync->lo_us = end_us;
+        if (p_sync->locked && end_us > p_sync->edge_us + 2 * p_sync->period_us) {
+            p_sync->locked = false;
+        }
+        p_sync->next_us = end_us + p_sync->retry_us;
+        return FRAME_SYNC_DUPLICATE;
+    }
+
+    /*
+     * Rows are read in order, so a read that straddles an update returns the old top rows and the new bottom
+     * ones. An update landing within the first row changes every row though, so the first change after a
+     * duplicate is always read again. When more than a period passed since the previous read the pattern can
+     * be missed, then also flag a predicted update too close to the start of the read.
+     */
+    torn = (!(changed & 0x01) && (changed & 0x80)) || p_sync->lo_us != 0;
+    if (end_us - last_us >= p_sync->period_us) {
+        torn |= p_sync->locked && pred_us > p_sync->edge_us && pred_us + p_sync->guard_us / 2 > start_us;
+    }
+    if (torn && !after_torn) {
+        p_sync->torn_pending = true;
+        p_sync->stats.torn++;
+        p_sync->torn_us = start_us + (end_us - start_us) / 2;
+        p_sync->next_us = end_us;
+        return FRAME_SYNC_TORN;
+    }
+    p_sync->stats.frames++;
+
+    if (after_torn && p_sync->lo_us != 0 && p_sync->torn_us - p_sync->lo_us <= 2 * p_sync->retry_us) {
+        /* Bracketed between the last old read and the one flagged torn */
+        frame_sync_lock(p_sync, p_sync->lo_us + (p_sync->torn_us - p_sync->lo_us) / 2);
+    } else if (after_torn && p_sync->lo_us == 0 && changed != 0) {
+        /* The torn read itself brackets the update. An identical re-read means that read was whole after all. */
+        frame_sync_lock(p_sync, p_sync->torn_us);
+    } else if (!after_torn && p_sync->locked && p_sync->since_probe >= FRAME_SYNC_PROBE_EVERY) {
+        /* The probe already saw the new frame, the updates drifted earlier than predicted */
+        p_sync->locked = false;
+    } else if (p_sync->locked) {
+        p_sync->edge_us = pred_us;
+    }
+    p_sync->lo_us = 0;
+
+    frame_sync_plan(p_sync, end_us);
+
+    return FRAME_SYNC_NEW;
+}
+
+void
+frame_sync_read_failed(frame_sync_t* p_sync, uint64_t now_us) {
+    p_sync->next_us = now_us + p_sync->retry_us;
+}
@@ -0,0 +1,117 @@
+/**
+ * \file            frame_sync.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Phase-locks frame reads to the sensor updates, flags duplicate and torn frames
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FRAME_SYNC_H
+#define FRAME_SYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FRAME_SYNC_GUARD_DIV    25              /*!< Read `period / 25` after the estimated update */
+#define FRAME_SYNC_RETRY_DIV    16              /*!< Poll every `period / 16` while looking for an update */
+#define FRAME_SYNC_PROBE_EVERY  16              /*!< Frames between two probes of the update phase */
+#define FRAME_SYNC_PERIOD_SHIFT 2               /*!< Period tracking moves `1 / 2^shift` of the way per measure */
+#define FRAME_SYNC_PERIOD_SPAN  255             /*!< Max periods between two updates used to measure the period */
+
+/**
+ * \brief           Classification of a read
+ */
+typedef enum {
+    FRAME_SYNC_NEW,                             /*!< New frame, process it */
+    FRAME_SYNC_DUPLICATE,                       /*!< Same frame as the previous read, skip it */
+    FRAME_SYNC_TORN,                            /*!< Read may have overlapped a sensor update (or there is no
+                                                     previous frame to tell, or it is the first change after a
+                                                     duplicate), skip it and read again now */
+} frame_sync_result_t;
+
+/**
+ * \brief           Statistics
+ */
+typedef struct {
+    uint32_t frames;                            /*!< New frames */
+    uint32_t duplicates;                        /*!< Duplicate reads */
+    uint32_t torn;                              /*!< Suspected torn reads */
+    uint32_t locks;                             /*!< Times the phase lock was (re)acquired */
+} frame_sync_stats_t;
+
+/**
+ * \brief           Sync handler
+ * \note            While locked, reads are planned a guard time after every predicted update. Every
+ *                  \ref FRAME_SYNC_PROBE_EVERY frames one read is planned just before it instead, the duplicate
+ *                  it returns and the next read bracket the update and re-measure both phase and period.
+ *                  Until the first probe has measured the period, reads are planned half way between updates.
+ */
+typedef struct {
+    uint32_t period_us;                         /*!< Tracked sensor frame period */
+    uint32_t guard_us;                          /*!< Delay between the estimated update and the read */
+    uint32_t retry_us;                          /*!< Poll step while looking for an update */
+
+    bool primed;                                /*!< A frame has been seen */
+    bool locked;                                /*!< `edge_us` follows the real updates */
+    bool measured;                              /*!< `period_us` has been measured at least once */
+    uint8_t since_probe;                        /*!< Frames since the phase was last measured */
+    bool torn_pending;                          /*!< Last read was flagged torn */
+    uint64_t torn_us;                           /*!< Middle of the read flagged torn */
+    uint64_t edge_us;                           /*!< Estimated time of the latest sensor update */
+    uint64_t ref_us;                            /*!< Latest bracketed update, for period tracking */
+    uint64_t lo_us;                             /*!< End of the latest read that still saw the old frame, `0` if none */
+    uint64_t next_us;                           /*!< When the next read should start */
+    uint64_t last_us;                           /*!< Start of the previous read */
+    uint32_t row_hash[AMG88_ARRAY_ROWS];        /*!< Per row hash of the latest read */
+
+    frame_sync_stats_t stats;                   /*!< Statistics */
+} frame_sync_t;
+
+/**
+ * \brief           Init the sync state
+ * \param[out]      p_sync: Sync handler
+ * \param[in]       period_us: Nominal sensor frame period (e.g. 100000 for \ref AMG88_FPS_10)
+ * \param[in]       now_us: Current time
+ */
+void frame_sync_init(frame_sync_t* p_sync, uint32_t period_us, uint64_t now_us);
+
+/**
+ * \brief           Classify a read and plan the next one
+ * \param[in]       p_sync: Sync handler
+ * \param[in]       p_frame: Frame just read
+ * \param[in]       start_us: Time the read started
+ * \param[in]       end_us: Time the read finished
+ * \return          Member of \ref frame_sync_result_t
+ */
+frame_sync_result_t frame_sync_check(frame_sync_t* p_sync, const amg88_frame_raw_t* p_frame, uint64_t start_us,
+                                     uint64_t end_us);
+
+/**
+ * \brief           Plan a retry after a failed read
+ * \param[in]       p_sync: Sync handler
+ * \param[in]       now_us: Current time
+ */
+void frame_sync_read_failed(frame_sync_t* p_sync, uint64_t now_us);
+
+/**
+ * \brief           When the next read should start
+ * \param[in]       p_sync: Sync handler
+ * \return          Start time, same base as the timestamps fed to \ref frame_sync_check
+ */
+static inline uint64_t
+frame_sync_next_read(const frame_sync_t* p_sync) {
+    return p_sync->next_us;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FRAME_SYNC_H */
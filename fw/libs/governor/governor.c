@@ -0,0 +1,96 @@
+/**
+ * \file            governor.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Scene-activity governor, picks the sensor frame rate and standby mode from inter-frame change
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "governor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+void
+governor_init(governor_t* p_gov, const governor_cfg_t* p_cfg) {
+    memset(p_gov, 0, sizeof(*p_gov));
+    memcpy(&p_gov->cfg, p_cfg, sizeof(p_gov->cfg));
+    p_gov->level = GOV_ACTIVE;
+    p_gov->active = true;
+}
+
+bool
+governor_update(governor_t* p_gov, const int16_t* p_temp, uint64_t ts_us) {
+    gov_level_t next = GOV_ACTIVE;
+    uint64_t quiet_us;
+    uint8_t changed = 0;
+
+    p_gov->stats.frames++;
+    if (!p_gov->primed) {
+        memcpy(p_gov->prev, p_temp, sizeof(p_gov->prev));
+        p_gov->primed = true;
+        p_gov->static_since_us = ts_us;
+        p_gov->last_us = ts_us;
+        return false;
+    }
+    p_gov->stats.level_us[p_gov->level] += ts_us - p_gov->last_us;
+    p_gov->last_us = ts_us;
+
+    for (uint8_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        if (abs(p_temp[i] - p_gov->prev[i]) >= p_gov->cfg.pixel_delta) {
+            changed++;
+        }
+    }
+    memcpy(p_gov->prev, p_temp, sizeof(p_gov->prev));
+    p_gov->changed = changed;
+
+    /* Between the two thresholds the frame keeps the previous classification */
+    if (changed >= p_gov->cfg.on_pixels) {
+        p_gov->active = true;
+    } else if (changed <= p_gov->cfg.off_pixels) {
+        p_gov->active = false;
+    }
+
+    if (p_gov->active) {
+        p_gov->static_since_us = ts_us;
+    } else {
+        quiet_us = ts_us - p_gov->static_since_us;
+        if (p_gov->cfg.standby_after_ms != 0 && quiet_us >= (uint64_t) p_gov->cfg.standby_after_ms * 1000) {
+            next = GOV_STANDBY;
+        } else if (quiet_us >= (uint64_t) p_gov->cfg.idle_after_ms * 1000) {
+            next = GOV_IDLE;
+        } else {
+            next = p_gov->level;
+        }
+    }
+
+    if (next == p_gov->level) {
+        return false;
+    }
+    p_gov->level = next;
+    p_gov->stats.switches++;
+
+    return true;
+}
+
+amg88_err_t
+governor_apply(const governor_t* p_gov, amg88_dev_t* p_dev) {
+    amg88_config_begin(p_dev);
+    amg88_set_op_mode(p_dev, p_gov->level == GOV_STANDBY ? AMG88_OP_10 : AMG88_OP_NORMAL);
+    amg88_set_frame_rate(p_dev, p_gov->level == GOV_ACTIVE ? AMG88_FPS_10 : AMG88_FPS_1);
+
+    return amg88_config_commit(p_dev);
+}
+
+uint32_t
+governor_period_us(gov_level_t level) {
+    switch (level) {
+        case GOV_IDLE:
+            return 1000000;
+        case GOV_STANDBY:
+            return 10000000;
+        default:
+            return 100000;
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * \file            governor.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Scene-activity governor, picks the sensor frame rate and standby mode from inter-frame change
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Acquisition levels, from the busiest to the quietest
+ */
+typedef enum {
+    GOV_ACTIVE,                                 /*!< Normal mode, 10 FPS */
+    GOV_IDLE,                                   /*!< Normal mode, 1 FPS */
+    GOV_STANDBY,                                /*!< Stand-by mode, one frame every 10 sec */
+
+    GOV_LEVELS,                                 /*!< Number of levels */
+} gov_level_t;
+
+/**
+ * \brief           Thresholds
+ * \note            A pixel has changed when it moved at least `pixel_delta` since the previous frame. A frame
+ *                  with `on_pixels` changed pixels or more is active, one with `off_pixels` or less is static,
+ *                  anything in between keeps the previous classification. Activity steps up to
+ *                  \ref GOV_ACTIVE at once, stepping down needs the scene to stay static for a while.
+ */
+typedef struct {
+    uint16_t pixel_delta;                       /*!< Change of a pixel, 1/4 degree units */
+    uint8_t on_pixels;                          /*!< Changed pixels that make a frame active */
+    uint8_t off_pixels;                         /*!< Changed pixels that make a frame static, below `on_pixels` */
+    uint32_t idle_after_ms;                     /*!< Static time before \ref GOV_IDLE */
+    uint32_t standby_after_ms;                  /*!< Static time before \ref GOV_STANDBY, `0` never goes there */
+} governor_cfg_t;
+
+/**
+ * \brief           Statistics
+ */
+typedef struct {
+    uint32_t frames;                            /*!< Frames seen */
+    uint32_t switches;                          /*!< Level changes */
+    uint64_t level_us[GOV_LEVELS];              /*!< Time spent at each level */
+} governor_stats_t;
+
+/**
+ * \brief           Governor handler
+ */
+typedef struct {
+    governor_cfg_t cfg;                         /*!< Configuration */
+    gov_level_t level;                          /*!< Current level */
+
+    bool primed;                                /*!< `prev` holds a frame */
+    bool active;                                /*!< Latest classification, with hysteresis */
+    uint8_t changed;                            /*!< Changed pixels in the latest frame */
+    int16_t prev[AMG88_ARRAY_SIZE];             /*!< Previous frame */
+    uint64_t static_since_us;                   /*!< Timestamp of the last active frame, the quiet run is timed
+                                                     from there */
+    uint64_t last_us;                           /*!< Timestamp of the previous frame */
+
+    governor_stats_t stats;                     /*!< Statistics */
+} governor_t;
+
+/**
+ * \brief           Init the governor, starting at \ref GOV_ACTIVE
+ * \param[out]      p_gov: Governor handler
+ * \param[in]       p_cfg: Thresholds, copied
+ */
+void governor_init(governor_t* p_gov, const governor_cfg_t* p_cfg);
+
+/**
+ * \brief           Feed a frame
+ * \param[inout]    p_gov: Governor handler
+ * \param[in]       p_temp: Pixel temperatures, 1/4 degree units
+ * \param[in]       ts_us: Frame timestamp
+ * \return          `true` when the level changed, apply it with \ref governor_apply
+ */
+bool governor_update(governor_t* p_gov, const int16_t* p_temp, uint64_t ts_us);
+
+/**
+ * \brief           Write the current level to the sensor, operation mode and frame rate in one batch
+ * \param[in]       p_gov: Governor handler
+ * \param[in]       p_dev: Pointer to sensor handler
+ * \return          \ref AMG88_OK on success, a member of \ref amg88_err_t otherwise
+ */
+amg88_err_t governor_apply(const governor_t* p_gov, amg88_dev_t* p_dev);
+
+/**
+ * \brief           Sensor frame period of a level
+ * \param[in]       level: Level
+ * \return          Period in microseconds
+ */
+uint32_t governor_period_us(gov_level_t level);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GOVERNOR_H */
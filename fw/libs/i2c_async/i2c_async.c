@@ -0,0 +1,90 @@
+/**
+ * \file            i2c_async.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Non-blocking I2C reads: a worker task per bus runs queued transfers through a blocking HAL
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "i2c_async.h"
+
+#include <string.h>
+
+/* Vars */
+static i2c_async_t* workers[I2C_ASYNC_MAX_BUS];
+
+
+static void
+i2c_async_task(void* arg) {
+    i2c_async_t* p_async = (i2c_async_t*) arg;
+    i2c_async_req_t req;
+
+    while (true) {
+        osal_sem_take(&p_async->pending, OSAL_WAIT_FOREVER);
+
+        /* Copy out and free the slot first, the callback may queue the next transfer */
+        req = p_async->queue[p_async->tail];
+        p_async->tail = (uint8_t) ((p_async->tail + 1) % I2C_ASYNC_QUEUE_LEN);
+        osal_sem_take(&p_async->lock, OSAL_WAIT_FOREVER);
+        --p_async->count;
+        osal_sem_give(&p_async->lock);
+
+        req.done(p_async->read(p_async->bus, req.addr, req.reg_addr, req.len, req.data_buf), req.arg);
+    }
+}
+
+osal_err_t
+i2c_async_init(i2c_async_t* p_async, uint8_t bus, amg88_i2c_fn read, uint8_t prio, int8_t core) {
+    if (bus >= I2C_ASYNC_MAX_BUS) {
+        return OSAL_ERR;
+    }
+
+    memset(p_async, 0, sizeof(*p_async));
+    p_async->bus = bus;
+    p_async->read = read;
+    if (osal_sem_init(&p_async->lock) != OSAL_OK || osal_sem_init(&p_async->pending) != OSAL_OK) {
+        return OSAL_ERR;
+    }
+    osal_sem_give(&p_async->lock);
+
+    if (osal_task_create(&p_async->task, "i2c_async", i2c_async_task, p_async, I2C_ASYNC_STACK_SIZE, prio,
+                         core) != OSAL_OK) {
+        return OSAL_ERR;
+    }
+    workers[bus] = p_async;
+
+    return OSAL_OK;
+}
+
+amg88_err_t
+i2c_async_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf,
+               amg88_done_fn done, void* arg) {
+    i2c_async_t* p_async = bus < I2C_ASYNC_MAX_BUS ? workers[bus] : NULL;
+    i2c_async_req_t* p_req;
+
+    if (p_async == NULL) {
+        return AMG88_ERR;
+    }
+
+    osal_sem_take(&p_async->lock, OSAL_WAIT_FOREVER);
+    if (p_async->count == I2C_ASYNC_QUEUE_LEN) {
+        ++p_async->rejected;
+        osal_sem_give(&p_async->lock);
+        return AMG88_ERR;
+    }
+    p_req = &p_async->queue[p_async->head];
+    p_req->addr = addr;
+    p_req->reg_addr = reg_addr;
+    p_req->len = len;
+    p_req->data_buf = data_buf;
+    p_req->done = done;
+    p_req->arg = arg;
+    p_async->head = (uint8_t) ((p_async->head + 1) % I2C_ASYNC_QUEUE_LEN);
+    ++p_async->count;
+    ++p_async->queued;
+    osal_sem_give(&p_async->lock);
+
+    osal_sem_give(&p_async->pending);
+
+    return AMG88_OK;
+}
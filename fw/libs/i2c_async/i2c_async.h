@@ -0,0 +1,82 @@
+/**
+ * \file            i2c_async.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Non-blocking I2C reads: a worker task per bus runs queued transfers through a blocking HAL
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define I2C_ASYNC_MAX_BUS       2               /*!< Buses with a worker, the ESP32 has two controllers */
+#define I2C_ASYNC_QUEUE_LEN     4               /*!< Transfers queued per bus */
+#define I2C_ASYNC_STACK_SIZE    2048            /*!< Worker stack */
+
+/**
+ * \brief           Queued transfer
+ */
+typedef struct {
+    uint8_t addr;                               /*!< I2C address */
+    uint8_t reg_addr;                           /*!< Sensor register address */
+    size_t len;                                 /*!< Data bytes */
+    uint8_t* data_buf;                          /*!< Destination */
+    amg88_done_fn done;                         /*!< Completion callback */
+    void* arg;                                  /*!< Callback argument */
+} i2c_async_req_t;
+
+/**
+ * \brief           Bus worker
+ */
+typedef struct {
+    uint8_t bus;                                /*!< I2C bus */
+    amg88_i2c_fn read;                          /*!< Blocking read run by the worker */
+
+    i2c_async_req_t queue[I2C_ASYNC_QUEUE_LEN]; /*!< Ring of queued transfers */
+    uint8_t head;                               /*!< Next slot to fill, under `lock` */
+    uint8_t tail;                               /*!< Next slot to run, worker only */
+    uint8_t count;                              /*!< Slots in use, under `lock` */
+    osal_sem_t lock;                            /*!< Protects the producer side of the ring */
+    osal_sem_t pending;                         /*!< One give per queued transfer */
+    osal_task_t task;                           /*!< Worker task */
+
+    uint32_t queued;                            /*!< Transfers accepted */
+    uint32_t rejected;                          /*!< Transfers refused, queue full */
+} i2c_async_t;
+
+/**
+ * \brief           Start the worker of a bus
+ * \note            The worker shares the bus with blocking callers, the HAL has to serialize them
+ *                  (the ESP-IDF driver locks each port)
+ * \param[out]      p_async: Bus worker, must outlive the program
+ * \param[in]       bus: I2C bus, below \ref I2C_ASYNC_MAX_BUS
+ * \param[in]       read: Blocking read the worker runs
+ * \param[in]       prio: Worker priority
+ * \param[in]       core: Core to pin the worker to, \ref OSAL_CORE_ANY to let the OS choose
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t i2c_async_init(i2c_async_t* p_async, uint8_t bus, amg88_i2c_fn read, uint8_t prio, int8_t core);
+
+/**
+ * \brief           Queue a read on the worker of its bus, \ref amg88_i2c_async_fn compatible
+ * \return          \ref AMG88_OK when queued, \ref AMG88_ERR without a worker or with a full queue
+ */
+amg88_err_t i2c_async_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf,
+                           amg88_done_fn done, void* arg);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* I2C_ASYNC_H */
@@ -0,0 +1,140 @@
+/**
+ * \file            interp.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Fixed-point separable frame upscaling (8x8 -> 32x32/64x64)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "interp.h"
+
+#define INTERP_ONE      (1 << INTERP_WEIGHT_BITS)
+#define INTERP_MAX_TAPS 4
+
+/*
+ * Weight bits the row pass drops before the column pass. Catmull-Rom taps sum to at most 1.25 in absolute
+ * value, so a full scale int16 input reaches 2^15 * 1.25 * 2^8 per pass: kept whole, the column pass would
+ * need 2^15 * 1.25^2 * 2^16 > 2^31. With 4 bits dropped it peaks around 2^28, and the row results keep
+ * 4 fractional bits so the final rounding is off by well under 1 LSB.
+ */
+#define INTERP_TMP_SHIFT 4
+
+/**
+ * \brief           Taps of an output phase
+ */
+typedef struct {
+    int8_t off;                                 /* First source pixel, relative to `out / scale` */
+    int16_t w[INTERP_MAX_TAPS];                 /* Weights, sum to INTERP_ONE */
+} interp_phase_t;
+
+/*
+ * Weights tables, evaluated by the compiler. Output `o` samples the source at `(o + 0.5) / s - 0.5`,
+ * so phases below `s / 2` sit left of their source pixel centre.
+ */
+#define POS(p, s)     (((p) + 0.5) / (s) - 0.5)
+#define LEFT(p, s)    (POS(p, s) < 0)
+#define FRAC(p, s)    (LEFT(p, s) ? POS(p, s) + 1 : POS(p, s))
+#define Q(w)          ((int16_t) ((w) * INTERP_ONE + ((w) < 0 ? -0.5 : 0.5)))
+
+#define BIL_W0(t)     (1 - (t))
+
+#define CUB_W0(t)     ((-(t) * (t) * (t) + 2 * (t) * (t) - (t)) / 2)
+#define CUB_W1(t)     ((3 * (t) * (t) * (t) - 5 * (t) * (t) + 2) / 2)
+#define CUB_W2(t)     ((-3 * (t) * (t) * (t) + 4 * (t) * (t) + (t)) / 2)
+
+#define BILINEAR(p, s) {                                                    \
+    .off = LEFT(p, s) ? -1 : 0,                                             \
+    .w = { Q(BIL_W0(FRAC(p, s))), INTERP_ONE - Q(BIL_W0(FRAC(p, s))) },     \
+}
+
+#define BICUBIC(p, s) {                                                     \
+    .off = LEFT(p, s) ? -2 : -1,                                            \
+    .w = {                                                                  \
+        Q(CUB_W0(FRAC(p, s))),                                              \
+        Q(CUB_W1(FRAC(p, s))),                                              \
+        Q(CUB_W2(FRAC(p, s))),                                              \
+        INTERP_ONE - Q(CUB_W0(FRAC(p, s))) - Q(CUB_W1(FRAC(p, s))) - Q(CUB_W2(FRAC(p, s))), \
+    },                                                                      \
+}
+
+#define PHASES_4(K)   { K(0, 4), K(1, 4), K(2, 4), K(3, 4) }
+#define PHASES_8(K)   { K(0, 8), K(1, 8), K(2, 8), K(3, 8), K(4, 8), K(5, 8), K(6, 8), K(7, 8) }
+
+static const interp_phase_t bilinear_x4[4] = PHASES_4(BILINEAR);
+static const interp_phase_t bilinear_x8[8] = PHASES_8(BILINEAR);
+static const interp_phase_t bicubic_x4[4] = PHASES_4(BICUBIC);
+static const interp_phase_t bicubic_x8[8] = PHASES_8(BICUBIC);
+
+static inline size_t
+interp_clamp(int32_t idx, size_t len) {
+    return idx < 0 ? 0 : (idx >= (int32_t) len ? len - 1 : (size_t) idx);
+}
+
+interp_err_t
+interp_upscale(const int16_t* p_in, int16_t* p_out, int32_t* p_tmp, uint8_t scale, interp_method_t method) {
+    const interp_phase_t* p_phases;
+    size_t n_taps, out_cols, out_rows;
+    uint8_t src[INTERP_MAX_TAPS * 8 * 8];       /* Clamped source index of every tap, per output index */
+    const int32_t tmp_round = 1 << (INTERP_TMP_SHIFT - 1);
+    const int32_t round = 1 << (2 * INTERP_WEIGHT_BITS - INTERP_TMP_SHIFT - 1);
+
+    if (scale != 4 && scale != 8) {
+        return INTERP_ERR_SCALE;
+    }
+    if (method == INTERP_BILINEAR) {
+        p_phases = scale == 4 ? bilinear_x4 : bilinear_x8;
+        n_taps = 2;
+    } else if (method == INTERP_BICUBIC) {
+        p_phases = scale == 4 ? bicubic_x4 : bicubic_x8;
+        n_taps = 4;
+    } else {
+        return INTERP_ERR_METHOD;
+    }
+
+    /* Rows and columns have the same length, so one index table serves both passes */
+    out_cols = AMG88_ARRAY_COLS * scale;
+    out_rows = AMG88_ARRAY_ROWS * scale;
+    for (size_t o = 0; o < out_cols; ++o) {
+        int32_t first = (int32_t) (o / scale) + p_phases[o % scale].off;
+
+        for (size_t k = 0; k < n_taps; ++k) {
+            src[o * n_taps + k] = (uint8_t) interp_clamp(first + (int32_t) k, AMG88_ARRAY_COLS);
+        }
+    }
+
+    /* Row pass: 8 input rows -> 8 rows of `out_cols`, all but `INTERP_TMP_SHIFT` weight bits kept */
+    for (size_t r = 0; r < AMG88_ARRAY_ROWS; ++r) {
+        const int16_t* p_row = &p_in[r * AMG88_ARRAY_COLS];
+        int32_t* p_dst = &p_tmp[r * out_cols];
+
+        for (size_t o = 0; o < out_cols; ++o) {
+            const int16_t* w = p_phases[o % scale].w;
+            const uint8_t* s = &src[o * n_taps];
+            int32_t acc = 0;
+
+            for (size_t k = 0; k < n_taps; ++k) {
+                acc += (int32_t) w[k] * p_row[s[k]];
+            }
+            p_dst[o] = (acc + tmp_round) >> INTERP_TMP_SHIFT;
+        }
+    }
+
+    /* Column pass: 8 rows -> `out_rows` rows, dropping the remaining weight bits with rounding */
+    for (size_t o = 0; o < out_rows; ++o) {
+        const int16_t* w = p_phases[o % scale].w;
+        const uint8_t* s = &src[o * n_taps];
+        int16_t* p_dst = &p_out[o * out_cols];
+
+        for (size_t c = 0; c < out_cols; ++c) {
+            int32_t acc = 0;
+
+            for (size_t k = 0; k < n_taps; ++k) {
+                acc += w[k] * p_tmp[s[k] * out_cols + c];
+            }
+            acc = (acc + round) >> (2 * INTERP_WEIGHT_BITS - INTERP_TMP_SHIFT);
+            p_dst[c] = (int16_t) (acc < INT16_MIN ? INT16_MIN : (acc > INT16_MAX ? INT16_MAX : acc));
+        }
+    }
+
+    return INTERP_OK;
+}
@@ -0,0 +1,118 @@
+/**
+ * \file            metrics.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Hot-path metrics: stage timers, latency histograms, error and drop counters
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "metrics.h"
+
+#include <string.h>
+#include <stdatomic.h>
+
+#if METRICS_ENABLE
+/**
+ * \brief           Live stage timer
+ */
+typedef struct {
+    atomic_uint_fast32_t count;                 /*!< Samples */
+    atomic_uint_fast32_t sum_us;                /*!< Sum of the samples */
+    atomic_uint_fast16_t hist[METRICS_HIST_BUCKETS]; /*!< Samples per bucket */
+} metrics_live_timer_t;
+
+/* Vars */
+static metrics_live_timer_t live_timers[METRICS_STAGES];
+static atomic_uint_fast32_t live_errors[METRICS_ERR_CODES];
+static atomic_uint_fast32_t live_counters[METRICS_COUNTERS];
+
+
+/* Relaxed: nothing else is ordered against a metric, and every probe of a stage may be on another task */
+void
+metrics_time(metrics_stage_t stage, uint32_t cycles) {
+    metrics_live_timer_t* p_timer = &live_timers[stage];
+    uint32_t us = cycles / OSAL_CYCLES_PER_US;
+    uint8_t bucket = us < 2 ? 0 : (uint8_t) (31 - __builtin_clz(us));
+
+    if (bucket >= METRICS_HIST_BUCKETS) {
+        bucket = METRICS_HIST_BUCKETS - 1;
+    }
+
+    atomic_fetch_add_explicit(&p_timer->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_timer->sum_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_timer->hist[bucket], 1, memory_order_relaxed);
+}
+
+void
+metrics_error(amg88_err_t err) {
+    atomic_fetch_add_explicit(&live_errors[(uint32_t) err < METRICS_ERR_CODES ? err : METRICS_ERR_CODES - 1], 1,
+                              memory_order_relaxed);
+}
+
+void
+metrics_count(metrics_counter_t counter, uint32_t n) {
+    atomic_fetch_add_explicit(&live_counters[counter], n, memory_order_relaxed);
+}
+#endif /* METRICS_ENABLE */
+
+void
+metrics_snapshot(metrics_t* p_out) {
+    memset(p_out, 0, sizeof(*p_out));
+
+#if METRICS_ENABLE
+    for (uint8_t s = 0; s < METRICS_STAGES; ++s) {
+        p_out->timers[s].count = atomic_load_explicit(&live_timers[s].count, memory_order_relaxed);
+        p_out->timers[s].sum_us = atomic_load_explicit(&live_timers[s].sum_us, memory_order_relaxed);
+        for (uint8_t b = 0; b < METRICS_HIST_BUCKETS; ++b) {
+            p_out->timers[s].hist[b] = (uint16_t) atomic_load_explicit(&live_timers[s].hist[b],
+                                                                       memory_order_relaxed);
+        }
+    }
+    for (uint8_t i = 0; i < METRICS_ERR_CODES; ++i) {
+        p_out->errors[i] = atomic_load_explicit(&live_errors[i], memory_order_relaxed);
+    }
+    for (uint8_t i = 0; i < METRICS_COUNTERS; ++i) {
+        p_out->counters[i] = atomic_load_explicit(&live_counters[i], memory_order_relaxed);
+    }
+#endif /* METRICS_ENABLE */
+}
+
+void
+metrics_delta(const metrics_t* p_cur, const metrics_t* p_prev, metrics_t* p_out) {
+    for (uint8_t s = 0; s < METRICS_STAGES; ++s) {
+        p_out->timers[s].count = p_cur->timers[s].count - p_prev->timers[s].count;
+        p_out->timers[s].sum_us = p_cur->timers[s].sum_us - p_prev->timers[s].sum_us;
+        for (uint8_t b = 0; b < METRICS_HIST_BUCKETS; ++b) {
+            p_out->timers[s].hist[b] = (uint16_t) (p_cur->timers[s].hist[b] - p_prev->timers[s].hist[b]);
+        }
+    }
+    for (uint8_t i = 0; i < METRICS_ERR_CODES; ++i) {
+        p_out->errors[i] = p_cur->errors[i] - p_prev->errors[i];
+    }
+    for (uint8_t i = 0; i < METRICS_COUNTERS; ++i) {
+        p_out->counters[i] = p_cur->counters[i] - p_prev->counters[i];
+    }
+}
+
+uint32_t
+metrics_percentile_us(const metrics_timer_t* p_timer, uint8_t pct) {
+    uint32_t total = 0, target, seen = 0;
+
+    for (uint8_t b = 0; b < METRICS_HIST_BUCKETS; ++b) {
+        total += p_timer->hist[b];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    /* Rank of the sample, rounded up, so p100 is the last one */
+    target = (total * pct + 99) / 100;
+    for (uint8_t b = 0; b < METRICS_HIST_BUCKETS - 1; ++b) {
+        seen += p_timer->hist[b];
+        if (seen >= target) {
+            return 1u << (b + 1);
+        }
+    }
+
+    return UINT32_MAX;
+}
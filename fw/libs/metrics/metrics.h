@@ -0,0 +1,144 @@
+/**
+ * \file            metrics.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Hot-path metrics: stage timers, latency histograms, error and drop counters
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Build switch, `0` turns every probe below into nothing
+ * \note            Set for the whole build (see fw/CMakeLists.txt), the snapshot, delta and percentile helpers
+ *                  stay available to the receivers either way
+ */
+#ifndef METRICS_ENABLE
+#define METRICS_ENABLE          1
+#endif /* METRICS_ENABLE */
+
+#define METRICS_HIST_BUCKETS    16              /*!< Bucket `b` counts [2^b, 2^(b+1)) us, the first from 0, the last open */
+#define METRICS_ERR_CODES       8               /*!< \ref amg88_err_t codes counted, later ones share the last */
+
+/**
+ * \brief           Timed stages
+ */
+typedef enum {
+    METRICS_READ,                               /*!< Sensor bus read */
+    METRICS_DECODE,                             /*!< Raw to temperatures, calibration included */
+    METRICS_PROCESS,                            /*!< Whole processing stage, decode and encode included */
+    METRICS_ENCODE,                             /*!< Codec and packet building */
+    METRICS_SEND,                               /*!< Transmit, or record while the link is down */
+
+    METRICS_STAGES,                             /*!< Number of stages */
+} metrics_stage_t;
+
+/**
+ * \brief           Event counters
+ */
+typedef enum {
+    METRICS_FRAMES,                             /*!< New frames acquired */
+    METRICS_DROPPED,                            /*!< Frames overwritten before they were processed or sent */
+    METRICS_DUPLICATES,                         /*!< Reads dropped as duplicates of the previous frame */
+    METRICS_TORN,                               /*!< Reads dropped as torn */
+    METRICS_TX_ERRORS,                          /*!< Packets the network stack refused */
+    METRICS_RETRIES,                            /*!< Sensor read bursts tried again */
+    METRICS_RECOVERIES,                         /*!< I2C bus recoveries */
+    METRICS_PARTIAL,                            /*!< Frames published with pixels held from an earlier read */
+
+    METRICS_COUNTERS,                           /*!< Number of counters */
+} metrics_counter_t;
+
+/**
+ * \brief           Stage timer
+ * \note            Every field wraps around, a reader works on the difference of two snapshots
+ */
+typedef struct {
+    uint32_t count;                             /*!< Samples */
+    uint32_t sum_us;                            /*!< Sum of the samples */
+    uint16_t hist[METRICS_HIST_BUCKETS];        /*!< Samples per bucket */
+} metrics_timer_t;
+
+/**
+ * \brief           Metrics snapshot, cumulative since boot
+ */
+typedef struct {
+    metrics_timer_t timers[METRICS_STAGES];     /*!< Per stage timers */
+    uint32_t errors[METRICS_ERR_CODES];         /*!< Per \ref amg88_err_t counters, `errors[AMG88_OK]` unused */
+    uint32_t counters[METRICS_COUNTERS];        /*!< Event counters */
+} metrics_t;
+
+#if METRICS_ENABLE
+#define METRICS_START()             osal_cycles()
+#define METRICS_STOP(stage, start)  metrics_time((stage), osal_cycles() - (start))
+#define METRICS_ERROR(err)          metrics_error(err)
+#define METRICS_COUNT(counter, n)   metrics_count((counter), (n))
+#else
+#define METRICS_START()             0
+#define METRICS_STOP(stage, start)  ((void) (start))
+#define METRICS_ERROR(err)          ((void) (err))
+#define METRICS_COUNT(counter, n)   ((void) 0)
+#endif /* METRICS_ENABLE */
+
+/**
+ * \brief           Add a sample to a stage timer, use \ref METRICS_START / \ref METRICS_STOP
+ * \note            Start and stop on the same core, see \ref osal_cycles. Safe from any task
+ * \param[in]       stage: Stage
+ * \param[in]       cycles: Duration, \ref osal_cycles units
+ */
+void metrics_time(metrics_stage_t stage, uint32_t cycles);
+
+/**
+ * \brief           Count a sensor error, use \ref METRICS_ERROR
+ * \param[in]       err: Error code
+ */
+void metrics_error(amg88_err_t err);
+
+/**
+ * \brief           Add to an event counter, use \ref METRICS_COUNT
+ * \param[in]       counter: Counter
+ * \param[in]       n: Increment
+ */
+void metrics_count(metrics_counter_t counter, uint32_t n);
+
+/**
+ * \brief           Copy the current values
+ * \note            Fields are read one by one while the probes keep running, a snapshot is not atomic as a whole
+ * \param[out]      p_out: Snapshot, all zeros when the metrics are compiled out
+ */
+void metrics_snapshot(metrics_t* p_out);
+
+/**
+ * \brief           Difference of two snapshots, correct across wrap-arounds
+ * \param[in]       p_cur: Newer snapshot
+ * \param[in]       p_prev: Older snapshot
+ * \param[out]      p_out: `p_cur - p_prev`, may alias either input
+ */
+void metrics_delta(const metrics_t* p_cur, const metrics_t* p_prev, metrics_t* p_out);
+
+/**
+ * \brief           Latency under which a share of the samples fall
+ * \param[in]       p_timer: Timer, usually a delta
+ * \param[in]       pct: Share in percent, 1 to 100
+ * \return          Upper bound of the bucket holding that sample in us, `0` without samples,
+ *                  `UINT32_MAX` when it falls in the open last bucket
+ */
+uint32_t metrics_percentile_us(const metrics_timer_t* p_timer, uint8_t pct);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* METRICS_H */
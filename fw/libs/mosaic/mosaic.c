@@ -0,0 +1,101 @@
+/**
+ * \file            mosaic.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Stitch several 8x8 sensor frames into one wider frame
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "mosaic.h"
+
+#include <string.h>
+
+#define MOSAIC_LAST (MOSAIC_TILE_SIDE - 1)
+
+
+/* Source pixel shown at (x, y) of a tile, x/y in output orientation */
+static uint8_t
+mosaic_src_idx(const mosaic_tile_t* p_tile, uint8_t x, uint8_t y) {
+    uint8_t sx, sy;
+
+    switch (p_tile->rot) {
+        case MOSAIC_ROT_90:
+            sx = y;
+            sy = MOSAIC_LAST - x;
+            break;
+        case MOSAIC_ROT_180:
+            sx = MOSAIC_LAST - x;
+            sy = MOSAIC_LAST - y;
+            break;
+        case MOSAIC_ROT_270:
+            sx = MOSAIC_LAST - y;
+            sy = x;
+            break;
+        default:
+            sx = x;
+            sy = y;
+            break;
+    }
+
+    if (p_tile->mirror) {
+        sx = MOSAIC_LAST - sx;
+    }
+
+    return (uint8_t) (sy * MOSAIC_TILE_SIDE + sx);
+}
+
+mosaic_err_t
+mosaic_init(mosaic_t* p_mosaic, uint8_t cols, uint8_t rows, const mosaic_tile_t* p_tiles,
+            uint8_t n_tiles, int16_t fill) {
+    size_t width = (size_t) cols * MOSAIC_TILE_SIDE;
+
+    if (cols == 0 || rows == 0 || cols * rows > MOSAIC_MAX_TILES || n_tiles > cols * rows) {
+        return MOSAIC_ERR_GRID;
+    }
+
+    p_mosaic->cols = cols;
+    p_mosaic->rows = rows;
+    p_mosaic->n_tiles = n_tiles;
+    p_mosaic->fill = fill;
+    memset(p_mosaic->map, 0xFF, sizeof(p_mosaic->map));
+
+    for (uint8_t t = 0; t < n_tiles; ++t) {
+        const mosaic_tile_t* p_tile = &p_tiles[t];
+        uint16_t* p_map;
+
+        if (p_tile->col >= cols || p_tile->row >= rows) {
+            return MOSAIC_ERR_TILE;
+        }
+
+        p_map = &p_mosaic->map[p_tile->row * MOSAIC_TILE_SIDE * width + p_tile->col * MOSAIC_TILE_SIDE];
+        if (p_map[0] != MOSAIC_EMPTY) {
+            return MOSAIC_ERR_TILE;
+        }
+
+        for (uint8_t y = 0; y < MOSAIC_TILE_SIDE; ++y) {
+            for (uint8_t x = 0; x < MOSAIC_TILE_SIDE; ++x) {
+                p_map[y * width + x] = (uint16_t) (t * MOSAIC_TILE_SIZE + mosaic_src_idx(p_tile, x, y));
+            }
+        }
+    }
+
+    return MOSAIC_OK;
+}
+
+void
+mosaic_stitch(const mosaic_t* p_mosaic, const int16_t* const* p_frames, int16_t* p_out) {
+    size_t len = MOSAIC_WIDTH(p_mosaic) * MOSAIC_HEIGHT(p_mosaic);
+
+    for (size_t i = 0; i < len; ++i) {
+        uint16_t src = p_mosaic->map[i];
+        const int16_t* p_frame;
+
+        if (src == MOSAIC_EMPTY) {
+            p_out[i] = p_mosaic->fill;
+            continue;
+        }
+
+        p_frame = p_frames[src / MOSAIC_TILE_SIZE];
+        p_out[i] = p_frame != NULL ? p_frame[src % MOSAIC_TILE_SIZE] : p_mosaic->fill;
+    }
+}
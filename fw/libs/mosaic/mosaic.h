@@ -0,0 +1,104 @@
+/**
+ * \file            mosaic.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Stitch several 8x8 sensor frames into one wider frame
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef MOSAIC_H
+#define MOSAIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define MOSAIC_TILE_SIDE  8                     /*!< Tile (sensor) side, pixels */
+#define MOSAIC_TILE_SIZE  (MOSAIC_TILE_SIDE * MOSAIC_TILE_SIDE)
+#define MOSAIC_MAX_TILES  4                     /*!< Max grid cells, hence max sensors */
+#define MOSAIC_MAX_SIZE   (MOSAIC_MAX_TILES * MOSAIC_TILE_SIZE)
+#define MOSAIC_EMPTY      0xFFFF                /*!< Map entry of a pixel no tile covers */
+
+/**
+ * \brief           Output width of a mosaic, pixels
+ * \hideinitializer
+ */
+#define MOSAIC_WIDTH(p_mosaic)  ((size_t) (p_mosaic)->cols * MOSAIC_TILE_SIDE)
+
+/**
+ * \brief           Output height of a mosaic, pixels
+ * \hideinitializer
+ */
+#define MOSAIC_HEIGHT(p_mosaic) ((size_t) (p_mosaic)->rows * MOSAIC_TILE_SIDE)
+
+/**
+ * \brief           Errors
+ */
+typedef enum {
+    MOSAIC_OK = 0,                              /*!< Everything OK */
+    MOSAIC_ERR_GRID,                            /*!< Empty grid or more cells than \ref MOSAIC_MAX_TILES */
+    MOSAIC_ERR_TILE,                            /*!< Tile outside the grid or on an already taken cell */
+} mosaic_err_t;
+
+/**
+ * \brief           Clockwise rotation of a tile, as seen in the output
+ */
+typedef enum {
+    MOSAIC_ROT_0,                               /*!< As read from the sensor */
+    MOSAIC_ROT_90,                              /*!< 90 degrees clockwise */
+    MOSAIC_ROT_180,                             /*!< Upside down */
+    MOSAIC_ROT_270,                             /*!< 90 degrees counter-clockwise */
+} mosaic_rot_t;
+
+/**
+ * \brief           Placement of one sensor in the grid
+ */
+typedef struct {
+    uint8_t col;                                /*!< Grid column */
+    uint8_t row;                                /*!< Grid row */
+    mosaic_rot_t rot;                           /*!< Rotation, applied after the mirror */
+    bool mirror;                                /*!< Flip the sensor frame left to right */
+} mosaic_tile_t;
+
+/**
+ * \brief           Mosaic handler
+ * \note            The layout is resolved once into a gather map, so stitching is a single table-driven pass
+ */
+typedef struct {
+    uint8_t cols;                               /*!< Grid columns */
+    uint8_t rows;                               /*!< Grid rows */
+    uint8_t n_tiles;                            /*!< Tiles (sensors) */
+    int16_t fill;                               /*!< Value of uncovered pixels and of missing sensors */
+    uint16_t map[MOSAIC_MAX_SIZE];              /*!< Output pixel -> `tile * 64 + pixel`, or \ref MOSAIC_EMPTY */
+} mosaic_t;
+
+/**
+ * \brief           Resolve a layout
+ * \param[out]      p_mosaic: Mosaic handler
+ * \param[in]       cols: Grid columns
+ * \param[in]       rows: Grid rows
+ * \param[in]       p_tiles: One entry per sensor, index `i` takes the frame `i` of \ref mosaic_stitch
+ * \param[in]       n_tiles: Entries in `p_tiles`
+ * \param[in]       fill: Value of uncovered pixels and of missing sensors
+ * \return          \ref MOSAIC_OK on success, a member of \ref mosaic_err_t otherwise
+ */
+mosaic_err_t mosaic_init(mosaic_t* p_mosaic, uint8_t cols, uint8_t rows, const mosaic_tile_t* p_tiles,
+                         uint8_t n_tiles, int16_t fill);
+
+/**
+ * \brief           Stitch the sensor frames into the mosaic
+ * \param[in]       p_mosaic: Mosaic handler
+ * \param[in]       p_frames: One 8x8 row-major frame per tile, `NULL` entries are filled
+ * \param[out]      p_out: \ref MOSAIC_WIDTH x \ref MOSAIC_HEIGHT row-major output
+ */
+void mosaic_stitch(const mosaic_t* p_mosaic, const int16_t* const* p_frames, int16_t* p_out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MOSAIC_H */
@@ -0,0 +1,150 @@
+/**
+ * \file            osal.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Minimal OS abstraction (FreeRTOS on the ESP32, pthreads on Linux)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef OSAL_H
+#define OSAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#else
+#include <pthread.h>
+#include <time.h>
+#endif /* ESP_PLATFORM */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define OSAL_CORE_ANY   (-1)                    /*!< Do not pin the task to a core */
+#define OSAL_WAIT_FOREVER UINT32_MAX            /*!< Block without timeout */
+
+#ifdef ESP_PLATFORM
+#define OSAL_CYCLES_PER_US CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ /*!< \ref osal_cycles rate */
+#else
+#define OSAL_CYCLES_PER_US 1000                 /*!< \ref osal_cycles rate, nanoseconds on Linux */
+#endif /* ESP_PLATFORM */
+
+/**
+ * \brief           OSAL error codes
+ */
+typedef enum {
+    OSAL_OK,                                    /*!< Everything is Ok */
+    OSAL_ERR,                                   /*!< Generic error */
+    OSAL_ERR_TIMEOUT,                           /*!< Timeout error */
+} osal_err_t;
+
+/**
+ * \brief           Task entry point
+ * \param[in]       arg: User argument
+ */
+typedef void (*osal_task_fn)(void* arg);
+
+#ifdef ESP_PLATFORM
+typedef TaskHandle_t osal_task_t;
+
+typedef struct {
+    SemaphoreHandle_t handle;                   /*!< FreeRTOS semaphore */
+    StaticSemaphore_t storage;                  /*!< Static storage, no heap */
+} osal_sem_t;
+#else
+typedef pthread_t osal_task_t;
+
+typedef struct {
+    pthread_mutex_t mutex;                      /*!< Protects count */
+    pthread_cond_t cond;                        /*!< Signalled on give */
+    uint32_t count;                             /*!< Pending gives */
+} osal_sem_t;
+#endif /* ESP_PLATFORM */
+
+/**
+ * \brief           Create a task
+ * \param[out]      p_task: Task handle
+ * \param[in]       name: Task name
+ * \param[in]       fn: Task entry point, the task ends when it returns
+ * \param[in]       arg: User argument
+ * \param[in]       stack: Stack size in bytes (ignored on Linux)
+ * \param[in]       prio: Priority (ignored on Linux)
+ * \param[in]       core: Core to pin the task to, \ref OSAL_CORE_ANY to let the OS choose
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t osal_task_create(osal_task_t* p_task, const char* name, osal_task_fn fn, void* arg,
+                            uint32_t stack, uint8_t prio, int8_t core);
+
+/**
+ * \brief           Init a counting semaphore with a zero count
+ * \param[out]      p_sem: Semaphore
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t osal_sem_init(osal_sem_t* p_sem);
+
+/**
+ * \brief           Increment the semaphore count
+ * \param[in]       p_sem: Semaphore
+ */
+void osal_sem_give(osal_sem_t* p_sem);
+
+/**
+ * \brief           Wait for the semaphore count to be positive and decrement it
+ * \param[in]       p_sem: Semaphore
+ * \param[in]       timeout_ms: Max time to wait, \ref OSAL_WAIT_FOREVER to block
+ * \return          \ref OSAL_OK on success, \ref OSAL_ERR_TIMEOUT on timeout
+ */
+osal_err_t osal_sem_take(osal_sem_t* p_sem, uint32_t timeout_ms);
+
+/**
+ * \brief           Monotonic time since boot
+ * \return          Time in microseconds
+ */
+uint64_t osal_time_us(void);
+
+/**
+ * \brief           Free-running cycle counter, for timing short code sections
+ * \note            Wraps around, only the difference of two reads is meaningful. On the ESP32 every core has
+ *                  its own counter: both reads have to be done on the same core (a pinned task)
+ * \return          Cycles, \ref OSAL_CYCLES_PER_US per microsecond
+ */
+static inline uint32_t
+osal_cycles(void) {
+#ifdef ESP_PLATFORM
+    return (uint32_t) esp_cpu_get_ccount();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t) ((uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec);
+#endif /* ESP_PLATFORM */
+}
+
+/**
+ * \brief           Sleep the calling task
+ * \param[in]       ms: Time to sleep in milliseconds
+ */
+void osal_delay_ms(uint32_t ms);
+
+/**
+ * \brief           Sleep until an absolute wake-up time, then advance it by a period
+ * \note            Keeps a fixed cadence regardless of the time spent between calls. Never returns before the
+ *                  wake-up time, the FreeRTOS backend rounds up to the tick.
+ * \param[inout]    p_wake_us: Next wake-up time (\ref osal_time_us base)
+ * \param[in]       period_us: Period, `0` to just sleep until `*p_wake_us`
+ */
+void osal_delay_until(uint64_t* p_wake_us, uint32_t period_us);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OSAL_H */
@@ -0,0 +1,100 @@
+/**
+ * \file            osal_freertos.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Minimal OS abstraction, FreeRTOS backend
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifdef ESP_PLATFORM
+
+#include "osal.h"
+
+#include <stdatomic.h>
+
+#include "esp_timer.h"
+
+#define OSAL_MAX_TASKS 16
+
+/* Vars */
+static struct {
+    osal_task_fn fn;
+    void* arg;
+} task_entries[OSAL_MAX_TASKS];
+static atomic_uint task_count;
+
+
+static void
+osal_task_entry(void* arg) {
+    size_t idx = (size_t) arg;
+
+    task_entries[idx].fn(task_entries[idx].arg);
+
+    /* FreeRTOS tasks must not return */
+    vTaskDelete(NULL);
+}
+
+osal_err_t
+osal_task_create(osal_task_t* p_task, const char* name, osal_task_fn fn, void* arg,
+                 uint32_t stack, uint8_t prio, int8_t core) {
+    BaseType_t ret;
+    size_t idx;
+
+    idx = atomic_fetch_add(&task_count, 1);
+    if (idx >= OSAL_MAX_TASKS) {
+        return OSAL_ERR;
+    }
+    task_entries[idx].fn = fn;
+    task_entries[idx].arg = arg;
+
+    ret = xTaskCreatePinnedToCore(osal_task_entry, name, stack, (void*) idx, prio, p_task,
+                                  core == OSAL_CORE_ANY ? tskNO_AFFINITY : core);
+
+    return ret == pdPASS ? OSAL_OK : OSAL_ERR;
+}
+
+osal_err_t
+osal_sem_init(osal_sem_t* p_sem) {
+    p_sem->handle = xSemaphoreCreateCountingStatic(UINT32_MAX, 0, &p_sem->storage);
+
+    return p_sem->handle != NULL ? OSAL_OK : OSAL_ERR;
+}
+
+void
+osal_sem_give(osal_sem_t* p_sem) {
+    xSemaphoreGive(p_sem->handle);
+}
+
+osal_err_t
+osal_sem_take(osal_sem_t* p_sem, uint32_t timeout_ms) {
+    TickType_t ticks = timeout_ms == OSAL_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    return xSemaphoreTake(p_sem->handle, ticks) == pdTRUE ? OSAL_OK : OSAL_ERR_TIMEOUT;
+}
+
+uint64_t
+osal_time_us(void) {
+    return (uint64_t) esp_timer_get_time();
+}
+
+void
+osal_delay_ms(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void
+osal_delay_until(uint64_t* p_wake_us, uint32_t period_us) {
+    uint64_t now = osal_time_us();
+
+    /* Missed whole periods are skipped instead of bursting to catch up */
+    if (now >= *p_wake_us + period_us) {
+        *p_wake_us = now;
+    }
+    /* Rounded up to whole ticks, waking up late is fine, early is not */
+    if (*p_wake_us > now) {
+        vTaskDelay((TickType_t) ((*p_wake_us - now + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000)));
+    }
+    *p_wake_us += period_us;
+}
+
+#endif /* ESP_PLATFORM */
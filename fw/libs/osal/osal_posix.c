@@ -0,0 +1,164 @@
+/**
+ * \file            osal_posix.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Minimal OS abstraction, pthreads backend
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef ESP_PLATFORM
+
+#define _GNU_SOURCE
+
+#include "osal.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define OSAL_MAX_TASKS 64
+
+/* Vars */
+static struct {
+    osal_task_fn fn;
+    void* arg;
+} task_entries[OSAL_MAX_TASKS];
+static atomic_uint task_count;
+
+
+static void*
+osal_task_entry(void* arg) {
+    size_t idx = (size_t) arg;
+
+    task_entries[idx].fn(task_entries[idx].arg);
+
+    return NULL;
+}
+
+osal_err_t
+osal_task_create(osal_task_t* p_task, const char* name, osal_task_fn fn, void* arg,
+                 uint32_t stack, uint8_t prio, int8_t core) {
+    size_t idx;
+
+    (void) stack;
+    (void) prio;
+
+    idx = atomic_fetch_add(&task_count, 1);
+    if (idx >= OSAL_MAX_TASKS) {
+        return OSAL_ERR;
+    }
+    task_entries[idx].fn = fn;
+    task_entries[idx].arg = arg;
+
+    if (pthread_create(p_task, NULL, osal_task_entry, (void*) idx) != 0) {
+        return OSAL_ERR;
+    }
+    /* Like FreeRTOS tasks, nobody joins them */
+    pthread_detach(*p_task);
+    pthread_setname_np(*p_task, name);
+
+    if (core != OSAL_CORE_ANY) {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        pthread_setaffinity_np(*p_task, sizeof(set), &set);
+    }
+
+    return OSAL_OK;
+}
+
+osal_err_t
+osal_sem_init(osal_sem_t* p_sem) {
+    pthread_condattr_t attr;
+
+    p_sem->count = 0;
+    if (pthread_mutex_init(&p_sem->mutex, NULL) != 0) {
+        return OSAL_ERR;
+    }
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (pthread_cond_init(&p_sem->cond, &attr) != 0) {
+        return OSAL_ERR;
+    }
+
+    return OSAL_OK;
+}
+
+void
+osal_sem_give(osal_sem_t* p_sem) {
+    pthread_mutex_lock(&p_sem->mutex);
+    p_sem->count++;
+    pthread_cond_signal(&p_sem->cond);
+    pthread_mutex_unlock(&p_sem->mutex);
+}
+
+osal_err_t
+osal_sem_take(osal_sem_t* p_sem, uint32_t timeout_ms) {
+    struct timespec ts;
+    int ret = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long) (timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&p_sem->mutex);
+    while (p_sem->count == 0 && ret != ETIMEDOUT) {
+        if (timeout_ms == OSAL_WAIT_FOREVER) {
+            ret = pthread_cond_wait(&p_sem->cond, &p_sem->mutex);
+        } else {
+            ret = pthread_cond_timedwait(&p_sem->cond, &p_sem->mutex, &ts);
+        }
+    }
+    if (p_sem->count > 0) {
+        p_sem->count--;
+        ret = 0;
+    }
+    pthread_mutex_unlock(&p_sem->mutex);
+
+    return ret == 0 ? OSAL_OK : OSAL_ERR_TIMEOUT;
+}
+
+uint64_t
+osal_time_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000ULL + (uint64_t) ts.tv_nsec / 1000ULL;
+}
+
+void
+osal_delay_ms(uint32_t ms) {
+    struct timespec ts = {
+        .tv_sec = ms / 1000,
+        .tv_nsec = (long) (ms % 1000) * 1000000L,
+    };
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+void
+osal_delay_until(uint64_t* p_wake_us, uint32_t period_us) {
+    uint64_t now = osal_time_us();
+    struct timespec ts;
+
+    /* Missed whole periods are skipped instead of bursting to catch up */
+    if (now >= *p_wake_us + period_us) {
+        *p_wake_us = now;
+    }
+
+    ts.tv_sec = (time_t) (*p_wake_us / 1000000ULL);
+    ts.tv_nsec = (long) (*p_wake_us % 1000000ULL) * 1000L;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+    *p_wake_us += period_us;
+}
+
+#endif /* ESP_PLATFORM */
@@ -0,0 +1,268 @@
+/**
+ * \file            pipeline.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Acquisition/processing/network pipeline
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "pipeline.h"
+#include "metrics/metrics.h"
+
+#include <string.h>
+
+
+/* Sleep in slices, so a stop or a period change is seen within PIPELINE_WAIT_MS even at slow rates */
+static void
+pipeline_sleep_until(pipeline_t* p_pipe, uint64_t wake_us) {
+    uint64_t now_us, slice_us;
+
+    while (atomic_load(&p_pipe->running) && atomic_load(&p_pipe->period_req) == 0) {
+        now_us = osal_time_us();
+        if (now_us >= wake_us) {
+            break;
+        }
+        slice_us = wake_us - now_us > PIPELINE_WAIT_MS * 1000 ? now_us + PIPELINE_WAIT_MS * 1000 : wake_us;
+        osal_delay_until(&slice_us, 0);
+    }
+}
+
+/* Merge a read into the held frame both ways: new pixels in, held ones out to the gaps */
+static void
+pipeline_hold(pipeline_t* p_pipe, amg88_frame_raw_t* p_raw, const amg88_frame_status_t* p_status) {
+    if (p_status->err == AMG88_OK) {
+        p_pipe->last = *p_raw;
+        p_pipe->have_last = true;
+        return;
+    }
+
+    atomic_fetch_add(&p_pipe->partial, 1);
+    METRICS_COUNT(METRICS_PARTIAL, 1);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        uint8_t* p_dst = (p_status->valid >> i) & 1 ? &p_pipe->last.pixels[2 * i] : &p_raw->pixels[2 * i];
+        const uint8_t* p_src = (p_status->valid >> i) & 1 ? &p_raw->pixels[2 * i] : &p_pipe->last.pixels[2 * i];
+
+        p_dst[0] = p_src[0];
+        p_dst[1] = p_src[1];
+    }
+    if (p_status->thermistor) {
+        memcpy(p_pipe->last.thermistor, p_raw->thermistor, sizeof(p_raw->thermistor));
+    } else {
+        memcpy(p_raw->thermistor, p_pipe->last.thermistor, sizeof(p_raw->thermistor));
+    }
+}
+
+static void
+pipeline_acq_task(void* arg) {
+    pipeline_t* p_pipe = (pipeline_t*) arg;
+    pipeline_frame_t* p_frame;
+    uint64_t wake_us, start_us;
+    uint32_t seq = 0, period_us, cycles;
+    amg88_frame_status_t status;
+
+    wake_us = osal_time_us();
+    if (p_pipe->cfg.sync) {
+        frame_sync_init(&p_pipe->sync, p_pipe->cfg.period_us, wake_us);
+    }
+
+    while (atomic_load(&p_pipe->running)) {
+        /* New sensor rate: read right away and lock again on the new period */
+        period_us = atomic_exchange(&p_pipe->period_req, 0);
+        if (period_us != 0) {
+            p_pipe->cfg.period_us = period_us;
+            wake_us = osal_time_us();
+            if (p_pipe->cfg.sync) {
+                frame_sync_init(&p_pipe->sync, period_us, wake_us);
+            }
+        }
+
+        if (p_pipe->cfg.sync) {
+            wake_us = frame_sync_next_read(&p_pipe->sync);
+            pipeline_sleep_until(p_pipe, wake_us);
+        } else {
+            /* Same catch-up rule as osal_delay_until: a missed period restarts the schedule from now */
+            if (osal_time_us() >= wake_us + p_pipe->cfg.period_us) {
+                wake_us = osal_time_us();
+            }
+            pipeline_sleep_until(p_pipe, wake_us);
+            wake_us += p_pipe->cfg.period_us;
+        }
+        if (!atomic_load(&p_pipe->running) || atomic_load(&p_pipe->period_req) != 0) {
+            continue;
+        }
+
+        /* The ring never blocks us, a late consumer just loses the older frames */
+        p_frame = (pipeline_frame_t*) frame_ring_write_slot(&p_pipe->raw_ring);
+        start_us = osal_time_us();
+        cycles = METRICS_START();
+        amg88_get_frame_raw_status(p_pipe->cfg.p_dev, &p_frame->raw, p_pipe->cfg.read_thermistor, &status);
+        METRICS_STOP(METRICS_READ, cycles);
+        METRICS_COUNT(METRICS_RETRIES, status.retries);
+        METRICS_COUNT(METRICS_RECOVERIES, status.recoveries);
+        if (status.err != AMG88_OK) {
+            METRICS_ERROR(status.err);
+        }
+
+        /* Some bursts lost for good: hold their pixels, unless there is nothing to hold yet */
+        if (status.valid == 0 || (status.err != AMG88_OK && !p_pipe->have_last)) {
+            atomic_fetch_add(&p_pipe->read_errors, 1);
+            if (p_pipe->cfg.sync) {
+                frame_sync_read_failed(&p_pipe->sync, osal_time_us());
+            }
+            continue;
+        }
+        pipeline_hold(p_pipe, &p_frame->raw, &status);
+        p_frame->valid = status.valid;
+        p_frame->ts_us = osal_time_us();
+
+        if (p_pipe->cfg.sync) {
+            switch (frame_sync_check(&p_pipe->sync, &p_frame->raw, start_us, p_frame->ts_us)) {
+                case FRAME_SYNC_DUPLICATE:
+                    atomic_fetch_add(&p_pipe->duplicates, 1);
+                    METRICS_COUNT(METRICS_DUPLICATES, 1);
+                    continue;
+                case FRAME_SYNC_TORN:
+                    atomic_fetch_add(&p_pipe->torn, 1);
+                    METRICS_COUNT(METRICS_TORN, 1);
+                    continue;
+                default:
+                    break;
+            }
+        }
+        p_frame->seq = seq++;
+
+        METRICS_COUNT(METRICS_FRAMES, 1);
+        if (frame_ring_publish(&p_pipe->raw_ring)) {
+            METRICS_COUNT(METRICS_DROPPED, 1);
+        }
+        osal_sem_give(&p_pipe->raw_sem);
+    }
+
+    osal_sem_give(&p_pipe->done_sem);
+}
+
+static void
+pipeline_proc_task(void* arg) {
+    pipeline_t* p_pipe = (pipeline_t*) arg;
+    const pipeline_frame_t* p_frame;
+    void* p_out;
+    uint32_t cycles;
+    bool publish;
+
+    while (atomic_load(&p_pipe->running)) {
+        if (osal_sem_take(&p_pipe->raw_sem, PIPELINE_WAIT_MS) != OSAL_OK) {
+            continue;
+        }
+
+        p_frame = (const pipeline_frame_t*) frame_ring_acquire(&p_pipe->raw_ring);
+        if (p_frame == NULL) {
+            continue;
+        }
+
+        p_out = frame_ring_write_slot(&p_pipe->out_ring);
+        cycles = METRICS_START();
+        publish = p_pipe->cfg.process(p_frame, p_out, p_pipe->cfg.process_arg);
+        METRICS_STOP(METRICS_PROCESS, cycles);
+        if (publish && p_pipe->cfg.send != NULL) {
+            if (frame_ring_publish(&p_pipe->out_ring)) {
+                METRICS_COUNT(METRICS_DROPPED, 1);
+            }
+            osal_sem_give(&p_pipe->out_sem);
+        }
+    }
+
+    osal_sem_give(&p_pipe->done_sem);
+}
+
+static void
+pipeline_net_task(void* arg) {
+    pipeline_t* p_pipe = (pipeline_t*) arg;
+    const void* p_out;
+    uint32_t cycles;
+
+    while (atomic_load(&p_pipe->running)) {
+        if (osal_sem_take(&p_pipe->out_sem, PIPELINE_WAIT_MS) != OSAL_OK) {
+            continue;
+        }
+
+        p_out = frame_ring_acquire(&p_pipe->out_ring);
+        if (p_out != NULL) {
+            cycles = METRICS_START();
+            p_pipe->cfg.send(p_out, p_pipe->cfg.send_arg);
+            METRICS_STOP(METRICS_SEND, cycles);
+        }
+    }
+
+    osal_sem_give(&p_pipe->done_sem);
+}
+
+osal_err_t
+pipeline_start(pipeline_t* p_pipe, const pipeline_cfg_t* p_cfg) {
+    memcpy(&p_pipe->cfg, p_cfg, sizeof(p_pipe->cfg));
+
+    frame_ring_init(&p_pipe->raw_ring, p_pipe->frames, sizeof(p_pipe->frames[0]));
+    frame_ring_init(&p_pipe->out_ring, p_cfg->p_out_buf, p_cfg->out_size);
+
+    if (osal_sem_init(&p_pipe->raw_sem) != OSAL_OK
+        || osal_sem_init(&p_pipe->out_sem) != OSAL_OK
+        || osal_sem_init(&p_pipe->done_sem) != OSAL_OK) {
+        return OSAL_ERR;
+    }
+
+    atomic_init(&p_pipe->running, true);
+    atomic_init(&p_pipe->read_errors, 0);
+    atomic_init(&p_pipe->partial, 0);
+    p_pipe->have_last = false;
+    atomic_init(&p_pipe->duplicates, 0);
+    atomic_init(&p_pipe->torn, 0);
+    atomic_init(&p_pipe->period_req, 0);
+    p_pipe->n_tasks = 0;
+
+    /* Consumers first, so no frame is published without someone to take it */
+    if (p_cfg->send != NULL) {
+        if (osal_task_create(&p_pipe->net_task, "pipe_net", pipeline_net_task, p_pipe,
+                             PIPELINE_STACK_SIZE, p_cfg->proc_prio, p_cfg->proc_core) != OSAL_OK) {
+            pipeline_stop(p_pipe);
+            return OSAL_ERR;
+        }
+        p_pipe->n_tasks++;
+    }
+    if (osal_task_create(&p_pipe->proc_task, "pipe_proc", pipeline_proc_task, p_pipe,
+                         PIPELINE_STACK_SIZE, p_cfg->proc_prio, p_cfg->proc_core) != OSAL_OK) {
+        pipeline_stop(p_pipe);
+        return OSAL_ERR;
+    }
+    p_pipe->n_tasks++;
+    if (osal_task_create(&p_pipe->acq_task, "pipe_acq", pipeline_acq_task, p_pipe,
+                         PIPELINE_STACK_SIZE, p_cfg->acq_prio, p_cfg->acq_core) != OSAL_OK) {
+        pipeline_stop(p_pipe);
+        return OSAL_ERR;
+    }
+    p_pipe->n_tasks++;
+
+    return OSAL_OK;
+}
+
+void
+pipeline_stop(pipeline_t* p_pipe) {
+    atomic_store(&p_pipe->running, false);
+
+    for (; p_pipe->n_tasks > 0; --p_pipe->n_tasks) {
+        osal_sem_take(&p_pipe->done_sem, OSAL_WAIT_FOREVER);
+    }
+}
+
+void
+pipeline_set_period(pipeline_t* p_pipe, uint32_t period_us) {
+    atomic_store(&p_pipe->period_req, period_us);
+}
+
+void
+pipeline_get_stats(pipeline_t* p_pipe, pipeline_stats_t* p_stats) {
+    p_stats->read_errors = atomic_load(&p_pipe->read_errors);
+    p_stats->partial = atomic_load(&p_pipe->partial);
+    p_stats->duplicates = atomic_load(&p_pipe->duplicates);
+    p_stats->torn = atomic_load(&p_pipe->torn);
+    frame_ring_get_stats(&p_pipe->raw_ring, &p_stats->raw);
+    frame_ring_get_stats(&p_pipe->out_ring, &p_stats->out);
+}
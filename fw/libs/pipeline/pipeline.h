@@ -0,0 +1,156 @@
+/**
+ * \file            pipeline.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Acquisition/processing/network pipeline
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "amg88/amg88.h"
+#include "frame_ring/frame_ring.h"
+#include "frame_sync/frame_sync.h"
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define PIPELINE_STACK_SIZE 4096                /*!< Stack size of every pipeline task */
+#define PIPELINE_WAIT_MS    100                 /*!< Max time a consumer waits before checking for a stop */
+
+/**
+ * \brief           Frame handed from the acquisition task to the processing task
+ */
+typedef struct {
+    amg88_frame_raw_t raw;                      /*!< Raw sensor frame */
+    uint64_t valid;                             /*!< Bit `i` set when pixel `i` is from this read, the others
+                                                     are held from the last read that had them */
+    uint32_t seq;                               /*!< Acquisition sequence number */
+    uint64_t ts_us;                             /*!< Acquisition timestamp, \ref osal_time_us base */
+} pipeline_frame_t;
+
+/**
+ * \brief           Processing stage
+ * \param[in]       p_frame: Latest acquired frame, valid until the function returns
+ * \param[out]      p_out: Output slot (`out_size` bytes) handed to the network stage
+ * \param[in]       arg: User argument
+ * \return          `true` to hand `p_out` over to the network stage, `false` to discard it
+ */
+typedef bool (*pipeline_process_fn)(const pipeline_frame_t* p_frame, void* p_out, void* arg);
+
+/**
+ * \brief           Network stage
+ * \param[in]       p_out: Latest processing output, valid until the function returns
+ * \param[in]       arg: User argument
+ */
+typedef void (*pipeline_send_fn)(const void* p_out, void* arg);
+
+/**
+ * \brief           Pipeline configuration
+ */
+typedef struct {
+    amg88_dev_t* p_dev;                         /*!< Sensor handler */
+    uint32_t period_us;                         /*!< Acquisition period, the sensor frame period with `sync` */
+    bool read_thermistor;                       /*!< Read the thermistor with every frame */
+    bool sync;                                  /*!< Phase-lock the reads to the sensor updates and drop duplicate
+                                                     and torn frames, see \ref frame_sync_t */
+
+    int8_t acq_core;                            /*!< Core of the acquisition task */
+    int8_t proc_core;                           /*!< Core of the processing and network tasks */
+    uint8_t acq_prio;                           /*!< Priority of the acquisition task */
+    uint8_t proc_prio;                          /*!< Priority of the processing and network tasks */
+
+    pipeline_process_fn process;                /*!< Processing stage */
+    void* process_arg;                          /*!< Processing stage user argument */
+    pipeline_send_fn send;                      /*!< Network stage, `NULL` to run without it */
+    void* send_arg;                             /*!< Network stage user argument */
+
+    void* p_out_buf;                            /*!< Output ring storage, \ref FRAME_RING_SLOTS * `out_size` bytes */
+    size_t out_size;                            /*!< Size of a processing output */
+} pipeline_cfg_t;
+
+/**
+ * \brief           Pipeline handler, all the storage is preallocated in it
+ */
+typedef struct {
+    pipeline_cfg_t cfg;                         /*!< Configuration */
+
+    pipeline_frame_t frames[FRAME_RING_SLOTS];  /*!< Acquisition ring storage */
+    frame_sync_t sync;                          /*!< Frame sync state, acquisition task only */
+    amg88_frame_raw_t last;                     /*!< Last value read of every pixel, acquisition task only */
+    bool have_last;                             /*!< `last` holds a full frame */
+    frame_ring_t raw_ring;                      /*!< Acquisition -> processing ring */
+    frame_ring_t out_ring;                      /*!< Processing -> network ring */
+
+    osal_sem_t raw_sem;                         /*!< Signals a new acquired frame */
+    osal_sem_t out_sem;                         /*!< Signals a new processing output */
+    osal_sem_t done_sem;                        /*!< Signals a task exit */
+
+    atomic_bool running;                        /*!< Cleared to stop the tasks */
+    atomic_uint_fast32_t read_errors;           /*!< Failed sensor reads */
+    atomic_uint_fast32_t partial;               /*!< Reads published with held pixels */
+    atomic_uint_fast32_t duplicates;            /*!< Reads dropped as duplicates */
+    atomic_uint_fast32_t torn;                  /*!< Reads dropped as torn */
+    atomic_uint_fast32_t period_req;            /*!< Requested read period, `0` when none is pending */
+    uint8_t n_tasks;                            /*!< Running tasks */
+
+    osal_task_t acq_task;                       /*!< Acquisition task */
+    osal_task_t proc_task;                      /*!< Processing task */
+    osal_task_t net_task;                       /*!< Network task */
+} pipeline_t;
+
+/**
+ * \brief           Pipeline statistics
+ */
+typedef struct {
+    uint32_t read_errors;                       /*!< Failed sensor reads */
+    uint32_t partial;                           /*!< Reads published with held pixels */
+    uint32_t duplicates;                        /*!< Reads dropped as duplicates */
+    uint32_t torn;                              /*!< Reads dropped as torn */
+    frame_ring_stats_t raw;                     /*!< Acquisition -> processing ring stats */
+    frame_ring_stats_t out;                     /*!< Processing -> network ring stats */
+} pipeline_stats_t;
+
+/**
+ * \brief           Start the pipeline tasks
+ * \param[out]      p_pipe: Pipeline handler
+ * \param[in]       p_cfg: Configuration, copied
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t pipeline_start(pipeline_t* p_pipe, const pipeline_cfg_t* p_cfg);
+
+/**
+ * \brief           Stop the pipeline and wait for its tasks to end
+ * \param[in]       p_pipe: Pipeline handler
+ */
+void pipeline_stop(pipeline_t* p_pipe);
+
+/**
+ * \brief           Change the read period, after the sensor frame rate was changed
+ * \note            Safe from any task, the processing stage included. The acquisition task picks it up
+ *                  within \ref PIPELINE_WAIT_MS, reads right away and, with `sync`, locks again
+ * \param[in]       p_pipe: Pipeline handler
+ * \param[in]       period_us: New period, nominal sensor frame period with `sync`
+ */
+void pipeline_set_period(pipeline_t* p_pipe, uint32_t period_us);
+
+/**
+ * \brief           Get the pipeline statistics
+ * \param[in]       p_pipe: Pipeline handler
+ * \param[out]      p_stats: Statistics
+ */
+void pipeline_get_stats(pipeline_t* p_pipe, pipeline_stats_t* p_stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* PIPELINE_H */
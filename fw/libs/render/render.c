@@ -0,0 +1,204 @@
+/**
+ * \file            render.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           False-color frame renderer (RGB565/RGB888)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "render.h"
+
+#include <string.h>
+
+/**
+ * \brief           Palette key point, entries in between are linearly interpolated
+ */
+typedef struct {
+    uint8_t idx;
+    uint8_t r, g, b;
+} render_key_t;
+
+static const render_key_t palette_iron[] = {
+    {   0,   0,   0,   0 },
+    {  48,  40,   0, 120 },
+    {  96, 140,   0, 150 },
+    { 144, 220,  40,  60 },
+    { 192, 250, 140,   0 },
+    { 224, 255, 210,  40 },
+    { 255, 255, 255, 255 },
+};
+
+static const render_key_t palette_rainbow[] = {
+    {   0,   0,   0, 255 },
+    {  64,   0, 255, 255 },
+    { 128,   0, 255,   0 },
+    { 192, 255, 255,   0 },
+    { 255, 255,   0,   0 },
+};
+
+static const render_key_t palette_gray[] = {
+    {   0,   0,   0,   0 },
+    { 255, 255, 255, 255 },
+};
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+static void
+render_build_lut(render_t* p_render, const render_key_t* p_keys, size_t n_keys) {
+    for (size_t k = 0; k + 1 < n_keys; ++k) {
+        const render_key_t* a = &p_keys[k];
+        const render_key_t* b = &p_keys[k + 1];
+        int32_t span = b->idx - a->idx;
+
+        for (int32_t i = a->idx; i <= b->idx; ++i) {
+            int32_t t = i - a->idx;
+            /* Weighted sum of the two keys, all positive so the rounding is exact at both ends */
+            uint8_t r = (uint8_t) ((a->r * (span - t) + b->r * t + span / 2) / span);
+            uint8_t g = (uint8_t) ((a->g * (span - t) + b->g * t + span / 2) / span);
+            uint8_t bl = (uint8_t) ((a->b * (span - t) + b->b * t + span / 2) / span);
+            uint16_t c565 = (uint16_t) (((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (bl >> 3));
+            uint8_t* p_entry = &p_render->lut[i * 3];
+
+            switch (p_render->format) {
+                case RENDER_RGB565:
+                    p_entry[0] = (uint8_t) c565;
+                    p_entry[1] = (uint8_t) (c565 >> 8);
+                    break;
+                case RENDER_RGB565_BE:
+                    p_entry[0] = (uint8_t) (c565 >> 8);
+                    p_entry[1] = (uint8_t) c565;
+                    break;
+                default:
+                    p_entry[0] = r;
+                    p_entry[1] = g;
+                    p_entry[2] = bl;
+                    break;
+            }
+        }
+    }
+}
+
+void
+render_init(render_t* p_render, render_palette_t palette, render_format_t format) {
+    memset(p_render, 0, sizeof(*p_render));
+    p_render->format = format;
+    p_render->lo = INT16_MIN;
+    p_render->hi = INT16_MAX;
+
+    switch (palette) {
+        case RENDER_PALETTE_RAINBOW:
+            render_build_lut(p_render, palette_rainbow, ARRAY_LEN(palette_rainbow));
+            break;
+        case RENDER_PALETTE_GRAY:
+            render_build_lut(p_render, palette_gray, ARRAY_LEN(palette_gray));
+            break;
+        default:
+            render_build_lut(p_render, palette_iron, ARRAY_LEN(palette_iron));
+            break;
+    }
+}
+
+/* Window kept at least 1 wide and inside int16, a low end of INT16_MAX would wrap the high end */
+static void
+render_apply_window(render_t* p_render, int32_t lo, int32_t hi) {
+    lo = lo < INT16_MIN ? INT16_MIN : lo;
+    lo = lo > INT16_MAX - 1 ? INT16_MAX - 1 : lo;
+    hi = hi > INT16_MAX ? INT16_MAX : hi;
+    hi = hi > lo ? hi : lo + 1;
+    p_render->lo = (int16_t) lo;
+    p_render->hi = (int16_t) hi;
+}
+
+void
+render_set_window(render_t* p_render, int16_t lo, int16_t hi) {
+    p_render->auto_range = false;
+    render_apply_window(p_render, lo, hi);
+}
+
+void
+render_set_auto(render_t* p_render, uint8_t smooth_shift, int16_t min_span) {
+    p_render->auto_range = true;
+    p_render->smooth_shift = smooth_shift;
+    p_render->min_span = min_span > 0 ? min_span : 1;
+    p_render->primed = false;
+}
+
+void
+render_update_range(render_t* p_render, int16_t min, int16_t max) {
+    int32_t lo, hi, mid;
+
+    if (!p_render->auto_range) {
+        return;
+    }
+
+    /* Widen around the centre up to the minimum span */
+    lo = min;
+    hi = max;
+    if (hi - lo < p_render->min_span) {
+        mid = (lo + hi) / 2;
+        lo = mid - p_render->min_span / 2;
+        hi = lo + p_render->min_span;
+    }
+
+    if (!p_render->primed) {
+        p_render->lo_q8 = lo * 256;
+        p_render->hi_q8 = hi * 256;
+        p_render->primed = true;
+    } else {
+        p_render->lo_q8 += (lo * 256 - p_render->lo_q8) >> p_render->smooth_shift;
+        p_render->hi_q8 += (hi * 256 - p_render->hi_q8) >> p_render->smooth_shift;
+    }
+
+    render_apply_window(p_render, p_render->lo_q8 >> 8, p_render->hi_q8 >> 8);
+}
+
+/* Palette index of a value, window and scale are per frame */
+static inline const uint8_t*
+render_entry(const render_t* p_render, int32_t v, uint32_t span, uint32_t scale) {
+    uint32_t off;
+
+    /* Clamped to the window first, so the product always fits in 32 bits */
+    v -= p_render->lo;
+    off = v < 0 ? 0 : (uint32_t) v;
+    off = off > span ? span : off;
+
+    return &p_render->lut[((off * scale) >> 16) * 3];
+}
+
+void
+render_frame(const render_t* p_render, const int16_t* p_in, size_t width, size_t height,
+             uint8_t* p_out, size_t stride) {
+    uint32_t span, scale;
+
+    /* Window to palette index as a 16.16 factor, the only division of the frame. Rounded up so the high end
+       reaches the last entry, `span * scale` still stays below `RENDER_LUT_SIZE << 16` */
+    span = (uint32_t) (p_render->hi - p_render->lo);
+    scale = (((uint32_t) (RENDER_LUT_SIZE - 1) << 16) + span - 1) / span;
+
+    for (size_t r = 0; r < height; ++r) {
+        const int16_t* p_row = &p_in[r * width];
+        uint8_t* p_dst = &p_out[r * stride];
+
+        if (p_render->format == RENDER_RGB888) {
+            for (size_t c = 0; c < width; ++c, p_dst += 3) {
+                const uint8_t* p_entry = render_entry(p_render, p_row[c], span, scale);
+
+                p_dst[0] = p_entry[0];
+                p_dst[1] = p_entry[1];
+                p_dst[2] = p_entry[2];
+            }
+        } else {
+            for (size_t c = 0; c < width; ++c, p_dst += 2) {
+                const uint8_t* p_entry = render_entry(p_render, p_row[c], span, scale);
+
+                p_dst[0] = p_entry[0];
+                p_dst[1] = p_entry[1];
+            }
+        }
+    }
+}
+
+size_t
+render_bpp(render_format_t format) {
+    return format == RENDER_RGB888 ? 3 : 2;
+}
@@ -0,0 +1,114 @@
+/**
+ * \file            render.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           False-color frame renderer (RGB565/RGB888)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define RENDER_LUT_SIZE 256                     /*!< Palette entries */
+
+/**
+ * \brief           Palettes
+ */
+typedef enum {
+    RENDER_PALETTE_IRON,                        /*!< Black, purple, red, orange, yellow, white */
+    RENDER_PALETTE_RAINBOW,                     /*!< Blue, cyan, green, yellow, red */
+    RENDER_PALETTE_GRAY,                        /*!< Black to white */
+} render_palette_t;
+
+/**
+ * \brief           Output pixel formats
+ */
+typedef enum {
+    RENDER_RGB565,                              /*!< 2 bytes per pixel, little endian */
+    RENDER_RGB565_BE,                           /*!< 2 bytes per pixel, big endian (SPI displays) */
+    RENDER_RGB888,                              /*!< 3 bytes per pixel, R, G, B */
+} render_format_t;
+
+/**
+ * \brief           Renderer handler
+ */
+typedef struct {
+    render_format_t format;                     /*!< Output pixel format */
+    uint8_t lut[RENDER_LUT_SIZE * 3];           /*!< Palette, already in the output format */
+
+    bool auto_range;                            /*!< Follow the frame range instead of a fixed window */
+    uint8_t smooth_shift;                       /*!< Auto window smoothing, moves `1 / 2^shift` of the way per frame */
+    int16_t min_span;                           /*!< Narrowest auto window */
+    bool primed;                                /*!< Auto window has been set at least once */
+    int32_t lo_q8;                              /*!< Smoothed auto window low end, 8 fractional bits */
+    int32_t hi_q8;                              /*!< Smoothed auto window high end, 8 fractional bits */
+
+    int16_t lo;                                 /*!< Current window low end, mapped to the first palette entry */
+    int16_t hi;                                 /*!< Current window high end, mapped to the last palette entry */
+} render_t;
+
+/**
+ * \brief           Init the renderer, with a fixed window covering the whole int16 range
+ * \param[out]      p_render: Renderer handler
+ * \param[in]       palette: Palette
+ * \param[in]       format: Output pixel format
+ */
+void render_init(render_t* p_render, render_palette_t palette, render_format_t format);
+
+/**
+ * \brief           Use a fixed window
+ * \param[in]       p_render: Renderer handler
+ * \param[in]       lo: Window low end, input units
+ * \param[in]       hi: Window high end, input units
+ */
+void render_set_window(render_t* p_render, int16_t lo, int16_t hi);
+
+/**
+ * \brief           Follow the range fed with \ref render_update_range
+ * \param[in]       p_render: Renderer handler
+ * \param[in]       smooth_shift: Smoothing, `0` to jump straight to every new range
+ * \param[in]       min_span: Narrowest window, input units (avoids amplifying noise on flat scenes)
+ */
+void render_set_auto(render_t* p_render, uint8_t smooth_shift, int16_t min_span);
+
+/**
+ * \brief           Feed the range of the next frame (e.g. from amg88_frame_stats), no-op with a fixed window
+ * \param[in]       p_render: Renderer handler
+ * \param[in]       min: Frame minimum
+ * \param[in]       max: Frame maximum
+ */
+void render_update_range(render_t* p_render, int16_t min, int16_t max);
+
+/**
+ * \brief           Render a frame into a caller-supplied buffer
+ * \note            One multiply and one table lookup per pixel, no intermediate image
+ * \param[in]       p_render: Renderer handler
+ * \param[in]       p_in: Frame values, row-major
+ * \param[in]       width: Frame width
+ * \param[in]       height: Frame height
+ * \param[out]      p_out: Output buffer
+ * \param[in]       stride: Bytes between the beginning of two output rows
+ */
+void render_frame(const render_t* p_render, const int16_t* p_in, size_t width, size_t height,
+                  uint8_t* p_out, size_t stride);
+
+/**
+ * \brief           Bytes per output pixel of a format
+ * \param[in]       format: Output pixel format
+ * \return          Bytes per pixel
+ */
+size_t render_bpp(render_format_t format);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RENDER_H */
@@ -0,0 +1,212 @@
+/**
+ * \file            sensor_array.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Multi-sensor, multi-bus synchronous acquisition
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "sensor_array.h"
+#include "metrics/metrics.h"
+
+#include <string.h>
+
+
+static void
+sensor_array_atomic_max(atomic_uint_fast32_t* p_max, uint32_t val) {
+    uint_fast32_t cur = atomic_load(p_max);
+
+    while (val > cur && !atomic_compare_exchange_weak(p_max, &cur, val)) {
+    }
+}
+
+static void
+sensor_array_bus_task(void* arg) {
+    sensor_array_bus_t* p_bus = (sensor_array_bus_t*) arg;
+    sensor_array_t* p_arr = p_bus->p_arr;
+
+    while (atomic_load(&p_arr->running)) {
+        if (osal_sem_take(&p_bus->go_sem, SENSOR_ARRAY_WAIT_MS) != OSAL_OK) {
+            continue;
+        }
+
+        /* Each reader only touches the entries of its own sensors */
+        p_bus->valid = 0;
+        for (uint8_t i = 0; i < p_arr->cfg.n_sensors; ++i) {
+            amg88_dev_t* p_dev = p_arr->cfg.p_devs[i];
+            uint64_t start_us;
+            uint32_t cycles;
+            amg88_err_t err;
+
+            if (p_dev->bus != p_bus->bus) {
+                continue;
+            }
+
+            start_us = osal_time_us();
+            cycles = METRICS_START();
+            err = amg88_get_frame_raw(p_dev, &p_arr->p_slot->raw[i], p_arr->cfg.read_thermistor);
+            METRICS_STOP(METRICS_READ, cycles);
+            if (err != AMG88_OK) {
+                METRICS_ERROR(err);
+                atomic_fetch_add(&p_arr->read_errors[i], 1);
+                continue;
+            }
+            p_arr->p_slot->ts_us[i] = start_us + (osal_time_us() - start_us) / 2;
+            p_bus->valid |= 1 << i;
+        }
+
+        osal_sem_give(&p_arr->bus_sem);
+    }
+
+    osal_sem_give(&p_arr->done_sem);
+}
+
+static void
+sensor_array_trigger_task(void* arg) {
+    sensor_array_t* p_arr = (sensor_array_t*) arg;
+    sensor_array_frame_t* p_slot;
+    uint64_t wake_us, ts_min, ts_max;
+    uint32_t seq = 0;
+    uint8_t done;
+
+    wake_us = osal_time_us();
+    while (atomic_load(&p_arr->running)) {
+        osal_delay_until(&wake_us, p_arr->cfg.period_us);
+
+        p_slot = (sensor_array_frame_t*) frame_ring_write_slot(&p_arr->ring);
+        p_slot->trigger_us = osal_time_us();
+        p_arr->p_slot = p_slot;
+
+        for (uint8_t b = 0; b < p_arr->n_buses; ++b) {
+            osal_sem_give(&p_arr->buses[b].go_sem);
+        }
+        for (done = 0; done < p_arr->n_buses;) {
+            if (osal_sem_take(&p_arr->bus_sem, SENSOR_ARRAY_WAIT_MS) == OSAL_OK) {
+                done++;
+            } else if (!atomic_load(&p_arr->running)) {
+                break;
+            }
+        }
+        if (done < p_arr->n_buses) {
+            break;
+        }
+
+        p_slot->valid = 0;
+        for (uint8_t b = 0; b < p_arr->n_buses; ++b) {
+            p_slot->valid |= p_arr->buses[b].valid;
+        }
+        ts_min = UINT64_MAX;
+        ts_max = 0;
+        for (uint8_t i = 0; i < p_arr->cfg.n_sensors; ++i) {
+            if (!(p_slot->valid & (1 << i))) {
+                continue;
+            }
+            ts_min = p_slot->ts_us[i] < ts_min ? p_slot->ts_us[i] : ts_min;
+            ts_max = p_slot->ts_us[i] > ts_max ? p_slot->ts_us[i] : ts_max;
+        }
+        if (p_slot->valid == 0) {
+            continue;
+        }
+        sensor_array_atomic_max(&p_arr->max_skew_us, (uint32_t) (ts_max - ts_min));
+        sensor_array_atomic_max(&p_arr->max_acq_us, (uint32_t) (osal_time_us() - p_slot->trigger_us));
+
+        p_slot->seq = seq++;
+        METRICS_COUNT(METRICS_FRAMES, 1);
+        if (frame_ring_publish(&p_arr->ring)) {
+            METRICS_COUNT(METRICS_DROPPED, 1);
+        }
+        osal_sem_give(&p_arr->frame_sem);
+    }
+
+    osal_sem_give(&p_arr->done_sem);
+}
+
+osal_err_t
+sensor_array_start(sensor_array_t* p_arr, const sensor_array_cfg_t* p_cfg) {
+    if (p_cfg->n_sensors == 0 || p_cfg->n_sensors > SENSOR_ARRAY_MAX) {
+        return OSAL_ERR;
+    }
+
+    memcpy(&p_arr->cfg, p_cfg, sizeof(p_arr->cfg));
+    frame_ring_init(&p_arr->ring, p_arr->frames, sizeof(p_arr->frames[0]));
+
+    /* One reader per distinct bus */
+    p_arr->n_buses = 0;
+    for (uint8_t i = 0; i < p_cfg->n_sensors; ++i) {
+        uint8_t b;
+
+        for (b = 0; b < p_arr->n_buses && p_arr->buses[b].bus != p_cfg->p_devs[i]->bus; ++b) {
+        }
+        if (b < p_arr->n_buses) {
+            continue;
+        }
+        if (p_arr->n_buses == SENSOR_ARRAY_MAX_BUS) {
+            return OSAL_ERR;
+        }
+        p_arr->buses[b].p_arr = p_arr;
+        p_arr->buses[b].bus = p_cfg->p_devs[i]->bus;
+        if (osal_sem_init(&p_arr->buses[b].go_sem) != OSAL_OK) {
+            return OSAL_ERR;
+        }
+        p_arr->n_buses++;
+    }
+
+    if (osal_sem_init(&p_arr->bus_sem) != OSAL_OK
+        || osal_sem_init(&p_arr->frame_sem) != OSAL_OK
+        || osal_sem_init(&p_arr->done_sem) != OSAL_OK) {
+        return OSAL_ERR;
+    }
+
+    atomic_init(&p_arr->running, true);
+    for (uint8_t i = 0; i < SENSOR_ARRAY_MAX; ++i) {
+        atomic_init(&p_arr->read_errors[i], 0);
+    }
+    atomic_init(&p_arr->max_skew_us, 0);
+    atomic_init(&p_arr->max_acq_us, 0);
+    p_arr->n_tasks = 0;
+
+    for (uint8_t b = 0; b < p_arr->n_buses; ++b) {
+        if (osal_task_create(&p_arr->buses[b].task, "arr_bus", sensor_array_bus_task, &p_arr->buses[b],
+                             SENSOR_ARRAY_STACK_SIZE, p_cfg->prio, p_cfg->core) != OSAL_OK) {
+            sensor_array_stop(p_arr);
+            return OSAL_ERR;
+        }
+        p_arr->n_tasks++;
+    }
+    if (osal_task_create(&p_arr->trigger_task, "arr_trig", sensor_array_trigger_task, p_arr,
+                         SENSOR_ARRAY_STACK_SIZE, p_cfg->prio, p_cfg->core) != OSAL_OK) {
+        sensor_array_stop(p_arr);
+        return OSAL_ERR;
+    }
+    p_arr->n_tasks++;
+
+    return OSAL_OK;
+}
+
+void
+sensor_array_stop(sensor_array_t* p_arr) {
+    atomic_store(&p_arr->running, false);
+
+    for (; p_arr->n_tasks > 0; --p_arr->n_tasks) {
+        osal_sem_take(&p_arr->done_sem, OSAL_WAIT_FOREVER);
+    }
+}
+
+const sensor_array_frame_t*
+sensor_array_acquire(sensor_array_t* p_arr, uint32_t timeout_ms) {
+    if (osal_sem_take(&p_arr->frame_sem, timeout_ms) != OSAL_OK) {
+        return NULL;
+    }
+
+    return (const sensor_array_frame_t*) frame_ring_acquire(&p_arr->ring);
+}
+
+void
+sensor_array_get_stats(sensor_array_t* p_arr, sensor_array_stats_t* p_stats) {
+    for (uint8_t i = 0; i < SENSOR_ARRAY_MAX; ++i) {
+        p_stats->read_errors[i] = atomic_load(&p_arr->read_errors[i]);
+    }
+    p_stats->max_skew_us = atomic_load(&p_arr->max_skew_us);
+    p_stats->max_acq_us = atomic_load(&p_arr->max_acq_us);
+    frame_ring_get_stats(&p_arr->ring, &p_stats->ring);
+}
@@ -0,0 +1,136 @@
+/**
+ * \file            sensor_array.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Multi-sensor, multi-bus synchronous acquisition
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef SENSOR_ARRAY_H
+#define SENSOR_ARRAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "amg88/amg88.h"
+#include "frame_ring/frame_ring.h"
+#include "osal/osal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define SENSOR_ARRAY_MAX        4               /*!< Max sensors, two addresses on each of two buses */
+#define SENSOR_ARRAY_MAX_BUS    2               /*!< Max buses, one reader task each */
+#define SENSOR_ARRAY_STACK_SIZE 4096            /*!< Stack size of every array task */
+#define SENSOR_ARRAY_WAIT_MS    100             /*!< Max time a task waits before checking for a stop */
+
+/**
+ * \brief           One acquisition of every sensor
+ */
+typedef struct {
+    amg88_frame_raw_t raw[SENSOR_ARRAY_MAX];    /*!< Raw frames, in configuration order */
+    uint64_t ts_us[SENSOR_ARRAY_MAX];           /*!< Per sensor timestamp, middle of its read, \ref osal_time_us base */
+    uint64_t trigger_us;                        /*!< Time the buses were started */
+    uint32_t seq;                               /*!< Acquisition sequence number */
+    uint8_t valid;                              /*!< Bit `i` set when `raw[i]` was read fine */
+} sensor_array_frame_t;
+
+/**
+ * \brief           Array configuration
+ */
+typedef struct {
+    amg88_dev_t* p_devs[SENSOR_ARRAY_MAX];      /*!< Sensors, `bus` selects the reader task */
+    uint8_t n_sensors;                          /*!< Sensors in `p_devs` */
+    uint32_t period_us;                         /*!< Acquisition period */
+    bool read_thermistor;                       /*!< Read the thermistor with every frame */
+    int8_t core;                                /*!< Core of the array tasks */
+    uint8_t prio;                               /*!< Priority of the array tasks */
+} sensor_array_cfg_t;
+
+struct sensor_array;
+
+/**
+ * \brief           Bus reader, reads the sensors of one bus back to back
+ */
+typedef struct {
+    struct sensor_array* p_arr;                 /*!< Owner */
+    uint8_t bus;                                /*!< I2C bus */
+    uint8_t valid;                              /*!< Sensors of this bus read fine in the current set */
+    osal_sem_t go_sem;                          /*!< Signals a new acquisition */
+    osal_task_t task;                           /*!< Reader task */
+} sensor_array_bus_t;
+
+/**
+ * \brief           Array handler, all the storage is preallocated in it
+ */
+typedef struct sensor_array {
+    sensor_array_cfg_t cfg;                     /*!< Configuration */
+
+    sensor_array_bus_t buses[SENSOR_ARRAY_MAX_BUS]; /*!< Bus readers */
+    uint8_t n_buses;                            /*!< Bus readers in use */
+
+    sensor_array_frame_t frames[FRAME_RING_SLOTS]; /*!< Ring storage */
+    frame_ring_t ring;                          /*!< Array -> consumer ring */
+    sensor_array_frame_t* p_slot;               /*!< Slot being filled by the bus readers */
+
+    osal_sem_t bus_sem;                         /*!< Signals a bus reader finished its sensors */
+    osal_sem_t frame_sem;                       /*!< Signals a new frame set */
+    osal_sem_t done_sem;                        /*!< Signals a task exit */
+
+    atomic_bool running;                        /*!< Cleared to stop the tasks */
+    atomic_uint_fast32_t read_errors[SENSOR_ARRAY_MAX]; /*!< Failed reads per sensor */
+    atomic_uint_fast32_t max_skew_us;           /*!< Largest timestamp spread inside a frame set */
+    atomic_uint_fast32_t max_acq_us;            /*!< Longest trigger to last read time */
+    uint8_t n_tasks;                            /*!< Running tasks */
+
+    osal_task_t trigger_task;                   /*!< Pacing task */
+} sensor_array_t;
+
+/**
+ * \brief           Array statistics
+ */
+typedef struct {
+    uint32_t read_errors[SENSOR_ARRAY_MAX];     /*!< Failed reads per sensor */
+    uint32_t max_skew_us;                       /*!< Largest timestamp spread inside a frame set */
+    uint32_t max_acq_us;                        /*!< Longest acquisition of a whole set */
+    frame_ring_stats_t ring;                    /*!< Array -> consumer ring stats */
+} sensor_array_stats_t;
+
+/**
+ * \brief           Start the array tasks
+ * \note            Buses are read in parallel, so a set takes as long as its busiest bus
+ * \param[out]      p_arr: Array handler
+ * \param[in]       p_cfg: Configuration, copied
+ * \return          \ref OSAL_OK on success, a member of \ref osal_err_t otherwise
+ */
+osal_err_t sensor_array_start(sensor_array_t* p_arr, const sensor_array_cfg_t* p_cfg);
+
+/**
+ * \brief           Stop the array and wait for its tasks to end
+ * \param[in]       p_arr: Array handler
+ */
+void sensor_array_stop(sensor_array_t* p_arr);
+
+/**
+ * \brief           Wait for the newest frame set
+ * \param[in]       p_arr: Array handler
+ * \param[in]       timeout_ms: Max time to wait
+ * \return          Frame set, valid until the next call, `NULL` on timeout
+ */
+const sensor_array_frame_t* sensor_array_acquire(sensor_array_t* p_arr, uint32_t timeout_ms);
+
+/**
+ * \brief           Get the array statistics
+ * \param[in]       p_arr: Array handler
+ * \param[out]      p_stats: Statistics
+ */
+void sensor_array_get_stats(sensor_array_t* p_arr, sensor_array_stats_t* p_stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SENSOR_ARRAY_H */
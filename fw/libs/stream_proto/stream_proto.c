@@ -0,0 +1,123 @@
+/**
+ * \file            stream_proto.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Binary frame streaming protocol (one frame per UDP datagram)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "stream_proto.h"
+#include "stream_proto_priv.h"
+
+#include <string.h>
+
+void
+stream_proto_write_hdr(uint8_t* p_buf, const stream_hdr_t* p_hdr) {
+    put_le(p_buf, STREAM_PROTO_MAGIC, 2);
+    p_buf[2] = STREAM_PROTO_VERSION;
+    p_buf[3] = p_hdr->type;
+    p_buf[4] = p_hdr->sensor_id;
+    p_buf[5] = p_hdr->flags;
+    put_le(p_buf + 6, p_hdr->len, 2);
+    put_le(p_buf + 8, p_hdr->seq, 4);
+    put_le(p_buf + 12, p_hdr->ts_us, 8);
+    put_le(p_buf + 20, p_hdr->boot_id, 2);
+}
+
+stream_proto_err_t
+stream_proto_parse(const uint8_t* p_buf, size_t len, stream_hdr_t* p_hdr, const uint8_t** pp_payload) {
+    if (len < STREAM_PROTO_HDR_SIZE) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+    if (get_le(p_buf, 2) != STREAM_PROTO_MAGIC) {
+        return STREAM_PROTO_ERR_MAGIC;
+    }
+    if (p_buf[2] != STREAM_PROTO_VERSION) {
+        return STREAM_PROTO_ERR_VERSION;
+    }
+
+    p_hdr->version = p_buf[2];
+    p_hdr->type = p_buf[3];
+    p_hdr->sensor_id = p_buf[4];
+    p_hdr->flags = p_buf[5];
+    p_hdr->len = (uint16_t) get_le(p_buf + 6, 2);
+    p_hdr->seq = (uint32_t) get_le(p_buf + 8, 4);
+    p_hdr->ts_us = get_le(p_buf + 12, 8);
+    p_hdr->boot_id = (uint16_t) get_le(p_buf + 20, 2);
+
+    if (len != STREAM_PROTO_HDR_SIZE + (size_t) p_hdr->len) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+    *pp_payload = p_buf + STREAM_PROTO_HDR_SIZE;
+
+    return STREAM_PROTO_OK;
+}
+
+size_t
+stream_proto_encode_frame(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                          uint32_t seq, uint64_t ts_us, const amg88_frame_raw_t* p_frame) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_FRAME_RAW,
+        .sensor_id = sensor_id,
+        .len = STREAM_PROTO_FRAME_RAW_SIZE,
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = boot_id,
+    };
+
+    if (buf_len < STREAM_PROTO_HDR_SIZE + STREAM_PROTO_FRAME_RAW_SIZE) {
+        return 0;
+    }
+
+    stream_proto_write_hdr(p_buf, &hdr);
+    memcpy(p_buf + STREAM_PROTO_HDR_SIZE, p_frame->thermistor, 2);
+    memcpy(p_buf + STREAM_PROTO_HDR_SIZE + 2, p_frame->pixels, AMG88_FRAME_RAW_SIZE);
+
+    return STREAM_PROTO_HDR_SIZE + STREAM_PROTO_FRAME_RAW_SIZE;
+}
+
+size_t
+stream_proto_encode_codec(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                          uint32_t seq, uint64_t ts_us, uint8_t flags, frame_codec_enc_t* p_enc,
+                          const amg88_frame_raw_t* p_frame) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_FRAME_CODEC,
+        .sensor_id = sensor_id,
+        .flags = flags,
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = boot_id,
+    };
+
+    if (buf_len < STREAM_PROTO_HDR_SIZE + FRAME_CODEC_MAX_SIZE) {
+        return 0;
+    }
+
+    /* Encode in place, the header goes in once the length is known */
+    hdr.len = (uint16_t) frame_codec_encode(p_enc, p_frame, p_buf + STREAM_PROTO_HDR_SIZE);
+    stream_proto_write_hdr(p_buf, &hdr);
+
+    return STREAM_PROTO_HDR_SIZE + hdr.len;
+}
+
+stream_proto_err_t
+stream_proto_decode_frame(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                          frame_codec_dec_t* p_dec, amg88_frame_raw_t* p_frame) {
+    if (p_hdr->type == STREAM_TYPE_FRAME_CODEC && p_dec != NULL) {
+        if (frame_codec_decode(p_dec, p_payload, p_hdr->len, p_frame) != FRAME_CODEC_OK) {
+            return STREAM_PROTO_ERR_CODEC;
+        }
+        return STREAM_PROTO_OK;
+    }
+    if (p_hdr->type != STREAM_TYPE_FRAME_RAW) {
+        return STREAM_PROTO_ERR_TYPE;
+    }
+    if (p_hdr->len != STREAM_PROTO_FRAME_RAW_SIZE) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+
+    memcpy(p_frame->thermistor, p_payload, 2);
+    memcpy(p_frame->pixels, p_payload + 2, AMG88_FRAME_RAW_SIZE);
+
+    return STREAM_PROTO_OK;
+}
@@ -0,0 +1,151 @@
+/**
+ * \file            stream_proto.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Binary frame streaming protocol (one frame per UDP datagram)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef STREAM_PROTO_H
+#define STREAM_PROTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "amg88/amg88_defs.h"
+#include "frame_codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define STREAM_PROTO_MAGIC      0x4354          /*!< "TC", first two bytes of every packet */
+/**
+ * \brief           Current protocol version, bumped on any change a receiver of the previous one would misread
+ * \note            1: raw and encoded frames. 2: \ref STREAM_FLAG_BACKFILL. 3: metrics packets.
+ *                  4: image packets. 5: blobs packets. 6: tracks packets. 7: boot ID in the header
+ */
+#define STREAM_PROTO_VERSION    7
+#define STREAM_PROTO_PORT       5005            /*!< Default UDP port */
+
+#define STREAM_PROTO_HDR_SIZE   22              /*!< Header size on the wire */
+#define STREAM_PROTO_MAX_PACKET 1400            /*!< Max packet size, below any usual path MTU so nothing fragments */
+#define STREAM_PROTO_MAX_PAYLOAD (STREAM_PROTO_MAX_PACKET - STREAM_PROTO_HDR_SIZE)
+
+#define STREAM_PROTO_FRAME_RAW_SIZE (2 + AMG88_FRAME_RAW_SIZE) /*!< Thermistor + pixels */
+#define STREAM_PROTO_IMAGE_HDR  3               /*!< Image payload bytes before the pixels */
+
+/**
+ * \brief           Frame recorded while the link was down and sent afterwards
+ * \note            Not part of the live sequence: encoded frames reference backfill keyframes only
+ */
+#define STREAM_FLAG_BACKFILL    0x01
+
+/**
+ * \brief           Packet types
+ */
+typedef enum {
+    STREAM_TYPE_FRAME_RAW   = 0x01,             /*!< Raw frame: thermistor + 64 pixels, 12 bits in 2 bytes each */
+    STREAM_TYPE_FRAME_CODEC = 0x02,             /*!< Frame encoded with frame_codec (packed keyframe or delta) */
+    STREAM_TYPE_METRICS     = 0x03,             /*!< Metrics snapshot, see \ref stream_proto_encode_metrics */
+    STREAM_TYPE_IMAGE       = 0x04,             /*!< Rendered image: width (1), height (1), render_format_t (1),
+                                                     then the rows. Stream transports only, it outgrows a datagram */
+    STREAM_TYPE_BLOBS       = 0x05,             /*!< Detected blobs, see \ref stream_proto_encode_blobs */
+    STREAM_TYPE_TRACKS      = 0x06,             /*!< Tracked hotspots, see \ref stream_proto_encode_tracks */
+} stream_type_t;
+
+/**
+ * \brief           Protocol error codes
+ */
+typedef enum {
+    STREAM_PROTO_OK,                            /*!< Everything is Ok */
+    STREAM_PROTO_ERR_LEN,                       /*!< Buffer too short or length mismatch */
+    STREAM_PROTO_ERR_MAGIC,                     /*!< Not a stream packet */
+    STREAM_PROTO_ERR_VERSION,                   /*!< Unsupported protocol version */
+    STREAM_PROTO_ERR_TYPE,                      /*!< Unexpected packet type */
+    STREAM_PROTO_ERR_CODEC,                     /*!< Encoded frame could not be decoded */
+} stream_proto_err_t;
+
+/**
+ * \brief           Packet header
+ * \note            Wire layout, little endian: magic (2), version (1), type (1), sensor_id (1), flags (1),
+ *                  payload length (2), sequence number (4), device timestamp in us (8), boot ID (2)
+ */
+typedef struct {
+    uint8_t version;                            /*!< Protocol version */
+    uint8_t type;                               /*!< Packet type, a member of \ref stream_type_t */
+    uint8_t sensor_id;                          /*!< Sensor ID */
+    uint8_t flags;                              /*!< Type specific flags */
+    uint16_t len;                               /*!< Payload length */
+    uint32_t seq;                               /*!< Sequence number, per sensor */
+    uint64_t ts_us;                             /*!< Device timestamp */
+    uint16_t boot_id;                           /*!< Drawn anew on every device boot, a new one means the sequence
+                                                     started over. `0` for senders without one */
+} stream_hdr_t;
+
+/**
+ * \brief           Serialize a header
+ * \param[out]      p_buf: Output buffer, at least \ref STREAM_PROTO_HDR_SIZE bytes
+ * \param[in]       p_hdr: Header, `version` is ignored and set to \ref STREAM_PROTO_VERSION
+ */
+void stream_proto_write_hdr(uint8_t* p_buf, const stream_hdr_t* p_hdr);
+
+/**
+ * \brief           Parse and validate a packet
+ * \param[in]       p_buf: Received packet
+ * \param[in]       len: Packet length
+ * \param[out]      p_hdr: Parsed header
+ * \param[out]      pp_payload: Pointer to the payload inside `p_buf`
+ * \return          \ref STREAM_PROTO_OK on success, a member of \ref stream_proto_err_t otherwise
+ */
+stream_proto_err_t stream_proto_parse(const uint8_t* p_buf, size_t len, stream_hdr_t* p_hdr,
+                                      const uint8_t** pp_payload);
+
+/**
+ * \brief           Build a raw frame packet
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       buf_len: Output buffer size
+ * \param[in]       sensor_id: Sensor ID
+ * \param[in]       boot_id: Device boot ID, see \ref stream_hdr_t
+ * \param[in]       seq: Sequence number
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       p_frame: Raw frame
+ * \return          Packet length, `0` if the buffer is too small
+ */
+size_t stream_proto_encode_frame(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                                 uint32_t seq, uint64_t ts_us, const amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Build an encoded frame packet
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       buf_len: Output buffer size
+ * \param[in]       sensor_id: Sensor ID
+ * \param[in]       boot_id: Device boot ID, see \ref stream_hdr_t
+ * \param[in]       seq: Sequence number
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       flags: Header flags, `STREAM_FLAG_*`
+ * \param[in]       p_enc: Encoder state
+ * \param[in]       p_frame: Raw frame
+ * \return          Packet length, `0` if the buffer is too small
+ */
+size_t stream_proto_encode_codec(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                                 uint32_t seq, uint64_t ts_us, uint8_t flags, frame_codec_enc_t* p_enc,
+                                 const amg88_frame_raw_t* p_frame);
+
+/**
+ * \brief           Extract the raw frame of a parsed packet
+ * \note            Encoded frames have to be decoded in sequence order
+ * \param[in]       p_hdr: Parsed header
+ * \param[in]       p_payload: Payload
+ * \param[in]       p_dec: Decoder state of the sensor, `NULL` to only accept raw frames
+ * \param[out]      p_frame: Raw frame
+ * \return          \ref STREAM_PROTO_OK on success, a member of \ref stream_proto_err_t otherwise
+ */
+stream_proto_err_t stream_proto_decode_frame(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                                             frame_codec_dec_t* p_dec, amg88_frame_raw_t* p_frame);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* STREAM_PROTO_H */
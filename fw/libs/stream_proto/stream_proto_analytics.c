@@ -0,0 +1,224 @@
+/**
+ * \file            stream_proto_analytics.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Streaming protocol payloads of the on-device analytics: metrics, blobs and tracks
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "stream_proto_analytics.h"
+#include "stream_proto_priv.h"
+
+#include <string.h>
+
+
+static int16_t
+sat16(int32_t v) {
+    return (int16_t) (v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+
+size_t
+stream_proto_encode_metrics(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                            uint32_t seq, uint64_t ts_us, const metrics_t* p_metrics) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_METRICS,
+        .sensor_id = sensor_id,
+        .len = STREAM_PROTO_METRICS_SIZE,
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = boot_id,
+    };
+    uint8_t* p = p_buf + STREAM_PROTO_HDR_SIZE;
+
+    if (buf_len < STREAM_PROTO_HDR_SIZE + STREAM_PROTO_METRICS_SIZE) {
+        return 0;
+    }
+
+    stream_proto_write_hdr(p_buf, &hdr);
+    *p++ = METRICS_STAGES;
+    *p++ = METRICS_HIST_BUCKETS;
+    *p++ = METRICS_ERR_CODES;
+    *p++ = METRICS_COUNTERS;
+    for (size_t s = 0; s < METRICS_STAGES; ++s) {
+        put_le(p, p_metrics->timers[s].count, 4);
+        put_le(p + 4, p_metrics->timers[s].sum_us, 4);
+        p += 8;
+        for (size_t b = 0; b < METRICS_HIST_BUCKETS; ++b, p += 2) {
+            put_le(p, p_metrics->timers[s].hist[b], 2);
+        }
+    }
+    for (size_t i = 0; i < METRICS_ERR_CODES; ++i, p += 4) {
+        put_le(p, p_metrics->errors[i], 4);
+    }
+    for (size_t i = 0; i < METRICS_COUNTERS; ++i, p += 4) {
+        put_le(p, p_metrics->counters[i], 4);
+    }
+
+    return STREAM_PROTO_HDR_SIZE + STREAM_PROTO_METRICS_SIZE;
+}
+
+stream_proto_err_t
+stream_proto_decode_metrics(const stream_hdr_t* p_hdr, const uint8_t* p_payload, metrics_t* p_metrics) {
+    const uint8_t* p = p_payload + 4;
+
+    if (p_hdr->type != STREAM_TYPE_METRICS) {
+        return STREAM_PROTO_ERR_TYPE;
+    }
+    if (p_hdr->len != STREAM_PROTO_METRICS_SIZE || p_payload[0] != METRICS_STAGES
+        || p_payload[1] != METRICS_HIST_BUCKETS || p_payload[2] != METRICS_ERR_CODES
+        || p_payload[3] != METRICS_COUNTERS) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+
+    for (size_t s = 0; s < METRICS_STAGES; ++s) {
+        p_metrics->timers[s].count = (uint32_t) get_le(p, 4);
+        p_metrics->timers[s].sum_us = (uint32_t) get_le(p + 4, 4);
+        p += 8;
+        for (size_t b = 0; b < METRICS_HIST_BUCKETS; ++b, p += 2) {
+            p_metrics->timers[s].hist[b] = (uint16_t) get_le(p, 2);
+        }
+    }
+    for (size_t i = 0; i < METRICS_ERR_CODES; ++i, p += 4) {
+        p_metrics->errors[i] = (uint32_t) get_le(p, 4);
+    }
+    for (size_t i = 0; i < METRICS_COUNTERS; ++i, p += 4) {
+        p_metrics->counters[i] = (uint32_t) get_le(p, 4);
+    }
+
+    return STREAM_PROTO_OK;
+}
+
+size_t
+stream_proto_encode_blobs(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                          uint32_t seq, uint64_t ts_us, const detect_blob_t* p_blobs, uint8_t n_blobs,
+                          uint8_t overflow) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_BLOBS,
+        .sensor_id = sensor_id,
+        .len = STREAM_PROTO_BLOBS_SIZE(n_blobs),
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = boot_id,
+    };
+    uint8_t* p = p_buf + STREAM_PROTO_HDR_SIZE;
+
+    if (buf_len < STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(n_blobs)) {
+        return 0;
+    }
+
+    stream_proto_write_hdr(p_buf, &hdr);
+    *p++ = n_blobs;
+    *p++ = overflow;
+    for (uint8_t i = 0; i < n_blobs; ++i, p += STREAM_PROTO_BLOB_SIZE) {
+        put_le(p, p_blobs[i].pixels, 2);
+        put_le(p + 2, (uint16_t) p_blobs[i].peak, 2);
+        put_le(p + 4, p_blobs[i].peak_idx, 2);
+        put_le(p + 6, p_blobs[i].cx_q8, 2);
+        put_le(p + 8, p_blobs[i].cy_q8, 2);
+        put_le(p + 10, p_blobs[i].heat, 4);
+        p[14] = p_blobs[i].x0;
+        p[15] = p_blobs[i].y0;
+        p[16] = p_blobs[i].x1;
+        p[17] = p_blobs[i].y1;
+    }
+
+    return STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(n_blobs);
+}
+
+stream_proto_err_t
+stream_proto_decode_blobs(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                          detect_blob_t* p_blobs, uint8_t* p_n_blobs, uint8_t* p_overflow) {
+    const uint8_t* p = p_payload + 2;
+
+    if (p_hdr->type != STREAM_TYPE_BLOBS) {
+        return STREAM_PROTO_ERR_TYPE;
+    }
+    if (p_hdr->len < STREAM_PROTO_BLOBS_SIZE(0) || p_payload[0] > DETECT_MAX_BLOBS
+        || p_hdr->len != STREAM_PROTO_BLOBS_SIZE(p_payload[0])) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+
+    *p_n_blobs = p_payload[0];
+    *p_overflow = p_payload[1];
+    for (uint8_t i = 0; i < *p_n_blobs; ++i, p += STREAM_PROTO_BLOB_SIZE) {
+        p_blobs[i].pixels = (uint16_t) get_le(p, 2);
+        p_blobs[i].peak = (int16_t) get_le(p + 2, 2);
+        p_blobs[i].peak_idx = (uint16_t) get_le(p + 4, 2);
+        p_blobs[i].cx_q8 = (uint16_t) get_le(p + 6, 2);
+        p_blobs[i].cy_q8 = (uint16_t) get_le(p + 8, 2);
+        p_blobs[i].heat = (uint32_t) get_le(p + 10, 4);
+        p_blobs[i].x0 = p[14];
+        p_blobs[i].y0 = p[15];
+        p_blobs[i].x1 = p[16];
+        p_blobs[i].y1 = p[17];
+    }
+
+    return STREAM_PROTO_OK;
+}
+
+size_t
+stream_proto_encode_tracks(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                           uint32_t seq, uint64_t ts_us, const track_t* p_tracks, uint8_t n_slots) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_TRACKS,
+        .sensor_id = sensor_id,
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = boot_id,
+    };
+    uint8_t* p = p_buf + STREAM_PROTO_HDR_SIZE + 1;
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < n_slots; ++i) {
+        n += p_tracks[i].state == TRACK_CONFIRMED;
+    }
+    if (buf_len < STREAM_PROTO_HDR_SIZE + STREAM_PROTO_TRACKS_SIZE(n)) {
+        return 0;
+    }
+
+    hdr.len = (uint16_t) STREAM_PROTO_TRACKS_SIZE(n);
+    stream_proto_write_hdr(p_buf, &hdr);
+    p_buf[STREAM_PROTO_HDR_SIZE] = n;
+    for (uint8_t i = 0; i < n_slots; ++i) {
+        if (p_tracks[i].state != TRACK_CONFIRMED) {
+            continue;
+        }
+        put_le(p, p_tracks[i].id, 2);
+        put_le(p + 2, (uint16_t) sat16(p_tracks[i].x), 2);
+        put_le(p + 4, (uint16_t) sat16(p_tracks[i].y), 2);
+        put_le(p + 6, (uint16_t) sat16(p_tracks[i].vx), 2);
+        put_le(p + 8, (uint16_t) sat16(p_tracks[i].vy), 2);
+        put_le(p + 10, (uint16_t) p_tracks[i].value, 2);
+        p += STREAM_PROTO_TRACK_SIZE;
+    }
+
+    return STREAM_PROTO_HDR_SIZE + STREAM_PROTO_TRACKS_SIZE(n);
+}
+
+stream_proto_err_t
+stream_proto_decode_tracks(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                           track_t* p_tracks, uint8_t* p_n_tracks) {
+    const uint8_t* p = p_payload + 1;
+
+    if (p_hdr->type != STREAM_TYPE_TRACKS) {
+        return STREAM_PROTO_ERR_TYPE;
+    }
+    if (p_hdr->len < STREAM_PROTO_TRACKS_SIZE(0) || p_payload[0] > TRACK_MAX_TRACKS
+        || p_hdr->len != STREAM_PROTO_TRACKS_SIZE(p_payload[0])) {
+        return STREAM_PROTO_ERR_LEN;
+    }
+
+    *p_n_tracks = p_payload[0];
+    for (uint8_t i = 0; i < *p_n_tracks; ++i, p += STREAM_PROTO_TRACK_SIZE) {
+        memset(&p_tracks[i], 0, sizeof(p_tracks[i]));
+        p_tracks[i].state = TRACK_CONFIRMED;
+        p_tracks[i].id = (uint16_t) get_le(p, 2);
+        p_tracks[i].x = (int16_t) get_le(p + 2, 2);
+        p_tracks[i].y = (int16_t) get_le(p + 4, 2);
+        p_tracks[i].vx = (int16_t) get_le(p + 6, 2);
+        p_tracks[i].vy = (int16_t) get_le(p + 8, 2);
+        p_tracks[i].value = (int16_t) get_le(p + 10, 2);
+    }
+
+    return STREAM_PROTO_OK;
+}
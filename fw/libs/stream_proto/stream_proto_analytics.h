@@ -0,0 +1,123 @@
+/**
+ * \file            stream_proto_analytics.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Streaming protocol payloads of the on-device analytics: metrics, blobs and tracks
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef STREAM_PROTO_ANALYTICS_H
+#define STREAM_PROTO_ANALYTICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "stream_proto/stream_proto.h"
+#include "metrics/metrics.h"
+#include "detect/detect.h"
+#include "track/track.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define STREAM_PROTO_METRICS_SIZE (4 + METRICS_STAGES * (8 + 2 * METRICS_HIST_BUCKETS) \
+                                   + 4 * METRICS_ERR_CODES + 4 * METRICS_COUNTERS) /*!< Metrics payload */
+#define STREAM_PROTO_BLOB_SIZE  18              /*!< Bytes per blob of a blobs payload */
+#define STREAM_PROTO_BLOBS_SIZE(n) (2u + (n) * STREAM_PROTO_BLOB_SIZE) /*!< Blobs payload with `n` blobs */
+#define STREAM_PROTO_TRACK_SIZE 12              /*!< Bytes per track of a tracks payload */
+#define STREAM_PROTO_TRACKS_SIZE(n) (1u + (n) * STREAM_PROTO_TRACK_SIZE) /*!< Tracks payload with `n` tracks */
+
+/**
+ * \brief           Build a metrics packet
+ * \note            Payload, little endian: stages, buckets, error codes and counters (1 each), then per stage
+ *                  count (4), sum in us (4) and the buckets (2 each), then the error counters (4 each) and the
+ *                  event counters (4 each). Values are cumulative and wrap around, receivers diff two packets
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       buf_len: Output buffer size
+ * \param[in]       sensor_id: Sensor ID
+ * \param[in]       boot_id: Device boot ID, see \ref stream_hdr_t
+ * \param[in]       seq: Sequence number, its own sequence apart from the frames
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       p_metrics: Snapshot
+ * \return          Packet length, `0` if the buffer is too small
+ */
+size_t stream_proto_encode_metrics(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                                   uint32_t seq, uint64_t ts_us, const metrics_t* p_metrics);
+
+/**
+ * \brief           Extract the metrics of a parsed packet
+ * \param[in]       p_hdr: Parsed header
+ * \param[in]       p_payload: Payload
+ * \param[out]      p_metrics: Snapshot
+ * \return          \ref STREAM_PROTO_OK on success, \ref STREAM_PROTO_ERR_LEN on a different layout
+ */
+stream_proto_err_t stream_proto_decode_metrics(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                                               metrics_t* p_metrics);
+
+/**
+ * \brief           Build a blobs packet, the event form of a frame
+ * \note            Payload, little endian: blobs (1), blobs left out (1), then per blob pixels (2), peak (2),
+ *                  peak index (2), centroid x and y (2 each), heat (4) and the bounding box x0, y0, x1, y1
+ *                  (1 each). Same sequence number as the frame it was found in
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       buf_len: Output buffer size
+ * \param[in]       sensor_id: Sensor ID
+ * \param[in]       boot_id: Device boot ID, see \ref stream_hdr_t
+ * \param[in]       seq: Frame sequence number
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       p_blobs: Blobs
+ * \param[in]       n_blobs: Blobs in `p_blobs`
+ * \param[in]       overflow: Blobs found but left out
+ * \return          Packet length, `0` if the buffer is too small
+ */
+size_t stream_proto_encode_blobs(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                                 uint32_t seq, uint64_t ts_us, const detect_blob_t* p_blobs, uint8_t n_blobs,
+                                 uint8_t overflow);
+
+/**
+ * \brief           Extract the blobs of a parsed packet
+ * \param[in]       p_hdr: Parsed header
+ * \param[in]       p_payload: Payload
+ * \param[out]      p_blobs: Blobs, room for \ref DETECT_MAX_BLOBS
+ * \param[out]      p_n_blobs: Blobs in `p_blobs`
+ * \param[out]      p_overflow: Blobs left out by the device
+ * \return          \ref STREAM_PROTO_OK on success, a member of \ref stream_proto_err_t otherwise
+ */
+stream_proto_err_t stream_proto_decode_blobs(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                                             detect_blob_t* p_blobs, uint8_t* p_n_blobs, uint8_t* p_overflow);
+
+/**
+ * \brief           Build a tracks packet from the confirmed tracks of a tracker
+ * \note            Payload, little endian: tracks (1), then per track id (2), x and y (2 each), vx and vy (2 each,
+ *                  saturated) and value (2). Positions in pixels, velocities in pixels per second, both with
+ *                  \ref TRACK_FRAC_BITS fractional bits. Same sequence number as the frame they were updated with
+ * \param[out]      p_buf: Output buffer
+ * \param[in]       buf_len: Output buffer size
+ * \param[in]       sensor_id: Sensor ID
+ * \param[in]       boot_id: Device boot ID, see \ref stream_hdr_t
+ * \param[in]       seq: Frame sequence number
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       p_tracks: Track slots, only the confirmed ones are sent
+ * \param[in]       n_slots: Slots in `p_tracks`, at most \ref TRACK_MAX_TRACKS
+ * \return          Packet length, `0` if the buffer is too small
+ */
+size_t stream_proto_encode_tracks(uint8_t* p_buf, size_t buf_len, uint8_t sensor_id, uint16_t boot_id,
+                                  uint32_t seq, uint64_t ts_us, const track_t* p_tracks, uint8_t n_slots);
+
+/**
+ * \brief           Extract the tracks of a parsed packet
+ * \param[in]       p_hdr: Parsed header
+ * \param[in]       p_payload: Payload
+ * \param[out]      p_tracks: Confirmed tracks, room for \ref TRACK_MAX_TRACKS. Hits and misses are not sent
+ * \param[out]      p_n_tracks: Tracks in `p_tracks`
+ * \return          \ref STREAM_PROTO_OK on success, a member of \ref stream_proto_err_t otherwise
+ */
+stream_proto_err_t stream_proto_decode_tracks(const stream_hdr_t* p_hdr, const uint8_t* p_payload,
+                                              track_t* p_tracks, uint8_t* p_n_tracks);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* STREAM_PROTO_ANALYTICS_H */
@@ -0,0 +1,33 @@
+/**
+ * \file            stream_proto_priv.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Little endian field helpers shared by the streaming protocol sources, not installed
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef STREAM_PROTO_PRIV_H
+#define STREAM_PROTO_PRIV_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+static inline void
+put_le(uint8_t* p_buf, uint64_t val, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        p_buf[i] = (uint8_t) (val >> (8 * i));
+    }
+}
+
+static inline uint64_t
+get_le(const uint8_t* p_buf, size_t len) {
+    uint64_t val = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        val |= (uint64_t) p_buf[i] << (8 * i);
+    }
+
+    return val;
+}
+
+#endif /* STREAM_PROTO_PRIV_H */
@@ -0,0 +1,59 @@
+/**
+ * \file            tfilter.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Per-pixel temporal noise filter, fixed-point IIR or scalar Kalman
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "tfilter.h"
+
+#include <string.h>
+
+#define TFILTER_ONE     (1 << TFILTER_FRAC_BITS)
+#define TFILTER_GAIN_BITS 16                    /* Fractional bits of the Kalman gain */
+
+
+void
+tfilter_init(tfilter_t* p_flt, const tfilter_cfg_t* p_cfg) {
+    memset(p_flt, 0, sizeof(*p_flt));
+    p_flt->cfg = *p_cfg;
+}
+
+void
+tfilter_reset(tfilter_t* p_flt) {
+    p_flt->frames = 0;
+}
+
+void
+tfilter_update(tfilter_t* p_flt, int16_t* p_temp) {
+    const int32_t step = (int32_t) p_flt->cfg.step * TFILTER_ONE;
+    const uint32_t q = p_flt->cfg.q, r = p_flt->cfg.r;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        int32_t z = (int32_t) p_temp[i] * TFILTER_ONE;
+        int32_t res = z - p_flt->x[i];
+
+        /* First frame, or a real change rather than noise: start over from the reading */
+        if (p_flt->frames == 0 || (step > 0 && (res > step || res < -step))) {
+            p_flt->restarts += p_flt->frames != 0;
+            p_flt->x[i] = z;
+            p_flt->p[i] = r;
+            continue;
+        }
+
+        if (p_flt->cfg.mode == TFILTER_KALMAN) {
+            /* Predict with a random walk, then blend by k = p / (p + r) */
+            uint32_t p = p_flt->p[i] + q;
+            uint32_t k = (uint32_t) (((uint64_t) p << TFILTER_GAIN_BITS) / ((uint64_t) p + r + (p + r == 0)));
+
+            p_flt->x[i] += (int32_t) (((int64_t) res * k) >> TFILTER_GAIN_BITS);
+            p_flt->p[i] = (uint32_t) (((uint64_t) p * ((1U << TFILTER_GAIN_BITS) - k)) >> TFILTER_GAIN_BITS);
+        } else {
+            p_flt->x[i] += res >> p_flt->cfg.iir_shift;
+        }
+
+        p_temp[i] = (int16_t) ((p_flt->x[i] + TFILTER_ONE / 2) >> TFILTER_FRAC_BITS);
+    }
+    p_flt->frames++;
+}
@@ -0,0 +1,82 @@
+/**
+ * \file            tfilter.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Per-pixel temporal noise filter, fixed-point IIR or scalar Kalman
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef TFILTER_H
+#define TFILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define TFILTER_FRAC_BITS   8                   /*!< Fractional bits of the estimates and variances */
+
+/**
+ * \brief           Filter types
+ */
+typedef enum {
+    TFILTER_IIR,                                /*!< Exponential moving average, fixed gain */
+    TFILTER_KALMAN,                             /*!< Random-walk Kalman filter, the gain settles from 1 to a
+                                                     steady value set by `q / r` */
+} tfilter_mode_t;
+
+/**
+ * \brief           Filter settings, temperatures in 1/4 degree units
+ */
+typedef struct {
+    tfilter_mode_t mode;                        /*!< Filter type */
+    uint8_t iir_shift;                          /*!< IIR: moves `1 / 2^shift` of the way per frame */
+    uint16_t q;                                 /*!< Kalman: process noise variance per frame, \ref TFILTER_FRAC_BITS
+                                                     fractional bits */
+    uint16_t r;                                 /*!< Kalman: measurement noise variance, same format */
+    int16_t step;                               /*!< A reading further than this from the estimate restarts the
+                                                     pixel on it, so a person walking in is not smeared. `0` to never */
+} tfilter_cfg_t;
+
+/**
+ * \brief           Filter handler, sensor grid, no dynamic memory
+ */
+typedef struct {
+    tfilter_cfg_t cfg;                          /*!< Settings */
+    int32_t x[AMG88_ARRAY_SIZE];                /*!< Estimates, \ref TFILTER_FRAC_BITS fractional bits */
+    uint32_t p[AMG88_ARRAY_SIZE];               /*!< Kalman estimate variances, same format */
+    uint32_t frames;                            /*!< Frames since init or the last \ref tfilter_reset */
+    uint32_t restarts;                          /*!< Pixels restarted by `step` */
+} tfilter_t;
+
+/**
+ * \brief           Init a filter, the first frame is passed through
+ * \param[out]      p_flt: Filter handler
+ * \param[in]       p_cfg: Settings, copied
+ */
+void tfilter_init(tfilter_t* p_flt, const tfilter_cfg_t* p_cfg);
+
+/**
+ * \brief           Forget the history, e.g. after a sensor mode change, the next frame is passed through
+ * \param[inout]    p_flt: Filter handler
+ */
+void tfilter_reset(tfilter_t* p_flt);
+
+/**
+ * \brief           Filter a frame in place
+ * \note            Input is \ref amg88_decode_frame output, the fixed-point form of \ref amg88_get_array
+ * \param[inout]    p_flt: Filter handler
+ * \param[inout]    p_temp: \ref AMG88_ARRAY_SIZE temperatures, 1/4 degree units, replaced by the estimates
+ */
+void tfilter_update(tfilter_t* p_flt, int16_t* p_temp);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TFILTER_H */
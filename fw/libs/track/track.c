@@ -0,0 +1,242 @@
+/**
+ * \file            track.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Sub-pixel hotspot localization and multi-frame tracking on the sensor grid
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "track.h"
+
+#include <string.h>
+
+#define TRACK_ONE       (1 << TRACK_FRAC_BITS)  /* One pixel */
+#define TRACK_HALF      (TRACK_ONE / 2)
+
+
+/* Vertex of the parabola through (-1, l), (0, c), (1, r), clamped to the pixel */
+static int16_t
+track_vertex(int32_t l, int32_t c, int32_t r) {
+    int32_t denom = 2 * (l - 2 * c + r);
+    int32_t off;
+
+    if (denom == 0) {
+        return 0;
+    }
+    off = (l - r) * TRACK_ONE / denom;
+
+    return (int16_t) (off > TRACK_HALF ? TRACK_HALF : off < -TRACK_HALF ? -TRACK_HALF : off);
+}
+
+static void
+track_refine(const int16_t* p_grid, uint8_t x, uint8_t y, track_refine_t refine, track_peak_t* p_peak) {
+    size_t i = (size_t) y * AMG88_ARRAY_COLS + x;
+    int32_t min = INT16_MAX, sw = 0, sx = 0, sy = 0;
+
+    p_peak->x = (int16_t) (x * TRACK_ONE);
+    p_peak->y = (int16_t) (y * TRACK_ONE);
+    p_peak->value = p_grid[i];
+
+    if (refine == TRACK_REFINE_QUADRATIC) {
+        /* On the border the missing side is unknown, the integer position is kept on that axis */
+        if (x > 0 && x < AMG88_ARRAY_COLS - 1) {
+            p_peak->x += track_vertex(p_grid[i - 1], p_grid[i], p_grid[i + 1]);
+        }
+        if (y > 0 && y < AMG88_ARRAY_ROWS - 1) {
+            p_peak->y += track_vertex(p_grid[i - AMG88_ARRAY_COLS], p_grid[i], p_grid[i + AMG88_ARRAY_COLS]);
+        }
+    } else if (refine == TRACK_REFINE_CENTROID) {
+        uint8_t x0 = x > 0 ? x - 1 : x, x1 = x < AMG88_ARRAY_COLS - 1 ? x + 1 : x;
+        uint8_t y0 = y > 0 ? y - 1 : y, y1 = y < AMG88_ARRAY_ROWS - 1 ? y + 1 : y;
+
+        for (uint8_t yy = y0; yy <= y1; ++yy) {
+            for (uint8_t xx = x0; xx <= x1; ++xx) {
+                min = p_grid[yy * AMG88_ARRAY_COLS + xx] < min ? p_grid[yy * AMG88_ARRAY_COLS + xx] : min;
+            }
+        }
+        for (uint8_t yy = y0; yy <= y1; ++yy) {
+            for (uint8_t xx = x0; xx <= x1; ++xx) {
+                int32_t w = p_grid[yy * AMG88_ARRAY_COLS + xx] - min;
+
+                sw += w;
+                sx += w * (xx - x);
+                sy += w * (yy - y);
+            }
+        }
+        if (sw > 0) {
+            p_peak->x += (int16_t) (sx * TRACK_ONE / sw);
+            p_peak->y += (int16_t) (sy * TRACK_ONE / sw);
+        }
+    }
+}
+
+uint8_t
+track_find_peaks(const int16_t* p_grid, int16_t threshold, track_refine_t refine, track_peak_t* p_peaks,
+                 uint8_t max_peaks) {
+    uint8_t n = 0;
+
+    for (uint8_t y = 0; y < AMG88_ARRAY_ROWS; ++y) {
+        for (uint8_t x = 0; x < AMG88_ARRAY_COLS; ++x) {
+            size_t i = (size_t) y * AMG88_ARRAY_COLS + x;
+            int16_t v = p_grid[i];
+            bool is_max = v > threshold;
+            track_peak_t peak;
+            uint8_t j;
+
+            for (int8_t dy = -1; dy <= 1 && is_max; ++dy) {
+                for (int8_t dx = -1; dx <= 1 && is_max; ++dx) {
+                    int8_t nx = (int8_t) (x + dx), ny = (int8_t) (y + dy);
+                    int16_t nv;
+
+                    if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= AMG88_ARRAY_COLS
+                        || ny >= AMG88_ARRAY_ROWS) {
+                        continue;
+                    }
+                    /* Plateaus: the earlier pixel in raster order wins */
+                    nv = p_grid[ny * AMG88_ARRAY_COLS + nx];
+                    is_max = nv < v || (nv == v && (dy > 0 || (dy == 0 && dx > 0)));
+                }
+            }
+            if (!is_max || (n == max_peaks && (max_peaks == 0 || v <= p_peaks[n - 1].value))) {
+                continue;
+            }
+
+            /* Warmest first, the coolest one falls off a full list */
+            track_refine(p_grid, x, y, refine, &peak);
+            j = n < max_peaks ? n++ : n - 1;
+            while (j > 0 && p_peaks[j - 1].value < v) {
+                p_peaks[j] = p_peaks[j - 1];
+                --j;
+            }
+            p_peaks[j] = peak;
+        }
+    }
+
+    return n;
+}
+
+void
+track_init(track_tracker_t* p_trk, const track_cfg_t* p_cfg) {
+    memset(p_trk, 0, sizeof(*p_trk));
+    p_trk->cfg = *p_cfg;
+    p_trk->next_id = 1;
+}
+
+uint8_t
+track_update(track_tracker_t* p_trk, const int16_t* p_grid, uint64_t ts_us) {
+    const int64_t gate_sq = (int64_t) p_trk->cfg.gate * p_trk->cfg.gate;
+    int64_t dt_us = p_trk->last_us != 0 && ts_us > p_trk->last_us ? (int64_t) (ts_us - p_trk->last_us) : 0;
+    bool track_used[TRACK_MAX_TRACKS] = { false };
+    bool peak_used[TRACK_MAX_PEAKS] = { false };
+    uint8_t confirmed = 0;
+
+    p_trk->last_us = ts_us;
+    p_trk->n_peaks = track_find_peaks(p_grid, p_trk->cfg.threshold, p_trk->cfg.refine, p_trk->peaks,
+                                      TRACK_MAX_PEAKS);
+
+    /* Predict */
+    for (uint8_t t = 0; t < TRACK_MAX_TRACKS; ++t) {
+        track_t* p_t = &p_trk->tracks[t];
+
+        if (p_t->state != TRACK_FREE) {
+            p_t->x += (int32_t) (p_t->vx * dt_us / 1000000);
+            p_t->y += (int32_t) (p_t->vy * dt_us / 1000000);
+        }
+    }
+
+    /* Closest pair first, at most min(tracks, peaks) rounds over a few dozen pairs */
+    while (true) {
+        int64_t best = gate_sq + 1;
+        uint8_t best_t = 0, best_p = 0;
+
+        for (uint8_t t = 0; t < TRACK_MAX_TRACKS; ++t) {
+            if (p_trk->tracks[t].state == TRACK_FREE || track_used[t]) {
+                continue;
+            }
+            for (uint8_t p = 0; p < p_trk->n_peaks; ++p) {
+                int64_t dx = p_trk->peaks[p].x - p_trk->tracks[t].x;
+                int64_t dy = p_trk->peaks[p].y - p_trk->tracks[t].y;
+
+                if (!peak_used[p] && dx * dx + dy * dy < best) {
+                    best = dx * dx + dy * dy;
+                    best_t = t;
+                    best_p = p;
+                }
+            }
+        }
+        if (best > gate_sq) {
+            break;
+        }
+
+        /* Alpha-beta update on the residual, the second sighting sets the velocity from two points */
+        track_t* p_t = &p_trk->tracks[best_t];
+        int32_t rx = p_trk->peaks[best_p].x - p_t->x;
+        int32_t ry = p_trk->peaks[best_p].y - p_t->y;
+
+        track_used[best_t] = true;
+        peak_used[best_p] = true;
+        if (p_t->hits == 1) {
+            p_t->x += rx;
+            p_t->y += ry;
+            if (dt_us > 0) {
+                p_t->vx = (int32_t) ((int64_t) rx * 1000000 / dt_us);
+                p_t->vy = (int32_t) ((int64_t) ry * 1000000 / dt_us);
+            }
+        } else {
+            p_t->x += rx * p_trk->cfg.alpha / 256;
+            p_t->y += ry * p_trk->cfg.alpha / 256;
+        }
+        if (dt_us > 0 && p_t->hits > 1) {
+            p_t->vx += (int32_t) ((int64_t) rx * p_trk->cfg.beta * 1000000 / 256 / dt_us);
+            p_t->vy += (int32_t) ((int64_t) ry * p_trk->cfg.beta * 1000000 / 256 / dt_us);
+        }
+        p_t->value = p_trk->peaks[best_p].value;
+        p_t->hits = p_t->hits < UINT16_MAX ? p_t->hits + 1 : UINT16_MAX;
+        p_t->misses = 0;
+        if (p_t->hits >= p_trk->cfg.confirm_hits) {
+            p_t->state = TRACK_CONFIRMED;
+        }
+    }
+
+    /* Unmatched tracks coast on their prediction, a tentative one is dropped at once */
+    for (uint8_t t = 0; t < TRACK_MAX_TRACKS; ++t) {
+        track_t* p_t = &p_trk->tracks[t];
+
+        if (p_t->state == TRACK_FREE || track_used[t]) {
+            continue;
+        }
+        if (p_t->state == TRACK_TENTATIVE || ++p_t->misses > p_trk->cfg.max_misses) {
+            p_t->state = TRACK_FREE;
+        }
+    }
+
+    /* Unmatched hotspots start new tracks while there are free slots */
+    for (uint8_t p = 0, t = 0; p < p_trk->n_peaks; ++p) {
+        if (peak_used[p]) {
+            continue;
+        }
+        while (t < TRACK_MAX_TRACKS && p_trk->tracks[t].state != TRACK_FREE) {
+            ++t;
+        }
+        if (t == TRACK_MAX_TRACKS) {
+            break;
+        }
+
+        track_t* p_t = &p_trk->tracks[t];
+
+        memset(p_t, 0, sizeof(*p_t));
+        p_t->state = p_trk->cfg.confirm_hits <= 1 ? TRACK_CONFIRMED : TRACK_TENTATIVE;
+        p_t->id = p_trk->next_id++;
+        p_trk->next_id += p_trk->next_id == 0;  /* 0 stays free for "no track" */
+        p_t->x = p_trk->peaks[p].x;
+        p_t->y = p_trk->peaks[p].y;
+        p_t->value = p_trk->peaks[p].value;
+        p_t->hits = 1;
+    }
+
+    for (uint8_t t = 0; t < TRACK_MAX_TRACKS; ++t) {
+        confirmed += p_trk->tracks[t].state == TRACK_CONFIRMED;
+    }
+
+    return confirmed;
+}
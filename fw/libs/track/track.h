@@ -0,0 +1,132 @@
+/**
+ * \file            track.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Sub-pixel hotspot localization and multi-frame tracking on the sensor grid
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define TRACK_MAX_PEAKS     8                   /*!< Hotspots kept per frame, warmest first */
+#define TRACK_MAX_TRACKS    8                   /*!< Tracks alive at once */
+#define TRACK_FRAC_BITS     8                   /*!< Fractional bits of positions and velocities */
+
+/**
+ * \brief           Sub-pixel refinement methods
+ */
+typedef enum {
+    TRACK_REFINE_NONE,                          /*!< Integer pixel of the maximum */
+    TRACK_REFINE_QUADRATIC,                     /*!< Parabola through the maximum and its row and column neighbours */
+    TRACK_REFINE_CENTROID,                      /*!< 3x3 centroid of the values above the window minimum */
+} track_refine_t;
+
+/**
+ * \brief           Hotspot, positions in pixels with \ref TRACK_FRAC_BITS fractional bits, pixel centres on
+ *                  integers
+ */
+typedef struct {
+    int16_t x;                                  /*!< Column */
+    int16_t y;                                  /*!< Row */
+    int16_t value;                              /*!< Value of the maximum pixel */
+} track_peak_t;
+
+/**
+ * \brief           Track states
+ */
+typedef enum {
+    TRACK_FREE,                                 /*!< Slot unused */
+    TRACK_TENTATIVE,                            /*!< Not seen for long enough to be reported */
+    TRACK_CONFIRMED,                            /*!< Reported */
+} track_state_t;
+
+/**
+ * \brief           Track
+ */
+typedef struct {
+    uint8_t state;                              /*!< A member of \ref track_state_t */
+    uint16_t id;                                /*!< Persistent id, never reused before it wraps around */
+    int32_t x;                                  /*!< Filtered column, \ref TRACK_FRAC_BITS fractional bits */
+    int32_t y;                                  /*!< Filtered row, same format */
+    int32_t vx;                                 /*!< Column velocity in pixels per second, same format */
+    int32_t vy;                                 /*!< Row velocity, same format */
+    int16_t value;                              /*!< Value of the last matched hotspot */
+    uint16_t hits;                              /*!< Frames matched */
+    uint8_t misses;                             /*!< Consecutive frames without a match */
+} track_t;
+
+/**
+ * \brief           Tracker settings
+ */
+typedef struct {
+    int16_t threshold;                          /*!< Hotspots are local maxima above this */
+    track_refine_t refine;                      /*!< Sub-pixel refinement */
+    uint16_t gate;                              /*!< Max distance between a prediction and its match, pixels with
+                                                     \ref TRACK_FRAC_BITS fractional bits */
+    uint8_t alpha;                              /*!< Position gain of the alpha-beta filter, 1/256 units */
+    uint8_t beta;                               /*!< Velocity gain, 1/256 units */
+    uint8_t confirm_hits;                       /*!< Matches before a track is confirmed */
+    uint8_t max_misses;                         /*!< Misses before a confirmed track is dropped */
+} track_cfg_t;
+
+/**
+ * \brief           Tracker handler, no dynamic memory
+ */
+typedef struct {
+    track_cfg_t cfg;                            /*!< Settings */
+    track_t tracks[TRACK_MAX_TRACKS];           /*!< Track slots */
+    uint16_t next_id;                           /*!< Id of the next new track */
+    uint64_t last_us;                           /*!< Timestamp of the previous frame, `0` before the first */
+
+    track_peak_t peaks[TRACK_MAX_PEAKS];        /*!< Last frame hotspots */
+    uint8_t n_peaks;                            /*!< Hotspots in `peaks` */
+} track_tracker_t;
+
+/**
+ * \brief           Find the local maxima of the sensor grid and refine them
+ * \note            A maximum is above its 8 neighbours, ties go to the first pixel in raster order
+ * \param[in]       p_grid: \ref AMG88_ARRAY_SIZE values, e.g. temperatures or their excess over a background
+ * \param[in]       threshold: Only maxima above this are kept
+ * \param[in]       refine: Sub-pixel refinement
+ * \param[out]      p_peaks: Hotspots, warmest first
+ * \param[in]       max_peaks: Room in `p_peaks`
+ * \return          Hotspots stored, the coolest ones are dropped when there is no room
+ */
+uint8_t track_find_peaks(const int16_t* p_grid, int16_t threshold, track_refine_t refine, track_peak_t* p_peaks,
+                         uint8_t max_peaks);
+
+/**
+ * \brief           Init a tracker
+ * \param[out]      p_trk: Tracker handler
+ * \param[in]       p_cfg: Settings, copied
+ */
+void track_init(track_tracker_t* p_trk, const track_cfg_t* p_cfg);
+
+/**
+ * \brief           Find the hotspots of a frame and match them to the tracks
+ * \note            Tracks are predicted to `ts_us` with their velocity, so dropped frames and rate changes
+ *                  (see governor) keep the velocities in pixels per second. Pairs are matched closest first
+ *                  within the gate, unmatched hotspots start tentative tracks
+ * \param[inout]    p_trk: Tracker handler
+ * \param[in]       p_grid: \ref AMG88_ARRAY_SIZE values
+ * \param[in]       ts_us: Frame timestamp
+ * \return          Confirmed tracks
+ */
+uint8_t track_update(track_tracker_t* p_trk, const int16_t* p_grid, uint64_t ts_us);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TRACK_H */
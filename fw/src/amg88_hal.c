@@ -8,22 +8,35 @@
 
 #include "amg88_hal.h"
 
-#include <string.h>
-
 #include "esp_err.h"
 #include "driver/i2c.h"
 
 #include "user_config.h"
+#include "uc_init.h"
 
 /* Vars */
 // static char* log_src = "amg88_hal";
+static i2c_async_t async_workers[I2C_ASYNC_MAX_BUS];
+
 
+static void IRAM_ATTR
+amg88_hal_int_isr(void* arg) {
+    BaseType_t woken = pdFALSE;
+
+    vTaskNotifyGiveFromISR((TaskHandle_t) arg, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
 
 amg88_err_t
-amg88_hal_i2c_read(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+amg88_hal_i2c_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
     esp_err_t ret;
 
-    ret = i2c_master_write_read_device(0, addr, &reg_addr, 1, data_buf, len, CFG_I2C_TIMEOUT / portTICK_RATE_MS);
+    /* The bus worker, the config writes and a recovery may share the port, see uc_init_i2c_lock */
+    uc_init_i2c_lock(bus);
+    ret = i2c_master_write_read_device((i2c_port_t) bus, addr, &reg_addr, 1, data_buf, len, CFG_I2C_TIMEOUT / portTICK_RATE_MS);
+    uc_init_i2c_unlock(bus);
 
     if (ret == ESP_OK) {
         return AMG88_OK;
@@ -39,17 +52,23 @@ amg88_hal_i2c_read(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf
 }
 
 amg88_err_t
-amg88_hal_i2c_write(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
-    uint8_t all_data_buf[len + 1];
+amg88_hal_i2c_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    uint8_t link_buf[I2C_LINK_RECOMMENDED_SIZE(3)] = { 0 };
+    i2c_cmd_handle_t cmd;
     esp_err_t ret;
 
-    memcpy(all_data_buf + 1, data_buf, sizeof(uint8_t) * len);
-    all_data_buf[0] = reg_addr;
-
-    all_data_buf[0] = reg_addr;
-    all_data_buf[1] = data_buf[0];
+    /* Register address and data go out as two chunks of the same transaction, no copy needed */
+    cmd = i2c_cmd_link_create_static(link_buf, sizeof(link_buf));
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, reg_addr, true);
+    i2c_master_write(cmd, data_buf, len, true);
+    i2c_master_stop(cmd);
 
-    ret = i2c_master_write_to_device(0, addr, all_data_buf, len + 1, CFG_I2C_TIMEOUT / portTICK_RATE_MS);
+    uc_init_i2c_lock(bus);
+    ret = i2c_master_cmd_begin((i2c_port_t) bus, cmd, CFG_I2C_TIMEOUT / portTICK_RATE_MS);
+    uc_init_i2c_unlock(bus);
+    i2c_cmd_link_delete_static(cmd);
 
     if (ret == ESP_OK) {
         return AMG88_OK;
@@ -61,3 +80,61 @@ amg88_hal_i2c_write(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_bu
 
     return AMG88_ERR;
 }
+
+amg88_err_t
+amg88_hal_i2c_recover(uint8_t bus) {
+    return uc_init_i2c_recover(bus) == ESP_OK ? AMG88_OK : AMG88_ERR_I2C;
+}
+
+esp_err_t
+amg88_hal_async_init(uint8_t bus, uint8_t prio, int8_t core) {
+    if (bus >= I2C_NUM_MAX || bus >= I2C_ASYNC_MAX_BUS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_async_init(&async_workers[bus], bus, amg88_hal_i2c_read, prio, core) == OSAL_OK ? ESP_OK
+                                                                                                : ESP_ERR_NO_MEM;
+}
+
+esp_err_t
+amg88_hal_int_init(gpio_num_t pin, TaskHandle_t task) {
+    esp_err_t ret;
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << pin,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+
+    ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* The service may already be installed by another driver */
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+
+    return gpio_isr_handler_add(pin, amg88_hal_int_isr, (void*) task);
+}
+
+esp_err_t
+amg88_hal_int_deinit(gpio_num_t pin) {
+    esp_err_t ret;
+
+    ret = gpio_isr_handler_remove(pin);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gpio_set_intr_type(pin, GPIO_INTR_DISABLE);
+}
+
+uint32_t
+amg88_hal_int_wait(TickType_t timeout) {
+    return ulTaskNotifyTake(pdTRUE, timeout);
+}
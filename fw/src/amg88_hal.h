@@ -12,7 +12,14 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_err.h"
+
 #include "amg88/amg88_defs.h"
+#include "i2c_async/i2c_async.h"
+#include "osal/osal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,32 +27,87 @@ extern "C" {
 
 /**
  * \brief           I2C read
+ * \param[in]       bus: I2C port the AMG device is wired to
  * \param[in]       addr: 7-bit I2C slave address of the AMG device
  * \param[in]       reg_addr: address of internal register to read
  * \param[in]       len: number of bytes to read
  * \param[out]      data_buf: pointer to the read data value
  * \return          error code
  */
-amg88_err_t amg88_hal_i2c_read(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+amg88_err_t amg88_hal_i2c_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
 
 /**
  * \brief           I2C write
+ * \param[in]       bus: I2C port the AMG device is wired to
  * \param[in]       addr: 7-bit I2C slave address of the AMG device
  * \param[in]       reg_addr: address of internal register to write
  * \param[in]       len: number of bytes to write
  * \param[in]       data_buf: pointer to the write data value
  * \return          error code
  */
-amg88_err_t amg88_hal_i2c_write(uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+amg88_err_t amg88_hal_i2c_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+/**
+ * \brief           I2C bus recovery, see \ref uc_init_i2c_recover
+ * \param[in]       bus: I2C port the AMG device is wired to
+ * \return          error code
+ */
+amg88_err_t amg88_hal_i2c_recover(uint8_t bus);
+
+/**
+ * \brief           Start the non-blocking read worker of an I2C port
+ * \note            The ESP-IDF v4.4 driver only has blocking transfers, so the worker runs them on behalf of the
+ *                  caller (see i2c_async). Needed once per port before \ref AMG88_HAL_ASYNC_INIT devices read
+ * \param[in]       bus: I2C port
+ * \param[in]       prio: Worker priority, above the tasks that overlap compute with the transfers
+ * \param[in]       core: Core to pin the worker to
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t amg88_hal_async_init(uint8_t bus, uint8_t prio, int8_t core);
+
+/**
+ * \brief           Route the sensor INT line to a task notification
+ * \note            The INT output is open-drain and active low, the internal pull-up is enabled
+ * \param[in]       pin: GPIO wired to the sensor INT pin
+ * \param[in]       task: Task woken up on every interrupt (e.g. the acquisition task)
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t amg88_hal_int_init(gpio_num_t pin, TaskHandle_t task);
+
+/**
+ * \brief           Detach the sensor INT line
+ * \param[in]       pin: GPIO wired to the sensor INT pin
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t amg88_hal_int_deinit(gpio_num_t pin);
+
+/**
+ * \brief           Block the notified task until the sensor raises an interrupt
+ * \param[in]       timeout: Max ticks to wait
+ * \return          Number of interrupts since the last call, `0` on timeout
+ */
+uint32_t amg88_hal_int_wait(TickType_t timeout);
 
 /**
  * \brief           Fill the dev struct with the HW related stuff
  * \param[in]       p_dev: Device struct pointer
  * \hideinitializer
  */
-#define AMG88_HAL_HW_INIT(p_dev) {           \
-    (p_dev)->write    = amg88_hal_i2c_write; \
-    (p_dev)->read     = amg88_hal_i2c_read;  \
+#define AMG88_HAL_HW_INIT(p_dev) do {           \
+    (p_dev)->write    = amg88_hal_i2c_write;    \
+    (p_dev)->read     = amg88_hal_i2c_read;     \
+    (p_dev)->recover  = amg88_hal_i2c_recover;  \
+    (p_dev)->clock_us = osal_time_us;           \
+} while (0)
+
+/**
+ * \brief           Also give the device non-blocking reads, see \ref amg88_hal_async_init
+ * \param[in]       p_dev: Device struct pointer
+ * \hideinitializer
+ */
+#define AMG88_HAL_ASYNC_INIT(p_dev) do {          \
+    AMG88_HAL_HW_INIT(p_dev);                     \
+    (p_dev)->read_async = i2c_async_read;         \
 } while (0)
 
 #ifdef __cplusplus
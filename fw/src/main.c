@@ -16,11 +16,392 @@
 
 #include "user_config.h"
 #include "uc_init.h"
+#include "amg88_hal.h"
+#include "amg88/amg88.h"
+#include "pipeline/pipeline.h"
+#include "sensor_array/sensor_array.h"
+#include "mosaic/mosaic.h"
+#include "stream_proto/stream_proto.h"
+#include "stream_proto/stream_proto_analytics.h"
+#include "governor/governor.h"
+#include "metrics/metrics.h"
+#include "detect/detect.h"
+#include "track/track.h"
+#include "tfilter/tfilter.h"
+#include "uc_stream.h"
+#include "uc_calib.h"
+#include "uc_recorder.h"
+#include "uc_boot.h"
+#include "uc_live.h"
 
+#define APP_INIT_STACK_SIZE 4096
+
+/**
+ * \brief           Processing stage output
+ */
+typedef struct {
+    uint32_t seq;                               /*!< Acquisition sequence number */
+    uint64_t ts_us;                             /*!< Acquisition timestamp */
+    int16_t temp[AMG88_ARRAY_SIZE];             /*!< Pixel temperatures, 1/4 degree units */
+    amg88_stats_t stats;                        /*!< Frame statistics */
+    amg88_frame_raw_t corrected;                /*!< Calibrated frame, streamed instead of the raw one */
+    uint8_t pkt[STREAM_PROTO_MAX_PACKET];       /*!< Stream packet */
+    size_t pkt_len;                             /*!< Stream packet length */
+    bool record;                                /*!< Link down: the packet goes to the recorder */
+    uint8_t evt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(DETECT_MAX_BLOBS)]; /*!< Blobs packet */
+    size_t evt_len;                             /*!< Blobs packet length, `0` when there is nothing to report */
+    uint8_t trk[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_TRACKS_SIZE(TRACK_MAX_TRACKS)]; /*!< Tracks packet */
+    size_t trk_len;                             /*!< Tracks packet length, `0` when there is nothing to report */
+} app_frame_t;
+
+/**
+ * \brief           Wiring and mosaic placement of an array sensor
+ */
+typedef struct {
+    uint8_t bus;                                /*!< I2C port */
+    uint8_t addr;                               /*!< I2C address */
+    mosaic_tile_t tile;                         /*!< Placement in the mosaic */
+} app_array_sensor_t;
+
+/* Vars */
 static char* log_src = "main";
 
+static amg88_dev_t amg88_dev = {
+    .bus = 0,
+    .addr = CFG_AMG88_ADDR,
+};
+static const amg88_retry_t amg88_retry = {
+    .bursts = CFG_AMG88_BURSTS,
+    .retries = CFG_AMG88_RETRIES,
+    .budget_us = CFG_AMG88_BUDGET_US,
+};
+static pipeline_t pipeline;
+static app_frame_t pipeline_out[FRAME_RING_SLOTS];
+static frame_codec_enc_t stream_enc;
+static bool stream_online = true;               /* Link state the last packet was encoded for */
+#if CFG_GOV_ENABLE
+static governor_t governor;
+#endif /* CFG_GOV_ENABLE */
+#if CFG_DETECT_ENABLE
+static detect_t detector;
+static uint8_t detect_prev_blobs;               /* Blobs of the last report, the one emptying the scene is sent too */
+#endif /* CFG_DETECT_ENABLE */
+#if CFG_FILTER_ENABLE
+static tfilter_t temporal;
+#endif /* CFG_FILTER_ENABLE */
+#if CFG_TRACK_ENABLE && !CFG_DETECT_ENABLE
+#error "CFG_TRACK_ENABLE tracks on the detector excess, it needs CFG_DETECT_ENABLE"
+#endif /* CFG_TRACK_ENABLE && !CFG_DETECT_ENABLE */
+#if CFG_TRACK_ENABLE
+static track_tracker_t tracker;
+static uint8_t track_prev;                      /* Confirmed tracks of the last report */
+#endif /* CFG_TRACK_ENABLE */
+static osal_task_t init_storage_task;
+static osal_task_t init_network_task;
+static osal_sem_t nvs_ready;
+#if METRICS_ENABLE
+static osal_task_t metrics_task;
+#endif /* METRICS_ENABLE */
+
+#if CFG_ARRAY_ENABLE
+static const app_array_sensor_t app_array_layout[CFG_ARRAY_SENSORS] = {
+    { 0, AMG88_I2C_ADDR_LOW,  { 0, 0, MOSAIC_ROT_0, false } },
+    { 0, AMG88_I2C_ADDR_HIGH, { 1, 0, MOSAIC_ROT_0, false } },
+    { 1, AMG88_I2C_ADDR_LOW,  { 0, 1, MOSAIC_ROT_0, false } },
+    { 1, AMG88_I2C_ADDR_HIGH, { 1, 1, MOSAIC_ROT_0, false } },
+};
+
+static amg88_dev_t array_devs[CFG_ARRAY_SENSORS];
+static sensor_array_t array;
+static mosaic_t array_mosaic;
+static frame_codec_enc_t array_enc[CFG_ARRAY_SENSORS];
+static osal_task_t array_task;
+#endif /* CFG_ARRAY_ENABLE */
+
+
+static bool
+app_process(const pipeline_frame_t* p_frame, void* p_out, void* arg) {
+    app_frame_t* p_app = (app_frame_t*) p_out;
+    const calib_table_t* p_calib = uc_calib_get();  /* NULL until NVS is up or without a stored table */
+    const amg88_frame_raw_t* p_raw;
+    uint32_t cycles;
+
+    p_app->seq = p_frame->seq;
+    p_app->ts_us = p_frame->ts_us;
+    p_raw = &p_frame->raw;
+    cycles = METRICS_START();
+    if (p_calib != NULL) {
+        calib_decode_frame(p_calib, &p_frame->raw, p_app->temp);
+    } else {
+        amg88_decode_frame(&p_frame->raw, p_app->temp);
+    }
+#if CFG_FILTER_ENABLE
+    tfilter_update(&temporal, p_app->temp);
+#endif /* CFG_FILTER_ENABLE */
+    if (p_calib != NULL || CFG_FILTER_ENABLE) {
+        p_app->corrected.thermistor[0] = p_frame->raw.thermistor[0];
+        p_app->corrected.thermistor[1] = p_frame->raw.thermistor[1];
+        calib_pack_frame(p_app->temp, &p_app->corrected);
+        p_raw = &p_app->corrected;
+    }
+    METRICS_STOP(METRICS_DECODE, cycles);
+    amg88_frame_stats(p_app->temp, AMG88_ARRAY_SIZE, &p_app->stats, NULL);
+
+#if CFG_GOV_ENABLE
+    /* The acquisition task keeps reading at the old period until told, a few extra duplicates at worst */
+    if (governor_update(&governor, p_app->temp, p_frame->ts_us)) {
+        ESP_LOGI(log_src, "Governor: level %d after %u changed pixels", governor.level, governor.changed);
+        if (governor_apply(&governor, &amg88_dev) != AMG88_OK) {
+            ESP_LOGW(log_src, "Governor: sensor mode change failed, retried on the next change");
+        }
+        pipeline_set_period(&pipeline, governor_period_us(governor.level));
+    }
+#endif /* CFG_GOV_ENABLE */
+
+    p_app->evt_len = 0;
+#if CFG_DETECT_ENABLE
+    if (detect_update(&detector, p_app->temp) > 0 || detect_prev_blobs > 0) {
+        p_app->evt_len = stream_proto_encode_blobs(p_app->evt, sizeof(p_app->evt), CFG_SENSOR_ID, uc_boot_id(),
+                                                   p_frame->seq, p_frame->ts_us, detector.blobs, detector.n_blobs,
+                                                   detector.overflow);
+    }
+    detect_prev_blobs = detector.n_blobs;
+#endif /* CFG_DETECT_ENABLE */
+
+    p_app->trk_len = 0;
+#if CFG_TRACK_ENABLE
+    /* On the excess over the background, a warm radiator is not a hotspot */
+    if (track_update(&tracker, detector.excess, p_frame->ts_us) > 0 || track_prev > 0) {
+        p_app->trk_len = stream_proto_encode_tracks(p_app->trk, sizeof(p_app->trk), CFG_SENSOR_ID, uc_boot_id(),
+                                                    p_frame->seq, p_frame->ts_us, tracker.tracks, TRACK_MAX_TRACKS);
+    }
+    track_prev = (uint8_t) (p_app->trk_len > 0 ? p_app->trk[STREAM_PROTO_HDR_SIZE] : 0);
+#endif /* CFG_TRACK_ENABLE */
+
+    if (p_app->seq % 10 == 0) {
+        ESP_LOGD(log_src, "Frame %u: min %.2f, max %.2f, mean %.2f", p_app->seq,
+                 AMG88_TEMP_FROM_FIXED(p_app->stats.min), AMG88_TEMP_FROM_FIXED(p_app->stats.max),
+                 AMG88_TEMP_FROM_FIXED(p_app->stats.mean));
+    }
+
+    /* Recorded packets are decoded apart from the live ones, both chains restart on a keyframe */
+    p_app->record = CFG_REC_ENABLE && !uc_init_wifi_connected();
+    if (p_app->record == stream_online) {
+        stream_online = !p_app->record;
+        frame_codec_enc_force_key(&stream_enc);
+    }
+
+    cycles = METRICS_START();
+    p_app->pkt_len = stream_proto_encode_codec(p_app->pkt, sizeof(p_app->pkt), CFG_SENSOR_ID, uc_boot_id(),
+                                               p_frame->seq, p_frame->ts_us,
+                                               p_app->record ? STREAM_FLAG_BACKFILL : 0, &stream_enc, p_raw);
+    METRICS_STOP(METRICS_ENCODE, cycles);
+    uc_boot_mark(UC_BOOT_FIRST_FRAME);
+
+#if CFG_LIVE_ENABLE
+    uc_live_publish(p_frame->seq, p_frame->ts_us, p_raw, p_app->temp, &p_app->stats);
+#endif /* CFG_LIVE_ENABLE */
+
+    return true;
+}
+
+static void
+app_send(const void* p_out, void* arg) {
+    const app_frame_t* p_app = (const app_frame_t*) p_out;
+
+    /* Events are live only, the recorder keeps the frames they come from */
+    if (p_app->record) {
+        uc_recorder_push(p_app->pkt, p_app->pkt_len);
+        return;
+    }
+    if (p_app->evt_len > 0 && uc_stream_send(p_app->evt, p_app->evt_len) != ESP_OK) {
+        METRICS_COUNT(METRICS_TX_ERRORS, 1);
+    }
+    if (p_app->trk_len > 0 && uc_stream_send(p_app->trk, p_app->trk_len) != ESP_OK) {
+        METRICS_COUNT(METRICS_TX_ERRORS, 1);
+    }
+    if (!CFG_DETECT_ENABLE || CFG_DETECT_FRAMES) {
+        if (uc_stream_send(p_app->pkt, p_app->pkt_len) == ESP_OK) {
+            uc_boot_mark(UC_BOOT_FIRST_TX);
+        } else {
+            METRICS_COUNT(METRICS_TX_ERRORS, 1);
+        }
+    }
+}
+
+#if METRICS_ENABLE
+/* One snapshot per period, cumulative: the receiver diffs them, a lost packet only widens the interval */
+static void
+app_metrics_task(void* arg) {
+    static metrics_t metrics;
+    static uint8_t pkt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_METRICS_SIZE];
+    uint64_t wake_us = osal_time_us();
+    uint32_t seq = 0;
+    size_t len;
+
+    while (true) {
+        osal_delay_until(&wake_us, CFG_METRICS_PERIOD_MS * 1000);
+        if (!uc_init_wifi_connected()) {
+            continue;
+        }
+
+        metrics_snapshot(&metrics);
+        len = stream_proto_encode_metrics(pkt, sizeof(pkt), CFG_SENSOR_ID, uc_boot_id(), seq++, osal_time_us(),
+                                          &metrics);
+        uc_stream_send(pkt, len);
+    }
+}
+#endif /* METRICS_ENABLE */
+
+#if CFG_ARRAY_ENABLE
+static void
+app_array_task(void* arg) {
+    static int16_t temp[CFG_ARRAY_SENSORS][AMG88_ARRAY_SIZE];
+    static int16_t mosaic[MOSAIC_MAX_SIZE];
+    static uint8_t pkt[STREAM_PROTO_MAX_PACKET];
+    const int16_t* p_temps[CFG_ARRAY_SENSORS];
+    const sensor_array_frame_t* p_set;
+    amg88_stats_t stats;
+    uint32_t cycles;
+    size_t len;
+
+    while (true) {
+        p_set = sensor_array_acquire(&array, OSAL_WAIT_FOREVER);
+        if (p_set == NULL) {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < CFG_ARRAY_SENSORS; ++i) {
+            p_temps[i] = NULL;
+            if (!(p_set->valid & (1 << i))) {
+                continue;
+            }
+            cycles = METRICS_START();
+            amg88_decode_frame(&p_set->raw[i], temp[i]);
+            METRICS_STOP(METRICS_DECODE, cycles);
+            p_temps[i] = temp[i];
+
+            /* Every sensor keeps its own stream, the receiver aligns them by timestamp */
+            cycles = METRICS_START();
+            len = stream_proto_encode_codec(pkt, sizeof(pkt), CFG_SENSOR_ID + i, uc_boot_id(), p_set->seq,
+                                            p_set->ts_us[i], 0, &array_enc[i], &p_set->raw[i]);
+            METRICS_STOP(METRICS_ENCODE, cycles);
+            if (!uc_init_wifi_connected()) {
+                continue;
+            }
+            cycles = METRICS_START();
+            if (uc_stream_send(pkt, len) == ESP_OK) {
+                uc_boot_mark(UC_BOOT_FIRST_TX);
+            } else {
+                METRICS_COUNT(METRICS_TX_ERRORS, 1);
+            }
+            METRICS_STOP(METRICS_SEND, cycles);
+        }
+
+        mosaic_stitch(&array_mosaic, p_temps, mosaic);
+        uc_boot_mark(UC_BOOT_FIRST_FRAME);
+        if (p_set->seq % 10 == 0) {
+            amg88_frame_stats(mosaic, MOSAIC_WIDTH(&array_mosaic) * MOSAIC_HEIGHT(&array_mosaic), &stats, NULL);
+            ESP_LOGD(log_src, "Mosaic %u (valid 0x%x): min %.2f, max %.2f, mean %.2f", p_set->seq, p_set->valid,
+                     AMG88_TEMP_FROM_FIXED(stats.min), AMG88_TEMP_FROM_FIXED(stats.max),
+                     AMG88_TEMP_FROM_FIXED(stats.mean));
+        }
+    }
+}
+
+static void
+app_array_start(void) {
+    mosaic_tile_t tiles[CFG_ARRAY_SENSORS];
+    sensor_array_cfg_t cfg = {
+        .n_sensors = CFG_ARRAY_SENSORS,
+        .period_us = CFG_ACQ_PERIOD_MS * 1000,
+        .read_thermistor = true,
+        .core = CFG_ACQ_CORE,
+        .prio = CFG_ACQ_PRIO,
+    };
+
+    for (uint8_t i = 0; i < CFG_ARRAY_SENSORS; ++i) {
+        array_devs[i].bus = app_array_layout[i].bus;
+        array_devs[i].addr = app_array_layout[i].addr;
+        AMG88_HAL_HW_INIT(&array_devs[i]);
+        array_devs[i].retry = amg88_retry;
+        frame_codec_enc_init(&array_enc[i], CFG_STREAM_KEY_INTERVAL);
+        cfg.p_devs[i] = &array_devs[i];
+        tiles[i] = app_array_layout[i].tile;
+    }
+
+    /* 2x2 grid, empty cells and missing sensors are drawn at 0 degrees */
+    if (mosaic_init(&array_mosaic, 2, 2, tiles, CFG_ARRAY_SENSORS, 0) != MOSAIC_OK) {
+        ESP_LOGE(log_src, "Bad mosaic layout");
+        return;
+    }
+
+    if (sensor_array_start(&array, &cfg) != OSAL_OK
+        || osal_task_create(&array_task, "app_array", app_array_task, NULL, SENSOR_ARRAY_STACK_SIZE,
+                            CFG_PROC_PRIO, CFG_PROC_CORE) != OSAL_OK) {
+        ESP_LOGE(log_src, "Sensor array start failed");
+    }
+}
+#endif /* CFG_ARRAY_ENABLE */
+
+/* Storage chain: NVS, then what is kept in it. Without NVS frames still flow, uncalibrated */
+static void
+app_init_storage(void* arg) {
+    esp_err_t ret = uc_init_sys();
+
+    if (ret == ESP_OK) {
+        uc_calib_load();
+    } else {
+        ESP_LOGE(log_src, "NVS init failed (%s), no calibration", esp_err_to_name(ret));
+    }
+#if CFG_REC_ENABLE
+    uc_recorder_init();
+#endif /* CFG_REC_ENABLE */
+    uc_boot_mark(UC_BOOT_NVS_READY);
+    osal_sem_give(&nvs_ready);
+}
+
+/* Bus setup is retried rather than rebooting, nothing works without the sensor anyway */
+static void
+app_init_i2c(uint8_t port, int sda_pin, int scl_pin) {
+    esp_err_t ret;
+
+    while ((ret = uc_init_i2c(port, sda_pin, scl_pin)) != ESP_OK) {
+        ESP_LOGE(log_src, "I2C%u init failed (%s), retrying", port, esp_err_to_name(ret));
+        osal_delay_ms(CFG_I2C_INIT_RETRY_MS);
+    }
+}
+
+/* Network chain: the stack comes up next to NVS, only WiFi itself has to wait for it */
+static void
+app_init_network(void* arg) {
+    esp_err_t ret;
+
+    /* A failure leaves the device offline, recording if it can, instead of rebooting in a loop */
+    ret = uc_init_net();
+    if (ret == ESP_OK) {
+        ret = uc_stream_init(CFG_STREAM_HOST, CFG_STREAM_PORT);
+    }
+#if CFG_LIVE_ENABLE
+    if (ret == ESP_OK && uc_live_init(CFG_LIVE_PORT) != ESP_OK) {
+        ESP_LOGW(log_src, "Live view server start failed");
+    }
+#endif /* CFG_LIVE_ENABLE */
+    osal_sem_take(&nvs_ready, OSAL_WAIT_FOREVER);
+    if (ret == ESP_OK) {
+        ret = uc_init_wifi();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(log_src, "Network init failed (%s), running offline", esp_err_to_name(ret));
+        return;
+    }
+    uc_boot_mark(UC_BOOT_NET_READY);
+}
+
 void
 app_main(void) {
+    uc_boot_mark(UC_BOOT_APP_START);
+
     /* Set logs verbosity level */
 #ifdef DEBUG_PRINT_ENABLE
     esp_log_level_set("*", ESP_LOG_VERBOSE);
@@ -30,6 +411,101 @@ app_main(void) {
 
     ESP_LOGI(log_src, "uC start");
 
-    ESP_ERROR_CHECK(uc_init_sys());
-    ESP_ERROR_CHECK(uc_init_wifi());
+    /* Storage and network come up in the background, frames flow before WiFi associates */
+    if (osal_sem_init(&nvs_ready) != OSAL_OK
+        || osal_task_create(&init_storage_task, "app_init_nvs", app_init_storage, NULL, APP_INIT_STACK_SIZE,
+                            CFG_PROC_PRIO, OSAL_CORE_ANY) != OSAL_OK
+        || osal_task_create(&init_network_task, "app_init_net", app_init_network, NULL, APP_INIT_STACK_SIZE,
+                            CFG_PROC_PRIO, OSAL_CORE_ANY) != OSAL_OK) {
+        ESP_LOGE(log_src, "Init tasks start failed");
+    }
+#if METRICS_ENABLE
+    if (osal_task_create(&metrics_task, "app_metrics", app_metrics_task, NULL, APP_INIT_STACK_SIZE,
+                         CFG_METRICS_PRIO, OSAL_CORE_ANY) != OSAL_OK) {
+        ESP_LOGE(log_src, "Metrics task start failed");
+    }
+#endif /* METRICS_ENABLE */
+
+    app_init_i2c(0, CFG_I2C_SDA_PIN, CFG_I2C_SCL_PIN);
+
+#if CFG_ARRAY_ENABLE
+    app_init_i2c(1, CFG_I2C1_SDA_PIN, CFG_I2C1_SCL_PIN);
+    uc_boot_mark(UC_BOOT_SENSOR_READY);
+    app_array_start();
+    return;
+#endif /* CFG_ARRAY_ENABLE */
+
+    AMG88_HAL_HW_INIT(&amg88_dev);
+    amg88_dev.retry = amg88_retry;
+    if (amg88_set_moving_average(&amg88_dev, CFG_AMG88_AVE) != AMG88_OK) {
+        ESP_LOGW(log_src, "Moving average mode not set, frames come unaveraged");
+    }
+    frame_codec_enc_init(&stream_enc, CFG_STREAM_KEY_INTERVAL);
+#if CFG_FILTER_ENABLE
+    tfilter_cfg_t flt_cfg = {
+        .mode = CFG_FILTER_MODE,
+        .iir_shift = CFG_FILTER_IIR_SHIFT,
+        .q = CFG_FILTER_Q,
+        .r = CFG_FILTER_R,
+        .step = CFG_FILTER_STEP,
+    };
+
+    tfilter_init(&temporal, &flt_cfg);
+#endif /* CFG_FILTER_ENABLE */
+#if CFG_GOV_ENABLE
+    governor_cfg_t gov_cfg = {
+        .pixel_delta = CFG_GOV_PIXEL_DELTA,
+        .on_pixels = CFG_GOV_ON_PIXELS,
+        .off_pixels = CFG_GOV_OFF_PIXELS,
+        .idle_after_ms = CFG_GOV_IDLE_MS,
+        .standby_after_ms = CFG_GOV_STANDBY_MS,
+    };
+
+    governor_init(&governor, &gov_cfg);
+    governor_apply(&governor, &amg88_dev);      /* A warm reboot can find the sensor still in stand-by */
+#endif /* CFG_GOV_ENABLE */
+#if CFG_DETECT_ENABLE
+    detect_cfg_t det_cfg = {
+        .bg_shift = CFG_DETECT_BG_SHIFT,
+        .fg_shift = CFG_DETECT_FG_SHIFT,
+        .threshold = CFG_DETECT_THRESHOLD,
+        .min_pixels = CFG_DETECT_MIN_PIXELS,
+        .warmup = CFG_DETECT_WARMUP,
+    };
+
+    detect_init(&detector, &det_cfg);
+#endif /* CFG_DETECT_ENABLE */
+#if CFG_TRACK_ENABLE
+    track_cfg_t trk_cfg = {
+        .threshold = CFG_TRACK_THRESHOLD,
+        .refine = CFG_TRACK_REFINE,
+        .gate = CFG_TRACK_GATE,
+        .alpha = CFG_TRACK_ALPHA,
+        .beta = CFG_TRACK_BETA,
+        .confirm_hits = CFG_TRACK_CONFIRM_HITS,
+        .max_misses = CFG_TRACK_MAX_MISSES,
+    };
+
+    track_init(&tracker, &trk_cfg);
+#endif /* CFG_TRACK_ENABLE */
+
+    pipeline_cfg_t pipe_cfg = {
+        .p_dev = &amg88_dev,
+        .period_us = CFG_ACQ_PERIOD_MS * 1000,
+        .read_thermistor = true,
+        .sync = CFG_ACQ_SYNC,
+        .acq_core = CFG_ACQ_CORE,
+        .acq_prio = CFG_ACQ_PRIO,
+        .proc_core = CFG_PROC_CORE,
+        .proc_prio = CFG_PROC_PRIO,
+        .process = app_process,
+        .send = app_send,
+        .p_out_buf = pipeline_out,
+        .out_size = sizeof(pipeline_out[0]),
+    };
+
+    uc_boot_mark(UC_BOOT_SENSOR_READY);
+    if (pipeline_start(&pipeline, &pipe_cfg) != OSAL_OK) {
+        ESP_LOGE(log_src, "Pipeline start failed");
+    }
 }
@@ -0,0 +1,61 @@
+/**
+ * \file            uc_boot.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Startup latency instrumentation
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "uc_boot.h"
+
+#include <stdatomic.h>
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+/* Vars */
+static char* log_src = "uc_boot";
+static const char* const event_names[UC_BOOT_EVENTS] = {
+    "app start",
+    "nvs ready",
+    "net ready",
+    "sensor ready",
+    "first frame",
+    "wifi connected",
+    "first tx",
+};
+static atomic_uint_least64_t event_us[UC_BOOT_EVENTS];
+static atomic_uint_least16_t boot_id;
+
+
+void
+uc_boot_mark(uc_boot_event_t event) {
+    uint_least64_t expected = 0;
+    uint64_t now = (uint64_t) esp_timer_get_time();
+
+    /* Cheap once set: a single load on the hot paths that call this every frame */
+    if (atomic_load_explicit(&event_us[event], memory_order_relaxed) != 0) {
+        return;
+    }
+    if (atomic_compare_exchange_strong(&event_us[event], &expected, now != 0 ? now : 1)) {
+        ESP_LOGI(log_src, "Boot to %s: %llu.%03llu ms", event_names[event], now / 1000, now % 1000);
+    }
+}
+
+uint64_t
+uc_boot_time_us(uc_boot_event_t event) {
+    return atomic_load(&event_us[event]);
+}
+
+uint16_t
+uc_boot_id(void) {
+    uint_least16_t expected = 0;
+
+    /* Whoever draws first wins, `0` is kept for senders without one */
+    if (atomic_load_explicit(&boot_id, memory_order_relaxed) == 0) {
+        atomic_compare_exchange_strong(&boot_id, &expected, (uint_least16_t) (esp_random() % 0xFFFF + 1));
+    }
+
+    return (uint16_t) atomic_load_explicit(&boot_id, memory_order_relaxed);
+}
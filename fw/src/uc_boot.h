@@ -0,0 +1,59 @@
+/**
+ * \file            uc_boot.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Startup latency instrumentation
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef UC_BOOT_H
+#define UC_BOOT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Startup milestones
+ */
+typedef enum {
+    UC_BOOT_APP_START,                          /*!< app_main entered */
+    UC_BOOT_NVS_READY,                          /*!< NVS, calibration and recorder up */
+    UC_BOOT_NET_READY,                          /*!< Network stack up, WiFi association started */
+    UC_BOOT_SENSOR_READY,                       /*!< I2C up and acquisition started */
+    UC_BOOT_FIRST_FRAME,                        /*!< First frame acquired and processed */
+    UC_BOOT_WIFI_CONNECTED,                     /*!< First IP address */
+    UC_BOOT_FIRST_TX,                           /*!< First frame handed to the network */
+    UC_BOOT_EVENTS,                             /*!< Number of milestones */
+} uc_boot_event_t;
+
+/**
+ * \brief           Record a milestone, only its first occurrence counts
+ * \note            Callable from any task. Times are taken from esp_timer, which starts early in the
+ *                  application startup: the bootloader time (a few hundred ms) is not included
+ * \param[in]       event: Milestone
+ */
+void uc_boot_mark(uc_boot_event_t event);
+
+/**
+ * \brief           Time of a milestone
+ * \param[in]       event: Milestone
+ * \return          Time since startup in us, `0` if not reached yet
+ */
+uint64_t uc_boot_time_us(uc_boot_event_t event);
+
+/**
+ * \brief           ID of this boot, written in every stream header
+ * \note            Random and never `0`, drawn on the first call. Receivers tell a device restart from a late packet
+ *                  by it
+ * \return          Boot ID
+ */
+uint16_t uc_boot_id(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UC_BOOT_H */
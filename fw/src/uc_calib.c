@@ -0,0 +1,132 @@
+/**
+ * \file            uc_calib.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Calibration table storage (NVS) and capture
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "uc_calib.h"
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "user_config.h"
+#include "amg88/amg88.h"
+
+/* Vars */
+static char* log_src = "uc_calib";
+static uint8_t blob[CALIB_BLOB_SIZE];           /* Serialization buffer, kept off the caller stack */
+static calib_table_t table;
+static atomic_bool loaded = false;             /* Set once `table` is complete, read by the processing task */
+
+
+esp_err_t
+uc_calib_load(void) {
+    nvs_handle_t handle;
+    size_t len = sizeof(blob);
+    calib_err_t err;
+    esp_err_t ret;
+
+    atomic_store(&loaded, false);
+
+    ret = nvs_open(CFG_CALIB_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGI(log_src, "No calibration stored");
+        return ret;
+    }
+    ret = nvs_get_blob(handle, CFG_CALIB_NVS_KEY, blob, &len);
+    nvs_close(handle);
+    if (ret != ESP_OK) {
+        ESP_LOGI(log_src, "No calibration stored");
+        return ret;
+    }
+
+    err = calib_parse(blob, len, &table);
+    if (err != CALIB_OK) {
+        ESP_LOGW(log_src, "Stored calibration rejected (%d), decoding uncorrected", err);
+        return err == CALIB_ERR_CRC ? ESP_ERR_INVALID_CRC : ESP_ERR_INVALID_VERSION;
+    }
+
+    atomic_store(&loaded, true);
+    ESP_LOGI(log_src, "Calibration loaded");
+
+    return ESP_OK;
+}
+
+const calib_table_t*
+uc_calib_get(void) {
+    return atomic_load(&loaded) ? &table : NULL;
+}
+
+esp_err_t
+uc_calib_save(const calib_table_t* p_table) {
+    nvs_handle_t handle;
+    size_t len;
+    esp_err_t ret;
+
+    len = calib_serialize(p_table, blob, sizeof(blob));
+    if (len == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    ret = nvs_open(CFG_CALIB_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(handle, CFG_CALIB_NVS_KEY, blob, len);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (ret == ESP_OK) {
+        table = *p_table;
+        atomic_store(&loaded, true);
+    }
+
+    return ret;
+}
+
+esp_err_t
+uc_calib_erase(void) {
+    nvs_handle_t handle;
+    esp_err_t ret;
+
+    atomic_store(&loaded, false);
+
+    ret = nvs_open(CFG_CALIB_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_erase_key(handle, CFG_CALIB_NVS_KEY);
+    if (ret == ESP_OK || ret == ESP_ERR_NVS_NOT_FOUND) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    return ret;
+}
+
+esp_err_t
+uc_calib_capture(amg88_dev_t* p_dev, calib_acc_t* p_acc, uint16_t n_frames, uint32_t period_ms) {
+    amg88_frame_raw_t frame;
+    TickType_t wake = xTaskGetTickCount();
+
+    for (uint16_t i = 0; i < n_frames; ++i) {
+        if (amg88_get_frame_raw(p_dev, &frame, true) != AMG88_OK) {
+            ESP_LOGE(log_src, "Capture read failed at frame %u", i);
+            return ESP_FAIL;
+        }
+        calib_acc_add(p_acc, &frame);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(period_ms));
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,66 @@
+/**
+ * \file            uc_calib.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Calibration table storage (NVS) and capture
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef UC_CALIB_H
+#define UC_CALIB_H
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "amg88/amg88_defs.h"
+#include "calib/calib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Load the stored table into the static copy, once at boot
+ * \note            NVS must be initialized (\ref uc_init_sys)
+ * \return          ESP_OK when a valid table was loaded, ESP_ERR_NVS_NOT_FOUND when there is none,
+ *                  ESP_ERR_INVALID_CRC or ESP_ERR_INVALID_VERSION for a rejected blob
+ */
+esp_err_t uc_calib_load(void);
+
+/**
+ * \brief           Loaded table
+ * \return          The table, NULL when no valid calibration is stored
+ */
+const calib_table_t* uc_calib_get(void);
+
+/**
+ * \brief           Store a table and make it the loaded one
+ * \note            Replaces the table in place, do not call it while frames are being decoded with it
+ * \param[in]       p_table: Table to store
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_calib_save(const calib_table_t* p_table);
+
+/**
+ * \brief           Erase the stored table, frames are decoded uncorrected afterwards
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_calib_erase(void);
+
+/**
+ * \brief           Accumulate frames for a capture routine (see calib.h)
+ * \note            Reads the sensor directly, do not run it while the pipeline owns the device
+ * \param[in]       p_dev: Sensor handler
+ * \param[inout]    p_acc: Accumulator, frames are added to what it already holds
+ * \param[in]       n_frames: Frames to add
+ * \param[in]       period_ms: Time between reads, the sensor frame period
+ * \return          ESP_OK on success, ESP_FAIL on a read error
+ */
+esp_err_t uc_calib_capture(amg88_dev_t* p_dev, calib_acc_t* p_acc, uint16_t n_frames, uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UC_CALIB_H */
@@ -8,52 +8,85 @@
 
 #include "uc_init.h"
 
+#include <stdatomic.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/event_groups.h"
 
 #include "esp_system.h"
 #include "esp_event.h"
 #include "esp_wifi.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+#include "esp_rom_sys.h"
+
+#include "osal/osal.h"
 
 #include "user_config.h"
+#include "uc_boot.h"
 
 /* Vars */
 static char* log_src = "uc_init";
-static EventGroupHandle_t wifi_event_group;
+static esp_netif_t* p_sta_netif;
+static esp_timer_handle_t wifi_retry_timer;
+static uint32_t wifi_backoff_ms = CFG_WIFI_BACKOFF_MIN_MS;
+static atomic_bool wifi_connected = false;
+static int i2c_pins[I2C_NUM_MAX][2] = { { -1, -1 }, { -1, -1 } }; /* SDA, SCL of every set up port */
+static osal_sem_t i2c_locks[I2C_NUM_MAX];       /* One owner per port: a transfer or a recovery */
 
 
 static void
-wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
-    static int retry_num = 0;
+wifi_retry_cb(void* arg) {
+    esp_wifi_connect();
+}
 
+static void
+wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (retry_num < CFG_WIFI_MAX_RETRY) {
-            esp_wifi_connect();
-            retry_num++;
-            ESP_LOGI(log_src, "Retrying connection to AP");
-        } else {
-            xEventGroupSetBits(wifi_event_group, WIFI_FAIL_BIT);
-        }
+        uint32_t delay_ms;
 
-        ESP_LOGI(log_src,"Connection to the AP failed");
+        atomic_store(&wifi_connected, false);
+
+        /* Never give up, back off exponentially; the jitter keeps a fleet from retrying in lockstep */
+        delay_ms = wifi_backoff_ms - wifi_backoff_ms / 4 + esp_random() % (wifi_backoff_ms / 2 + 1);
+        wifi_backoff_ms = wifi_backoff_ms >= CFG_WIFI_BACKOFF_MAX_MS / 2 ? CFG_WIFI_BACKOFF_MAX_MS
+                                                                         : 2 * wifi_backoff_ms;
+        esp_timer_stop(wifi_retry_timer);
+        esp_timer_start_once(wifi_retry_timer, (uint64_t) delay_ms * 1000);
+
+        ESP_LOGI(log_src, "Connection to the AP failed, retrying in %u ms", delay_ms);
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(log_src, "Got ip:" IPSTR, IP2STR(&event->ip_info.ip));
-        retry_num = 0;
-        xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
+        wifi_backoff_ms = CFG_WIFI_BACKOFF_MIN_MS;
+        atomic_store(&wifi_connected, true);
+        uc_boot_mark(UC_BOOT_WIFI_CONNECTED);
     }
 }
 
+esp_err_t
+uc_init_net() {
+    UC_RETURN_FAIL(esp_netif_init());
+    UC_RETURN_FAIL(esp_event_loop_create_default());
+    p_sta_netif = esp_netif_create_default_wifi_sta();
+    UC_RETURN_FAIL(esp_netif_set_hostname(p_sta_netif, CFG_WIFI_HOSTNAME));
+
+    return ESP_OK;
+}
+
 esp_err_t
 uc_init_wifi() {
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_event_handler_instance_t instance_any_id, instance_got_ip;
+    esp_timer_create_args_t timer_args = {
+        .callback = wifi_retry_cb,
+        .name = "wifi_retry",
+    };
 
     wifi_config_t wifi_config = {
         .sta = {
@@ -67,16 +100,7 @@ uc_init_wifi() {
         },
     };
 
-    esp_netif_t* p_netif;
-
-    wifi_event_group = xEventGroupCreate();
-
-    UC_RETURN_FAIL(esp_netif_init());
-
-    UC_RETURN_FAIL(esp_event_loop_create_default());
-    p_netif = esp_netif_create_default_wifi_sta();
-    UC_RETURN_FAIL(esp_netif_set_hostname(p_netif, CFG_WIFI_HOSTNAME));
-
+    UC_RETURN_FAIL(esp_timer_create(&timer_args, &wifi_retry_timer));
     UC_RETURN_FAIL(esp_wifi_init(&cfg));
 
     UC_RETURN_FAIL(
@@ -84,44 +108,129 @@ uc_init_wifi() {
                                             ESP_EVENT_ANY_ID,
                                             &wifi_event_handler,
                                             NULL,
-                                            &instance_any_id)
+                                            NULL)
     );
     UC_RETURN_FAIL(
         esp_event_handler_instance_register(IP_EVENT,
                                             IP_EVENT_STA_GOT_IP,
                                             &wifi_event_handler,
                                             NULL,
-                                            &instance_got_ip)
+                                            NULL)
     );
 
     UC_RETURN_FAIL(esp_wifi_set_mode(WIFI_MODE_STA));
     UC_RETURN_FAIL(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+
+    /* Association happens in the background, see uc_init_wifi_connected */
     UC_RETURN_FAIL(esp_wifi_start());
+    ESP_LOGI(log_src, "Connecting to %s", CFG_WIFI_SSID);
 
-    EventBits_t bits = xEventGroupWaitBits(
-        wifi_event_group,
-        WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-        pdFALSE,
-        pdFALSE,
-        portMAX_DELAY
-    );
+    return ESP_OK;
+}
 
-    if (bits & WIFI_CONNECTED_BIT) {
-        ESP_LOGI(log_src, "Connected to %s", CFG_WIFI_SSID);
-    } else if (bits & WIFI_FAIL_BIT) {
-        ESP_LOGI(log_src, "Failed to connect to %s", CFG_WIFI_SSID);
-    } else {
-        ESP_LOGE(log_src, "UNEXPECTED EVENT");
+bool
+uc_init_wifi_connected(void) {
+    return atomic_load(&wifi_connected);
+}
+
+/* Driver install only, the recovery goes through it again with the bus lock held */
+static esp_err_t
+uc_init_i2c_install(uint8_t port, int sda_pin, int scl_pin) {
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = sda_pin,
+        .scl_io_num = scl_pin,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = CFG_I2C_FREQ_HZ,
+    };
+
+    UC_RETURN_FAIL(i2c_param_config((i2c_port_t) port, &conf));
+    UC_RETURN_FAIL(i2c_driver_install((i2c_port_t) port, conf.mode, 0, 0, 0));
+
+    return ESP_OK;
+}
+
+esp_err_t
+uc_init_i2c(uint8_t port, int sda_pin, int scl_pin) {
+    if (port >= I2C_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    /* The event will not be processed after unregister */
-    UC_RETURN_FAIL(esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, instance_got_ip));
-    UC_RETURN_FAIL(esp_event_handler_instance_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID, instance_any_id));
-    vEventGroupDelete(wifi_event_group);
+    /* The lock exists before the pins are published, so a port with pins always has one */
+    if (i2c_pins[port][0] < 0) {
+        if (osal_sem_init(&i2c_locks[port]) != OSAL_OK) {
+            return ESP_ERR_NO_MEM;
+        }
+        osal_sem_give(&i2c_locks[port]);
+    }
+    UC_RETURN_FAIL(uc_init_i2c_install(port, sda_pin, scl_pin));
+    i2c_pins[port][0] = sda_pin;
+    i2c_pins[port][1] = scl_pin;
 
     return ESP_OK;
 }
 
+void
+uc_init_i2c_lock(uint8_t port) {
+    if (port < I2C_NUM_MAX && i2c_pins[port][0] >= 0) {
+        osal_sem_take(&i2c_locks[port], OSAL_WAIT_FOREVER);
+    }
+}
+
+void
+uc_init_i2c_unlock(uint8_t port) {
+    if (port < I2C_NUM_MAX && i2c_pins[port][0] >= 0) {
+        osal_sem_give(&i2c_locks[port]);
+    }
+}
+
+esp_err_t
+uc_init_i2c_recover(uint8_t port) {
+    const uint32_t half_us = 5;                 /* 100 kHz, slow enough for any slave */
+    esp_err_t ret;
+    int sda, scl;
+
+    if (port >= I2C_NUM_MAX || i2c_pins[port][0] < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    sda = i2c_pins[port][0];
+    scl = i2c_pins[port][1];
+
+    /* No transfer from another task (bus worker, config writes) may run on a deleted driver */
+    uc_init_i2c_lock(port);
+
+    /* The driver owns the pins until deleted, a failure here only means it was already gone */
+    i2c_driver_delete((i2c_port_t) port);
+    gpio_set_direction(sda, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_direction(scl, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_level(sda, 1);
+    gpio_set_level(scl, 1);
+    esp_rom_delay_us(half_us);
+
+    /* A slave stuck mid-byte lets SDA go within 9 clocks */
+    for (uint8_t i = 0; i < 9 && gpio_get_level(sda) == 0; ++i) {
+        gpio_set_level(scl, 0);
+        esp_rom_delay_us(half_us);
+        gpio_set_level(scl, 1);
+        esp_rom_delay_us(half_us);
+    }
+
+    /* STOP: SDA rises while SCL is high */
+    gpio_set_level(scl, 0);
+    gpio_set_level(sda, 0);
+    esp_rom_delay_us(half_us);
+    gpio_set_level(scl, 1);
+    esp_rom_delay_us(half_us);
+    gpio_set_level(sda, 1);
+    esp_rom_delay_us(half_us);
+
+    ret = uc_init_i2c_install(port, sda, scl);
+    uc_init_i2c_unlock(port);
+
+    return ret;
+}
+
 esp_err_t
 uc_init_sys() {
     /* NVS */
@@ -9,36 +9,79 @@
 #ifndef UC_INIT_H
 #define UC_INIT_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #include "esp_err.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
-#define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT      BIT1
-
 /**
  * \brief           Return on failure
  * \param[in]       err: Error code
  * \hideinitializer
  */
-/*
 #define UC_RETURN_FAIL(err) do {    \
     esp_err_t _err_tmp = err;       \
     if (_err_tmp != ESP_OK) {       \
         return _err_tmp;            \
     }                               \
 } while (0)
-*/
-#define UC_RETURN_FAIL ESP_ERROR_CHECK
 
 /**
- * \brief           Init uC wifi comms
- * \return          Result 
+ * \brief           Init the network stack and the default event loop, no NVS needed
+ * \return          Result
+ */
+esp_err_t uc_init_net();
+
+/**
+ * \brief           Start WiFi, returns without waiting for the association
+ * \note            Needs \ref uc_init_net and \ref uc_init_sys (NVS). A lost or missing AP is retried
+ *                  forever with exponential backoff, from \ref CFG_WIFI_BACKOFF_MIN_MS to \ref CFG_WIFI_BACKOFF_MAX_MS
+ * \return          Result
  */
 esp_err_t uc_init_wifi();
 
+/**
+ * \brief           WiFi link state
+ * \return          `true` while connected with an IP address
+ */
+bool uc_init_wifi_connected(void);
+
+/**
+ * \brief           Init a sensors I2C bus
+ * \param[in]       port: I2C port (controller) number
+ * \param[in]       sda_pin: SDA GPIO
+ * \param[in]       scl_pin: SCL GPIO
+ * \return          Result
+ */
+esp_err_t uc_init_i2c(uint8_t port, int sda_pin, int scl_pin);
+
+/**
+ * \brief           Take the bus of an I2C port, one transfer or recovery at a time across tasks
+ * \note            No-op on a port not set up with \ref uc_init_i2c. Not recursive
+ * \param[in]       port: I2C port (controller) number
+ */
+void uc_init_i2c_lock(uint8_t port);
+
+/**
+ * \brief           Give back the bus taken with \ref uc_init_i2c_lock
+ * \param[in]       port: I2C port (controller) number
+ */
+void uc_init_i2c_unlock(uint8_t port);
+
+/**
+ * \brief           Free an I2C bus a slave holds down and re-init its driver
+ * \note            Clocks SCL until SDA is released (9 pulses at most), sends a STOP and installs the driver
+ *                  again with the \ref uc_init_i2c settings. Takes about 100 us plus the driver install.
+ *                  Holds the bus lock throughout, so call it without it
+ * \param[in]       port: I2C port (controller) number, already set up with \ref uc_init_i2c
+ * \return          Result
+ */
+esp_err_t uc_init_i2c_recover(uint8_t port);
+
 /**
  * \brief           Init uC system
  * \return          Result 
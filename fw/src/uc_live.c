@@ -0,0 +1,389 @@
+/**
+ * \file            uc_live.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Live view server: TCP and WebSocket viewers, every frame encoded once per format in use
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "uc_live.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "lwip/sockets.h"
+#include "mbedtls/sha1.h"
+#include "mbedtls/base64.h"
+#include "esp_log.h"
+
+#include "user_config.h"
+#include "osal/osal.h"
+#include "fanout/fanout.h"
+#include "stream_proto/stream_proto.h"
+#include "frame_codec/frame_codec.h"
+#include "interp/interp.h"
+#include "render/render.h"
+#include "uc_boot.h"
+
+#define UC_LIVE_SCALE       4                   /* Color output upscaling, 8x8 to 32x32 */
+#define UC_LIVE_SIDE        (AMG88_ARRAY_COLS * UC_LIVE_SCALE)
+#define UC_LIVE_COLOR_SIZE  (STREAM_PROTO_HDR_SIZE + STREAM_PROTO_IMAGE_HDR + UC_LIVE_SIDE * UC_LIVE_SIDE * 2)
+#define UC_LIVE_PACKED_SIZE (STREAM_PROTO_HDR_SIZE + FRAME_CODEC_MAX_SIZE)
+#define UC_LIVE_RAW_SIZE    (STREAM_PROTO_HDR_SIZE + STREAM_PROTO_FRAME_RAW_SIZE)
+#define UC_LIVE_IDLE_MS     1000                /* Peer check period while no frame comes (stand-by) */
+#define UC_LIVE_SEND_MS     1000                /* A client that can't take a frame in this long is dropped */
+#define UC_LIVE_REQ_MS      2000                /* Time to get the first byte or the HTTP request */
+#define UC_LIVE_WS_GUID     "258EAFA5-E914-47DA-95CA-C5AB0DC11B4E"
+
+/**
+ * \brief           Client worker, one per fan-out slot
+ * \note            Tasks are never deleted (OSAL task slots are not reused), a worker idles until the listener
+ *                  hands it the next connection
+ */
+typedef struct {
+    osal_task_t task;                           /*!< Worker task */
+    osal_sem_t start;                           /*!< Given when `sock` holds a new connection */
+    int sock;                                   /*!< Client socket */
+    bool ws;                                    /*!< WebSocket framing */
+    int8_t id;                                  /*!< Fan-out client id, the worker index */
+} uc_live_worker_t;
+
+/* Vars */
+static char* log_src = "uc_live";
+static atomic_bool ready = false;
+static int listen_sock = -1;
+static fanout_t fan;
+static osal_task_t listen_task;
+static uc_live_worker_t workers[FANOUT_MAX_CLIENTS];
+static char req[512];
+
+static uint8_t raw_bufs[FANOUT_MAX_BUFS][UC_LIVE_RAW_SIZE];
+static uint8_t packed_bufs[FANOUT_MAX_BUFS][UC_LIVE_PACKED_SIZE];
+static uint8_t color_bufs[FANOUT_MAX_BUFS][UC_LIVE_COLOR_SIZE];
+
+/* Producer state, only touched from the processing task */
+static frame_codec_enc_t key_enc;
+static render_t render;
+static int16_t upscaled[INTERP_OUT_LEN(UC_LIVE_SCALE)];
+static int32_t interp_tmp[INTERP_TMP_LEN(UC_LIVE_SCALE)];
+static uint32_t interp_worst;                   /* Slowest upscale over the budget so far, cycles */
+
+static const char* ws_paths[UC_LIVE_FORMATS] = {
+    [UC_LIVE_RAW] = "/raw",
+    [UC_LIVE_PACKED] = "/packed",
+    [UC_LIVE_COLOR] = "/color",
+};
+
+
+static bool
+uc_live_send_all(int sock, const uint8_t* p_data, size_t len, int flags) {
+    ssize_t sent;
+
+    while (len > 0) {
+        sent = send(sock, p_data, len, flags);
+        if (sent <= 0) {
+            return false;
+        }
+        p_data += sent;
+        len -= (size_t) sent;
+    }
+
+    return true;
+}
+
+/* Unmasked binary message, server frames are never masked */
+static bool
+uc_live_send_ws(int sock, const uint8_t* p_data, size_t len) {
+    uint8_t hdr[4] = { 0x82 };
+    size_t hdr_len = 2;
+
+    if (len < 126) {
+        hdr[1] = (uint8_t) len;
+    } else {
+        hdr[1] = 126;
+        hdr[2] = (uint8_t) (len >> 8);
+        hdr[3] = (uint8_t) len;
+        hdr_len = 4;
+    }
+
+    return uc_live_send_all(sock, hdr, hdr_len, MSG_MORE) && uc_live_send_all(sock, p_data, len, 0);
+}
+
+/* Whatever a client sends after the handshake is dropped, only a close matters */
+static bool
+uc_live_peer_open(const uc_live_worker_t* p_w) {
+    uint8_t buf[32];
+    ssize_t len = recv(p_w->sock, buf, sizeof(buf), MSG_DONTWAIT);
+
+    if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        return false;
+    }
+    /* WebSocket close, assuming the read starts on a message boundary as it does for a quiet viewer */
+    if (len > 0 && p_w->ws && (buf[0] & 0x0F) == 0x08) {
+        return false;
+    }
+
+    return true;
+}
+
+static void
+uc_live_worker_task(void* arg) {
+    uc_live_worker_t* p_w = (uc_live_worker_t*) arg;
+    fanout_buf_t* p_buf;
+    bool ok;
+
+    while (true) {
+        osal_sem_take(&p_w->start, OSAL_WAIT_FOREVER);
+
+        do {
+            p_buf = fanout_take(&fan, p_w->id, UC_LIVE_IDLE_MS);
+            if (p_buf == NULL) {
+                ok = uc_live_peer_open(p_w);
+                continue;
+            }
+            ok = p_w->ws ? uc_live_send_ws(p_w->sock, p_buf->p_data, p_buf->len)
+                         : uc_live_send_all(p_w->sock, p_buf->p_data, p_buf->len, 0);
+            fanout_release(p_buf);
+            ok = ok && uc_live_peer_open(p_w);
+        } while (ok);
+
+        ESP_LOGI(log_src, "Client %d gone: %u frames sent, %u skipped", p_w->id,
+                 atomic_load(&fan.clients[p_w->id].delivered), atomic_load(&fan.clients[p_w->id].skipped));
+        /* Done with the socket before the slot is free: the listener may hand the worker a new one right after */
+        close(p_w->sock);
+        p_w->sock = -1;
+        fanout_unsubscribe(&fan, p_w->id);
+    }
+}
+
+/* HTTP upgrade, https://datatracker.ietf.org/doc/html/rfc6455#section-4.2 */
+static int
+uc_live_ws_handshake(int sock, size_t len) {
+    static const char key_field[] = "Sec-WebSocket-Key:";
+    static const char not_found[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    uint8_t digest[20];
+    uint8_t accept[32];
+    char* p_key;
+    char* p_end;
+    size_t accept_len;
+    int format = -1;
+    int ret;
+
+    /* The request is small and comes in one segment from a browser, read until the end of the headers anyway */
+    while (strstr(req, "\r\n\r\n") == NULL && len < sizeof(req) - 1) {
+        ret = recv(sock, req + len, sizeof(req) - 1 - len, 0);
+        if (ret <= 0) {
+            return -1;
+        }
+        len += (size_t) ret;
+        req[len] = '\0';
+    }
+
+    for (uint8_t f = 0; f < UC_LIVE_FORMATS; ++f) {
+        size_t path_len = strlen(ws_paths[f]);
+
+        if (strncmp(req + 4, ws_paths[f], path_len) == 0
+            && (req[4 + path_len] == ' ' || req[4 + path_len] == '?')) {
+            format = f;
+        }
+    }
+    p_key = strstr(req, key_field);
+    if (format < 0 || p_key == NULL) {
+        send(sock, not_found, sizeof(not_found) - 1, 0);
+        return -1;
+    }
+
+    p_key += sizeof(key_field) - 1;
+    while (*p_key == ' ') {
+        ++p_key;
+    }
+    p_end = strstr(p_key, "\r\n");
+    if (p_end == NULL || p_end + sizeof(UC_LIVE_WS_GUID) - 1 >= req + sizeof(req)) {
+        return -1;
+    }
+    memcpy(p_end, UC_LIVE_WS_GUID, sizeof(UC_LIVE_WS_GUID) - 1);
+
+    if (mbedtls_sha1_ret((const uint8_t*) p_key, (size_t) (p_end - p_key) + sizeof(UC_LIVE_WS_GUID) - 1,
+                         digest) != 0
+        || mbedtls_base64_encode(accept, sizeof(accept), &accept_len, digest, sizeof(digest)) != 0) {
+        return -1;
+    }
+
+    len = (size_t) snprintf(req, sizeof(req),
+                            "HTTP/1.1 101 Switching Protocols\r\n"
+                            "Upgrade: websocket\r\n"
+                            "Connection: Upgrade\r\n"
+                            "Sec-WebSocket-Accept: %.*s\r\n\r\n", (int) accept_len, accept);
+    if (!uc_live_send_all(sock, (const uint8_t*) req, len, 0)) {
+        return -1;
+    }
+
+    return format;
+}
+
+static void
+uc_live_listen_task(void* arg) {
+    struct timeval tv;
+    uc_live_worker_t* p_w;
+    int sock, format, one = 1;
+    ssize_t len;
+    bool ws;
+    int8_t id;
+
+    while (true) {
+        sock = accept(listen_sock, NULL, NULL);
+        if (sock < 0) {
+            ESP_LOGW(log_src, "accept failed: errno %d", errno);
+            osal_delay_ms(UC_LIVE_IDLE_MS);
+            continue;
+        }
+
+        tv.tv_sec = UC_LIVE_REQ_MS / 1000;
+        tv.tv_usec = (UC_LIVE_REQ_MS % 1000) * 1000;
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        tv.tv_sec = UC_LIVE_SEND_MS / 1000;
+        tv.tv_usec = (UC_LIVE_SEND_MS % 1000) * 1000;
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        /* Plain clients send the format as their first byte, anything starting with "GET " is a WebSocket upgrade */
+        len = recv(sock, req, sizeof(req) - 1, 0);
+        if (len <= 0) {
+            close(sock);
+            continue;
+        }
+        req[len] = '\0';
+        ws = strncmp(req, "GET ", 4) == 0;
+        format = ws ? uc_live_ws_handshake(sock, (size_t) len) : req[0];
+
+        id = format >= 0 && format < UC_LIVE_FORMATS ? fanout_subscribe(&fan, (uint8_t) format) : -1;
+        if (id < 0) {
+            ESP_LOGW(log_src, "Client refused: format %d, %d clients max", format, FANOUT_MAX_CLIENTS);
+            close(sock);
+            continue;
+        }
+
+        /* The slot was free, so its worker is idle or about to be, its old socket already closed */
+        p_w = &workers[id];
+        p_w->sock = sock;
+        p_w->ws = ws;
+        ESP_LOGI(log_src, "Client %d: format %d over %s", id, format, p_w->ws ? "WebSocket" : "TCP");
+        osal_sem_give(&p_w->start);
+    }
+}
+
+esp_err_t
+uc_live_init(uint16_t port) {
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    int one = 1;
+
+    if (fanout_init(&fan) != OSAL_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+    fanout_add_format(&fan, UC_LIVE_RAW, raw_bufs, UC_LIVE_RAW_SIZE, FANOUT_MAX_BUFS);
+    fanout_add_format(&fan, UC_LIVE_PACKED, packed_bufs, UC_LIVE_PACKED_SIZE, FANOUT_MAX_BUFS);
+    fanout_add_format(&fan, UC_LIVE_COLOR, color_bufs, UC_LIVE_COLOR_SIZE, FANOUT_MAX_BUFS);
+
+    frame_codec_enc_init(&key_enc, 0);
+    render_init(&render, RENDER_PALETTE_IRON, RENDER_RGB565);
+    render_set_auto(&render, 3, 8);    /* 2 degrees at least */
+
+    listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listen_sock < 0) {
+        ESP_LOGE(log_src, "Unable to create socket: errno %d", errno);
+        return ESP_FAIL;
+    }
+    setsockopt(listen_sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listen_sock, (struct sockaddr*) &addr, sizeof(addr)) != 0 || listen(listen_sock, 2) != 0) {
+        ESP_LOGE(log_src, "Unable to listen on port %u: errno %d", port, errno);
+        close(listen_sock);
+        listen_sock = -1;
+        return ESP_FAIL;
+    }
+
+    for (int8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        workers[i].id = i;
+        if (osal_sem_init(&workers[i].start) != OSAL_OK
+            || osal_task_create(&workers[i].task, "live_client", uc_live_worker_task, &workers[i],
+                                CFG_LIVE_STACK, CFG_LIVE_PRIO, CFG_LIVE_CORE) != OSAL_OK) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (osal_task_create(&listen_task, "live_listen", uc_live_listen_task, NULL, CFG_LIVE_STACK, CFG_LIVE_PRIO,
+                         CFG_LIVE_CORE) != OSAL_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    atomic_store(&ready, true);
+    ESP_LOGI(log_src, "Live view on port %u, WebSocket paths /raw, /packed, /color", port);
+
+    return ESP_OK;
+}
+
+void
+uc_live_publish(uint32_t seq, uint64_t ts_us, const amg88_frame_raw_t* p_raw, const int16_t* p_temp,
+                const amg88_stats_t* p_stats) {
+    stream_hdr_t hdr = {
+        .type = STREAM_TYPE_IMAGE,
+        .sensor_id = CFG_SENSOR_ID,
+        .len = STREAM_PROTO_IMAGE_HDR + UC_LIVE_SIDE * UC_LIVE_SIDE * 2,
+        .seq = seq,
+        .ts_us = ts_us,
+        .boot_id = uc_boot_id(),
+    };
+    fanout_buf_t* p_buf;
+    uint8_t* p_img;
+    uint32_t cycles;
+
+    if (!atomic_load_explicit(&ready, memory_order_acquire)) {
+        return;
+    }
+
+    /* The color window follows the scene even while nobody watches, so a new viewer starts settled */
+    render_update_range(&render, p_stats->min, p_stats->max);
+
+    for (uint8_t f = 0; f < UC_LIVE_FORMATS; ++f) {
+        if (!fanout_wanted(&fan, f) || (p_buf = fanout_alloc(&fan, f)) == NULL) {
+            continue;
+        }
+
+        p_buf->seq = seq;
+        switch (f) {
+            case UC_LIVE_RAW:
+                p_buf->len = stream_proto_encode_frame(p_buf->p_data, UC_LIVE_RAW_SIZE, CFG_SENSOR_ID, hdr.boot_id,
+                                                       seq, ts_us, p_raw);
+                break;
+            case UC_LIVE_PACKED:
+                p_buf->len = stream_proto_encode_codec(p_buf->p_data, UC_LIVE_PACKED_SIZE, CFG_SENSOR_ID,
+                                                       hdr.boot_id, seq, ts_us, 0, &key_enc, p_raw);
+                break;
+            case UC_LIVE_COLOR:
+                cycles = osal_cycles();
+                interp_upscale(p_temp, upscaled, interp_tmp, UC_LIVE_SCALE, INTERP_BICUBIC);
+                cycles = osal_cycles() - cycles;
+                /* Preemption counts too, so only the worst case is reported, once per new worst */
+                if (cycles > INTERP_BUDGET_CYCLES(UC_LIVE_SCALE) && cycles > interp_worst) {
+                    interp_worst = cycles;
+                    ESP_LOGW(log_src, "Upscale took %lu cycles, budget %lu", (unsigned long) cycles,
+                             (unsigned long) INTERP_BUDGET_CYCLES(UC_LIVE_SCALE));
+                }
+                stream_proto_write_hdr(p_buf->p_data, &hdr);
+                p_img = p_buf->p_data + STREAM_PROTO_HDR_SIZE;
+                p_img[0] = UC_LIVE_SIDE;
+                p_img[1] = UC_LIVE_SIDE;
+                p_img[2] = RENDER_RGB565;
+                render_frame(&render, upscaled, UC_LIVE_SIDE, UC_LIVE_SIDE, p_img + STREAM_PROTO_IMAGE_HDR,
+                             UC_LIVE_SIDE * 2);
+                p_buf->len = UC_LIVE_COLOR_SIZE;
+                break;
+            default:
+                break;
+        }
+        fanout_publish(&fan, p_buf);
+    }
+}
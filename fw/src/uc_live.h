@@ -0,0 +1,60 @@
+/**
+ * \file            uc_live.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Live view server: TCP and WebSocket viewers, every frame encoded once per format in use
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef UC_LIVE_H
+#define UC_LIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "amg88/amg88.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Output formats, all of them stream_proto packets
+ * \note            A plain TCP client sends the format as its first byte and then reads packets back to back,
+ *                  each one delimited by its header. A WebSocket client opens `/raw`, `/packed` or `/color`
+ *                  and gets one packet per binary message.
+ */
+typedef enum {
+    UC_LIVE_RAW,                                /*!< \ref STREAM_TYPE_FRAME_RAW */
+    UC_LIVE_PACKED,                             /*!< \ref STREAM_TYPE_FRAME_CODEC, keyframes only: no state to
+                                                     lose when a client joins or skips frames */
+    UC_LIVE_COLOR,                              /*!< \ref STREAM_TYPE_IMAGE, 32x32 RGB565, iron palette */
+
+    UC_LIVE_FORMATS,                            /*!< Number of formats */
+} uc_live_format_t;
+
+/**
+ * \brief           Open the listening socket and start the server tasks
+ * \param[in]       port: TCP port, shared by plain TCP and WebSocket clients
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_live_init(uint16_t port);
+
+/**
+ * \brief           Encode a frame in every format a client is watching and hand it to them
+ * \note            Never blocks on a client, a client still busy with an older frame skips to this one
+ * \param[in]       seq: Sequence number
+ * \param[in]       ts_us: Device timestamp
+ * \param[in]       p_raw: Raw frame (calibrated when a table is loaded)
+ * \param[in]       p_temp: Decoded pixels, 1/4 degree units
+ * \param[in]       p_stats: Frame statistics, for the false-color range
+ */
+void uc_live_publish(uint32_t seq, uint64_t ts_us, const amg88_frame_raw_t* p_raw, const int16_t* p_temp,
+                     const amg88_stats_t* p_stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UC_LIVE_H */
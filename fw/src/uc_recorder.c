@@ -0,0 +1,205 @@
+/**
+ * \file            uc_recorder.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Flash recorder: keeps the stream packets while WiFi is down and backfills them afterwards
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "uc_recorder.h"
+
+#include <stdatomic.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "nvs.h"
+
+#include "user_config.h"
+#include "osal/osal.h"
+#include "flash_log/flash_log.h"
+#include "uc_init.h"
+#include "uc_stream.h"
+
+#define UC_REC_STACK_SIZE 4096
+#define UC_REC_IDLE_MS    500                   /* Poll period while offline or caught up */
+#define UC_REC_BUSY_MS    5                     /* Back-off when the network stack is out of buffers */
+#define UC_REC_BURST      32                    /* Packets sent back to back before yielding */
+
+/* Vars */
+static char* log_src = "uc_recorder";
+static const esp_partition_t* p_part;
+static spi_flash_mmap_handle_t map_handle;
+static flash_log_t rec_log;
+static flash_log_cursor_t cursor;               /* Next record to backfill */
+static osal_sem_t lock;                         /* Guards rec_log and cursor */
+static osal_task_t task;
+static atomic_bool ready = false;               /* Mounted, the pipeline may start pushing before that */
+
+
+static flash_log_err_t
+uc_recorder_erase(void* p_ctx, size_t off, size_t len) {
+    return esp_partition_erase_range((const esp_partition_t*) p_ctx, off, len) == ESP_OK
+           ? FLASH_LOG_OK : FLASH_LOG_ERR_IO;
+}
+
+static flash_log_err_t
+uc_recorder_write(void* p_ctx, size_t off, const void* p_data, size_t len) {
+    return esp_partition_write((const esp_partition_t*) p_ctx, off, p_data, len) == ESP_OK
+           ? FLASH_LOG_OK : FLASH_LOG_ERR_IO;
+}
+
+/* Last backfilled id, so a reboot does not send the whole partition again */
+static uint32_t
+uc_recorder_load_cursor(void) {
+    nvs_handle_t handle;
+    uint32_t id = 0;
+
+    if (nvs_open(CFG_REC_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        nvs_get_u32(handle, "sent", &id);
+        nvs_close(handle);
+    }
+
+    return id;
+}
+
+static void
+uc_recorder_save_cursor(uint32_t id) {
+    nvs_handle_t handle;
+
+    if (nvs_open(CFG_REC_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK) {
+        if (nvs_set_u32(handle, "sent", id) == ESP_OK) {
+            nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+}
+
+/* Backfill straight from the memory-mapped partition into the socket, no copy through RAM */
+static void
+uc_recorder_task(void* arg) {
+    flash_log_cursor_t prev;
+    const uint8_t* p_data;
+    flash_log_err_t err;
+    uint32_t saved = cursor.id, burst = 0;
+    size_t len;
+
+    while (true) {
+        if (!uc_init_wifi_connected()) {
+            osal_delay_ms(UC_REC_IDLE_MS);
+            continue;
+        }
+
+        osal_sem_take(&lock, OSAL_WAIT_FOREVER);
+        prev = cursor;
+        err = flash_log_read(&rec_log, &cursor, &p_data, &len);
+        if (err == FLASH_LOG_OK && uc_stream_send(p_data, len) != ESP_OK) {
+            cursor = prev;
+            err = FLASH_LOG_ERR_IO;
+        }
+        osal_sem_give(&lock);
+
+        if (err == FLASH_LOG_OK) {
+            if (++burst >= UC_REC_BURST) {
+                burst = 0;
+                osal_delay_ms(1);
+            }
+        } else if (err == FLASH_LOG_ERR_EMPTY) {
+            if (cursor.id != saved) {
+                ESP_LOGI(log_src, "Backfilled %u records, %u overwritten before they could be sent",
+                         cursor.id - saved, cursor.lost);
+                uc_recorder_save_cursor(cursor.id);
+                saved = cursor.id;
+                cursor.lost = 0;
+            }
+            osal_delay_ms(UC_REC_IDLE_MS);
+        } else {
+            osal_delay_ms(UC_REC_BUSY_MS);
+        }
+    }
+}
+
+esp_err_t
+uc_recorder_init(void) {
+    flash_log_io_t io;
+    uint32_t sent;
+    esp_err_t ret;
+
+    p_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, CFG_REC_PARTITION);
+    if (p_part == NULL) {
+        ESP_LOGW(log_src, "No %s partition, recording disabled", CFG_REC_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* Map the whole partition once, records are read in place */
+    ret = esp_partition_mmap(p_part, 0, p_part->size, SPI_FLASH_MMAP_DATA, (const void**) &io.p_map, &map_handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    io.size = p_part->size;
+    io.sector_size = SPI_FLASH_SEC_SIZE;
+    io.p_ctx = (void*) p_part;
+    io.erase = uc_recorder_erase;
+    io.write = uc_recorder_write;
+
+    if (flash_log_mount(&rec_log, &io) != FLASH_LOG_OK) {
+        ESP_LOGE(log_src, "Bad %s partition geometry", CFG_REC_PARTITION);
+        spi_flash_munmap(map_handle);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    /* Ids restart on a blank partition */
+    sent = uc_recorder_load_cursor();
+    flash_log_seek(&rec_log, &cursor, sent > rec_log.next_id ? 0 : sent);
+    ESP_LOGI(log_src, "%u records stored, %u to backfill, %u sectors sealed after a power loss",
+             rec_log.next_id - flash_log_oldest_id(&rec_log), rec_log.next_id - cursor.id,
+             rec_log.stats.recovered);
+
+    if (osal_sem_init(&lock) != OSAL_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+    osal_sem_give(&lock);
+
+    if (osal_task_create(&task, "uc_recorder", uc_recorder_task, NULL, UC_REC_STACK_SIZE, CFG_REC_PRIO,
+                         CFG_REC_CORE) != OSAL_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+    atomic_store(&ready, true);
+
+    return ESP_OK;
+}
+
+esp_err_t
+uc_recorder_push(const uint8_t* p_pkt, size_t len) {
+    flash_log_err_t err;
+
+    if (!atomic_load(&ready)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    osal_sem_take(&lock, OSAL_WAIT_FOREVER);
+    err = flash_log_append(&rec_log, p_pkt, len);
+    osal_sem_give(&lock);
+
+    if (err != FLASH_LOG_OK) {
+        ESP_LOGD(log_src, "Record dropped (%d)", err);
+        return err == FLASH_LOG_ERR_LEN ? ESP_ERR_INVALID_SIZE : ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+uint32_t
+uc_recorder_pending(void) {
+    uint32_t pending, oldest;
+
+    if (!atomic_load(&ready)) {
+        return 0;
+    }
+
+    osal_sem_take(&lock, OSAL_WAIT_FOREVER);
+    oldest = flash_log_oldest_id(&rec_log);
+    pending = rec_log.next_id - (cursor.id > oldest ? cursor.id : oldest);
+    osal_sem_give(&lock);
+
+    return pending;
+}
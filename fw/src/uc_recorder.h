@@ -0,0 +1,48 @@
+/**
+ * \file            uc_recorder.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Flash recorder: keeps the stream packets while WiFi is down and backfills them afterwards
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef UC_RECORDER_H
+#define UC_RECORDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Mount the recorder partition and start the backfill task
+ * \note            NVS must be initialized (\ref uc_init_sys), the last backfilled record is kept there
+ * \return          ESP_OK on success, ESP_ERR_NOT_FOUND without a \ref CFG_REC_PARTITION partition,
+ *                  an ESP error code otherwise
+ */
+esp_err_t uc_recorder_init(void);
+
+/**
+ * \brief           Record a stream packet, it is sent once the link is back
+ * \note            Blocks for a sector erase (tens of ms) every few kB recorded
+ * \param[in]       p_pkt: Packet (see stream_proto.h), normally flagged \ref STREAM_FLAG_BACKFILL
+ * \param[in]       len: Packet length
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_recorder_push(const uint8_t* p_pkt, size_t len);
+
+/**
+ * \brief           Records waiting to be backfilled
+ * \return          Number of records
+ */
+uint32_t uc_recorder_pending(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UC_RECORDER_H */
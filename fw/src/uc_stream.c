@@ -0,0 +1,54 @@
+/**
+ * \file            uc_stream.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           UDP frame streaming
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "uc_stream.h"
+
+#include <string.h>
+
+#include "lwip/sockets.h"
+#include "esp_log.h"
+
+/* Vars */
+static char* log_src = "uc_stream";
+static int sock = -1;
+static struct sockaddr_in dest_addr;
+
+
+esp_err_t
+uc_stream_init(const char* host, uint16_t port) {
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &dest_addr.sin_addr) != 1) {
+        ESP_LOGE(log_src, "Invalid receiver address %s", host);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(log_src, "Unable to create socket: errno %d", errno);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(log_src, "Streaming to %s:%u", host, port);
+
+    return ESP_OK;
+}
+
+esp_err_t
+uc_stream_send(const uint8_t* p_pkt, size_t len) {
+    if (sock < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sendto(sock, p_pkt, len, MSG_DONTWAIT, (struct sockaddr*) &dest_addr, sizeof(dest_addr)) < 0) {
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
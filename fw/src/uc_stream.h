@@ -0,0 +1,42 @@
+/**
+ * \file            uc_stream.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           UDP frame streaming
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef UC_STREAM_H
+#define UC_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Open the streaming socket
+ * \param[in]       host: Receiver IPv4 address (dotted notation)
+ * \param[in]       port: Receiver UDP port
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_stream_init(const char* host, uint16_t port);
+
+/**
+ * \brief           Send a packet to the receiver
+ * \note            Never blocks, a packet that does not fit in the stack buffers is dropped
+ * \param[in]       p_pkt: Packet (see stream_proto.h)
+ * \param[in]       len: Packet length
+ * \return          ESP_OK on success, an ESP error code otherwise
+ */
+esp_err_t uc_stream_send(const uint8_t* p_pkt, size_t len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UC_STREAM_H */
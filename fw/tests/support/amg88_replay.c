@@ -0,0 +1,189 @@
+/**
+ * \file            amg88_replay.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Recorded AMG88xx, plugs a \ref frame_rec_t recording into amg88_dev_t read/write
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "amg88_replay.h"
+
+#include <string.h>
+
+/* Vars */
+static amg88_replay_t* replays[AMG88_REPLAY_MAX];
+
+
+static amg88_replay_t*
+amg88_replay_find(uint8_t bus, uint8_t addr) {
+    for (size_t i = 0; i < AMG88_REPLAY_MAX; ++i) {
+        if (replays[i] != NULL && replays[i]->bus == bus && replays[i]->addr == addr) {
+            return replays[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Time the last record stays on the output, the recorded period or else the mean spacing */
+static uint64_t
+amg88_replay_hold_us(const amg88_replay_t* p_rp) {
+    const frame_rec_t* p_rec = p_rp->p_rec;
+
+    if (p_rec->period_us != 0 || p_rec->n_records < 2) {
+        return p_rec->period_us;
+    }
+
+    return (p_rec->last_us - p_rec->first_us) / (p_rec->n_records - 1);
+}
+
+/* A corrupted record is a frame the sensor never put out, the previous one stays */
+static void
+amg88_replay_load(amg88_replay_t* p_rp, size_t idx) {
+    amg88_frame_raw_t frame;
+
+    if (p_rp->loaded && idx > p_rp->idx + 1) {
+        p_rp->stats.skipped += (uint32_t) (idx - p_rp->idx - 1);
+    }
+    p_rp->idx = idx;
+    p_rp->loaded = true;
+
+    if (frame_rec_get(p_rp->p_rec, idx, NULL, NULL, &frame) != FRAME_REC_OK) {
+        p_rp->stats.crc_errors++;
+        return;
+    }
+    memcpy(&p_rp->regs[AMG88_REG_TL], frame.pixels, AMG88_FRAME_RAW_SIZE);
+    memcpy(&p_rp->regs[AMG88_REG_TTHL], frame.thermistor, 2);
+    p_rp->stats.frames++;
+}
+
+/* Bring the output registers to what the sensor showed at this point of the recording */
+static void
+amg88_replay_sync(amg88_replay_t* p_rp, bool frame_read) {
+    const frame_rec_t* p_rec = p_rp->p_rec;
+    uint64_t elapsed_us;
+    size_t idx;
+
+    if (p_rec->n_records == 0) {
+        atomic_store(&p_rp->done, true);
+        return;
+    }
+
+    if (p_rp->speed == AMG88_REPLAY_ASAP) {
+        if (!frame_read) {
+            return;
+        }
+        if (!p_rp->loaded) {
+            amg88_replay_load(p_rp, 0);
+        } else if (p_rp->idx + 1 < p_rec->n_records) {
+            if (p_rp->pace != NULL) {
+                p_rp->pace(p_rp->pace_arg);
+            }
+            amg88_replay_load(p_rp, p_rp->idx + 1);
+        } else {
+            atomic_store(&p_rp->done, true);
+        }
+        return;
+    }
+
+    elapsed_us = (p_rp->clock_us() - p_rp->t0_us) * p_rp->speed;
+    if (elapsed_us >= p_rec->last_us - p_rec->first_us + amg88_replay_hold_us(p_rp)) {
+        atomic_store(&p_rp->done, true);
+        return;
+    }
+    idx = frame_rec_find(p_rec, p_rec->first_us + elapsed_us);
+    if (!p_rp->loaded || idx != p_rp->idx) {
+        amg88_replay_load(p_rp, idx);
+    }
+}
+
+void
+amg88_replay_init(amg88_replay_t* p_rp, uint8_t bus, uint8_t addr, const frame_rec_t* p_rec, uint32_t speed,
+                  uint64_t (*clock_us)(void)) {
+    memset(p_rp, 0, sizeof(*p_rp));
+    p_rp->bus = bus;
+    p_rp->addr = addr;
+    p_rp->p_rec = p_rec;
+    p_rp->speed = speed;
+    p_rp->clock_us = clock_us;
+    atomic_init(&p_rp->done, false);
+    amg88_replay_start(p_rp);
+}
+
+amg88_err_t
+amg88_replay_attach(amg88_replay_t* p_rp, amg88_dev_t* p_dev) {
+    for (size_t i = 0; i < AMG88_REPLAY_MAX; ++i) {
+        if (replays[i] == NULL || replays[i] == p_rp) {
+            replays[i] = p_rp;
+            p_dev->bus = p_rp->bus;
+            p_dev->addr = p_rp->addr;
+            p_dev->read = amg88_replay_read;
+            p_dev->write = amg88_replay_write;
+            return AMG88_OK;
+        }
+    }
+
+    return AMG88_ERR;
+}
+
+void
+amg88_replay_detach_all(void) {
+    memset(replays, 0, sizeof(replays));
+}
+
+void
+amg88_replay_set_pace(amg88_replay_t* p_rp, amg88_replay_pace_fn pace, void* arg) {
+    p_rp->pace = pace;
+    p_rp->pace_arg = arg;
+}
+
+void
+amg88_replay_start(amg88_replay_t* p_rp) {
+    p_rp->idx = 0;
+    p_rp->loaded = false;
+    p_rp->t0_us = p_rp->speed != AMG88_REPLAY_ASAP && p_rp->clock_us != NULL ? p_rp->clock_us() : 0;
+    atomic_store(&p_rp->done, false);
+}
+
+bool
+amg88_replay_done(amg88_replay_t* p_rp) {
+    return atomic_load(&p_rp->done);
+}
+
+amg88_err_t
+amg88_replay_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    amg88_replay_t* p_rp = amg88_replay_find(bus, addr);
+
+    if (p_rp == NULL) {
+        return AMG88_ERR_I2C;                   /* Nobody ACKs the address */
+    }
+
+    p_rp->stats.reads++;
+    if (!atomic_load(&p_rp->done)) {
+        amg88_replay_sync(p_rp, reg_addr == AMG88_REG_TL);
+    }
+    if (atomic_load(&p_rp->done)) {
+        return AMG88_ERR_I2C;
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        data_buf[i] = p_rp->regs[(uint8_t) (reg_addr + i)];
+    }
+
+    return AMG88_OK;
+}
+
+amg88_err_t
+amg88_replay_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    amg88_replay_t* p_rp = amg88_replay_find(bus, addr);
+
+    if (p_rp == NULL) {
+        return AMG88_ERR_I2C;
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        p_rp->regs[(uint8_t) (reg_addr + i)] = data_buf[i];
+    }
+
+    return AMG88_OK;
+}
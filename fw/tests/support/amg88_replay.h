@@ -0,0 +1,133 @@
+/**
+ * \file            amg88_replay.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Recorded AMG88xx, plugs a \ref frame_rec_t recording into amg88_dev_t read/write
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef AMG88_REPLAY_H
+#define AMG88_REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "amg88/amg88_defs.h"
+#include "frame_rec/frame_rec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define AMG88_REPLAY_MAX    4                   /*!< Max replayed devices attached at once */
+#define AMG88_REPLAY_ASAP   0                   /*!< Speed: one record per frame read, as fast as they are read */
+
+/**
+ * \brief           Pacing hook of \ref AMG88_REPLAY_ASAP mode, called on the reading thread before the next record
+ *                  is loaded. It may block, e.g. until the consumer took the previous frame, for lossless replay
+ *                  through a "latest frame wins" ring
+ * \param[in]       arg: User argument
+ */
+typedef void (*amg88_replay_pace_fn)(void* arg);
+
+/**
+ * \brief           Replay statistics
+ */
+typedef struct {
+    uint32_t reads;                             /*!< Read transactions */
+    uint32_t frames;                            /*!< Records loaded into the output registers */
+    uint32_t skipped;                           /*!< Records that came and went between two reads */
+    uint32_t crc_errors;                        /*!< Corrupted records, the previous one was kept instead */
+} amg88_replay_stats_t;
+
+/**
+ * \brief           Replayed device
+ * \note            Reads are served from the recording, writes land in the register map and nothing else
+ *                  (use \ref amg88_sim_t to exercise the control side)
+ */
+typedef struct {
+    uint8_t bus;                                /*!< I2C bus */
+    uint8_t addr;                               /*!< I2C address */
+    uint8_t regs[256];                          /*!< Register map */
+
+    const frame_rec_t* p_rec;                   /*!< Recording */
+    uint32_t speed;                             /*!< Times real time, \ref AMG88_REPLAY_ASAP to go as fast as read */
+    uint64_t (*clock_us)(void);                 /*!< Time source of the timed modes */
+    amg88_replay_pace_fn pace;                  /*!< Pacing hook of \ref AMG88_REPLAY_ASAP mode, `NULL` for none */
+    void* pace_arg;                             /*!< Pacing hook user argument */
+    uint64_t t0_us;                             /*!< Time the first record went out */
+    size_t idx;                                 /*!< Record in the output registers */
+    bool loaded;                                /*!< `idx` was loaded, `false` until the first frame read */
+    atomic_bool done;                           /*!< Past the last record, frame reads fail from then on */
+
+    amg88_replay_stats_t stats;                 /*!< Statistics */
+} amg88_replay_t;
+
+/**
+ * \brief           Init a replayed device
+ * \param[out]      p_rp: Replayed device
+ * \param[in]       bus: I2C bus
+ * \param[in]       addr: I2C address
+ * \param[in]       p_rec: Open recording, must outlive the replayed device
+ * \param[in]       speed: `1` for real time, `N` for N times real time, \ref AMG88_REPLAY_ASAP to hand out the next
+ *                  record on every frame read (deterministic, whatever the reader timing)
+ * \param[in]       clock_us: Time source of the timed modes, e.g. \ref osal_time_us
+ */
+void amg88_replay_init(amg88_replay_t* p_rp, uint8_t bus, uint8_t addr, const frame_rec_t* p_rec, uint32_t speed,
+                       uint64_t (*clock_us)(void));
+
+/**
+ * \brief           Attach a replayed device to a sensor handler
+ * \param[in]       p_rp: Replayed device, must outlive the attachment
+ * \param[out]      p_dev: Sensor handler, address and read/write functions are set
+ * \return          \ref AMG88_OK on success, \ref AMG88_ERR when \ref AMG88_REPLAY_MAX devices are attached
+ */
+amg88_err_t amg88_replay_attach(amg88_replay_t* p_rp, amg88_dev_t* p_dev);
+
+/**
+ * \brief           Detach every replayed device
+ */
+void amg88_replay_detach_all(void);
+
+/**
+ * \brief           Set the pacing hook of \ref AMG88_REPLAY_ASAP mode
+ * \param[in]       p_rp: Replayed device
+ * \param[in]       pace: Hook, `NULL` to load records as fast as they are read
+ * \param[in]       arg: User argument
+ */
+void amg88_replay_set_pace(amg88_replay_t* p_rp, amg88_replay_pace_fn pace, void* arg);
+
+/**
+ * \brief           Start over from the first record, the timed modes count from now
+ * \param[in]       p_rp: Replayed device
+ */
+void amg88_replay_start(amg88_replay_t* p_rp);
+
+/**
+ * \brief           Tell whether the recording is over
+ * \note            Safe from any thread
+ * \param[in]       p_rp: Replayed device
+ * \return          `true` once the last record had its time on the output, or was read in
+ *                  \ref AMG88_REPLAY_ASAP mode
+ */
+bool amg88_replay_done(amg88_replay_t* p_rp);
+
+/**
+ * \brief           I2C read, \ref amg88_i2c_fn compatible
+ * \note            A read starting at \ref AMG88_REG_TL is a new frame read: it loads the record due at that time,
+ *                  or the next one in \ref AMG88_REPLAY_ASAP mode. Past the end it fails with \ref AMG88_ERR_I2C
+ */
+amg88_err_t amg88_replay_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+/**
+ * \brief           I2C write, \ref amg88_i2c_fn compatible
+ */
+amg88_err_t amg88_replay_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AMG88_REPLAY_H */
@@ -0,0 +1,396 @@
+/**
+ * \file            amg88_sim.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Simulated AMG88xx register map, plugs into amg88_dev_t read/write
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "amg88_sim.h"
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#define AMG88_SIM_PERIOD_10FPS_US 100000
+#define AMG88_SIM_PERIOD_1FPS_US  1000000
+
+/* Vars */
+static amg88_sim_t* sims[AMG88_SIM_MAX];
+static const uint8_t ave_unlock[] = AMG88_AVE_UNLOCK;
+
+
+static amg88_sim_t*
+amg88_sim_find(uint8_t bus, uint8_t addr) {
+    for (size_t i = 0; i < AMG88_SIM_MAX; ++i) {
+        if (sims[i] != NULL && sims[i]->bus == bus && sims[i]->addr == addr) {
+            return sims[i];
+        }
+    }
+
+    return NULL;
+}
+
+static int16_t
+amg88_sim_sext12(uint16_t raw) {
+    return (int16_t) (uint16_t) (raw << 4) >> 4;
+}
+
+static int16_t
+amg88_sim_reg12(const amg88_sim_t* p_sim, uint8_t reg) {
+    return amg88_sim_sext12((uint16_t) (p_sim->regs[reg] | (p_sim->regs[reg + 1] << 8)));
+}
+
+static uint32_t
+amg88_sim_period_us(const amg88_sim_t* p_sim) {
+    return (p_sim->regs[AMG88_REG_FPSC] & 0x01) ? AMG88_SIM_PERIOD_1FPS_US : AMG88_SIM_PERIOD_10FPS_US;
+}
+
+/* Update the interrupt table and flag against the levels, like the sensor does on every frame */
+static void
+amg88_sim_update_int(amg88_sim_t* p_sim) {
+    uint8_t intc = p_sim->regs[AMG88_REG_INTC];
+    int16_t high = amg88_sim_reg12(p_sim, AMG88_REG_INTHL);
+    int16_t low = amg88_sim_reg12(p_sim, AMG88_REG_INTLL);
+    bool any = false;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        int16_t v = amg88_sim_reg12(p_sim, AMG88_REG_TL + 2 * i);
+        int16_t cmp = (intc & AMG88_INTC_INTMOD) ? v : (int16_t) (v - p_sim->prev_pixels[i]);
+
+        p_sim->prev_pixels[i] = v;
+        if ((intc & AMG88_INTC_INTEN) && (cmp > high || cmp < low)) {
+            p_sim->regs[AMG88_REG_INT0 + i / 8] |= (uint8_t) (1 << (i % 8));
+            any = true;
+        }
+    }
+
+    if (any) {
+        p_sim->regs[AMG88_REG_STAT] |= AMG88_STAT_INT;
+    }
+}
+
+static void
+amg88_sim_load(amg88_sim_t* p_sim, size_t idx) {
+    const amg88_frame_raw_t* p_frame;
+
+    if (p_sim->p_frames == NULL || p_sim->n_frames == 0) {
+        return;
+    }
+
+    p_sim->frame_idx = idx;
+    p_frame = &p_sim->p_frames[idx % p_sim->n_frames];
+    memcpy(&p_sim->regs[AMG88_REG_TL], p_frame->pixels, AMG88_FRAME_RAW_SIZE);
+    memcpy(&p_sim->regs[AMG88_REG_TTHL], p_frame->thermistor, 2);
+
+    amg88_sim_update_int(p_sim);
+}
+
+/* Bring the output registers up to date with the clock */
+static void
+amg88_sim_sync(amg88_sim_t* p_sim, uint64_t now_us) {
+    size_t idx;
+
+    if (p_sim->clock_us == NULL) {
+        return;
+    }
+
+    idx = p_sim->base_idx + (size_t) ((now_us - p_sim->t0_us) / amg88_sim_period_us(p_sim));
+    if (idx != p_sim->frame_idx) {
+        amg88_sim_load(p_sim, idx);
+    }
+}
+
+/* Numerical Recipes LCG, good enough and repeatable. Per byte rate, first order is plenty below 1% */
+static bool
+amg88_sim_draw(amg88_sim_t* p_sim, uint32_t ppm, size_t bytes) {
+    if (ppm == 0) {
+        return false;
+    }
+    p_sim->rng = p_sim->rng * 1664525u + 1013904223u;
+
+    return (p_sim->rng >> 8) % 1000000u < (uint64_t) ppm * bytes;
+}
+
+static bool
+amg88_sim_should_fail(amg88_sim_t* p_sim, size_t bytes) {
+    if (p_sim->fail_after > 0) {
+        p_sim->fail_after--;
+    } else if (p_sim->fail_count > 0) {
+        p_sim->fail_count--;
+        return true;
+    }
+
+    return amg88_sim_draw(p_sim, p_sim->fail_ppm, bytes);
+}
+
+static uint64_t
+amg88_sim_byte_ns(const amg88_sim_t* p_sim) {
+    return p_sim->bus_hz > 0 ? (uint64_t) AMG88_SIM_BITS_BYTE * 1000000000ULL / p_sim->bus_hz : 0;
+}
+
+static void
+amg88_sim_spend(amg88_sim_t* p_sim, uint64_t ns) {
+    p_sim->stats.bus_ns += ns;
+
+    if (p_sim->realtime && ns > 0) {
+        struct timespec ts = {
+            .tv_sec = (time_t) (ns / 1000000000ULL),
+            .tv_nsec = (long) (ns % 1000000000ULL),
+        };
+
+        while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+    }
+}
+
+/* Common fault and timing handling, returns the error of the transaction */
+static amg88_err_t
+amg88_sim_xfer(amg88_sim_t* p_sim, size_t bytes) {
+    uint64_t ns = p_sim->xfer_ns + bytes * amg88_sim_byte_ns(p_sim);
+
+    /* A held bus times out whatever the transaction, the slave may give up on its own after a while */
+    if (p_sim->stuck_left == 0 && amg88_sim_draw(p_sim, p_sim->stuck_ppm, bytes)) {
+        p_sim->stats.stuck++;
+        p_sim->stuck_left = p_sim->stuck_release > 0 ? p_sim->stuck_release : UINT32_MAX;
+    }
+    if (p_sim->stuck_left > 0) {
+        if (p_sim->stuck_left != UINT32_MAX) {
+            p_sim->stuck_left--;
+        }
+        p_sim->stats.errors++;
+        amg88_sim_spend(p_sim, p_sim->xfer_ns + (uint64_t) p_sim->timeout_us * 1000ULL);
+        return AMG88_ERR_TIMEOUT;
+    }
+
+    if (amg88_sim_should_fail(p_sim, bytes)) {
+        p_sim->stats.errors++;
+        if (p_sim->fail_err == AMG88_ERR_TIMEOUT) {
+            ns = p_sim->xfer_ns + (uint64_t) p_sim->timeout_us * 1000ULL;
+        }
+        amg88_sim_spend(p_sim, ns);
+        return p_sim->fail_err;
+    }
+
+    amg88_sim_spend(p_sim, ns);
+
+    return AMG88_OK;
+}
+
+void
+amg88_sim_init(amg88_sim_t* p_sim, uint8_t bus, uint8_t addr) {
+    memset(p_sim, 0, sizeof(*p_sim));
+    p_sim->bus = bus;
+    p_sim->addr = addr;
+    p_sim->fail_err = AMG88_ERR_I2C;
+    p_sim->timeout_us = 1000;
+    p_sim->rng = 1;
+
+    /* 25 degrees everywhere */
+    p_sim->regs[AMG88_REG_TTHL] = 0x90;
+    p_sim->regs[AMG88_REG_TTHH] = 0x01;
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_sim->regs[AMG88_REG_TL + 2 * i] = 0x64;
+        p_sim->prev_pixels[i] = 0x64;
+    }
+}
+
+amg88_err_t
+amg88_sim_attach(amg88_sim_t* p_sim, amg88_dev_t* p_dev) {
+    for (size_t i = 0; i < AMG88_SIM_MAX; ++i) {
+        if (sims[i] == NULL || sims[i] == p_sim) {
+            sims[i] = p_sim;
+            p_dev->bus = p_sim->bus;
+            p_dev->addr = p_sim->addr;
+            p_dev->read = amg88_sim_read;
+            p_dev->write = amg88_sim_write;
+            return AMG88_OK;
+        }
+    }
+
+    return AMG88_ERR;
+}
+
+void
+amg88_sim_detach_all(void) {
+    memset(sims, 0, sizeof(sims));
+}
+
+void
+amg88_sim_set_frames(amg88_sim_t* p_sim, const amg88_frame_raw_t* p_frames, size_t n_frames) {
+    p_sim->p_frames = p_frames;
+    p_sim->n_frames = n_frames;
+    amg88_sim_load(p_sim, 0);
+    p_sim->base_idx = 0;
+    p_sim->t0_us = p_sim->clock_us != NULL ? p_sim->clock_us() : 0;
+}
+
+void
+amg88_sim_set_clock(amg88_sim_t* p_sim, uint64_t (*clock_us)(void)) {
+    p_sim->clock_us = clock_us;
+    p_sim->base_idx = p_sim->frame_idx;
+    p_sim->t0_us = clock_us != NULL ? clock_us() : 0;
+}
+
+void
+amg88_sim_next_frame(amg88_sim_t* p_sim) {
+    amg88_sim_load(p_sim, p_sim->frame_idx + 1);
+}
+
+void
+amg88_sim_set_bus(amg88_sim_t* p_sim, uint32_t bus_hz, uint32_t xfer_ns, bool realtime) {
+    p_sim->bus_hz = bus_hz;
+    p_sim->xfer_ns = xfer_ns;
+    p_sim->realtime = realtime;
+}
+
+void
+amg88_sim_inject(amg88_sim_t* p_sim, amg88_err_t err, uint32_t after, uint32_t count) {
+    p_sim->fail_err = err;
+    p_sim->fail_after = after;
+    p_sim->fail_count = count;
+}
+
+void
+amg88_sim_inject_random(amg88_sim_t* p_sim, amg88_err_t err, uint32_t ppm, uint32_t seed) {
+    p_sim->fail_err = err;
+    p_sim->fail_ppm = ppm;
+    p_sim->rng = seed;
+}
+
+void
+amg88_sim_inject_stuck(amg88_sim_t* p_sim, uint32_t ppm, uint32_t release) {
+    p_sim->stuck_ppm = ppm;
+    p_sim->stuck_release = release;
+}
+
+amg88_err_t
+amg88_sim_recover(uint8_t bus) {
+    bool found = false;
+
+    for (size_t i = 0; i < AMG88_SIM_MAX; ++i) {
+        if (sims[i] != NULL && sims[i]->bus == bus) {
+            if (!found) {
+                amg88_sim_spend(sims[i], (uint64_t) AMG88_SIM_RECOVER_US * 1000ULL);
+            }
+            sims[i]->stuck_left = 0;
+            sims[i]->stats.recoveries++;
+            found = true;
+        }
+    }
+
+    return found ? AMG88_OK : AMG88_ERR_I2C;
+}
+
+void
+amg88_sim_reset_stats(amg88_sim_t* p_sim) {
+    memset(&p_sim->stats, 0, sizeof(p_sim->stats));
+}
+
+amg88_err_t
+amg88_sim_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    amg88_sim_t* p_sim = amg88_sim_find(bus, addr);
+    uint64_t start_us = 0, byte_ns;
+    amg88_err_t ret;
+
+    if (p_sim == NULL) {
+        return AMG88_ERR_I2C;                   /* Nobody ACKs the address */
+    }
+
+    p_sim->stats.reads++;
+    if (p_sim->clock_us != NULL) {
+        start_us = p_sim->clock_us();
+        amg88_sim_sync(p_sim, start_us);
+    }
+
+    /* Sample every byte at its own time on the wire, a frame update can land mid-burst */
+    byte_ns = amg88_sim_byte_ns(p_sim);
+    for (size_t i = 0; i < len; ++i) {
+        if (p_sim->clock_us != NULL) {
+            amg88_sim_sync(p_sim, start_us + (p_sim->xfer_ns + (AMG88_SIM_READ_HDR + i) * byte_ns) / 1000);
+        }
+        data_buf[i] = p_sim->regs[(uint8_t) (reg_addr + i)];
+    }
+
+    ret = amg88_sim_xfer(p_sim, AMG88_SIM_READ_HDR + len);
+    if (ret == AMG88_OK) {
+        p_sim->stats.bytes_read += len;
+    }
+
+    return ret;
+}
+
+amg88_err_t
+amg88_sim_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    amg88_sim_t* p_sim = amg88_sim_find(bus, addr);
+    amg88_err_t ret;
+
+    if (p_sim == NULL) {
+        return AMG88_ERR_I2C;
+    }
+
+    p_sim->stats.writes++;
+    ret = amg88_sim_xfer(p_sim, AMG88_SIM_WRITE_HDR + len);
+    if (ret != AMG88_OK) {
+        return ret;
+    }
+    p_sim->stats.bytes_written += len;
+
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t reg = (uint8_t) (reg_addr + i);
+        uint8_t val = data_buf[i];
+
+        switch (reg) {
+            case AMG88_REG_RST:
+                if (val == AMG88_RESET_INITIAL) {
+                    memset(p_sim->regs, 0, AMG88_REG_IHYSH + 1);
+                }
+                if (val == AMG88_RESET_INITIAL || val == AMG88_RESET_FLAG) {
+                    p_sim->regs[AMG88_REG_STAT] = 0;
+                    memset(&p_sim->regs[AMG88_REG_INT0], 0, 8);
+                }
+                break;
+            case AMG88_REG_SCLR:
+                p_sim->regs[AMG88_REG_STAT] &= (uint8_t) ~val;
+                if (val & AMG88_STAT_INT) {
+                    memset(&p_sim->regs[AMG88_REG_INT0], 0, 8);
+                }
+                break;
+            case AMG88_REG_FPSC:
+                /* Keep the frame index continuous across a rate change */
+                if (p_sim->clock_us != NULL) {
+                    p_sim->t0_us = p_sim->clock_us();
+                    amg88_sim_sync(p_sim, p_sim->t0_us);
+                    p_sim->base_idx = p_sim->frame_idx;
+                }
+                p_sim->regs[reg] = val;
+                break;
+            case AMG88_REG_AVE_KEY:
+                if (p_sim->ave_key < sizeof(ave_unlock) && val == ave_unlock[p_sim->ave_key]) {
+                    p_sim->ave_key++;
+                } else {
+                    p_sim->ave_key = val == ave_unlock[0] ? 1 : 0;
+                }
+                break;
+            case AMG88_REG_AVE:
+                if (p_sim->ave_key == sizeof(ave_unlock)) {
+                    p_sim->regs[reg] = val;
+                }
+                break;
+            case AMG88_REG_PCTL:
+            case AMG88_REG_INTC:
+            case AMG88_REG_INTHL:
+            case AMG88_REG_INTHH:
+            case AMG88_REG_INTLL:
+            case AMG88_REG_INTLH:
+            case AMG88_REG_IHYSL:
+            case AMG88_REG_IHYSH:
+                p_sim->regs[reg] = val;
+                break;
+            default:
+                /* Read-only or reserved, ignored like the sensor does */
+                break;
+        }
+    }
+
+    return AMG88_OK;
+}
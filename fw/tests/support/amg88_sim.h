@@ -0,0 +1,189 @@
+/**
+ * \file            amg88_sim.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Simulated AMG88xx register map, plugs into amg88_dev_t read/write
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef AMG88_SIM_H
+#define AMG88_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define AMG88_SIM_MAX         8                 /*!< Max simulated devices attached at once */
+#define AMG88_SIM_BITS_BYTE   9                 /*!< Bits on the wire per byte (8 + ACK) */
+#define AMG88_SIM_READ_HDR    3                 /*!< Bytes before the data of a read: addr+W, reg, addr+R */
+#define AMG88_SIM_WRITE_HDR   2                 /*!< Bytes before the data of a write: addr+W, reg */
+#define AMG88_SIM_RECOVER_US  150               /*!< Modelled cost of a bus recovery: 9 clocks, STOP, driver re-init */
+
+/**
+ * \brief           Simulated device statistics
+ */
+typedef struct {
+    uint32_t reads;                             /*!< Read transactions */
+    uint32_t writes;                            /*!< Write transactions */
+    uint32_t bytes_read;                        /*!< Data bytes read */
+    uint32_t bytes_written;                     /*!< Data bytes written */
+    uint32_t errors;                            /*!< Transactions failed by fault injection */
+    uint32_t stuck;                             /*!< Times the bus was held down */
+    uint32_t recoveries;                        /*!< \ref amg88_sim_recover calls */
+    uint64_t bus_ns;                            /*!< Modelled bus time */
+} amg88_sim_stats_t;
+
+/**
+ * \brief           Simulated device
+ */
+typedef struct {
+    uint8_t bus;                                /*!< I2C bus */
+    uint8_t addr;                               /*!< I2C address */
+    uint8_t regs[256];                          /*!< Register map */
+    uint8_t ave_key;                            /*!< \ref AMG88_AVE_UNLOCK bytes received in order, AVE writes
+                                                     only land once all are in */
+
+    const amg88_frame_raw_t* p_frames;          /*!< Frame sequence, `NULL` to keep the registers as they are */
+    size_t n_frames;                            /*!< Frames in the sequence */
+    size_t frame_idx;                           /*!< Frame currently in the output registers */
+    int16_t prev_pixels[AMG88_ARRAY_SIZE];      /*!< Previous frame, for difference mode interrupts */
+
+    uint64_t (*clock_us)(void);                 /*!< Time source, `NULL` to advance frames by hand only */
+    uint64_t t0_us;                             /*!< Time `base_idx` was loaded */
+    size_t base_idx;                            /*!< Frame loaded at `t0_us` */
+
+    uint32_t bus_hz;                            /*!< Modelled SCL frequency, `0` for no bus time */
+    uint32_t xfer_ns;                           /*!< Modelled fixed cost per transaction (start/stop, driver setup) */
+    bool realtime;                              /*!< Actually sleep for the modelled bus time */
+
+    amg88_err_t fail_err;                       /*!< Error returned by injected faults */
+    uint32_t fail_after;                        /*!< Transactions left before the faults start */
+    uint32_t fail_count;                        /*!< Transactions left to fail */
+    uint32_t fail_ppm;                          /*!< Random fault rate per byte on the wire, parts per million */
+    uint32_t stuck_ppm;                         /*!< Rate per byte of a glitch that holds the bus down */
+    uint32_t stuck_release;                     /*!< Timed out transactions before a held bus frees itself, `0`
+                                                     for never */
+    uint32_t stuck_left;                        /*!< Timed out transactions left while held, `0` when free */
+    uint32_t timeout_us;                        /*!< Modelled bus time of an injected timeout */
+    uint32_t rng;                               /*!< Fault injection random state */
+
+    amg88_sim_stats_t stats;                    /*!< Statistics */
+} amg88_sim_t;
+
+/**
+ * \brief           Init a simulated device with its power-on register values
+ * \param[out]      p_sim: Simulated device
+ * \param[in]       bus: I2C bus
+ * \param[in]       addr: I2C address
+ */
+void amg88_sim_init(amg88_sim_t* p_sim, uint8_t bus, uint8_t addr);
+
+/**
+ * \brief           Attach a simulated device to a sensor handler
+ * \param[in]       p_sim: Simulated device, must outlive the attachment
+ * \param[out]      p_dev: Sensor handler, address and read/write functions are set
+ * \return          \ref AMG88_OK on success, \ref AMG88_ERR when \ref AMG88_SIM_MAX devices are attached
+ */
+amg88_err_t amg88_sim_attach(amg88_sim_t* p_sim, amg88_dev_t* p_dev);
+
+/**
+ * \brief           Detach every simulated device
+ */
+void amg88_sim_detach_all(void);
+
+/**
+ * \brief           Program a frame sequence, played back in a loop
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       p_frames: Frames, must outlive the simulated device
+ * \param[in]       n_frames: Number of frames
+ */
+void amg88_sim_set_frames(amg88_sim_t* p_sim, const amg88_frame_raw_t* p_frames, size_t n_frames);
+
+/**
+ * \brief           Advance the frames with a clock, at the rate set in \ref AMG88_REG_FPSC
+ * \note            Bytes of a read burst are timed individually, so a burst crossing a frame update
+ *                  returns a torn frame like the real sensor
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       clock_us: Time source, `NULL` to go back to manual advance
+ */
+void amg88_sim_set_clock(amg88_sim_t* p_sim, uint64_t (*clock_us)(void));
+
+/**
+ * \brief           Load the next frame of the sequence into the output registers
+ * \param[in]       p_sim: Simulated device
+ */
+void amg88_sim_next_frame(amg88_sim_t* p_sim);
+
+/**
+ * \brief           Configure the bus latency model
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       bus_hz: SCL frequency (e.g. 100000, 400000), `0` for no bus time
+ * \param[in]       xfer_ns: Fixed cost per transaction
+ * \param[in]       realtime: Actually sleep for the modelled time
+ */
+void amg88_sim_set_bus(amg88_sim_t* p_sim, uint32_t bus_hz, uint32_t xfer_ns, bool realtime);
+
+/**
+ * \brief           Fail a run of transactions
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       err: Error to return (\ref AMG88_ERR_TIMEOUT also costs `timeout_us` of bus time)
+ * \param[in]       after: Transactions to let through first
+ * \param[in]       count: Transactions to fail
+ */
+void amg88_sim_inject(amg88_sim_t* p_sim, amg88_err_t err, uint32_t after, uint32_t count);
+
+/**
+ * \brief           Fail transactions at random
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       err: Error to return
+ * \param[in]       ppm: Fault rate per byte on the wire, parts per million, so long bursts fail more often.
+ *                  `0` to disable
+ * \param[in]       seed: Random seed, for repeatable runs
+ */
+void amg88_sim_inject_random(amg88_sim_t* p_sim, amg88_err_t err, uint32_t ppm, uint32_t seed);
+
+/**
+ * \brief           Hold the bus down at random, like a slave stuck mid-byte pulling SDA low
+ * \note            Every transaction then times out (`timeout_us` of bus time) until \ref amg88_sim_recover or
+ *                  `release` of them went by. Shares the random state of \ref amg88_sim_inject_random
+ * \param[in]       p_sim: Simulated device
+ * \param[in]       ppm: Rate per byte on the wire, parts per million, `0` to disable
+ * \param[in]       release: Timed out transactions before the bus frees itself, `0` for never
+ */
+void amg88_sim_inject_stuck(amg88_sim_t* p_sim, uint32_t ppm, uint32_t release);
+
+/**
+ * \brief           Bus recovery, \ref amg88_recover_fn compatible
+ * \note            Frees the bus of every device attached on `bus`, costs \ref AMG88_SIM_RECOVER_US of bus time
+ * \param[in]       bus: I2C bus
+ * \return          \ref AMG88_OK, \ref AMG88_ERR_I2C when no device is attached on `bus`
+ */
+amg88_err_t amg88_sim_recover(uint8_t bus);
+
+/**
+ * \brief           Clear the statistics
+ * \param[in]       p_sim: Simulated device
+ */
+void amg88_sim_reset_stats(amg88_sim_t* p_sim);
+
+/**
+ * \brief           I2C read, \ref amg88_i2c_fn compatible
+ */
+amg88_err_t amg88_sim_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+/**
+ * \brief           I2C write, \ref amg88_i2c_fn compatible
+ */
+amg88_err_t amg88_sim_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AMG88_SIM_H */
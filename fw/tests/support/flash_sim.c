@@ -0,0 +1,162 @@
+/**
+ * \file            flash_sim.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           File-backed NOR flash emulation, plugs into flash_log_io_t
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "flash_sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/* Bytes of an operation that happen before the power cut */
+static size_t
+flash_sim_consume(flash_sim_t* p_sim, size_t len) {
+    if (p_sim->budget < 0) {
+        return len;
+    }
+    if ((int64_t) len > p_sim->budget) {
+        len = (size_t) p_sim->budget;
+        p_sim->dead = true;
+    }
+    p_sim->budget -= (int64_t) len;
+
+    return len;
+}
+
+static flash_log_err_t
+flash_sim_erase(void* p_ctx, size_t off, size_t len) {
+    flash_sim_t* p_sim = (flash_sim_t*) p_ctx;
+    size_t done;
+
+    if (p_sim->dead || off % p_sim->sector_size != 0 || len % p_sim->sector_size != 0 || off + len > p_sim->size) {
+        return FLASH_LOG_ERR_IO;
+    }
+
+    done = flash_sim_consume(p_sim, len);
+    memset(p_sim->p_rw + off, 0xFF, done);
+    for (size_t s = off / p_sim->sector_size; s < (off + done) / p_sim->sector_size; ++s) {
+        p_sim->p_wear[s]++;
+    }
+    p_sim->stats.erases += (uint32_t) (len / p_sim->sector_size);
+    p_sim->stats.busy_us += (uint64_t) p_sim->erase_us * (len / p_sim->sector_size);
+
+    return done == len ? FLASH_LOG_OK : FLASH_LOG_ERR_IO;
+}
+
+static flash_log_err_t
+flash_sim_write(void* p_ctx, size_t off, const void* p_data, size_t len) {
+    flash_sim_t* p_sim = (flash_sim_t*) p_ctx;
+    const uint8_t* p_src = (const uint8_t*) p_data;
+    size_t done;
+
+    if (p_sim->dead || off + len > p_sim->size) {
+        return FLASH_LOG_ERR_IO;
+    }
+
+    /* NOR programming only clears bits */
+    done = flash_sim_consume(p_sim, len);
+    for (size_t i = 0; i < done; ++i) {
+        p_sim->p_rw[off + i] &= p_src[i];
+    }
+    p_sim->stats.writes++;
+    p_sim->stats.bytes_written += done;
+    p_sim->stats.busy_us += (uint64_t) p_sim->page_us
+                            * ((off + len - 1) / FLASH_SIM_PAGE_SIZE - off / FLASH_SIM_PAGE_SIZE + 1);
+
+    return done == len ? FLASH_LOG_OK : FLASH_LOG_ERR_IO;
+}
+
+bool
+flash_sim_open(flash_sim_t* p_sim, const char* path, size_t size, size_t sector_size) {
+    struct stat st;
+    void* p_rw;
+    void* p_ro;
+
+    memset(p_sim, 0, sizeof(*p_sim));
+    p_sim->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (p_sim->fd < 0 || fstat(p_sim->fd, &st) != 0) {
+        goto fail;
+    }
+
+    /* Extend with erased bytes, a plain ftruncate would fill with zeros */
+    if ((size_t) st.st_size < size) {
+        uint8_t blank[256];
+
+        memset(blank, 0xFF, sizeof(blank));
+        lseek(p_sim->fd, st.st_size, SEEK_SET);
+        for (size_t left = size - (size_t) st.st_size; left > 0;) {
+            ssize_t n = write(p_sim->fd, blank, left < sizeof(blank) ? left : sizeof(blank));
+
+            if (n <= 0) {
+                goto fail;
+            }
+            left -= (size_t) n;
+        }
+    }
+
+    p_rw = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, p_sim->fd, 0);
+    p_ro = mmap(NULL, size, PROT_READ, MAP_SHARED, p_sim->fd, 0);
+    if (p_rw == MAP_FAILED || p_ro == MAP_FAILED) {
+        if (p_rw != MAP_FAILED) {
+            munmap(p_rw, size);
+        }
+        if (p_ro != MAP_FAILED) {
+            munmap(p_ro, size);
+        }
+        goto fail;
+    }
+
+    p_sim->p_rw = (uint8_t*) p_rw;
+    p_sim->p_ro = (const uint8_t*) p_ro;
+    p_sim->size = size;
+    p_sim->sector_size = sector_size;
+    p_sim->p_wear = (uint32_t*) calloc(size / sector_size, sizeof(uint32_t));
+    p_sim->erase_us = FLASH_SIM_ERASE_US;
+    p_sim->page_us = FLASH_SIM_PAGE_US;
+    p_sim->budget = -1;
+
+    return p_sim->p_wear != NULL;
+
+fail:
+    if (p_sim->fd >= 0) {
+        close(p_sim->fd);
+    }
+    p_sim->fd = -1;
+
+    return false;
+}
+
+void
+flash_sim_close(flash_sim_t* p_sim) {
+    if (p_sim->fd < 0) {
+        return;
+    }
+    munmap(p_sim->p_rw, p_sim->size);
+    munmap((void*) p_sim->p_ro, p_sim->size);
+    close(p_sim->fd);
+    free(p_sim->p_wear);
+    p_sim->fd = -1;
+}
+
+void
+flash_sim_attach(flash_sim_t* p_sim, flash_log_io_t* p_io) {
+    p_io->p_map = p_sim->p_ro;
+    p_io->size = p_sim->size;
+    p_io->sector_size = p_sim->sector_size;
+    p_io->p_ctx = p_sim;
+    p_io->erase = flash_sim_erase;
+    p_io->write = flash_sim_write;
+}
+
+void
+flash_sim_cut_after(flash_sim_t* p_sim, int64_t bytes) {
+    p_sim->budget = bytes;
+}
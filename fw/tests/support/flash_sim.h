@@ -0,0 +1,92 @@
+/**
+ * \file            flash_sim.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           File-backed NOR flash emulation, plugs into flash_log_io_t
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "flash_log/flash_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FLASH_SIM_ERASE_US  45000               /*!< Default sector erase time, 4 KiB SPI NOR */
+#define FLASH_SIM_PAGE_US   700                 /*!< Default page program time */
+#define FLASH_SIM_PAGE_SIZE 256                 /*!< Program page */
+
+/**
+ * \brief           Simulated flash statistics
+ */
+typedef struct {
+    uint32_t erases;                            /*!< Sector erases */
+    uint32_t writes;                            /*!< Write calls */
+    uint64_t bytes_written;                     /*!< Bytes programmed */
+    uint64_t busy_us;                           /*!< Modelled erase and program time */
+} flash_sim_stats_t;
+
+/**
+ * \brief           Simulated flash
+ */
+typedef struct {
+    int fd;                                     /*!< Backing file */
+    uint8_t* p_rw;                              /*!< Writable map, used by erase and write only */
+    const uint8_t* p_ro;                        /*!< Read-only map, handed to the log */
+    size_t size;                                /*!< Region size */
+    size_t sector_size;                         /*!< Erase unit */
+    uint32_t* p_wear;                           /*!< Erase count per sector */
+
+    uint32_t erase_us;                          /*!< Modelled sector erase time */
+    uint32_t page_us;                           /*!< Modelled page program time */
+
+    int64_t budget;                             /*!< Bytes left before the power cut, negative for none */
+    bool dead;                                  /*!< Power was cut, every operation fails */
+
+    flash_sim_stats_t stats;                    /*!< Statistics */
+} flash_sim_t;
+
+/**
+ * \brief           Open a backing file as flash, a new or shorter file is extended with erased (0xFF) bytes
+ * \param[out]      p_sim: Simulated flash
+ * \param[in]       path: Backing file
+ * \param[in]       size: Region size
+ * \param[in]       sector_size: Erase unit
+ * \return          `true` on success
+ */
+bool flash_sim_open(flash_sim_t* p_sim, const char* path, size_t size, size_t sector_size);
+
+/**
+ * \brief           Unmap and close, the file keeps the flash contents
+ * \param[in]       p_sim: Simulated flash
+ */
+void flash_sim_close(flash_sim_t* p_sim);
+
+/**
+ * \brief           Fill a log access struct with the simulated flash
+ * \param[in]       p_sim: Simulated flash, must outlive the log
+ * \param[out]      p_io: Log flash access
+ */
+void flash_sim_attach(flash_sim_t* p_sim, flash_log_io_t* p_io);
+
+/**
+ * \brief           Cut the power after some more bytes are erased or programmed
+ * \note            The operation that crosses the limit is applied only up to it, like a real interrupted
+ *                  erase or program, and every later one fails. Reopen the file to "power up" again
+ * \param[in]       p_sim: Simulated flash
+ * \param[in]       bytes: Bytes left, negative to disable
+ */
+void flash_sim_cut_after(flash_sim_t* p_sim, int64_t bytes);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FLASH_SIM_H */
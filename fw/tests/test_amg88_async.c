@@ -0,0 +1,171 @@
+/**
+ * \file            test_amg88_async.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Non-blocking frame reads: the blocking fallback and the bus worker, with the bus held busy
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88/amg88_async.h"
+#include "i2c_async/i2c_async.h"
+#include "osal/osal.h"
+
+TEST_FILE("osal_posix.c");
+
+#define WORKER_BUS      1
+
+/* Vars */
+static uint8_t regs[256];
+static unsigned transactions;
+static amg88_dev_t dev;
+static amg88_xfer_t xfer;
+static amg88_frame_raw_t frame, expected;
+static i2c_async_t worker;
+static bool worker_up;
+static bool gated;                              /* Reads hold the bus until `gate` is given */
+static osal_sem_t gate;
+static unsigned done_calls;
+static amg88_err_t done_err;
+static void* done_arg;
+
+
+/* Mock bus: a flat register map, reads can be held on the bus to look like a slow transfer */
+static amg88_err_t
+mock_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    if (gated) {
+        osal_sem_take(&gate, OSAL_WAIT_FOREVER);
+    }
+    transactions++;
+    for (size_t i = 0; i < len; ++i) {
+        data_buf[i] = regs[(uint8_t) (reg_addr + i)];
+    }
+
+    return AMG88_OK;
+}
+
+static void
+on_done(amg88_err_t err, void* arg) {
+    /* May run on the worker, the test checks the result */
+    done_arg = arg;
+    done_calls++;
+    done_err = err;
+}
+
+void
+setUp(void) {
+    memset(regs, 0, sizeof(regs));
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        regs[AMG88_REG_TL + 2 * i] = (uint8_t) (i * 5);
+        regs[AMG88_REG_TL + 2 * i + 1] = (uint8_t) (i & 3);
+    }
+    regs[AMG88_REG_TTHL] = 0x90;
+    regs[AMG88_REG_TTHH] = 0x01;
+    memcpy(expected.pixels, &regs[AMG88_REG_TL], AMG88_FRAME_RAW_SIZE);
+    memcpy(expected.thermistor, &regs[AMG88_REG_TTHL], 2);
+    memset(&frame, 0, sizeof(frame));
+
+    /* The worker lives for the whole program, like on the target */
+    if (!worker_up) {
+        TEST_ASSERT_EQUAL_INT(OSAL_OK, osal_sem_init(&gate));
+        TEST_ASSERT_EQUAL_INT(OSAL_OK, i2c_async_init(&worker, WORKER_BUS, mock_read, 5, OSAL_CORE_ANY));
+        worker_up = true;
+    }
+
+    dev = (amg88_dev_t) { .bus = WORKER_BUS, .addr = AMG88_I2C_ADDR_LOW, .read = mock_read };
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_init(&xfer));
+    transactions = 0;
+    gated = false;
+    done_calls = 0;
+    done_err = AMG88_ERR;
+    done_arg = NULL;
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_without_async_read_the_transfer_is_finished_on_return(void) {
+    amg88_err_t err = AMG88_ERR;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_xfer_wait(&xfer, 0));     /* Nothing started */
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &xfer, &frame, 1, on_done, &done_calls));
+    TEST_ASSERT_EQUAL_UINT(1, done_calls);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, done_err);
+    TEST_ASSERT_EQUAL_PTR(&done_calls, done_arg);
+    TEST_ASSERT_TRUE(amg88_xfer_poll(&xfer, &err));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, err);
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &frame, sizeof(frame));
+
+    /* Collected, so the handle takes the next one and a wait does not see the old give */
+    TEST_ASSERT_FALSE(amg88_xfer_poll(&xfer, &err));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &xfer, &frame, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_wait(&xfer, 0));
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_xfer_wait(&xfer, 0));
+}
+
+void
+test_worker_reads_in_the_background_and_chains_the_thermistor(void) {
+    amg88_err_t err = AMG88_ERR;
+
+    dev.read_async = i2c_async_read;
+    gated = true;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &xfer, &frame, 1, on_done, &done_calls));
+
+    /* On the bus: nothing to collect, and the handle refuses a second transfer */
+    TEST_ASSERT_FALSE(amg88_xfer_poll(&xfer, &err));
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_TIMEOUT, amg88_xfer_wait(&xfer, 20));
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_get_frame_raw_async(&dev, &xfer, &frame, 1, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT(0, done_calls);
+
+    /* Pixel burst, then the thermistor burst queued from the worker itself */
+    osal_sem_give(&gate);
+    osal_sem_give(&gate);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_wait(&xfer, OSAL_WAIT_FOREVER));
+    TEST_ASSERT_EQUAL_UINT(2, transactions);
+    TEST_ASSERT_EQUAL_UINT(1, done_calls);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, done_err);
+    TEST_ASSERT_EQUAL_PTR(&done_calls, done_arg);
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &frame, sizeof(frame));
+}
+
+void
+test_two_handles_keep_a_read_queued_behind_another(void) {
+    amg88_xfer_t second;
+    amg88_frame_raw_t frame2;
+    amg88_err_t err = AMG88_ERR;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_init(&second));
+    dev.read_async = i2c_async_read;
+    gated = true;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &xfer, &frame, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &second, &frame2, 0, NULL, NULL));
+
+    /* Finished in queue order */
+    osal_sem_give(&gate);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_wait(&xfer, OSAL_WAIT_FOREVER));
+    TEST_ASSERT_FALSE(amg88_xfer_poll(&second, &err));
+    osal_sem_give(&gate);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_wait(&second, OSAL_WAIT_FOREVER));
+    TEST_ASSERT_EQUAL_MEMORY(expected.pixels, frame2.pixels, AMG88_FRAME_RAW_SIZE);
+}
+
+void
+test_unstarted_bus_is_refused_without_a_callback(void) {
+    dev.bus = 0;
+    dev.read_async = i2c_async_read;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_get_frame_raw_async(&dev, &xfer, &frame, 1, on_done, &done_calls));
+    TEST_ASSERT_EQUAL_UINT(0, done_calls);
+
+    /* The handle is free again */
+    dev.read_async = NULL;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_async(&dev, &xfer, &frame, 1, on_done, &done_calls));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_xfer_wait(&xfer, 0));
+}
@@ -0,0 +1,103 @@
+/**
+ * \file            test_amg88_burst.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame reads against a mock bus that counts transactions: one burst instead of one per pixel
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+
+/* Vars */
+static uint8_t regs[256];
+static unsigned transactions;
+static unsigned bytes;
+static amg88_dev_t dev;
+
+
+/* Mock bus: a flat register map, every call is one write-then-read transaction */
+static amg88_err_t
+mock_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    transactions++;
+    bytes += (unsigned) len;
+    for (size_t i = 0; i < len; ++i) {
+        data_buf[i] = regs[(uint8_t) (reg_addr + i)];
+    }
+
+    return AMG88_OK;
+}
+
+static amg88_err_t
+mock_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    transactions++;
+    memcpy(&regs[reg_addr], data_buf, len);
+
+    return AMG88_OK;
+}
+
+void
+setUp(void) {
+    memset(regs, 0, sizeof(regs));
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        regs[AMG88_REG_TL + 2 * i] = (uint8_t) (i * 3);
+        regs[AMG88_REG_TL + 2 * i + 1] = (uint8_t) (i & 1);
+    }
+    regs[AMG88_REG_TTHL] = 0x90;
+    regs[AMG88_REG_TTHH] = 0x01;
+
+    dev = (amg88_dev_t) { .addr = AMG88_I2C_ADDR_LOW, .read = mock_read, .write = mock_write };
+    transactions = 0;
+    bytes = 0;
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_get_array_is_one_burst_with_per_pixel_values(void) {
+    float per_pixel[AMG88_ARRAY_SIZE], burst[AMG88_ARRAY_SIZE];
+
+    /* The old way, one read per pixel */
+    for (uint8_t r = 0; r < AMG88_ARRAY_ROWS; ++r) {
+        for (uint8_t c = 0; c < AMG88_ARRAY_COLS; ++c) {
+            per_pixel[r * AMG88_ARRAY_COLS + c] = amg88_get_pixel(&dev, r, c);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(AMG88_ARRAY_SIZE, transactions);
+
+    /* Whole array in one burst, same values */
+    transactions = 0;
+    bytes = 0;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_array(&dev, burst));
+    TEST_ASSERT_EQUAL_UINT(1, transactions);
+    TEST_ASSERT_EQUAL_UINT(AMG88_FRAME_RAW_SIZE, bytes);
+    TEST_ASSERT_EQUAL_MEMORY(per_pixel, burst, sizeof(burst));
+}
+
+void
+test_get_frame_raw_chains_the_thermistor(void) {
+    amg88_frame_raw_t frame;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 1));
+    TEST_ASSERT_EQUAL_UINT(2, transactions);
+    TEST_ASSERT_EQUAL_UINT(AMG88_FRAME_RAW_SIZE + 2, bytes);
+    TEST_ASSERT_EQUAL_MEMORY(&regs[AMG88_REG_TL], frame.pixels, AMG88_FRAME_RAW_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(&regs[AMG88_REG_TTHL], frame.thermistor, 2);
+}
+
+void
+test_get_frame_raw_without_thermistor(void) {
+    amg88_frame_raw_t frame;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_UINT(1, transactions);
+    TEST_ASSERT_EQUAL_UINT(AMG88_FRAME_RAW_SIZE, bytes);
+}
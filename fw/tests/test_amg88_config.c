@@ -0,0 +1,213 @@
+/**
+ * \file            test_amg88_config.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Config register shadow: cached getters, skipped setters, batched writes and the AVE key
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+
+#define MAX_LOG 16
+
+/**
+ * \brief           One bus write, as seen by the mock
+ */
+typedef struct {
+    uint8_t reg;
+    size_t len;
+    uint8_t val;                                /* First byte */
+} write_log_t;
+
+/* Vars */
+static uint8_t regs[256];
+static unsigned reads;
+static write_log_t log_w[MAX_LOG];
+static unsigned writes;
+static unsigned fail_writes;
+static amg88_dev_t dev;
+
+
+static amg88_err_t
+mock_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    reads++;
+    memcpy(data_buf, &regs[reg_addr], len);
+
+    return AMG88_OK;
+}
+
+/* Logs every write, `fail_writes` of them fail before reaching the registers */
+static amg88_err_t
+mock_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    if (fail_writes > 0) {
+        fail_writes--;
+        return AMG88_ERR_I2C;
+    }
+    if (writes < MAX_LOG) {
+        log_w[writes] = (write_log_t) { .reg = reg_addr, .len = len, .val = data_buf[0] };
+    }
+    writes++;
+    memcpy(&regs[reg_addr], data_buf, len);
+
+    return AMG88_OK;
+}
+
+static void
+check_write(unsigned idx, uint8_t reg, size_t len) {
+    TEST_ASSERT_GREATER_THAN_UINT(idx, writes);
+    TEST_ASSERT_EQUAL_HEX8(reg, log_w[idx].reg);
+    TEST_ASSERT_EQUAL_size_t(len, log_w[idx].len);
+}
+
+void
+setUp(void) {
+    memset(regs, 0, sizeof(regs));
+    regs[AMG88_REG_FPSC] = AMG88_FPS_10;
+    reads = writes = fail_writes = 0;
+    dev = (amg88_dev_t) { .addr = AMG88_I2C_ADDR_LOW, .read = mock_read, .write = mock_write };
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_getters_read_the_sensor_once(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_FPS_10, amg88_get_frame_rate(&dev));
+    TEST_ASSERT_EQUAL_INT(AMG88_FPS_10, amg88_get_frame_rate(&dev));
+    TEST_ASSERT_EQUAL_UINT(1, reads);
+
+    /* Known after a set, no read needed */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_op_mode(&dev, AMG88_OP_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AMG88_OP_NORMAL, amg88_get_op_mode(&dev));
+    TEST_ASSERT_EQUAL_UINT(1, reads);
+
+    /* Forgotten after an invalidation or an initial reset */
+    amg88_config_invalidate(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_FPS_10, amg88_get_frame_rate(&dev));
+    TEST_ASSERT_EQUAL_UINT(2, reads);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_reset(&dev, AMG88_RESET_INITIAL));
+    TEST_ASSERT_EQUAL_INT(AMG88_FPS_10, amg88_get_frame_rate(&dev));
+    TEST_ASSERT_EQUAL_UINT(3, reads);
+}
+
+void
+test_unchanged_values_stay_off_the_bus(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, 0.0f, 1.0f));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, 0.0f, 1.0f));
+    TEST_ASSERT_EQUAL_UINT(2, writes);
+    check_write(0, AMG88_REG_FPSC, 1);
+    check_write(1, AMG88_REG_INTHL, 6);
+    TEST_ASSERT_EQUAL_UINT(0, reads);
+}
+
+void
+test_batch_writes_once_per_burst(void) {
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_enable_int(&dev, AMG88_INT_ABSOLUTE));
+
+    /* Nested, the inner commit writes nothing */
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, 0.0f, 1.0f));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(0, writes);
+
+    /* FPSC and INTC share a burst, the levels take another */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(2, writes);
+    check_write(0, AMG88_REG_FPSC, 2);
+    check_write(1, AMG88_REG_INTHL, 6);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_1, regs[AMG88_REG_FPSC]);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_INTC_INTEN | AMG88_INTC_INTMOD, regs[AMG88_REG_INTC]);
+}
+
+void
+test_clean_known_registers_are_bridged(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, 0.0f, 1.0f));
+    writes = 0;
+
+    /* Only the low bytes of high and hysteresis change, the low level in between is rewritten as it is */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 35.0f, 0.0f, 2.0f));
+    TEST_ASSERT_EQUAL_UINT(1, writes);
+    check_write(0, AMG88_REG_INTHL, AMG88_REG_IHYSL - AMG88_REG_INTHL + 1);
+    TEST_ASSERT_EQUAL_HEX8(0, regs[AMG88_REG_INTLL]);
+}
+
+void
+test_sleep_goes_last_and_wake_up_first(void) {
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_op_mode(&dev, AMG88_OP_SLEEP));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(2, writes);
+    check_write(0, AMG88_REG_FPSC, 1);
+    check_write(1, AMG88_REG_PCTL, 1);
+
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_10));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_op_mode(&dev, AMG88_OP_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(4, writes);
+    check_write(2, AMG88_REG_PCTL, 1);
+    check_write(3, AMG88_REG_FPSC, 1);
+}
+
+void
+test_failed_write_stays_pending(void) {
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    fail_writes = 1;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_10, regs[AMG88_REG_FPSC]);
+
+    /* Retried by the next commit */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(1, writes);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_1, regs[AMG88_REG_FPSC]);
+}
+
+void
+test_moving_average_is_written_between_the_key_and_the_lock(void) {
+    static const uint8_t key[] = AMG88_AVE_UNLOCK;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_moving_average(&dev, AMG88_AVE_TWICE));
+    TEST_ASSERT_EQUAL_UINT(5, writes);
+    for (unsigned i = 0; i < sizeof(key); ++i) {
+        check_write(i, AMG88_REG_AVE_KEY, 1);
+        TEST_ASSERT_EQUAL_HEX8(key[i], log_w[i].val);
+    }
+    check_write(3, AMG88_REG_AVE, 1);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_TWICE, log_w[3].val);
+    check_write(4, AMG88_REG_AVE_KEY, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log_w[4].val);
+
+    /* Unchanged: not even the key goes out */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_moving_average(&dev, AMG88_AVE_TWICE));
+    TEST_ASSERT_EQUAL_UINT(5, writes);
+}
+
+void
+test_moving_average_relocks_after_a_failed_key(void) {
+    fail_writes = 1;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_set_moving_average(&dev, AMG88_AVE_TWICE));
+    TEST_ASSERT_EQUAL_UINT(1, writes);
+    check_write(0, AMG88_REG_AVE_KEY, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log_w[0].val);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_OFF, regs[AMG88_REG_AVE]);
+
+    /* Still pending, the next flush sends the whole sequence */
+    amg88_config_begin(&dev);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_config_commit(&dev));
+    TEST_ASSERT_EQUAL_UINT(6, writes);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_TWICE, regs[AMG88_REG_AVE]);
+}
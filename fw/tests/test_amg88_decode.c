@@ -0,0 +1,78 @@
+/**
+ * \file            test_amg88_decode.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Batch decoders against the per-pixel macros, every possible register value
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+
+/* Vars */
+static amg88_frame_raw_t frame;
+static int16_t fixed[AMG88_ARRAY_SIZE];
+
+
+void
+setUp(void) {
+    memset(&frame, 0, sizeof(frame));
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_decode_matches_macro_bit_for_bit(void) {
+    float batch[AMG88_ARRAY_SIZE];
+
+    /* All 2^16 register pairs, the 4 unused high bits included, 64 per frame */
+    for (uint32_t base = 0; base < 0x10000; base += AMG88_ARRAY_SIZE) {
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            frame.pixels[2 * i] = (uint8_t) (base + i);
+            frame.pixels[2 * i + 1] = (uint8_t) ((base + i) >> 8);
+        }
+        amg88_decode_frame(&frame, fixed);
+        amg88_decode_frame_float(&frame, batch);
+
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            float macro = AMG88_PIXEL_2_TEMP(&frame.pixels[2 * i]);
+            float from_fixed = AMG88_TEMP_FROM_FIXED(fixed[i]);
+
+            /* Bit for bit, so -0.0 against 0.0 counts as a mismatch */
+            TEST_ASSERT_EQUAL_MEMORY(&macro, &batch[i], sizeof(macro));
+            TEST_ASSERT_EQUAL_MEMORY(&macro, &from_fixed, sizeof(macro));
+        }
+    }
+}
+
+void
+test_decode_range_ends_and_zero(void) {
+    frame.pixels[0] = 0xFF, frame.pixels[1] = 0x07;    /* +511.75 */
+    frame.pixels[2] = 0x00, frame.pixels[3] = 0x08;    /* -512 */
+    frame.pixels[4] = 0xFF, frame.pixels[5] = 0x0F;    /* -0.25 */
+    frame.pixels[6] = 0x01, frame.pixels[7] = 0x00;    /* +0.25 */
+    amg88_decode_frame(&frame, fixed);
+    TEST_ASSERT_EQUAL_INT16(2047, fixed[0]);
+    TEST_ASSERT_EQUAL_INT16(-2048, fixed[1]);
+    TEST_ASSERT_EQUAL_INT16(-1, fixed[2]);
+    TEST_ASSERT_EQUAL_INT16(1, fixed[3]);
+    TEST_ASSERT_TRUE(AMG88_PIXEL_2_TEMP(&frame.pixels[2]) == -512.0f);
+}
+
+void
+test_decode_thermistor_matches_macro(void) {
+    /* 12-bit sign-magnitude */
+    for (uint32_t v = 0; v < 0x10000; ++v) {
+        float macro, batch;
+
+        frame.thermistor[0] = (uint8_t) v;
+        frame.thermistor[1] = (uint8_t) (v >> 8);
+        macro = AMG88_THERMISTOR_2_TEMP(frame.thermistor);
+        batch = AMG88_THERMISTOR_FROM_FIXED(amg88_decode_thermistor(&frame));
+        TEST_ASSERT_EQUAL_MEMORY(&macro, &batch, sizeof(macro));
+    }
+}
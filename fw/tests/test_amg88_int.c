@@ -0,0 +1,127 @@
+/**
+ * \file            test_amg88_int.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Interrupt API register encoding, checked on a mock register map
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+
+/* Vars */
+static uint8_t regs[256];
+static unsigned reads, writes;
+static unsigned bytes_read, bytes_written;
+static amg88_dev_t dev;
+
+
+static amg88_err_t
+mock_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    reads++;
+    bytes_read += (unsigned) len;
+    memcpy(data_buf, &regs[reg_addr], len);
+
+    return AMG88_OK;
+}
+
+static amg88_err_t
+mock_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    writes++;
+    bytes_written += (unsigned) len;
+    memcpy(&regs[reg_addr], data_buf, len);
+
+    return AMG88_OK;
+}
+
+static uint16_t
+reg16(uint8_t reg) {
+    return (uint16_t) (regs[reg] | (regs[reg + 1] << 8));
+}
+
+void
+setUp(void) {
+    memset(regs, 0, sizeof(regs));
+    reads = writes = 0;
+    bytes_read = bytes_written = 0;
+    dev = (amg88_dev_t) { .addr = AMG88_I2C_ADDR_LOW, .read = mock_read, .write = mock_write };
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_temp_to_reg_rounds_and_saturates(void) {
+    /* 12-bit two's complement, 1/4 degree, rounded half away from zero */
+    TEST_ASSERT_EQUAL_HEX16(0x000, amg88_temp_to_reg(0.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x001, amg88_temp_to_reg(0.25f));
+    TEST_ASSERT_EQUAL_HEX16(0x001, amg88_temp_to_reg(0.125f));
+    TEST_ASSERT_EQUAL_HEX16(0x000, amg88_temp_to_reg(0.1f));
+    TEST_ASSERT_EQUAL_HEX16(0xFFF, amg88_temp_to_reg(-0.25f));
+    TEST_ASSERT_EQUAL_HEX16(0xFFF, amg88_temp_to_reg(-0.125f));
+    TEST_ASSERT_EQUAL_HEX16(0x064, amg88_temp_to_reg(25.0f));
+    TEST_ASSERT_EQUAL_HEX16(0xFD6, amg88_temp_to_reg(-10.5f));
+
+    /* Saturated at both ends */
+    TEST_ASSERT_EQUAL_HEX16(0x7FF, amg88_temp_to_reg(511.75f));
+    TEST_ASSERT_EQUAL_HEX16(0x7FF, amg88_temp_to_reg(1000.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x800, amg88_temp_to_reg(-512.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x800, amg88_temp_to_reg(-1000.0f));
+}
+
+void
+test_set_int_levels_is_one_burst(void) {
+    /* Six registers, low byte first */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, -10.5f, 2.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x078, reg16(AMG88_REG_INTHL));
+    TEST_ASSERT_EQUAL_HEX16(0xFD6, reg16(AMG88_REG_INTLL));
+    TEST_ASSERT_EQUAL_HEX16(0x008, reg16(AMG88_REG_IHYSL));
+    TEST_ASSERT_EQUAL_UINT(1, writes);
+    TEST_ASSERT_EQUAL_UINT(6, bytes_written);
+
+    /* Negative hysteresis is clamped to 0 */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, -10.5f, -1.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x000, reg16(AMG88_REG_IHYSL));
+}
+
+void
+test_enable_int_sets_mode_and_enable_bits(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_enable_int(&dev, AMG88_INT_ABSOLUTE));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_INTC_INTEN | AMG88_INTC_INTMOD, regs[AMG88_REG_INTC]);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_enable_int(&dev, AMG88_INT_DIFFERENCE));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_INTC_INTEN, regs[AMG88_REG_INTC]);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_disable_int(&dev));
+    TEST_ASSERT_EQUAL_HEX8(0x00, regs[AMG88_REG_INTC]);
+}
+
+void
+test_get_int_table_is_one_burst_pixel_0_in_bit_0(void) {
+    uint64_t mask;
+
+    regs[AMG88_REG_INT0] = 0x01;                /* Pixel 0 */
+    regs[AMG88_REG_INT0 + 1] = 0x02;            /* Pixel 9 */
+    regs[AMG88_REG_INT0 + 7] = 0x80;            /* Pixel 63 */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_int_table(&dev, &mask));
+    TEST_ASSERT_EQUAL_HEX64((1ULL << 0) | (1ULL << 9) | (1ULL << 63), mask);
+    TEST_ASSERT_EQUAL_UINT(1, reads);
+    TEST_ASSERT_EQUAL_UINT(8, bytes_read);
+}
+
+void
+test_clear_status_writes_only_the_flag_bits(void) {
+    uint8_t stat;
+
+    regs[AMG88_REG_STAT] = AMG88_STAT_INT | AMG88_STAT_OVF_IRS;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_status(&dev, &stat));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_STAT_INT | AMG88_STAT_OVF_IRS, stat);
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_clear_status(&dev, AMG88_STAT_INT | 0xF0));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_STAT_INT, regs[AMG88_REG_SCLR]);
+}
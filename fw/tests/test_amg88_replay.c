@@ -0,0 +1,135 @@
+/**
+ * \file            test_amg88_replay.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Replayed sensor through the driver: one record per read, pacing, timed speeds, corrupted records
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88_replay.h"
+#include "frame_rec/frame_rec.h"
+
+#define N_RECORDS       3
+#define PERIOD_US       100000
+
+/* Vars */
+static uint8_t file[FRAME_REC_HDR_SIZE + N_RECORDS * FRAME_REC_RECORD_SIZE];
+static frame_rec_t rec;
+static amg88_replay_t rp;
+static amg88_dev_t dev;
+static uint64_t now_us;
+static unsigned paced;
+
+
+static uint64_t
+fake_clock_us(void) {
+    return now_us;
+}
+
+static void
+count_pace(void* arg) {
+    (*(unsigned*) arg)++;
+}
+
+/* Pixel byte of the frame read now */
+static uint8_t
+read_frame(amg88_err_t expected) {
+    amg88_frame_raw_t frame;
+
+    memset(&frame, 0xFF, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(expected, amg88_get_frame_raw(&dev, &frame, 0));
+
+    return frame.pixels[0];
+}
+
+/* Record `i` has every pixel byte at `i`, a period apart */
+static void
+open_recording(void) {
+    amg88_frame_raw_t frame;
+    size_t size;
+
+    memset(&frame, 0, sizeof(frame));
+    size = frame_rec_encode_hdr(file, PERIOD_US);
+    for (uint8_t i = 0; i < N_RECORDS; ++i) {
+        memset(frame.pixels, i, sizeof(frame.pixels));
+        size += frame_rec_encode(&file[size], 5000000ULL + i * PERIOD_US, i, &frame);
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, size));
+}
+
+void
+setUp(void) {
+    now_us = 0;
+    paced = 0;
+    memset(&dev, 0, sizeof(dev));
+    open_recording();
+}
+
+void
+tearDown(void) {
+    amg88_replay_detach_all();
+}
+
+void
+test_asap_hands_out_the_next_record_on_every_frame_read(void) {
+    amg88_replay_init(&rp, 0, AMG88_I2C_ADDR_LOW, &rec, AMG88_REPLAY_ASAP, NULL);
+    amg88_replay_set_pace(&rp, count_pace, &paced);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_replay_attach(&rp, &dev));
+
+    for (uint8_t i = 0; i < N_RECORDS; ++i) {
+        TEST_ASSERT_EQUAL_HEX8(i, read_frame(AMG88_OK));
+        TEST_ASSERT_EQUAL_UINT(i, paced);       /* Held before every record but the first */
+    }
+    TEST_ASSERT_FALSE(amg88_replay_done(&rp));
+    read_frame(AMG88_ERR_I2C);
+    TEST_ASSERT_TRUE(amg88_replay_done(&rp));
+    TEST_ASSERT_EQUAL_UINT32(N_RECORDS, rp.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, rp.stats.skipped);
+
+    /* And again from the top */
+    amg88_replay_start(&rp);
+    TEST_ASSERT_EQUAL_HEX8(0, read_frame(AMG88_OK));
+}
+
+void
+test_timed_replay_follows_the_clock_at_speed(void) {
+    amg88_replay_init(&rp, 0, AMG88_I2C_ADDR_LOW, &rec, 2, fake_clock_us);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_replay_attach(&rp, &dev));
+
+    /* Twice real time: a record every 50 ms, the one in between is missed */
+    TEST_ASSERT_EQUAL_HEX8(0, read_frame(AMG88_OK));
+    now_us = 49999;
+    TEST_ASSERT_EQUAL_HEX8(0, read_frame(AMG88_OK));
+    now_us = 100000;
+    TEST_ASSERT_EQUAL_HEX8(2, read_frame(AMG88_OK));
+    TEST_ASSERT_EQUAL_UINT32(1, rp.stats.skipped);
+
+    /* The last record holds for one period, then the recording is over */
+    now_us = 149999;
+    TEST_ASSERT_EQUAL_HEX8(2, read_frame(AMG88_OK));
+    now_us = 150000;
+    read_frame(AMG88_ERR_I2C);
+    TEST_ASSERT_TRUE(amg88_replay_done(&rp));
+}
+
+void
+test_corrupted_record_keeps_the_previous_frame(void) {
+    file[FRAME_REC_HDR_SIZE + FRAME_REC_RECORD_SIZE + 20] ^= 1;
+    amg88_replay_init(&rp, 0, AMG88_I2C_ADDR_LOW, &rec, AMG88_REPLAY_ASAP, NULL);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_replay_attach(&rp, &dev));
+
+    TEST_ASSERT_EQUAL_HEX8(0, read_frame(AMG88_OK));
+    TEST_ASSERT_EQUAL_HEX8(0, read_frame(AMG88_OK));
+    TEST_ASSERT_EQUAL_HEX8(2, read_frame(AMG88_OK));
+    TEST_ASSERT_EQUAL_UINT32(1, rp.stats.crc_errors);
+
+    /* Writes only land in the register map, another address is nobody */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_1, rp.regs[AMG88_REG_FPSC]);
+    dev.addr = AMG88_I2C_ADDR_HIGH;
+    read_frame(AMG88_ERR_I2C);
+}
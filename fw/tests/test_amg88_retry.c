@@ -0,0 +1,122 @@
+/**
+ * \file            test_amg88_retry.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame reads under the retry policy: burst retries, lost rows, bus recovery, the time budget
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+
+#define ROW_MASK        0xFFULL                 /* Valid bits of one row */
+
+/* Vars */
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static amg88_frame_raw_t frame;
+static amg88_frame_status_t status;
+
+
+/* Budget clock: the modelled bus time, so timeouts advance it */
+static uint64_t
+bus_clock_us(void) {
+    return sim.stats.bus_ns / 1000ULL;
+}
+
+void
+setUp(void) {
+    memset(&dev, 0, sizeof(dev));
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_attach(&sim, &dev));
+    dev.retry = (amg88_retry_t) { .bursts = 8, .retries = 2 };
+}
+
+void
+tearDown(void) {
+    amg88_sim_detach_all();
+}
+
+void
+test_failed_burst_is_retried_alone(void) {
+    amg88_sim_inject(&sim, AMG88_ERR_I2C, 3, 1);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, status.err);
+    TEST_ASSERT_EQUAL_HEX64(UINT64_MAX, status.valid);
+    TEST_ASSERT_TRUE(status.thermistor);
+    TEST_ASSERT_EQUAL_UINT8(1, status.retries);
+    TEST_ASSERT_EQUAL_UINT8(0, status.recoveries);
+    TEST_ASSERT_EQUAL_MEMORY(&sim.regs[AMG88_REG_TL], frame.pixels, AMG88_FRAME_RAW_SIZE);
+
+    /* Only the failed row went on the wire again */
+    TEST_ASSERT_EQUAL_UINT32(AMG88_FRAME_RAW_SIZE + 2, sim.stats.bytes_read);
+}
+
+void
+test_lost_burst_costs_its_row_not_the_frame(void) {
+    dev.retry.retries = 1;
+    amg88_sim_inject(&sim, AMG88_ERR_I2C, 2, 2);
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_EQUAL_HEX64(~(ROW_MASK << 16), status.valid);
+    TEST_ASSERT_TRUE(status.thermistor);
+    TEST_ASSERT_EQUAL_UINT8(1, status.retries);
+
+    /* The rows after it were still read */
+    TEST_ASSERT_EQUAL_MEMORY(&sim.regs[AMG88_REG_TL + 3 * AMG88_ARRAY_COLS * AMG88_PIXEL_BYTES],
+                             &frame.pixels[3 * AMG88_ARRAY_COLS * AMG88_PIXEL_BYTES],
+                             5 * AMG88_ARRAY_COLS * AMG88_PIXEL_BYTES);
+
+    /* No status wanted, same result */
+    amg88_sim_inject(&sim, AMG88_ERR_I2C, 0, 2);
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_get_frame_raw_status(&dev, &frame, 0, NULL));
+}
+
+void
+test_timed_out_burst_recovers_the_bus_before_its_retry(void) {
+    /* Held down until recovered */
+    sim.stuck_left = UINT32_MAX;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_TIMEOUT, amg88_get_frame_raw_status(&dev, &frame, 0, &status));
+    TEST_ASSERT_EQUAL_HEX64(0, status.valid);
+    TEST_ASSERT_EQUAL_UINT8(0, status.recoveries);
+
+    dev.recover = amg88_sim_recover;
+    amg88_sim_reset_stats(&sim);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_EQUAL_HEX64(UINT64_MAX, status.valid);
+    TEST_ASSERT_EQUAL_UINT8(1, status.retries);
+    TEST_ASSERT_EQUAL_UINT8(1, status.recoveries);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stats.recoveries);
+
+    /* Two plain failures in a row are taken for a held bus too */
+    amg88_sim_inject(&sim, AMG88_ERR_I2C, 0, 2);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_status(&dev, &frame, 0, &status));
+    TEST_ASSERT_EQUAL_UINT8(2, status.retries);
+    TEST_ASSERT_EQUAL_UINT8(1, status.recoveries);
+}
+
+void
+test_budget_stops_the_retries_once_spent(void) {
+    /* Every attempt times out, 1 ms of bus time each */
+    sim.stuck_left = UINT32_MAX;
+    dev.retry.budget_us = 2500;
+
+    /* No clock, no budget: every burst and the thermistor get all their attempts */
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_TIMEOUT, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_EQUAL_UINT32(9 * 3, sim.stats.errors);
+
+    /* Three attempts fit in 2.5 ms, then the rest of the frame is skipped */
+    dev.clock_us = bus_clock_us;
+    amg88_sim_reset_stats(&sim);
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_TIMEOUT, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_EQUAL_UINT32(3, sim.stats.errors);
+    TEST_ASSERT_EQUAL_UINT8(2, status.retries);
+    TEST_ASSERT_FALSE(status.thermistor);
+
+    /* A healthy frame is never cut short, whatever the time */
+    sim.stuck_left = 0;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw_status(&dev, &frame, 1, &status));
+    TEST_ASSERT_TRUE(status.thermistor);
+}
@@ -0,0 +1,194 @@
+/**
+ * \file            test_amg88_sim.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Simulated register map through the driver: bus time model, torn reads, interrupts, faults and
+ *                  bus routing, the AVE key
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+
+/* Vars */
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static amg88_frame_raw_t frames[2];
+static uint64_t now_us;
+
+
+static uint64_t
+fake_clock_us(void) {
+    return now_us;
+}
+
+/* Every pixel at the same raw value */
+static void
+fill_frame(amg88_frame_raw_t* p_frame, uint16_t raw) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_frame->pixels[2 * i] = (uint8_t) raw;
+        p_frame->pixels[2 * i + 1] = (uint8_t) (raw >> 8);
+    }
+    p_frame->thermistor[0] = 0x90;
+    p_frame->thermistor[1] = 0x01;
+}
+
+void
+setUp(void) {
+    now_us = 0;
+    fill_frame(&frames[0], 0x064);              /* 25 degrees */
+    fill_frame(&frames[1], 0x0A0);              /* 40 degrees */
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_attach(&sim, &dev));
+}
+
+void
+tearDown(void) {
+    amg88_sim_detach_all();
+}
+
+void
+test_bus_time_counts_header_and_data_bytes(void) {
+    amg88_frame_raw_t frame;
+
+    /* 9 bits per byte at 400 kHz, 3 header bytes per read */
+    amg88_sim_set_bus(&sim, 400000, 0, false);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stats.reads);
+    TEST_ASSERT_EQUAL_UINT32(AMG88_FRAME_RAW_SIZE, sim.stats.bytes_read);
+    TEST_ASSERT_EQUAL_UINT64((AMG88_SIM_READ_HDR + AMG88_FRAME_RAW_SIZE) * 22500ULL, sim.stats.bus_ns);
+
+    /* Plus the fixed cost per transaction, 2 header bytes per write */
+    amg88_sim_reset_stats(&sim);
+    amg88_sim_set_bus(&sim, 400000, 1000, false);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_frame_rate(&dev, AMG88_FPS_1));
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stats.writes);
+    TEST_ASSERT_EQUAL_UINT64(1000 + (AMG88_SIM_WRITE_HDR + 1) * 22500ULL, sim.stats.bus_ns);
+}
+
+void
+test_frames_advance_by_hand_and_loop(void) {
+    amg88_frame_raw_t frame;
+
+    amg88_sim_set_frames(&sim, frames, 2);
+    for (size_t i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 1));
+        TEST_ASSERT_EQUAL_MEMORY(&frames[i % 2], &frame, sizeof(frame));
+        amg88_sim_next_frame(&sim);
+    }
+}
+
+void
+test_burst_across_a_frame_update_is_torn(void) {
+    amg88_frame_raw_t frame;
+    size_t first_new;
+
+    /* 10 fps, 90 us per byte at 100 kHz, the update lands 5 ms into the burst */
+    amg88_sim_set_frames(&sim, frames, 2);
+    amg88_sim_set_clock(&sim, fake_clock_us);
+    amg88_sim_set_bus(&sim, 100000, 0, false);
+    now_us = 95000;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+
+    /* Bytes on the wire from 5 ms on come from the next frame */
+    first_new = (5000 + 89) / 90 - AMG88_SIM_READ_HDR;
+    TEST_ASSERT_EQUAL_MEMORY(frames[0].pixels, frame.pixels, first_new);
+    TEST_ASSERT_EQUAL_MEMORY(&frames[1].pixels[first_new], &frame.pixels[first_new],
+                             AMG88_FRAME_RAW_SIZE - first_new);
+
+    /* A burst within one frame period is whole */
+    now_us = 150000;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_MEMORY(frames[1].pixels, frame.pixels, AMG88_FRAME_RAW_SIZE);
+}
+
+void
+test_absolute_interrupt_follows_the_frames(void) {
+    uint64_t mask;
+    uint8_t stat;
+
+    amg88_sim_set_frames(&sim, frames, 2);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_int_levels(&dev, 30.0f, 0.0f, 0.0f));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_enable_int(&dev, AMG88_INT_ABSOLUTE));
+
+    /* 25 degrees, inside the levels */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_status(&dev, &stat));
+    TEST_ASSERT_EQUAL_HEX8(0, stat & AMG88_STAT_INT);
+
+    /* 40 degrees, every pixel above the high level */
+    amg88_sim_next_frame(&sim);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_status(&dev, &stat));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_STAT_INT, stat & AMG88_STAT_INT);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_int_table(&dev, &mask));
+    TEST_ASSERT_EQUAL_HEX64(UINT64_MAX, mask);
+
+    /* Clearing the flag clears the table */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_clear_status(&dev, AMG88_STAT_INT));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_int_table(&dev, &mask));
+    TEST_ASSERT_EQUAL_HEX64(0, mask);
+}
+
+void
+test_injected_faults_fail_a_run_of_transactions(void) {
+    amg88_frame_raw_t frame;
+
+    amg88_sim_inject(&sim, AMG88_ERR_I2C, 1, 2);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, sim.stats.errors);
+    TEST_ASSERT_EQUAL_UINT32(2 * AMG88_FRAME_RAW_SIZE, sim.stats.bytes_read);
+
+    /* A timeout holds the bus for its whole duration */
+    amg88_sim_reset_stats(&sim);
+    amg88_sim_inject(&sim, AMG88_ERR_TIMEOUT, 0, 1);
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_TIMEOUT, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_UINT64(sim.timeout_us * 1000ULL, sim.stats.bus_ns);
+
+    /* Nobody at the other address */
+    dev.addr = AMG88_I2C_ADDR_HIGH;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR_I2C, amg88_get_frame_raw(&dev, &frame, 0));
+}
+
+void
+test_same_address_on_two_buses(void) {
+    amg88_sim_t other;
+    amg88_dev_t other_dev;
+    amg88_frame_raw_t frame;
+
+    memset(&other_dev, 0, sizeof(other_dev));
+    amg88_sim_init(&other, 1, AMG88_I2C_ADDR_LOW);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_attach(&other, &other_dev));
+    TEST_ASSERT_EQUAL_UINT8(1, other_dev.bus);
+    amg88_sim_set_frames(&other, &frames[1], 1);
+
+    /* Each handler reaches only the device on its own bus */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+    TEST_ASSERT_EQUAL_MEMORY(frames[0].pixels, frame.pixels, AMG88_FRAME_RAW_SIZE);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&other_dev, &frame, 0));
+    TEST_ASSERT_EQUAL_MEMORY(frames[1].pixels, frame.pixels, AMG88_FRAME_RAW_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stats.reads);
+    TEST_ASSERT_EQUAL_UINT32(1, other.stats.reads);
+}
+
+void
+test_moving_average_needs_the_key(void) {
+    uint8_t val = AMG88_AVE_TWICE;
+
+    /* A bare write is ignored, like on the sensor */
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_write(0, AMG88_I2C_ADDR_LOW, AMG88_REG_AVE, 1, &val));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_OFF, sim.regs[AMG88_REG_AVE]);
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_set_moving_average(&dev, AMG88_AVE_TWICE));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_TWICE, sim.regs[AMG88_REG_AVE]);
+    TEST_ASSERT_EQUAL_UINT8(0, sim.ave_key);
+
+    /* Locked again */
+    val = AMG88_AVE_OFF;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_write(0, AMG88_I2C_ADDR_LOW, AMG88_REG_AVE, 1, &val));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_AVE_TWICE, sim.regs[AMG88_REG_AVE]);
+}
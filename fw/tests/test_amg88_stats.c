@@ -0,0 +1,94 @@
+/**
+ * \file            test_amg88_stats.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Single-pass frame statistics against a two-pass reference, and the rejected inputs
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+
+#define N_BINS          8
+
+/* Vars */
+static int16_t frame[AMG88_ARRAY_SIZE];
+static uint16_t bins[N_BINS];
+static amg88_hist_t hist;
+static amg88_stats_t stats, untouched;
+
+
+void
+setUp(void) {
+    srand(7);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        frame[i] = (int16_t) (rand() % 400 - 100); /* -25..75 degrees */
+    }
+    frame[10] = -2048;
+    frame[20] = 2047;
+
+    hist = (amg88_hist_t) { .bins = bins, .n_bins = N_BINS, .lo = 80, .shift = 4 };
+    memset(&untouched, 0x5A, sizeof(untouched));
+    stats = untouched;
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_stats_match_a_two_pass_reference(void) {
+    double mean = 0, var = 0;
+    unsigned hist_total = 0;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        mean += frame[i];
+    }
+    mean /= AMG88_ARRAY_SIZE;
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        var += (frame[i] - mean) * (frame[i] - mean);
+    }
+    var /= AMG88_ARRAY_SIZE;
+
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_frame_stats(frame, AMG88_ARRAY_SIZE, &stats, &hist));
+    TEST_ASSERT_EQUAL_INT16(-2048, stats.min);
+    TEST_ASSERT_EQUAL_UINT16(10, stats.argmin);
+    TEST_ASSERT_EQUAL_INT16(2047, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(20, stats.argmax);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, (float) mean, stats.mean);
+    TEST_ASSERT_FLOAT_WITHIN((float) var * 1e-4f, (float) var, stats.variance);
+
+    /* Both ends clamped in */
+    for (size_t i = 0; i < N_BINS; ++i) {
+        hist_total += bins[i];
+    }
+    TEST_ASSERT_EQUAL_UINT(AMG88_ARRAY_SIZE, hist_total);
+    TEST_ASSERT_TRUE(bins[0] > 0);
+    TEST_ASSERT_TRUE(bins[N_BINS - 1] > 0);
+}
+
+void
+test_single_value_is_degenerate_but_valid(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_frame_stats(&frame[20], 1, &stats, NULL));
+    TEST_ASSERT_EQUAL_INT16(2047, stats.min);
+    TEST_ASSERT_EQUAL_INT16(2047, stats.max);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance);
+}
+
+void
+test_nothing_to_compute_leaves_the_stats_untouched(void) {
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_frame_stats(frame, 0, &stats, NULL));
+    TEST_ASSERT_EQUAL_MEMORY(&untouched, &stats, sizeof(stats));
+
+    hist.n_bins = 0;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_frame_stats(frame, AMG88_ARRAY_SIZE, &stats, &hist));
+    TEST_ASSERT_EQUAL_MEMORY(&untouched, &stats, sizeof(stats));
+
+    hist.n_bins = N_BINS;
+    hist.bins = NULL;
+    TEST_ASSERT_EQUAL_INT(AMG88_ERR, amg88_frame_stats(frame, AMG88_ARRAY_SIZE, &stats, &hist));
+    TEST_ASSERT_EQUAL_MEMORY(&untouched, &stats, sizeof(stats));
+}
@@ -0,0 +1,248 @@
+/**
+ * \file            test_calib.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Calibration captures against a synthetic sensor with per-pixel errors, blob format and CRC-32
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "calib/calib.h"
+#include "crc32/crc32.h"
+
+#define CAPTURE_FRAMES  16
+#define TOL_Q2          2                       /* Tolerance after correction, 1/4 degree units */
+
+/* Vars */
+static calib_table_t table;
+static calib_acc_t acc_a, acc_b;
+static float pixel_gain[AMG88_ARRAY_SIZE];      /* Synthetic sensor errors */
+static float pixel_offset[AMG88_ARRAY_SIZE];
+static float pixel_drift[AMG88_ARRAY_SIZE];
+static uint32_t rng;
+
+
+static uint32_t
+rand_next(void) {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+/* Uniform in [-1, 1) */
+static float
+rand_unit(void) {
+    return (float) (rand_next() % 2000) / 1000.0f - 1.0f;
+}
+
+/* What the synthetic sensor reads looking at `scene` with its body at `th`, `frame_no` dithers the rounding */
+static void
+sensor_frame(float scene, float th, uint32_t frame_no, amg88_frame_raw_t* p_frame) {
+    int16_t q[AMG88_ARRAY_SIZE];
+    uint16_t th_raw;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        float v = pixel_gain[i] * scene + pixel_offset[i] + pixel_drift[i] * (th - 25.0f);
+
+        v = v * 4.0f + (float) ((frame_no + i) % CAPTURE_FRAMES) / CAPTURE_FRAMES - 0.5f;
+        q[i] = (int16_t) (v + (v < 0 ? -0.5f : 0.5f));
+    }
+    calib_pack_frame(q, p_frame);
+
+    /* Thermistor: 12-bit sign-magnitude, 1/16 degree */
+    th_raw = (uint16_t) (th < 0 ? (0x800 | (uint16_t) (-th * 16.0f + 0.5f)) : (uint16_t) (th * 16.0f + 0.5f));
+    p_frame->thermistor[0] = (uint8_t) th_raw;
+    p_frame->thermistor[1] = (uint8_t) (th_raw >> 8);
+}
+
+static void
+capture(calib_acc_t* p_acc, float scene, float th) {
+    amg88_frame_raw_t frame;
+
+    calib_acc_reset(p_acc);
+    for (uint32_t n = 0; n < CAPTURE_FRAMES; ++n) {
+        sensor_frame(scene, th, n, &frame);
+        calib_acc_add(p_acc, &frame);
+    }
+}
+
+/* Corrected frame of the scene, every pixel within the tolerance */
+static void
+check_reads(float scene, float th, int tol) {
+    amg88_frame_raw_t frame;
+    int16_t out[AMG88_ARRAY_SIZE];
+
+    sensor_frame(scene, th, CAPTURE_FRAMES / 2, &frame);
+    calib_decode_frame(&table, &frame, out);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        TEST_ASSERT_INT_WITHIN(tol, (int) (scene * 4.0f), out[i]);
+    }
+}
+
+void
+setUp(void) {
+    rng = 7;
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        pixel_gain[i] = 1.0f + 0.1f * rand_unit();
+        pixel_offset[i] = 2.0f * rand_unit();
+        pixel_drift[i] = 0.0f;
+    }
+    calib_init(&table);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_crc32_check_value_and_chunks(void) {
+    const char* p_check = "123456789";
+
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32_update(CRC32_INIT, p_check, 9));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32_update(crc32_update(CRC32_INIT, p_check, 4), p_check + 4, 5));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_INIT, crc32_update(CRC32_INIT, p_check, 0));
+}
+
+void
+test_identity_table_decodes_like_amg88(void) {
+    amg88_frame_raw_t frame;
+    int16_t plain[AMG88_ARRAY_SIZE], corrected[AMG88_ARRAY_SIZE];
+
+    for (size_t n = 0; n < 64; ++n) {
+        for (size_t i = 0; i < sizeof(frame.pixels); ++i) {
+            frame.pixels[i] = (uint8_t) rand_next();
+        }
+        frame.thermistor[0] = (uint8_t) rand_next();
+        frame.thermistor[1] = (uint8_t) rand_next();
+        amg88_decode_frame(&frame, plain);
+        calib_decode_frame(&table, &frame, corrected);
+        TEST_ASSERT_EQUAL_INT16_ARRAY(plain, corrected, AMG88_ARRAY_SIZE);
+    }
+}
+
+void
+test_two_point_recovers_gains_and_offsets(void) {
+    amg88_frame_raw_t frame;
+    int16_t out[AMG88_ARRAY_SIZE];
+    bool off = false;
+
+    /* Uncorrected, the pixel errors show */
+    sensor_frame(30.0f, 25.0f, 0, &frame);
+    calib_decode_frame(&table, &frame, out);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        off |= out[i] < 30 * 4 - 4 || out[i] > 30 * 4 + 4;
+    }
+    TEST_ASSERT_TRUE(off);
+
+    capture(&acc_a, 20.0f, 25.0f);
+    capture(&acc_b, 40.0f, 25.0f);
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_two_point(&table, &acc_a, 20.0f, &acc_b, 40.0f));
+    check_reads(30.0f, 25.0f, TOL_Q2);
+    check_reads(0.0f, 25.0f, TOL_Q2);
+    check_reads(60.0f, 25.0f, TOL_Q2);
+
+    /* Blackbodies too close together, table untouched */
+    memcpy(&acc_b, &acc_a, sizeof(acc_b));
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_RANGE, calib_capture_two_point(&table, &acc_a, 20.0f, &acc_b, 20.5f));
+    check_reads(30.0f, 25.0f, TOL_Q2);
+}
+
+void
+test_flat_field_and_one_point_fix_offsets(void) {
+    amg88_frame_raw_t frame;
+    int16_t out[AMG88_ARRAY_SIZE];
+    int16_t lo = INT16_MAX, hi = INT16_MIN;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        pixel_gain[i] = 1.0f;
+    }
+
+    /* Flat-field makes the pixels agree, not necessarily with the scene */
+    capture(&acc_a, 25.0f, 25.0f);
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_flat(&table, &acc_a));
+    sensor_frame(25.0f, 25.0f, CAPTURE_FRAMES / 2, &frame);
+    calib_decode_frame(&table, &frame, out);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        lo = out[i] < lo ? out[i] : lo;
+        hi = out[i] > hi ? out[i] : hi;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_INT(TOL_Q2, hi - lo);
+
+    /* One point against a blackbody puts them on it */
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_point(&table, &acc_a, 25.0f));
+    check_reads(25.0f, 25.0f, TOL_Q2);
+    check_reads(45.0f, 25.0f, TOL_Q2);
+
+    /* Nothing captured */
+    calib_acc_reset(&acc_b);
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_RANGE, calib_capture_flat(&table, &acc_b));
+}
+
+void
+test_drift_cancels_the_sensor_temperature(void) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        pixel_drift[i] = 0.2f * rand_unit();
+    }
+
+    capture(&acc_a, 20.0f, 25.0f);
+    capture(&acc_b, 40.0f, 25.0f);
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_two_point(&table, &acc_a, 20.0f, &acc_b, 40.0f));
+
+    /* Same scene, sensor body 10 degrees warmer */
+    capture(&acc_a, 30.0f, 25.0f);
+    capture(&acc_b, 30.0f, 35.0f);
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_drift(&table, &acc_a, &acc_b));
+    check_reads(30.0f, 25.0f, TOL_Q2);
+    check_reads(30.0f, 35.0f, TOL_Q2);
+    check_reads(30.0f, 15.0f, TOL_Q2 + 1);
+
+    /* Sensor temperature did not move */
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_RANGE, calib_capture_drift(&table, &acc_a, &acc_a));
+}
+
+void
+test_blob_round_trip_and_rejects(void) {
+    uint8_t blob[CALIB_BLOB_SIZE + 1];
+    calib_table_t parsed;
+
+    capture(&acc_a, 20.0f, 25.0f);
+    capture(&acc_b, 40.0f, 25.0f);
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_capture_two_point(&table, &acc_a, 20.0f, &acc_b, 40.0f));
+
+    TEST_ASSERT_EQUAL_size_t(0, calib_serialize(&table, blob, CALIB_BLOB_SIZE - 1));
+    TEST_ASSERT_EQUAL_size_t(CALIB_BLOB_SIZE, calib_serialize(&table, blob, sizeof(blob)));
+    memset(&parsed, 0, sizeof(parsed));
+    TEST_ASSERT_EQUAL_INT(CALIB_OK, calib_parse(blob, CALIB_BLOB_SIZE, &parsed));
+    TEST_ASSERT_EQUAL_MEMORY(&table, &parsed, sizeof(table));
+
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_LEN, calib_parse(blob, CALIB_BLOB_SIZE - 1, &parsed));
+    blob[100] ^= 0x01;
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_CRC, calib_parse(blob, CALIB_BLOB_SIZE, &parsed));
+    blob[100] ^= 0x01;
+    blob[4] = CALIB_VERSION + 1;
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_VERSION, calib_parse(blob, CALIB_BLOB_SIZE, &parsed));
+    blob[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL_INT(CALIB_ERR_MAGIC, calib_parse(blob, CALIB_BLOB_SIZE, &parsed));
+}
+
+void
+test_pack_frame_saturates_and_round_trips(void) {
+    amg88_frame_raw_t frame;
+    int16_t in[AMG88_ARRAY_SIZE], out[AMG88_ARRAY_SIZE];
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        in[i] = (int16_t) ((int) i * 64 - 2048);
+    }
+    in[0] = INT16_MIN;
+    in[1] = INT16_MAX;
+    memset(&frame, 0xA5, sizeof(frame));
+    calib_pack_frame(in, &frame);
+    amg88_decode_frame(&frame, out);
+
+    TEST_ASSERT_EQUAL_INT16(-2048, out[0]);
+    TEST_ASSERT_EQUAL_INT16(2047, out[1]);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(&in[2], &out[2], AMG88_ARRAY_SIZE - 2);
+    TEST_ASSERT_EQUAL_HEX8(0xA5, frame.thermistor[0]);
+}
@@ -0,0 +1,159 @@
+/**
+ * \file            test_detect.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Blob detection: warm-up, 8-connected labeling, ordering and overflow, selective background
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "detect/detect.h"
+
+#define AMBIENT         (22 * 4)                /* 22 degrees in 1/4 degree units */
+#define WARM            (AMBIENT + 40)          /* A person, 10 degrees over the ambient */
+
+static const detect_cfg_t cfg = {
+    .bg_shift = 3,
+    .fg_shift = 0,
+    .threshold = 8,
+    .min_pixels = 2,
+    .warmup = 2,
+};
+
+/* Vars */
+static detect_t det;
+static int16_t frame[AMG88_ARRAY_SIZE];
+
+
+static void
+fill(int16_t value) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        frame[i] = value;
+    }
+}
+
+static void
+warm(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, int16_t value) {
+    for (uint8_t y = y0; y <= y1; ++y) {
+        for (uint8_t x = x0; x <= x1; ++x) {
+            frame[y * AMG88_ARRAY_COLS + x] = value;
+        }
+    }
+}
+
+void
+setUp(void) {
+    detect_init(&det, &cfg);
+    fill(AMBIENT);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_first_frame_is_the_background_and_warmup_reports_nothing(void) {
+    int16_t bg[AMG88_ARRAY_SIZE];
+
+    TEST_ASSERT_EQUAL_UINT8(0, detect_update(&det, frame));
+    detect_background(&det, bg);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(frame, bg, AMG88_ARRAY_SIZE);
+
+    warm(2, 2, 3, 3, WARM);
+    TEST_ASSERT_EQUAL_UINT8(0, detect_update(&det, frame));     /* Frame 2, still warming up */
+    TEST_ASSERT_EQUAL_UINT8(1, detect_update(&det, frame));
+    TEST_ASSERT_EQUAL_UINT16(4, det.blobs[0].pixels);
+}
+
+void
+test_components_are_8_connected_sorted_largest_first_and_described(void) {
+    detect_update(&det, frame);
+    detect_update(&det, frame);
+
+    /* A diagonal pair joins, a lone pixel is noise, a 2x3 block is the largest */
+    warm(0, 0, 0, 0, WARM);
+    warm(1, 1, 1, 1, WARM + 8);
+    warm(7, 7, 7, 7, WARM);
+    warm(4, 2, 5, 4, WARM);
+    frame[4 * AMG88_ARRAY_COLS + 5] = WARM + 20;
+    TEST_ASSERT_EQUAL_UINT8(2, detect_update(&det, frame));
+    TEST_ASSERT_EQUAL_UINT8(0, det.overflow);
+
+    TEST_ASSERT_EQUAL_UINT16(6, det.blobs[0].pixels);
+    TEST_ASSERT_EQUAL_INT16(WARM + 20, det.blobs[0].peak);
+    TEST_ASSERT_EQUAL_UINT16(4 * AMG88_ARRAY_COLS + 5, det.blobs[0].peak_idx);
+    TEST_ASSERT_EQUAL_UINT8(4, det.blobs[0].x0);
+    TEST_ASSERT_EQUAL_UINT8(2, det.blobs[0].y0);
+    TEST_ASSERT_EQUAL_UINT8(5, det.blobs[0].x1);
+    TEST_ASSERT_EQUAL_UINT8(4, det.blobs[0].y1);
+    TEST_ASSERT_EQUAL_UINT32(6 * 40 + 20, det.blobs[0].heat);
+
+    /* The centroid is weighted by the excess: 40 and 48 put it past the middle of the pair */
+    TEST_ASSERT_EQUAL_UINT16(2, det.blobs[1].pixels);
+    TEST_ASSERT_EQUAL_UINT32(88, det.blobs[1].heat);
+    TEST_ASSERT_EQUAL_UINT16((48 << DETECT_BG_FRAC_BITS) / 88, det.blobs[1].cx_q8);
+    TEST_ASSERT_EQUAL_UINT16(det.blobs[1].cx_q8, det.blobs[1].cy_q8);
+
+    /* Labels follow the order, the dropped pixel stays plain foreground */
+    TEST_ASSERT_EQUAL_HEX8(1, det.labels[2 * AMG88_ARRAY_COLS + 4]);
+    TEST_ASSERT_EQUAL_HEX8(2, det.labels[0]);
+    TEST_ASSERT_EQUAL_HEX8(2, det.labels[AMG88_ARRAY_COLS + 1]);
+    TEST_ASSERT_EQUAL_HEX8(DETECT_LABEL_FG, det.labels[AMG88_ARRAY_SIZE - 1]);
+    TEST_ASSERT_EQUAL_HEX8(DETECT_LABEL_NONE, det.labels[AMG88_ARRAY_COLS]);
+}
+
+void
+test_only_the_largest_fit_and_the_rest_is_overflow(void) {
+    int16_t excess[AMG88_ARRAY_SIZE];
+    uint8_t labels[AMG88_ARRAY_SIZE];
+    uint16_t stack[AMG88_ARRAY_SIZE];
+    detect_blob_t blobs[2];
+    uint8_t overflow;
+
+    /* Columns 0, 2, 4 and 6, of 2, 5, 3 and 8 rows */
+    warm(0, 0, 0, 1, WARM);
+    warm(2, 0, 2, 4, WARM);
+    warm(4, 0, 4, 2, WARM);
+    warm(6, 0, 6, 7, WARM);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        excess[i] = (int16_t) (frame[i] - AMBIENT);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, detect_label(frame, excess, AMG88_ARRAY_COLS, AMG88_ARRAY_ROWS, cfg.threshold, 1,
+                                            labels, stack, blobs, 2, &overflow));
+    TEST_ASSERT_EQUAL_UINT8(2, overflow);
+    TEST_ASSERT_EQUAL_UINT16(8, blobs[0].pixels);
+    TEST_ASSERT_EQUAL_UINT8(6, blobs[0].x0);
+    TEST_ASSERT_EQUAL_UINT16(5, blobs[1].pixels);
+    TEST_ASSERT_EQUAL_UINT8(2, blobs[1].x0);
+    TEST_ASSERT_EQUAL_HEX8(DETECT_LABEL_FG, labels[0]);
+    TEST_ASSERT_EQUAL_HEX8(DETECT_LABEL_FG, labels[4]);
+    TEST_ASSERT_EQUAL_HEX8(1, labels[6]);
+
+    /* Room for none: everything is overflow */
+    TEST_ASSERT_EQUAL_UINT8(0, detect_label(frame, excess, AMG88_ARRAY_COLS, AMG88_ARRAY_ROWS, cfg.threshold, 1,
+                                            labels, stack, blobs, 0, &overflow));
+    TEST_ASSERT_EQUAL_UINT8(4, overflow);
+}
+
+void
+test_background_follows_the_scene_but_not_a_still_person(void) {
+    int16_t bg[AMG88_ARRAY_SIZE];
+
+    detect_update(&det, frame);
+    detect_update(&det, frame);
+
+    /* The room warms by 2 degrees while a person stands still in one corner */
+    fill(AMBIENT + 8);
+    warm(0, 0, 1, 1, WARM);
+    for (uint8_t n = 0; n < 100; ++n) {
+        detect_update(&det, frame);
+        TEST_ASSERT_EQUAL_UINT8(1, det.n_blobs);
+    }
+    detect_background(&det, bg);
+    TEST_ASSERT_EQUAL_INT16(AMBIENT + 8, bg[AMG88_ARRAY_SIZE - 1]);
+    TEST_ASSERT_EQUAL_INT16(AMBIENT, bg[0]);                    /* fg_shift 0 freezes it */
+    TEST_ASSERT_EQUAL_UINT16(4, det.blobs[0].pixels);
+}
@@ -0,0 +1,209 @@
+/**
+ * \file            test_fanout.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Fan-out stress: clients of two formats at different speeds, coming and going, against a producer
+ *                  flat out. No torn or reused buffers, no reordering, no leaked reference and no starved producer
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <sched.h>
+#include <string.h>
+
+#include "unity.h"
+#include "fanout/fanout.h"
+#include "osal/osal.h"
+
+TEST_FILE("osal_posix.c");
+
+#define FRAMES          200000                  /* Frames published per format */
+#define FORMATS         2
+#define WORDS           32                      /* Words per buffer, all set to the frame number */
+#define TAKE_MS         5                       /* Client wait, short so the stop flag is seen soon */
+
+/* Client thread, keeps whatever slot it gets on every subscribe */
+typedef struct {
+    uint8_t format;
+    uint32_t rng;
+    uint32_t slow;                              /* Busy wait scale, 0 for a fast client */
+    uint32_t takes, delivered, resubscribed, torn, reordered;
+    atomic_bool done;
+} client_t;
+
+/* Vars */
+static fanout_t fan;
+static uint32_t storage[FORMATS][FANOUT_MAX_BUFS][WORDS];
+static client_t clients[FANOUT_MAX_CLIENTS];
+static atomic_bool stop;
+static atomic_uint ready;                       /* Clients through their first subscribe */
+static volatile uint32_t spin_sink;
+
+
+static bool
+buf_torn(const fanout_buf_t* p_buf) {
+    const uint32_t* p_words = (const uint32_t*) p_buf->p_data;
+
+    for (size_t i = 0; i < WORDS; ++i) {
+        if (p_words[i] != p_buf->seq) {
+            return true;
+        }
+    }
+
+    return p_buf->len != sizeof(storage[0][0]);
+}
+
+/* Random busy wait, and now and then a yield so a single core interleaves the threads too */
+static void
+spin(uint32_t* p_rng, uint32_t scale) {
+    *p_rng = *p_rng * 1664525u + 1013904223u;
+    for (uint32_t i = (*p_rng >> 24) * scale; i > 0; --i) {
+        spin_sink++;
+    }
+    if ((*p_rng & 0x30) == 0) {
+        sched_yield();
+    }
+}
+
+static void
+client_task(void* arg) {
+    client_t* p_c = (client_t*) arg;
+    fanout_buf_t* p_buf;
+    uint32_t last = 0;
+    int8_t id = fanout_subscribe(&fan, p_c->format);
+
+    atomic_fetch_add(&ready, 1);
+    while (!atomic_load(&stop) && id >= 0) {
+        p_buf = fanout_take(&fan, id, TAKE_MS);
+        if (p_buf != NULL) {
+            p_c->takes++;
+            p_c->reordered += p_buf->seq <= last || p_buf->format != p_c->format;
+            last = p_buf->seq;
+            p_c->torn += buf_torn(p_buf);
+
+            /* Still ours until released, the producer must not reuse it meanwhile */
+            spin(&p_c->rng, p_c->slow);
+            p_c->torn += buf_torn(p_buf) || p_buf->seq != last;
+        }
+
+        /* Now and then leave and come back, like a viewer reconnecting. Sometimes still holding a buffer */
+        if (((p_c->rng >> 16) & 0x3FF) == 0) {
+            p_c->delivered += (uint32_t) atomic_load(&fan.clients[id].delivered);
+            fanout_unsubscribe(&fan, id);
+            if (p_buf != NULL) {
+                fanout_release(p_buf);
+                p_buf = NULL;
+            }
+            id = fanout_subscribe(&fan, p_c->format);
+            p_c->resubscribed++;
+        }
+        if (p_buf != NULL) {
+            fanout_release(p_buf);
+        }
+        p_c->rng = p_c->rng * 1664525u + 1013904223u;
+    }
+
+    if (id >= 0) {
+        p_c->delivered += (uint32_t) atomic_load(&fan.clients[id].delivered);
+        fanout_unsubscribe(&fan, id);
+    } else {
+        p_c->torn++;                            /* A slot was always free, every thread holds at most one */
+    }
+    atomic_store(&p_c->done, true);
+}
+
+void
+setUp(void) {
+    memset(storage, 0, sizeof(storage));
+    memset(clients, 0, sizeof(clients));
+    atomic_store(&stop, false);
+    atomic_store(&ready, 0);
+
+    TEST_ASSERT_EQUAL_INT(OSAL_OK, fanout_init(&fan));
+    for (uint8_t f = 0; f < FORMATS; ++f) {
+        fanout_add_format(&fan, f, storage[f], sizeof(storage[f][0]), FANOUT_MAX_BUFS);
+    }
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_unknown_format_has_no_slot(void) {
+    TEST_ASSERT_EQUAL_INT8(-1, fanout_subscribe(&fan, FORMATS));
+    TEST_ASSERT_FALSE(fanout_wanted(&fan, 0));
+}
+
+void
+test_clients_coming_and_going_never_see_a_reused_buffer(void) {
+    osal_task_t tasks[FANOUT_MAX_CLIENTS];
+    fanout_buf_t* p_buf;
+    uint32_t published[FORMATS] = { 0 }, starved = 0, rng = 3, refs = 0;
+    bool all_done;
+
+    /* Two clients per format, one of them slow */
+    for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        clients[i].format = i % FORMATS;
+        clients[i].rng = 100u + i;
+        clients[i].slow = i < FORMATS ? 0 : 4;
+        TEST_ASSERT_EQUAL_INT(OSAL_OK, osal_task_create(&tasks[i], "fan_client", client_task, &clients[i], 4096, 1,
+                                                        OSAL_CORE_ANY));
+    }
+
+    /* Nobody to publish to until the clients are up, a slow thread start would leave the run empty */
+    while (atomic_load(&ready) < FANOUT_MAX_CLIENTS) {
+        osal_delay_ms(1);
+    }
+
+    for (uint32_t n = 1; n <= FRAMES; ++n) {
+        for (uint8_t f = 0; f < FORMATS; ++f) {
+            if (!fanout_wanted(&fan, f)) {
+                continue;
+            }
+            if ((p_buf = fanout_alloc(&fan, f)) == NULL) {
+                starved++;
+                continue;
+            }
+            /* Word by word with a pause half way, a client reading a reused buffer would see it torn */
+            for (size_t i = 0; i < WORDS; ++i) {
+                ((uint32_t*) p_buf->p_data)[i] = n;
+                if (i == WORDS / 2) {
+                    spin(&rng, 1);
+                }
+            }
+            p_buf->seq = n;
+            p_buf->len = sizeof(storage[f][0]);
+            fanout_publish(&fan, p_buf);
+            published[f]++;
+        }
+    }
+
+    atomic_store(&stop, true);
+    do {
+        osal_delay_ms(TAKE_MS);
+        all_done = true;
+        for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+            all_done = all_done && atomic_load(&clients[i].done);
+        }
+    } while (!all_done);
+
+    /* Sized so the producer never waits: one being filled, one pending and one being sent per client */
+    TEST_ASSERT_EQUAL_UINT32(0, starved);
+    for (uint8_t f = 0; f < FORMATS; ++f) {
+        TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&fan.formats[f].starved));
+        TEST_ASSERT_EQUAL_UINT32(published[f], atomic_load(&fan.formats[f].encoded));
+        TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&fan.formats[f].subscribers));
+        TEST_ASSERT_TRUE(published[f] > FRAMES / 2);
+        for (uint8_t b = 0; b < FANOUT_MAX_BUFS; ++b) {
+            refs += (uint32_t) atomic_load(&fan.formats[f].bufs[b].refs);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, refs);          /* Every reference dropped, none dropped twice */
+
+    for (uint8_t i = 0; i < FANOUT_MAX_CLIENTS; ++i) {
+        TEST_ASSERT_EQUAL_UINT32(0, clients[i].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, clients[i].reordered);
+        TEST_ASSERT_EQUAL_UINT32(clients[i].takes, clients[i].delivered);
+        TEST_ASSERT_TRUE(clients[i].takes > 0);
+    }
+}
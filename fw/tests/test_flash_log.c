@@ -0,0 +1,201 @@
+/**
+ * \file            test_flash_log.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Flash recorder on the simulated NOR flash: readback, ring wrap and power cuts
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "unity.h"
+#include "crc32/crc32.h"
+#include "flash_log/flash_log.h"
+#include "flash_sim.h"
+
+#define SECTOR_SIZE     4096
+#define REGION_SIZE     (16 * SECTOR_SIZE)
+#define REC_MIN         40                      /* Record sizes span keyframe and delta codec packets */
+#define REC_SPAN        160
+#define POWER_CUTS      500
+
+/* Vars */
+static char path[] = "/tmp/test_flash_log_XXXXXX";
+static uint8_t payload[SECTOR_SIZE];
+static flash_sim_t sim;
+static flash_log_t log_state;
+
+
+/* Contents are a function of the id, so any record can be checked after a remount */
+static size_t
+make_record(uint32_t id, uint8_t* p_buf) {
+    size_t len = REC_MIN + (id * 37u) % REC_SPAN;
+
+    for (size_t i = 0; i < len; ++i) {
+        p_buf[i] = (uint8_t) (id * 131u + i);
+    }
+
+    return len;
+}
+
+static void
+mount(void) {
+    flash_log_io_t io;
+
+    TEST_ASSERT_TRUE(flash_sim_open(&sim, path, REGION_SIZE, SECTOR_SIZE));
+    flash_sim_attach(&sim, &io);
+    TEST_ASSERT_EQUAL_INT(FLASH_LOG_OK, flash_log_mount(&log_state, &io));
+}
+
+static void
+append(uint32_t n) {
+    size_t len;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        len = make_record(log_state.next_id, payload);
+        TEST_ASSERT_EQUAL_INT(FLASH_LOG_OK, flash_log_append(&log_state, payload, len));
+    }
+}
+
+/* Every record from `from` up to the newest, in order, once and intact; returns the records read */
+static uint32_t
+check_records(uint32_t from, uint32_t* p_lost) {
+    flash_log_cursor_t cur;
+    const uint8_t* p_data;
+    size_t len;
+    uint32_t id, n = 0;
+    uint8_t expected[SECTOR_SIZE];
+
+    flash_log_seek(&log_state, &cur, from);
+    id = cur.id;
+    while (flash_log_read(&log_state, &cur, &p_data, &len) == FLASH_LOG_OK) {
+        TEST_ASSERT_EQUAL_UINT32(id + 1, cur.id);
+        TEST_ASSERT_EQUAL_size_t(make_record(id, expected), len);
+        TEST_ASSERT_EQUAL_MEMORY(expected, p_data, len);
+        id = cur.id;
+        n++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(log_state.next_id, id);
+    *p_lost = cur.lost;
+
+    return n;
+}
+
+void
+setUp(void) {
+    int fd = mkstemp(path);
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    memset(&sim, 0, sizeof(sim));
+    sim.fd = -1;
+    memset(&log_state, 0, sizeof(log_state));
+}
+
+void
+tearDown(void) {
+    flash_sim_close(&sim);
+    unlink(path);
+    memcpy(&path[sizeof(path) - 7], "XXXXXX", 6);
+}
+
+void
+test_blank_region_mounts_empty(void) {
+    uint32_t lost;
+
+    mount();
+    TEST_ASSERT_EQUAL_UINT32(0, log_state.next_id);
+    TEST_ASSERT_EQUAL_UINT32(0, flash_log_oldest_id(&log_state));
+    TEST_ASSERT_EQUAL_UINT32(0, check_records(0, &lost));
+    TEST_ASSERT_EQUAL_INT(FLASH_LOG_ERR_LEN,
+                          flash_log_append(&log_state, payload, flash_log_max_record(&log_state) + 1));
+}
+
+void
+test_records_read_back_across_a_remount(void) {
+    uint32_t lost;
+
+    mount();
+    append(200);
+    TEST_ASSERT_EQUAL_UINT32(200, check_records(0, &lost));
+    TEST_ASSERT_EQUAL_UINT32(150, check_records(50, &lost));
+
+    flash_sim_close(&sim);
+    mount();
+    TEST_ASSERT_EQUAL_UINT32(200, log_state.next_id);
+    TEST_ASSERT_EQUAL_UINT32(0, log_state.stats.recovered);
+    TEST_ASSERT_EQUAL_UINT32(200, check_records(0, &lost));
+    TEST_ASSERT_EQUAL_UINT32(0, lost);
+
+    /* Appends carry on in the same sector */
+    append(10);
+    TEST_ASSERT_EQUAL_UINT32(0, log_state.stats.erases);
+    TEST_ASSERT_EQUAL_UINT32(210, check_records(0, &lost));
+}
+
+void
+test_wrap_drops_the_oldest_sector_and_counts_lost(void) {
+    flash_log_cursor_t cur;
+    const uint8_t* p_data;
+    size_t len;
+    uint32_t lost, oldest;
+
+    mount();
+    append(2000);
+    oldest = flash_log_oldest_id(&log_state);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, oldest);
+    TEST_ASSERT_EQUAL_UINT32(2000 - oldest, check_records(0, &lost));
+
+    /* A reader overtaken by the writer skips what was erased under it */
+    flash_log_seek(&log_state, &cur, oldest);
+    TEST_ASSERT_EQUAL_INT(FLASH_LOG_OK, flash_log_read(&log_state, &cur, &p_data, &len));
+    append(200);
+    TEST_ASSERT_EQUAL_INT(FLASH_LOG_OK, flash_log_read(&log_state, &cur, &p_data, &len));
+    TEST_ASSERT_EQUAL_UINT32(flash_log_oldest_id(&log_state) + 1, cur.id);
+    TEST_ASSERT_EQUAL_UINT32(flash_log_oldest_id(&log_state) - oldest - 1, cur.lost);
+
+    /* Wear stays even */
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(log_state.stats.erases / log_state.n_sectors + 1, log_state.stats.max_erases);
+
+    flash_sim_close(&sim);
+    mount();
+    TEST_ASSERT_EQUAL_UINT32(2200, log_state.next_id);
+    TEST_ASSERT_EQUAL_UINT32(2200 - flash_log_oldest_id(&log_state), check_records(0, &lost));
+}
+
+void
+test_power_cut_never_loses_an_acknowledged_record(void) {
+    uint32_t acked, oldest, lost, sealed = 0;
+    size_t len;
+
+    srand(1);
+    for (uint32_t t = 0; t < POWER_CUTS; ++t) {
+        mount();
+
+        /* Appends until the cut, up to a few sectors worth of records, the ring wraps every few cuts */
+        acked = log_state.next_id;
+        flash_sim_cut_after(&sim, rand() % (3 * SECTOR_SIZE));
+        while (true) {
+            len = make_record(log_state.next_id, payload);
+            if (flash_log_append(&log_state, payload, len) != FLASH_LOG_OK) {
+                break;
+            }
+            acked = log_state.next_id;
+        }
+        oldest = flash_log_oldest_id(&log_state);
+        flash_sim_close(&sim);
+
+        /* Power up: every acknowledged record still stored before the cut is there, nothing else */
+        mount();
+        sealed += log_state.stats.recovered;
+        TEST_ASSERT_EQUAL_UINT32(acked, log_state.next_id);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(oldest, flash_log_oldest_id(&log_state));
+        check_records(0, &lost);
+        flash_sim_close(&sim);
+    }
+
+    /* Cuts that land in a record seal the sector it was in, the others hit an erase or a sector header */
+    TEST_ASSERT_GREATER_THAN_UINT32(POWER_CUTS / 4, sealed);
+}
@@ -0,0 +1,214 @@
+/**
+ * \file            test_frame_codec.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame codec round trip on random deltas, encoder bounds and decoder robustness.
+ *                  Run it under ASan too, the canary only catches overruns past the encoder output
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+#include "frame_codec/frame_codec.h"
+
+#define FUZZ_FRAMES     200000                  /* Random frames through the encoder and back */
+#define FUZZ_CORRUPT    200000                  /* Random byte strings fed to the decoder */
+#define CANARY          0xA5                    /* Fill past the encoder output */
+#define CANARY_LEN      16
+
+/* Vars */
+static uint8_t out[FRAME_CODEC_MAX_SIZE + CANARY_LEN]; /* Encoder output, followed by the canary */
+static frame_codec_enc_t enc;
+static frame_codec_dec_t dec;
+static amg88_frame_raw_t key, frame;
+
+
+static int16_t
+get_px(const amg88_frame_raw_t* p_frame, size_t i) {
+    uint16_t raw = (uint16_t) (p_frame->pixels[2 * i] | (p_frame->pixels[2 * i + 1] << 8));
+
+    return (int16_t) (uint16_t) (raw << 4) >> 4;
+}
+
+static void
+set_px(amg88_frame_raw_t* p_frame, size_t i, int32_t val) {
+    val = val > 2047 ? 2047 : val < -2048 ? -2048 : val;
+    p_frame->pixels[2 * i] = (uint8_t) val;
+    p_frame->pixels[2 * i + 1] = (uint8_t) (val >> 8) & 0x0F;
+}
+
+static bool
+canary_intact(void) {
+    for (size_t i = FRAME_CODEC_MAX_SIZE; i < sizeof(out); ++i) {
+        if (out[i] != CANARY) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Encode then decode, the frame must come back bit for bit and nothing written past the buffer */
+static bool
+round_trip(const amg88_frame_raw_t* p_frame, size_t* p_len) {
+    amg88_frame_raw_t back;
+    frame_codec_err_t err;
+    size_t len;
+
+    memset(out, CANARY, sizeof(out));
+    len = frame_codec_encode(&enc, p_frame, out);
+    *p_len = len;
+
+    /* Decoded even when something else failed, so the decoder keeps the encoder's keyframe */
+    err = frame_codec_decode(&dec, out, len, &back);
+
+    return canary_intact() && len <= FRAME_CODEC_MAX_SIZE && err == FRAME_CODEC_OK
+           && memcmp(&back, p_frame, sizeof(back)) == 0;
+}
+
+/* 47 wide deltas and a zero run to the end */
+static void
+wide_deltas(void) {
+    frame = key;
+    for (size_t i = 0; i < 47; ++i) {
+        set_px(&frame, i, 100);
+    }
+}
+
+void
+setUp(void) {
+    srand(11);
+    memset(&key, 0, sizeof(key));
+    frame = key;
+    frame_codec_enc_init(&enc, 10);
+    frame_codec_dec_init(&dec);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_wide_deltas_past_the_bound_fall_back_to_a_key(void) {
+    size_t len;
+
+    /* A small delta, a zero run, a wide one. Used to write 2 bytes past the end */
+    wide_deltas();
+    set_px(&frame, 47, 1);
+    set_px(&frame, 49, 100);
+    for (size_t i = 50; i < AMG88_ARRAY_SIZE; ++i) {
+        set_px(&frame, i, 100);
+    }
+    TEST_ASSERT_TRUE(round_trip(&key, &len));
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_KEY, out[0]);
+}
+
+void
+test_delta_one_byte_short_of_packed_stays_a_delta(void) {
+    size_t len;
+
+    wide_deltas();
+    TEST_ASSERT_TRUE(round_trip(&key, &len));
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_DELTA, out[0]);
+    TEST_ASSERT_EQUAL_size_t(FRAME_CODEC_MAX_SIZE - 1, len);
+
+    /* One more small delta and the run no longer fits */
+    set_px(&frame, 47, 1);
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_KEY, out[0]);
+}
+
+void
+test_deltas_of_a_lost_keyframe_are_rejected(void) {
+    amg88_frame_raw_t back;
+    size_t len;
+
+    /* First keyframe and a delta on it go through */
+    TEST_ASSERT_TRUE(round_trip(&key, &len));
+    set_px(&frame, 0, 8);
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_DELTA, out[0]);
+
+    /* The next keyframe never reaches the decoder */
+    frame_codec_enc_force_key(&enc);
+    set_px(&key, 1, 40);
+    len = frame_codec_encode(&enc, &key, out);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_KEY, out[0]);
+
+    /* Its deltas are refused, not applied to the first keyframe */
+    frame = key;
+    set_px(&frame, 2, -8);
+    len = frame_codec_encode(&enc, &frame, out);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_DELTA, out[0]);
+    TEST_ASSERT_EQUAL_INT(FRAME_CODEC_ERR_NO_KEY, frame_codec_decode(&dec, out, len, &back));
+
+    /* Until the next keyframe */
+    frame_codec_enc_force_key(&enc);
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    set_px(&frame, 3, 12);
+    TEST_ASSERT_TRUE(round_trip(&frame, &len));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_CODEC_DELTA, out[0]);
+}
+
+void
+test_random_frames_round_trip(void) {
+    unsigned deltas = 0, full_deltas = 0;
+    size_t len;
+
+    /* Each frame picks how many pixels change and how far, from a few LSB to full scale */
+    frame_codec_enc_init(&enc, 8);
+    for (uint32_t n = 0; n < FUZZ_FRAMES; ++n) {
+        int32_t scale = (int32_t[]) { 1, 4, 40, 64, 65, 300, 4095 }[rand() % 7];
+        int changed = rand() % (AMG88_ARRAY_SIZE + 1);
+
+        for (int c = 0; c < changed; ++c) {
+            size_t i = (size_t) rand() % AMG88_ARRAY_SIZE;
+
+            set_px(&frame, i, get_px(&frame, i) + rand() % (2 * scale + 1) - scale);
+        }
+        frame.thermistor[0] = (uint8_t) rand();
+        frame.thermistor[1] = (uint8_t) (rand() & 0x0F);
+
+        TEST_ASSERT_TRUE_MESSAGE(round_trip(&frame, &len), "round trip failed");
+        if (out[0] == FRAME_CODEC_DELTA) {
+            deltas++;
+            full_deltas += len == FRAME_CODEC_MAX_SIZE - 1;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN_UINT(FUZZ_FRAMES / 4, deltas); /* Both paths exercised */
+    TEST_ASSERT_GREATER_THAN_UINT(0, full_deltas);          /* Right at the bound too */
+}
+
+void
+test_garbage_decodes_to_an_error_or_a_frame(void) {
+    amg88_frame_raw_t back;
+    size_t len;
+
+    /* A keyframe first, so half the garbage below gets past the keyframe ID check */
+    TEST_ASSERT_TRUE(round_trip(&key, &len));
+
+    /* Never a read past the input */
+    for (uint32_t n = 0; n < FUZZ_CORRUPT; ++n) {
+        size_t n_bytes = (size_t) rand() % (FRAME_CODEC_MAX_SIZE + 2);
+        uint8_t* p_in = malloc(n_bytes > 0 ? n_bytes : 1); /* Exact size, so ASan sees an overread */
+        frame_codec_err_t err;
+
+        for (size_t i = 0; i < n_bytes; ++i) {
+            p_in[i] = (uint8_t) rand();
+        }
+        if (n_bytes > 0) {
+            p_in[0] &= 0x01;                    /* Mostly valid types, to get past the first check */
+        }
+        if (n_bytes > 2 && (n & 1)) {
+            p_in[1] = (uint8_t) dec.key_id;
+            p_in[2] = (uint8_t) (dec.key_id >> 8);
+        }
+        err = frame_codec_decode(&dec, p_in, n_bytes, &back);
+        free(p_in);
+        TEST_ASSERT_LESS_OR_EQUAL_INT(FRAME_CODEC_ERR_CORRUPT, err);
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * \file            test_frame_rec.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame recordings: round trip, cut short tail, corrupted records, time lookup
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "frame_rec/frame_rec.h"
+
+#define N_RECORDS       4
+#define PERIOD_US       100000
+
+static const uint64_t timestamps[N_RECORDS] = { 1000, 1100, 1200, 1400 };
+
+/* Vars */
+static uint8_t file[FRAME_REC_HDR_SIZE + N_RECORDS * FRAME_REC_RECORD_SIZE];
+static size_t file_size;
+static frame_rec_t rec;
+
+
+/* Record `i`: every pixel byte at `i`, the thermistor at `i + 100` */
+static void
+make_frame(amg88_frame_raw_t* p_frame, uint8_t i) {
+    memset(p_frame->pixels, i, sizeof(p_frame->pixels));
+    p_frame->thermistor[0] = (uint8_t) (i + 100);
+    p_frame->thermistor[1] = 0;
+}
+
+void
+setUp(void) {
+    amg88_frame_raw_t frame;
+
+    file_size = frame_rec_encode_hdr(file, PERIOD_US);
+    for (uint8_t i = 0; i < N_RECORDS; ++i) {
+        make_frame(&frame, i);
+        file_size += frame_rec_encode(&file[file_size], timestamps[i], 10u + i, &frame);
+    }
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_records_round_trip(void) {
+    amg88_frame_raw_t frame, expected;
+    uint64_t ts;
+    uint32_t seq;
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(file), file_size);
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, file_size));
+    TEST_ASSERT_EQUAL_UINT32(N_RECORDS, rec.n_records);
+    TEST_ASSERT_EQUAL_UINT32(PERIOD_US, rec.period_us);
+    TEST_ASSERT_EQUAL_UINT64(timestamps[0], rec.first_us);
+    TEST_ASSERT_EQUAL_UINT64(timestamps[N_RECORDS - 1], rec.last_us);
+
+    for (uint8_t i = 0; i < N_RECORDS; ++i) {
+        make_frame(&expected, i);
+        TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_get(&rec, i, &ts, &seq, &frame));
+        TEST_ASSERT_EQUAL_UINT64(timestamps[i], ts);
+        TEST_ASSERT_EQUAL_UINT32(10u + i, seq);
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &frame, sizeof(frame));
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_ERR_RANGE, frame_rec_get(&rec, N_RECORDS, &ts, NULL, NULL));
+}
+
+void
+test_short_tail_is_left_out_and_a_bad_header_refused(void) {
+    /* A writer stopped mid-append */
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, file_size - 10));
+    TEST_ASSERT_EQUAL_UINT32(N_RECORDS - 1, rec.n_records);
+    TEST_ASSERT_EQUAL_UINT64(timestamps[N_RECORDS - 2], rec.last_us);
+
+    /* Just the header: an empty recording */
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, FRAME_REC_HDR_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(0, rec.n_records);
+    TEST_ASSERT_EQUAL_UINT32(0, frame_rec_find(&rec, 5000));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_ERR_FORMAT, frame_rec_open(&rec, file, FRAME_REC_HDR_SIZE - 1));
+    file[8] ^= 1;                               /* Period, under the header CRC */
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_ERR_FORMAT, frame_rec_open(&rec, file, file_size));
+}
+
+void
+test_corrupted_record_is_reported_on_its_own(void) {
+    amg88_frame_raw_t frame;
+    uint64_t ts;
+
+    file[FRAME_REC_HDR_SIZE + FRAME_REC_RECORD_SIZE + 20] ^= 0x40;
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, file_size));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_get(&rec, 0, NULL, NULL, &frame));
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_ERR_CRC, frame_rec_get(&rec, 1, &ts, NULL, &frame));
+    TEST_ASSERT_EQUAL_UINT64(timestamps[1], ts);
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_get(&rec, 2, NULL, NULL, &frame));
+
+    /* Timestamp only: the CRC is not checked */
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_get(&rec, 1, &ts, NULL, NULL));
+}
+
+void
+test_find_returns_the_record_on_the_output(void) {
+    TEST_ASSERT_EQUAL_INT(FRAME_REC_OK, frame_rec_open(&rec, file, file_size));
+
+    TEST_ASSERT_EQUAL_UINT32(0, frame_rec_find(&rec, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, frame_rec_find(&rec, 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, frame_rec_find(&rec, 1099));
+    TEST_ASSERT_EQUAL_UINT32(1, frame_rec_find(&rec, 1100));
+    TEST_ASSERT_EQUAL_UINT32(2, frame_rec_find(&rec, 1399));
+    TEST_ASSERT_EQUAL_UINT32(3, frame_rec_find(&rec, 1400));
+    TEST_ASSERT_EQUAL_UINT32(3, frame_rec_find(&rec, UINT64_MAX));
+}
@@ -0,0 +1,197 @@
+/**
+ * \file            test_frame_sync.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Read classification, and a closed loop against the simulated sensor with a drifting clock
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+#include "frame_sync/frame_sync.h"
+
+#define PERIOD_US   100000                      /* AMG88_FPS_10 */
+#define RUN_US      60000000ULL
+#define N_FRAMES    (RUN_US / PERIOD_US + 16)
+#define ROW_BYTES   (AMG88_ARRAY_COLS * AMG88_PIXEL_BYTES)
+
+/**
+ * \brief           Outcome of a closed loop run
+ */
+typedef struct {
+    uint32_t reads;
+    uint32_t delivered;
+    uint32_t mixed;                             /* Delivered frames with rows of two sensor frames */
+    uint32_t repeated;                          /* Sensor frames delivered more than once */
+    uint32_t missed;                            /* Sensor frames never delivered */
+} run_t;
+
+/* Vars */
+static frame_sync_t sync_state;
+static amg88_frame_raw_t frame;
+static amg88_frame_raw_t frames[N_FRAMES];
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static uint64_t now_us;
+static int32_t drift_ppm;
+
+
+/* Sensor clock, drifting against the reader's */
+static uint64_t
+sensor_clock_us(void) {
+    return now_us + (uint64_t) ((int64_t) now_us * drift_ppm / 1000000);
+}
+
+/* Every pixel of frame `n` holds `n` */
+static void
+fill_frame(amg88_frame_raw_t* p_frame, uint32_t n) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_frame->pixels[2 * i] = (uint8_t) n;
+        p_frame->pixels[2 * i + 1] = (uint8_t) ((n >> 8) & 0x07);
+    }
+}
+
+static uint32_t
+frame_number(const amg88_frame_raw_t* p_frame, size_t pixel) {
+    return p_frame->pixels[2 * pixel] | ((uint32_t) p_frame->pixels[2 * pixel + 1] << 8);
+}
+
+/* Read the simulated sensor whenever frame_sync asks to, for a minute */
+static run_t
+run_closed_loop(int32_t ppm) {
+    run_t run = { 0 };
+    uint32_t last = 0;
+    bool first = true;
+
+    drift_ppm = ppm;
+    now_us = 1000;
+    amg88_sim_set_frames(&sim, frames, N_FRAMES);
+    amg88_sim_set_clock(&sim, sensor_clock_us);
+    frame_sync_init(&sync_state, PERIOD_US, now_us);
+
+    while (now_us < RUN_US) {
+        uint64_t start_us, bus_ns = sim.stats.bus_ns;
+        uint32_t n;
+
+        if (frame_sync_next_read(&sync_state) > now_us) {
+            now_us = frame_sync_next_read(&sync_state);
+        }
+        start_us = now_us;
+        TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_get_frame_raw(&dev, &frame, 0));
+        now_us += (sim.stats.bus_ns - bus_ns) / 1000;
+        run.reads++;
+
+        if (frame_sync_check(&sync_state, &frame, start_us, now_us) != FRAME_SYNC_NEW) {
+            continue;
+        }
+
+        run.delivered++;
+        n = frame_number(&frame, 0);
+        run.mixed += n != frame_number(&frame, AMG88_ARRAY_SIZE - 1);
+        if (!first) {
+            run.repeated += n <= last;
+            run.missed += n > last + 1 ? n - last - 1 : 0;
+        }
+        first = false;
+        last = n;
+    }
+
+    return run;
+}
+
+void
+setUp(void) {
+    memset(&frame, 0, sizeof(frame));
+    for (uint32_t n = 0; n < N_FRAMES; ++n) {
+        fill_frame(&frames[n], n);
+    }
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    amg88_sim_set_bus(&sim, 400000, 20000, false);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_attach(&sim, &dev));
+}
+
+void
+tearDown(void) {
+    amg88_sim_detach_all();
+}
+
+void
+test_first_read_is_confirmed_then_duplicates_skipped(void) {
+    frame_sync_init(&sync_state, PERIOD_US, 0);
+    fill_frame(&frame, 1);
+
+    /* Nothing to compare against yet, the re-read confirms it */
+    TEST_ASSERT_EQUAL_INT(FRAME_SYNC_TORN, frame_sync_check(&sync_state, &frame, 0, 3000));
+    TEST_ASSERT_EQUAL_INT(FRAME_SYNC_NEW, frame_sync_check(&sync_state, &frame, 3000, 6000));
+    TEST_ASSERT_EQUAL_INT(FRAME_SYNC_DUPLICATE, frame_sync_check(&sync_state, &frame, 20000, 23000));
+    TEST_ASSERT_EQUAL_UINT32(1, sync_state.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, sync_state.stats.duplicates);
+
+    /* Duplicates poll again a step later */
+    TEST_ASSERT_EQUAL_UINT64(23000 + sync_state.retry_us, frame_sync_next_read(&sync_state));
+}
+
+void
+test_old_top_rows_with_new_bottom_rows_is_torn(void) {
+    frame_sync_init(&sync_state, PERIOD_US, 0);
+    fill_frame(&frame, 1);
+    frame_sync_check(&sync_state, &frame, 0, 3000);
+    frame_sync_check(&sync_state, &frame, 3000, 6000);
+
+    /* The update landed half way through the read */
+    fill_frame(&frame, 2);
+    memset(frame.pixels, 1, 4 * ROW_BYTES);
+    for (size_t i = 0; i < 4 * AMG88_ARRAY_COLS; ++i) {
+        frame.pixels[2 * i + 1] = 0;
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_SYNC_TORN, frame_sync_check(&sync_state, &frame, 10000, 13000));
+    TEST_ASSERT_EQUAL_UINT64(13000, frame_sync_next_read(&sync_state));
+
+    /* The immediate re-read gets the whole frame and locks on the update */
+    fill_frame(&frame, 2);
+    TEST_ASSERT_EQUAL_INT(FRAME_SYNC_NEW, frame_sync_check(&sync_state, &frame, 13000, 16000));
+    TEST_ASSERT_EQUAL_UINT32(1, sync_state.stats.torn);
+    TEST_ASSERT_TRUE(sync_state.locked);
+    TEST_ASSERT_EQUAL_UINT64(11500, sync_state.edge_us);
+
+    /* Half way to the next update until a probe has measured the period */
+    TEST_ASSERT_EQUAL_UINT64(11500 + PERIOD_US + PERIOD_US / 2, frame_sync_next_read(&sync_state));
+}
+
+void
+test_every_frame_once_with_a_small_drift(void) {
+    static const int32_t ppm[] = { 0, 200, -200 };
+
+    for (size_t i = 0; i < sizeof(ppm) / sizeof(ppm[0]); ++i) {
+        run_t run;
+
+        amg88_sim_reset_stats(&sim);
+        run = run_closed_loop(ppm[i]);
+        TEST_ASSERT_EQUAL_UINT32(0, run.mixed);
+        TEST_ASSERT_EQUAL_UINT32(0, run.repeated);
+        TEST_ASSERT_EQUAL_UINT32(0, run.missed);
+        TEST_ASSERT_UINT32_WITHIN(2, RUN_US / PERIOD_US, run.delivered);
+
+        /* About two extra reads per probe: the duplicate and the confirmation of the new frame */
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(run.delivered + run.delivered / 6, run.reads);
+    }
+}
+
+void
+test_every_frame_once_with_a_large_drift(void) {
+    static const int32_t ppm[] = { 10000, -10000 };
+
+    /* Reads stay half way between the drifting updates until the first probe measures the period */
+    for (size_t i = 0; i < sizeof(ppm) / sizeof(ppm[0]); ++i) {
+        run_t run = run_closed_loop(ppm[i]);
+
+        TEST_ASSERT_EQUAL_UINT32(0, run.mixed);
+        TEST_ASSERT_EQUAL_UINT32(0, run.repeated);
+        TEST_ASSERT_EQUAL_UINT32(0, run.missed);
+        TEST_ASSERT_TRUE(sync_state.measured);
+        TEST_ASSERT_UINT32_WITHIN(PERIOD_US / 1000, PERIOD_US - ppm[i] / 10, sync_state.period_us);
+    }
+}
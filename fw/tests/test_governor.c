@@ -0,0 +1,160 @@
+/**
+ * \file            test_governor.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Governor hysteresis: the on/off changed-pixels band and the idle and standby timing
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+#include "governor/governor.h"
+
+#define MS              1000ULL                 /* Timestamps are in us */
+#define PERIOD          (100 * MS)              /* 10 FPS */
+
+static const governor_cfg_t cfg = {
+    .pixel_delta = 4,
+    .on_pixels = 8,
+    .off_pixels = 2,
+    .idle_after_ms = 3000,
+    .standby_after_ms = 10000,
+};
+
+/* Vars */
+static governor_t gov;
+static int16_t frame[AMG88_ARRAY_SIZE];
+static int16_t step;
+
+
+/* Next frame: `changed` pixels move by exactly `pixel_delta`, `near` more by one LSB less */
+static bool
+feed(uint8_t changed, uint8_t near, uint64_t ts_us) {
+    step = (int16_t) -step;
+    for (uint8_t i = 0; i < changed + near; ++i) {
+        frame[i] = (int16_t) (frame[i] + step * (int16_t) (i < changed ? cfg.pixel_delta : cfg.pixel_delta - 1));
+    }
+
+    return governor_update(&gov, frame, ts_us);
+}
+
+void
+setUp(void) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        frame[i] = 100;
+    }
+    step = 1;
+    governor_init(&gov, &cfg);
+}
+
+void
+tearDown(void) {
+    amg88_sim_detach_all();
+}
+
+void
+test_pixels_under_the_delta_never_count(void) {
+    TEST_ASSERT_EQUAL_INT(GOV_ACTIVE, gov.level);
+    TEST_ASSERT_FALSE(feed(0, 0, 0));           /* Primes only */
+
+    TEST_ASSERT_FALSE(feed(0, 60, PERIOD));
+    TEST_ASSERT_EQUAL_UINT8(0, gov.changed);
+    TEST_ASSERT_FALSE(gov.active);
+    TEST_ASSERT_FALSE(feed(8, 0, 2 * PERIOD));
+    TEST_ASSERT_EQUAL_UINT8(8, gov.changed);
+    TEST_ASSERT_TRUE(gov.active);
+}
+
+void
+test_band_keeps_the_classification_and_levels_are_timed_from_the_last_active_frame(void) {
+    uint64_t ts = 0, quiet;
+
+    feed(0, 0, ts);
+    TEST_ASSERT_FALSE(feed(8, 0, ts += PERIOD));
+    TEST_ASSERT_TRUE(gov.active);
+
+    /* Inside the band (3 to 7 changed) an active scene stays active, so it never idles */
+    for (uint8_t n = 0; n < 2 * cfg.idle_after_ms * MS / PERIOD; ++n) {
+        TEST_ASSERT_FALSE(feed((uint8_t) (3 + n % 5), 0, ts += PERIOD));
+        TEST_ASSERT_TRUE(gov.active);
+    }
+    TEST_ASSERT_EQUAL_INT(GOV_ACTIVE, gov.level);
+
+    /* `off_pixels` changed: static. The quiet run is timed from the last active frame */
+    quiet = ts;
+    TEST_ASSERT_FALSE(feed(2, 0, ts += PERIOD));
+    TEST_ASSERT_FALSE(gov.active);
+
+    /* Inside the band a static scene stays static, the quiet run goes on */
+    TEST_ASSERT_FALSE(feed(7, 0, ts += PERIOD));
+    TEST_ASSERT_FALSE(gov.active);
+
+    /* Idle exactly `idle_after_ms` after the last active frame, not a microsecond before */
+    TEST_ASSERT_FALSE(feed(5, 0, quiet + cfg.idle_after_ms * MS - 1));
+    TEST_ASSERT_EQUAL_INT(GOV_ACTIVE, gov.level);
+    TEST_ASSERT_TRUE(feed(3, 0, ts = quiet + cfg.idle_after_ms * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_IDLE, gov.level);
+
+    /* Idle frames come once a second, standby still counts from the last active frame */
+    while (ts + 1000 * MS < quiet + cfg.standby_after_ms * MS) {
+        TEST_ASSERT_FALSE(feed(7, 0, ts += 1000 * MS));
+        TEST_ASSERT_EQUAL_INT(GOV_IDLE, gov.level);
+    }
+    TEST_ASSERT_FALSE(feed(0, 0, quiet + cfg.standby_after_ms * MS - 1));
+    TEST_ASSERT_EQUAL_INT(GOV_IDLE, gov.level);
+    TEST_ASSERT_TRUE(feed(0, 0, ts = quiet + cfg.standby_after_ms * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_STANDBY, gov.level);
+    TEST_ASSERT_FALSE(feed(7, 0, ts += 10000 * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_STANDBY, gov.level);
+
+    /* `on_pixels` changed: straight back to active, whatever the level */
+    TEST_ASSERT_TRUE(feed(8, 0, ts += 10000 * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_ACTIVE, gov.level);
+    TEST_ASSERT_EQUAL_UINT32(3, gov.stats.switches);
+    TEST_ASSERT_EQUAL_UINT64(ts, gov.stats.level_us[GOV_ACTIVE] + gov.stats.level_us[GOV_IDLE]
+                                     + gov.stats.level_us[GOV_STANDBY]);
+    TEST_ASSERT_EQUAL_UINT64(20000 * MS, gov.stats.level_us[GOV_STANDBY]);
+
+    /* And a new quiet run starts over from active */
+    quiet = ts;
+    TEST_ASSERT_FALSE(feed(0, 0, ts += PERIOD));
+    TEST_ASSERT_FALSE(feed(0, 0, quiet + cfg.idle_after_ms * MS - 1));
+    TEST_ASSERT_TRUE(feed(0, 0, quiet + cfg.idle_after_ms * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_IDLE, gov.level);
+}
+
+void
+test_no_standby_threshold_idles_for_good(void) {
+    governor_cfg_t no_standby = cfg;
+    uint64_t ts = 0;
+
+    no_standby.standby_after_ms = 0;
+    governor_init(&gov, &no_standby);
+    TEST_ASSERT_FALSE(feed(0, 0, ts));
+    TEST_ASSERT_TRUE(feed(0, 0, ts += no_standby.idle_after_ms * MS));
+    TEST_ASSERT_FALSE(feed(0, 0, ts += 3600000 * MS));
+    TEST_ASSERT_EQUAL_INT(GOV_IDLE, gov.level);
+}
+
+void
+test_levels_as_written_to_the_sensor(void) {
+    amg88_sim_t sim;
+    amg88_dev_t dev;
+
+    memset(&dev, 0, sizeof(dev));
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, amg88_sim_attach(&sim, &dev));
+
+    gov.level = GOV_STANDBY;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, governor_apply(&gov, &dev));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_OP_10, sim.regs[AMG88_REG_PCTL]);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_1, sim.regs[AMG88_REG_FPSC]);
+
+    gov.level = GOV_ACTIVE;
+    TEST_ASSERT_EQUAL_INT(AMG88_OK, governor_apply(&gov, &dev));
+    TEST_ASSERT_EQUAL_HEX8(AMG88_OP_NORMAL, sim.regs[AMG88_REG_PCTL]);
+    TEST_ASSERT_EQUAL_HEX8(AMG88_FPS_10, sim.regs[AMG88_REG_FPSC]);
+}
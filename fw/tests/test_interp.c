@@ -0,0 +1,177 @@
+/**
+ * \file            test_interp.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Fixed-point upscaling against a double precision reference, sensor range to full int16 range
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "unity.h"
+#include "interp/interp.h"
+
+#define RANDOM_FRAMES   2000                    /* Random frames per method, scale and input span */
+#define SIDE_MAX        (AMG88_ARRAY_COLS * 8)
+
+/*
+ * Two references: the interp weights (rounded to 1/256, as in the tables) checks the arithmetic, any
+ * overflow or rounding slip shows up past 1 LSB. Exact weights check the weight resolution: three taps
+ * off by up to 1/512 and the last by 3/512, summing to one, so a pass drifts by up to span * 3/512 and the
+ * column pass adds 1.25x the row pass drift, under span / 64 in all.
+ */
+#define TOL_ROUNDED         1.0
+#define TOL_EXACT(span)     (1.0 + (double) (span) / 64)
+#define Q(w)                (round((w) * (1 << INTERP_WEIGHT_BITS)) / (1 << INTERP_WEIGHT_BITS))
+
+/* Vars */
+static const uint8_t scales[] = { 4, 8 };
+static const interp_method_t methods[] = { INTERP_BILINEAR, INTERP_BICUBIC };
+static int16_t in[AMG88_ARRAY_SIZE];
+static int16_t out[INTERP_OUT_LEN(8)];
+static int32_t tmp[INTERP_TMP_LEN(8)];
+static double ref_tmp[AMG88_ARRAY_ROWS][SIDE_MAX];
+
+
+/* Taps and weights of output `o` along an 8 wide axis, as in the interp_upscale documentation */
+static size_t
+ref_taps(size_t o, uint8_t scale, interp_method_t method, bool rounded, size_t* p_idx, double* p_w) {
+    double x = (o + 0.5) / scale - 0.5, first = floor(x), t = x - first;
+    size_t n_taps = method == INTERP_BILINEAR ? 2 : 4;
+    int start = (int) first - (method == INTERP_BILINEAR ? 0 : 1);
+
+    if (method == INTERP_BILINEAR) {
+        p_w[0] = 1 - t;
+        p_w[1] = t;
+    } else {
+        p_w[0] = (-t * t * t + 2 * t * t - t) / 2;
+        p_w[1] = (3 * t * t * t - 5 * t * t + 2) / 2;
+        p_w[2] = (-3 * t * t * t + 4 * t * t + t) / 2;
+        p_w[3] = (t * t * t - t * t) / 2;
+    }
+    if (rounded) {
+        /* The last tap takes the rounding of the others, so they still sum to one */
+        p_w[n_taps - 1] = 1;
+        for (size_t k = 0; k + 1 < n_taps; ++k) {
+            p_w[k] = Q(p_w[k]);
+            p_w[n_taps - 1] -= p_w[k];
+        }
+    }
+    for (size_t k = 0; k < n_taps; ++k) {
+        int idx = start + (int) k;
+
+        p_idx[k] = idx < 0 ? 0 : idx > AMG88_ARRAY_COLS - 1 ? AMG88_ARRAY_COLS - 1 : (size_t) idx;
+    }
+
+    return n_taps;
+}
+
+/* Largest distance to the reference, saturated to int16 like the fixed-point output */
+static double
+max_error(uint8_t scale, interp_method_t method, bool rounded) {
+    size_t side = AMG88_ARRAY_COLS * scale, idx[4], n_taps;
+    double w[4], err = 0;
+
+    for (size_t r = 0; r < AMG88_ARRAY_ROWS; ++r) {
+        for (size_t o = 0; o < side; ++o) {
+            n_taps = ref_taps(o, scale, method, rounded, idx, w);
+            ref_tmp[r][o] = 0;
+            for (size_t k = 0; k < n_taps; ++k) {
+                ref_tmp[r][o] += w[k] * in[r * AMG88_ARRAY_COLS + idx[k]];
+            }
+        }
+    }
+    for (size_t o = 0; o < side; ++o) {
+        n_taps = ref_taps(o, scale, method, rounded, idx, w);
+        for (size_t c = 0; c < side; ++c) {
+            double ref = 0;
+
+            for (size_t k = 0; k < n_taps; ++k) {
+                ref += w[k] * ref_tmp[idx[k]][c];
+            }
+            ref = ref < INT16_MIN ? INT16_MIN : ref > INT16_MAX ? INT16_MAX : ref;
+            err = fmax(err, fabs(out[o * side + c] - ref));
+        }
+    }
+
+    return err;
+}
+
+/* Every method and scale against both references */
+static void
+check_upscale(int32_t span) {
+    char msg[96];
+    double err_rounded, err_exact;
+
+    for (size_t s = 0; s < sizeof(scales); ++s) {
+        for (size_t m = 0; m < 2; ++m) {
+            TEST_ASSERT_EQUAL_INT(INTERP_OK, interp_upscale(in, out, tmp, scales[s], methods[m]));
+            err_rounded = max_error(scales[s], methods[m], true);
+            err_exact = max_error(scales[s], methods[m], false);
+            snprintf(msg, sizeof(msg), "x%u %s, span %ld: off by %.2f (rounded weights), %.2f (exact)", scales[s],
+                     methods[m] == INTERP_BILINEAR ? "bilinear" : "bicubic", (long) span, err_rounded, err_exact);
+            TEST_ASSERT_TRUE_MESSAGE(err_rounded <= TOL_ROUNDED && err_exact <= TOL_EXACT(span), msg);
+        }
+    }
+}
+
+void
+setUp(void) {
+    srand(5);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_flat_frame_is_exact(void) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        in[i] = -1234;
+    }
+    check_upscale(0);
+}
+
+void
+test_full_scale_checkerboard(void) {
+    /* The largest sums either pass sees, and bicubic overshoot */
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        in[i] = ((i / AMG88_ARRAY_COLS) + i) % 2 ? INT16_MAX : INT16_MIN;
+    }
+    check_upscale(65535);
+}
+
+void
+test_hot_square_above_20000(void) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        size_t r = i / AMG88_ARRAY_COLS, c = i % AMG88_ARRAY_COLS;
+
+        in[i] = r >= 2 && r < 6 && c >= 2 && c < 6 ? 30000 : -30000;
+    }
+    check_upscale(60000);
+}
+
+void
+test_random_frames(void) {
+    /* Sensor range (12-bit), calibrated data, full int16 */
+    static const int32_t spans[] = { 40, 4096, 20000, 65535 };
+
+    for (size_t n = 0; n < RANDOM_FRAMES; ++n) {
+        int32_t span = spans[n % (sizeof(spans) / sizeof(spans[0]))];
+        int32_t base = INT16_MIN + rand() % (65536 - span);
+
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            in[i] = (int16_t) (base + rand() % (span + 1));
+        }
+        check_upscale(span);
+    }
+}
+
+void
+test_bad_scale_and_method(void) {
+    TEST_ASSERT_EQUAL_INT(INTERP_ERR_SCALE, interp_upscale(in, out, tmp, 2, INTERP_BICUBIC));
+    TEST_ASSERT_EQUAL_INT(INTERP_ERR_METHOD, interp_upscale(in, out, tmp, 4, (interp_method_t) 7));
+}
@@ -0,0 +1,110 @@
+/**
+ * \file            test_metrics.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Stage timer buckets, percentiles, error and event counters, deltas across wrap-arounds
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "metrics/metrics.h"
+
+/* Vars */
+static metrics_t before, after, delta;
+
+
+/* What the probes added since setUp */
+static void
+take_delta(void) {
+    metrics_snapshot(&after);
+    metrics_delta(&after, &before, &delta);
+}
+
+void
+setUp(void) {
+    metrics_snapshot(&before);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_samples_land_in_log2_buckets(void) {
+    static const uint32_t us[] = { 0, 1, 2, 3, 4, 1000, 32767, 32768, 4000000 };
+    static const uint8_t bucket[] = { 0, 0, 1, 1, 2, 9, 14, 15, 15 };
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < sizeof(us) / sizeof(us[0]); ++i) {
+        metrics_time(METRICS_READ, us[i] * OSAL_CYCLES_PER_US);
+        sum += us[i];
+    }
+    take_delta();
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(us) / sizeof(us[0]), delta.timers[METRICS_READ].count);
+    TEST_ASSERT_EQUAL_UINT32(sum, delta.timers[METRICS_READ].sum_us);
+    TEST_ASSERT_EQUAL_UINT32(0, delta.timers[METRICS_SEND].count);
+    for (uint8_t b = 0; b < METRICS_HIST_BUCKETS; ++b) {
+        uint16_t n = 0;
+
+        for (size_t i = 0; i < sizeof(bucket); ++i) {
+            n += bucket[i] == b;
+        }
+        TEST_ASSERT_EQUAL_UINT16(n, delta.timers[METRICS_READ].hist[b]);
+    }
+}
+
+void
+test_percentile_is_the_upper_bound_of_the_bucket(void) {
+    metrics_timer_t timer;
+
+    memset(&timer, 0, sizeof(timer));
+    TEST_ASSERT_EQUAL_UINT32(0, metrics_percentile_us(&timer, 50));
+
+    timer.hist[3] = 98;                         /* [8, 16) us */
+    timer.hist[10] = 1;                         /* [1024, 2048) us */
+    timer.hist[METRICS_HIST_BUCKETS - 1] = 1;
+    TEST_ASSERT_EQUAL_UINT32(16, metrics_percentile_us(&timer, 1));
+    TEST_ASSERT_EQUAL_UINT32(16, metrics_percentile_us(&timer, 98));
+    TEST_ASSERT_EQUAL_UINT32(2048, metrics_percentile_us(&timer, 99));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, metrics_percentile_us(&timer, 100));
+}
+
+void
+test_counters_and_errors(void) {
+    metrics_error(AMG88_ERR_I2C);
+    metrics_error(AMG88_ERR_I2C);
+    metrics_error((amg88_err_t) (METRICS_ERR_CODES + 3));
+    metrics_count(METRICS_FRAMES, 10);
+    metrics_count(METRICS_DROPPED, 1);
+    take_delta();
+
+    TEST_ASSERT_EQUAL_UINT32(2, delta.errors[AMG88_ERR_I2C]);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.errors[METRICS_ERR_CODES - 1]);
+    TEST_ASSERT_EQUAL_UINT32(10, delta.counters[METRICS_FRAMES]);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.counters[METRICS_DROPPED]);
+    TEST_ASSERT_EQUAL_UINT32(0, delta.counters[METRICS_TORN]);
+}
+
+void
+test_delta_across_a_wrap_around(void) {
+    memset(&before, 0, sizeof(before));
+    memset(&after, 0, sizeof(after));
+    before.timers[METRICS_DECODE].count = UINT32_MAX - 1;
+    before.timers[METRICS_DECODE].sum_us = UINT32_MAX - 100;
+    before.timers[METRICS_DECODE].hist[4] = UINT16_MAX;
+    before.counters[METRICS_FRAMES] = UINT32_MAX;
+    after.timers[METRICS_DECODE].count = 3;
+    after.timers[METRICS_DECODE].sum_us = 50;
+    after.timers[METRICS_DECODE].hist[4] = 4;
+    after.counters[METRICS_FRAMES] = 9;
+
+    /* In place, over the newer snapshot */
+    metrics_delta(&after, &before, &after);
+    TEST_ASSERT_EQUAL_UINT32(5, after.timers[METRICS_DECODE].count);
+    TEST_ASSERT_EQUAL_UINT32(151, after.timers[METRICS_DECODE].sum_us);
+    TEST_ASSERT_EQUAL_UINT16(5, after.timers[METRICS_DECODE].hist[4]);
+    TEST_ASSERT_EQUAL_UINT32(10, after.counters[METRICS_FRAMES]);
+}
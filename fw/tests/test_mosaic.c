@@ -0,0 +1,112 @@
+/**
+ * \file            test_mosaic.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Mosaic layouts: tile placement, rotation, mirroring, fill and layout errors
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "mosaic/mosaic.h"
+
+#define FILL    (-1000)
+
+/* Vars */
+static mosaic_t mosaic;
+static int16_t tiles[MOSAIC_MAX_TILES][MOSAIC_TILE_SIZE];
+static int16_t out[MOSAIC_MAX_SIZE];
+
+
+/* Output pixel at (x, y) */
+static int16_t
+at(size_t x, size_t y) {
+    return out[y * MOSAIC_WIDTH(&mosaic) + x];
+}
+
+void
+setUp(void) {
+    /* Tile t, source pixel i holds t * 100 + i */
+    for (size_t t = 0; t < MOSAIC_MAX_TILES; ++t) {
+        for (size_t i = 0; i < MOSAIC_TILE_SIZE; ++i) {
+            tiles[t][i] = (int16_t) (t * 100 + i);
+        }
+    }
+    memset(out, 0, sizeof(out));
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_tiles_land_in_their_cells(void) {
+    const mosaic_tile_t layout[] = { { .col = 1, .row = 0 }, { .col = 0, .row = 1 } };
+    const int16_t* frames[] = { tiles[0], tiles[1] };
+
+    TEST_ASSERT_EQUAL_INT(MOSAIC_OK, mosaic_init(&mosaic, 2, 2, layout, 2, FILL));
+    TEST_ASSERT_EQUAL_size_t(16, MOSAIC_WIDTH(&mosaic));
+    TEST_ASSERT_EQUAL_size_t(16, MOSAIC_HEIGHT(&mosaic));
+    mosaic_stitch(&mosaic, frames, out);
+
+    for (size_t y = 0; y < MOSAIC_TILE_SIDE; ++y) {
+        for (size_t x = 0; x < MOSAIC_TILE_SIDE; ++x) {
+            TEST_ASSERT_EQUAL_INT16(y * 8 + x, at(8 + x, y));
+            TEST_ASSERT_EQUAL_INT16(100 + y * 8 + x, at(x, 8 + y));
+
+            /* Cells no tile covers */
+            TEST_ASSERT_EQUAL_INT16(FILL, at(x, y));
+            TEST_ASSERT_EQUAL_INT16(FILL, at(8 + x, 8 + y));
+        }
+    }
+}
+
+void
+test_rotation_and_mirror(void) {
+    const mosaic_tile_t layout[] = {
+        { .col = 0, .rot = MOSAIC_ROT_90 },
+        { .col = 1, .rot = MOSAIC_ROT_180 },
+        { .col = 2, .rot = MOSAIC_ROT_270 },
+        { .col = 3, .mirror = true },
+    };
+    const int16_t* frames[] = { tiles[0], tiles[1], tiles[2], tiles[3] };
+
+    TEST_ASSERT_EQUAL_INT(MOSAIC_OK, mosaic_init(&mosaic, 4, 1, layout, 4, FILL));
+    mosaic_stitch(&mosaic, frames, out);
+
+    /* Source corners: top-left 0, top-right 7, bottom-left 56, bottom-right 63 */
+    TEST_ASSERT_EQUAL_INT16(56, at(0, 0));      /* Clockwise, bottom-left goes to the top-left */
+    TEST_ASSERT_EQUAL_INT16(0, at(7, 0));
+    TEST_ASSERT_EQUAL_INT16(7, at(7, 7));
+    TEST_ASSERT_EQUAL_INT16(163, at(8, 0));     /* Upside down */
+    TEST_ASSERT_EQUAL_INT16(100, at(15, 7));
+    TEST_ASSERT_EQUAL_INT16(207, at(16, 0));    /* Counter-clockwise, top-right goes to the top-left */
+    TEST_ASSERT_EQUAL_INT16(200, at(16, 7));
+    TEST_ASSERT_EQUAL_INT16(307, at(24, 0));    /* Left to right */
+    TEST_ASSERT_EQUAL_INT16(356, at(31, 7));
+}
+
+void
+test_missing_sensor_is_filled(void) {
+    const mosaic_tile_t layout[] = { { .col = 0 }, { .col = 1 } };
+    const int16_t* frames[] = { tiles[0], NULL };
+
+    TEST_ASSERT_EQUAL_INT(MOSAIC_OK, mosaic_init(&mosaic, 2, 1, layout, 2, FILL));
+    mosaic_stitch(&mosaic, frames, out);
+    TEST_ASSERT_EQUAL_INT16(63, at(7, 7));
+    TEST_ASSERT_EQUAL_INT16(FILL, at(8, 0));
+    TEST_ASSERT_EQUAL_INT16(FILL, at(15, 7));
+}
+
+void
+test_bad_layouts_are_rejected(void) {
+    const mosaic_tile_t outside[] = { { .col = 2 } };
+    const mosaic_tile_t twice[] = { { .col = 1 }, { .col = 1 } };
+
+    TEST_ASSERT_EQUAL_INT(MOSAIC_ERR_GRID, mosaic_init(&mosaic, 0, 1, NULL, 0, FILL));
+    TEST_ASSERT_EQUAL_INT(MOSAIC_ERR_GRID, mosaic_init(&mosaic, 3, 2, NULL, 0, FILL));
+    TEST_ASSERT_EQUAL_INT(MOSAIC_ERR_GRID, mosaic_init(&mosaic, 1, 1, twice, 2, FILL));
+    TEST_ASSERT_EQUAL_INT(MOSAIC_ERR_TILE, mosaic_init(&mosaic, 2, 1, outside, 1, FILL));
+    TEST_ASSERT_EQUAL_INT(MOSAIC_ERR_TILE, mosaic_init(&mosaic, 2, 1, twice, 2, FILL));
+}
@@ -0,0 +1,228 @@
+/**
+ * \file            test_pipeline.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame ring and pipeline stress under pthreads: no torn slots, no reordering, every frame
+ *                  either consumed or counted as an overrun, and a slow consumer never slows the reads
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <sched.h>
+#include <string.h>
+
+#include "unity.h"
+#include "amg88/amg88.h"
+#include "frame_ring/frame_ring.h"
+#include "frame_sync/frame_sync.h"
+#include "metrics/metrics.h"
+#include "pipeline/pipeline.h"
+
+TEST_FILE("osal_posix.c");
+
+#define RING_FRAMES     1000000                 /* Frames pushed through the bare ring */
+#define RING_WORDS      32                      /* Words per ring slot, all set to the frame number */
+#define PIPE_PERIOD_US  500                     /* Acquisition period of the pipeline run */
+#define PIPE_RUN_MS     1000                    /* Length of the pipeline run */
+
+/* Processing output, the frame number the processing stage saw, repeated */
+typedef struct {
+    uint32_t seq;
+    uint32_t tag[RING_WORDS];
+} out_t;
+
+/* Vars */
+static frame_ring_t ring;
+static uint32_t ring_buf[FRAME_RING_SLOTS][RING_WORDS];
+static atomic_bool ring_done;
+static volatile uint32_t spin_sink;
+
+static atomic_uint_fast32_t reads;
+static uint32_t bad_proc, bad_send, last_tag, last_seq, last_send;
+static bool proc_first = true, send_first = true;
+
+
+/* Every word of a slot must come from the same frame */
+static bool
+slot_torn(const uint32_t* p_words) {
+    for (size_t i = 1; i < RING_WORDS; ++i) {
+        if (p_words[i] != p_words[0]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Random busy wait, and now and then a yield so a single core interleaves the two sides too */
+static void
+spin(uint32_t* p_rng) {
+    *p_rng = *p_rng * 1664525u + 1013904223u;
+    for (uint32_t i = (*p_rng >> 24); i > 0; --i) {
+        spin_sink++;
+    }
+    if ((*p_rng & 0x30) == 0) {
+        sched_yield();
+    }
+}
+
+static void
+ring_producer(void* arg) {
+    uint32_t rng = 1;
+
+    (void) arg;
+    for (uint32_t n = 1; n <= RING_FRAMES; ++n) {
+        uint32_t* p_slot = (uint32_t*) frame_ring_write_slot(&ring);
+
+        for (size_t i = 0; i < RING_WORDS; ++i) {
+            p_slot[i] = n;
+            if (i == RING_WORDS / 2) {
+                spin(&rng);
+            }
+        }
+        frame_ring_publish(&ring);
+    }
+
+    atomic_store(&ring_done, true);
+}
+
+/* Sensor mock: every frame read returns the next frame number, repeated over the 128 pixel bytes */
+static amg88_err_t
+mock_read(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    uint32_t n = 0;
+
+    (void) bus;
+    (void) addr;
+    if (reg_addr == AMG88_REG_TL) {
+        n = (uint32_t) atomic_fetch_add(&reads, 1) + 1;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        data_buf[i] = (uint8_t) (n >> (8 * (i % 4)));
+    }
+
+    return AMG88_OK;
+}
+
+static amg88_err_t
+mock_write(uint8_t bus, uint8_t addr, uint8_t reg_addr, size_t len, uint8_t* data_buf) {
+    (void) bus;
+    (void) addr;
+    (void) reg_addr;
+    (void) len;
+    (void) data_buf;
+
+    return AMG88_OK;
+}
+
+/* Checks the frame, then takes four acquisition periods so the ring has to drop */
+static bool
+process(const pipeline_frame_t* p_frame, void* p_out, void* arg) {
+    out_t* p_o = (out_t*) p_out;
+    uint32_t tag;
+
+    (void) arg;
+    memcpy(p_o->tag, p_frame->raw.pixels, sizeof(p_o->tag));
+    tag = p_o->tag[0];
+    if (slot_torn(p_o->tag) || (!proc_first && (tag <= last_tag || p_frame->seq <= last_seq))) {
+        bad_proc++;
+    }
+    proc_first = false;
+    last_tag = tag;
+    last_seq = p_frame->seq;
+    p_o->seq = p_frame->seq;
+
+    osal_delay_ms(4 * PIPE_PERIOD_US / 1000);
+
+    return true;
+}
+
+static void
+send(const void* p_out, void* arg) {
+    const out_t* p_o = (const out_t*) p_out;
+
+    (void) arg;
+    if (slot_torn(p_o->tag) || (!send_first && p_o->tag[0] <= last_send)) {
+        bad_send++;
+    }
+    send_first = false;
+    last_send = p_o->tag[0];
+    osal_delay_ms(1);
+}
+
+void
+setUp(void) {
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_ring_never_tears_or_reorders(void) {
+    osal_task_t producer;
+    const uint32_t* p_slot;
+    uint32_t last = 0, torn = 0, reordered = 0, seen = 0, rng = 2;
+    frame_ring_stats_t rs;
+
+    /* Producer flat out against a consumer that spins on it */
+    frame_ring_init(&ring, ring_buf, sizeof(ring_buf[0]));
+    TEST_ASSERT_EQUAL_INT(OSAL_OK, osal_task_create(&producer, "ring_prod", ring_producer, NULL, 4096, 1,
+                                                    OSAL_CORE_ANY));
+
+    for (bool done = false; !done; sched_yield()) {
+        done = atomic_load(&ring_done);
+        /* Once the producer is done, one last pass drains the latest frame */
+        while ((p_slot = (const uint32_t*) frame_ring_acquire(&ring)) != NULL) {
+            torn += slot_torn(p_slot);
+            reordered += p_slot[0] <= last;
+            last = p_slot[0];
+            seen++;
+
+            /* Still ours until the next acquire, the producer must not touch it meanwhile */
+            spin(&rng);
+            torn += slot_torn(p_slot) || p_slot[0] != last;
+        }
+    }
+    frame_ring_get_stats(&ring, &rs);
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, reordered);
+    TEST_ASSERT_EQUAL_UINT32(RING_FRAMES, last);
+    TEST_ASSERT_EQUAL_UINT32(RING_FRAMES, rs.published);
+    TEST_ASSERT_EQUAL_UINT32(seen, rs.consumed);
+    TEST_ASSERT_EQUAL_UINT32(rs.published, rs.consumed + rs.overruns);
+}
+
+void
+test_pipeline_drops_instead_of_slowing_the_reads(void) {
+    amg88_dev_t dev = { .addr = AMG88_I2C_ADDR_LOW, .read = mock_read, .write = mock_write };
+    static out_t out_buf[FRAME_RING_SLOTS];
+    static pipeline_t pipeline;
+    pipeline_cfg_t cfg = {
+        .p_dev = &dev,
+        .period_us = PIPE_PERIOD_US,
+        .process = process,
+        .send = send,
+        .p_out_buf = out_buf,
+        .out_size = sizeof(out_buf[0]),
+    };
+    pipeline_stats_t ps;
+    uint32_t n_reads;
+
+    /* Slow processing and network stages */
+    TEST_ASSERT_EQUAL_INT(OSAL_OK, pipeline_start(&pipeline, &cfg));
+    osal_delay_ms(PIPE_RUN_MS);
+    pipeline_stop(&pipeline);
+    pipeline_get_stats(&pipeline, &ps);
+    n_reads = (uint32_t) atomic_load(&reads);
+
+    TEST_ASSERT_EQUAL_UINT32(0, bad_proc);
+    TEST_ASSERT_EQUAL_UINT32(0, bad_send);
+    TEST_ASSERT_EQUAL_UINT32(0, ps.read_errors);
+    TEST_ASSERT_EQUAL_UINT32(n_reads, ps.raw.published);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, ps.raw.overruns);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ps.raw.published, ps.raw.consumed + ps.raw.overruns);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(ps.raw.published, ps.raw.consumed + ps.raw.overruns + 1);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ps.out.published, ps.out.consumed + ps.out.overruns);
+
+    /* Processing is 4x too slow, the reads must still keep most of their cadence */
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(PIPE_RUN_MS * 1000 / PIPE_PERIOD_US / 2, n_reads);
+}
@@ -0,0 +1,151 @@
+/**
+ * \file            test_render.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Palette endpoints in every output format, window clamping and row stride
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "render/render.h"
+
+/* Vars */
+static render_t render;
+
+
+/* Render a single value and return its output pixel */
+static void
+render_one(int16_t v, uint8_t* p_px) {
+    render_frame(&render, &v, 1, 1, p_px, 3);
+}
+
+void
+setUp(void) {
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_palette_endpoints_in_every_format(void) {
+    static const struct {
+        render_palette_t palette;
+        render_format_t format;
+        uint8_t first[3], last[3];
+    } cases[] = {
+        { RENDER_PALETTE_GRAY, RENDER_RGB888, { 0x00, 0x00, 0x00 }, { 0xFF, 0xFF, 0xFF } },
+        { RENDER_PALETTE_IRON, RENDER_RGB888, { 0x00, 0x00, 0x00 }, { 0xFF, 0xFF, 0xFF } },
+        { RENDER_PALETTE_RAINBOW, RENDER_RGB888, { 0x00, 0x00, 0xFF }, { 0xFF, 0x00, 0x00 } },
+        { RENDER_PALETTE_RAINBOW, RENDER_RGB565, { 0x1F, 0x00 }, { 0x00, 0xF8 } },
+        { RENDER_PALETTE_RAINBOW, RENDER_RGB565_BE, { 0x00, 0x1F }, { 0xF8, 0x00 } },
+        { RENDER_PALETTE_GRAY, RENDER_RGB565, { 0x00, 0x00 }, { 0xFF, 0xFF } },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        size_t bpp = render_bpp(cases[i].format);
+        uint8_t px[3];
+
+        render_init(&render, cases[i].palette, cases[i].format);
+        render_set_window(&render, -100, 100);
+
+        /* Window ends, then values past them clamped to the same entries */
+        render_one(-100, px);
+        TEST_ASSERT_EQUAL_MEMORY(cases[i].first, px, bpp);
+        render_one(INT16_MIN, px);
+        TEST_ASSERT_EQUAL_MEMORY(cases[i].first, px, bpp);
+        render_one(100, px);
+        TEST_ASSERT_EQUAL_MEMORY(cases[i].last, px, bpp);
+        render_one(INT16_MAX, px);
+        TEST_ASSERT_EQUAL_MEMORY(cases[i].last, px, bpp);
+    }
+}
+
+void
+test_gray_midpoint(void) {
+    uint8_t px[3];
+
+    render_init(&render, RENDER_PALETTE_GRAY, RENDER_RGB888);
+    render_set_window(&render, 0, 255);
+    render_one(128, px);
+    TEST_ASSERT_EQUAL_UINT8(128, px[0]);
+    TEST_ASSERT_EQUAL_UINT8(128, px[1]);
+    TEST_ASSERT_EQUAL_UINT8(128, px[2]);
+}
+
+void
+test_fixed_window_is_clamped(void) {
+    uint8_t px[3];
+
+    render_init(&render, RENDER_PALETTE_GRAY, RENDER_RGB888);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, render.lo);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, render.hi);
+
+    /* Empty or inverted, 1 wide */
+    render_set_window(&render, 50, 50);
+    TEST_ASSERT_EQUAL_INT16(50, render.lo);
+    TEST_ASSERT_EQUAL_INT16(51, render.hi);
+    render_set_window(&render, 50, -50);
+    TEST_ASSERT_EQUAL_INT16(51, render.hi);
+
+    /* Low end at the top of the range, the high end must not wrap */
+    render_set_window(&render, INT16_MAX, INT16_MAX);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX - 1, render.lo);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, render.hi);
+    render_one(INT16_MAX, px);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, px[0]);
+    render_one(0, px);
+    TEST_ASSERT_EQUAL_UINT8(0x00, px[0]);
+
+    render_set_window(&render, INT16_MIN, INT16_MIN);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, render.lo);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN + 1, render.hi);
+}
+
+void
+test_auto_window_is_clamped_and_widened(void) {
+    render_init(&render, RENDER_PALETTE_IRON, RENDER_RGB565);
+
+    /* Fixed window ignores the range */
+    render_set_window(&render, -10, 10);
+    render_update_range(&render, 0, 1000);
+    TEST_ASSERT_EQUAL_INT16(-10, render.lo);
+    TEST_ASSERT_EQUAL_INT16(10, render.hi);
+
+    /* Flat scene widened around its centre */
+    render_set_auto(&render, 0, 40);
+    render_update_range(&render, 100, 100);
+    TEST_ASSERT_EQUAL_INT16(80, render.lo);
+    TEST_ASSERT_EQUAL_INT16(120, render.hi);
+
+    /* Flat scenes at both ends of the range */
+    render_update_range(&render, INT16_MAX, INT16_MAX);
+    TEST_ASSERT_LESS_THAN_INT(render.hi, render.lo);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, render.hi);
+    render_update_range(&render, INT16_MIN, INT16_MIN);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, render.lo);
+    TEST_ASSERT_LESS_THAN_INT(render.hi, render.lo);
+
+    /* Smoothed, moves half of the way per frame */
+    render_set_auto(&render, 1, 1);
+    render_update_range(&render, 0, 100);
+    render_update_range(&render, 100, 300);
+    TEST_ASSERT_EQUAL_INT16(50, render.lo);
+    TEST_ASSERT_EQUAL_INT16(200, render.hi);
+}
+
+void
+test_rows_follow_the_stride(void) {
+    const int16_t in[2 * 2] = { 0, 255, 255, 0 };
+    uint8_t out[2 * 8];
+
+    memset(out, 0xAA, sizeof(out));
+    render_init(&render, RENDER_PALETTE_GRAY, RENDER_RGB888);
+    render_set_window(&render, 0, 255);
+    render_frame(&render, in, 2, 2, out, 8);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((const uint8_t[]) { 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xAA, 0xAA }), &out[0], 8);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((const uint8_t[]) { 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xAA, 0xAA }), &out[8], 8);
+}
@@ -0,0 +1,416 @@
+/**
+ * \file            test_stream_rx.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Receiver over a UDP loopback: reordering, gaps, duplicates, late packets, device restarts,
+ *                  encoded frames on a lossy link, recorded (backfill) frames, metrics, blobs
+ *                  and tracks
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "unity.h"
+#include "frame_codec/frame_codec.h"
+#include "stream_proto/stream_proto.h"
+#include "stream_proto/stream_proto_analytics.h"
+#include "stream_rx.h"
+
+#define MAX_DELIVERED   64
+#define KEY_INTERVAL    3                       /* Deltas between keyframes of the encoded stream */
+#define BOOT_ID         0x2A5C
+
+/* Vars */
+static stream_rx_t rx;
+static frame_codec_enc_t enc;
+static frame_codec_enc_t rec_enc;               /* Encoder of the recorded frames */
+static uint16_t boot_id;                        /* Boot ID of the packets sent */
+static int tx_sock = -1;
+static struct sockaddr_in rx_addr;
+static uint32_t delivered[MAX_DELIVERED];
+static uint16_t delivered_boot_id;
+static size_t n_delivered;
+static unsigned bad_payload;
+static metrics_t rx_metrics;
+static size_t n_metrics;
+static detect_blob_t rx_blobs[DETECT_MAX_BLOBS];
+static uint8_t rx_n_blobs, rx_overflow;
+static size_t n_blob_pkts;
+static track_t rx_tracks[TRACK_MAX_TRACKS];
+static uint8_t rx_n_tracks;
+static size_t n_track_pkts;
+
+
+/* Frame payload carries its sequence number, so the delivery order can be checked against the content */
+static void
+send_frame(uint32_t seq) {
+    uint8_t pkt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_FRAME_RAW_SIZE];
+    amg88_frame_raw_t frame;
+    size_t len;
+
+    memset(&frame, 0, sizeof(frame));
+    memcpy(frame.pixels, &seq, sizeof(seq));
+    len = stream_proto_encode_frame(pkt, sizeof(pkt), 0, boot_id, seq, 1000 + seq * 100000ULL, &frame);
+    sendto(tx_sock, pkt, len, 0, (const struct sockaddr*) &rx_addr, sizeof(rx_addr));
+}
+
+/* Same, encoded against the running keyframe. `drop` loses it on the way, it still advances the encoder */
+static bool
+send_codec(uint32_t seq, uint8_t flags, bool drop) {
+    uint8_t pkt[STREAM_PROTO_HDR_SIZE + FRAME_CODEC_MAX_SIZE];
+    amg88_frame_raw_t frame;
+    size_t len;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.pixels[0] = (uint8_t) seq;
+    len = stream_proto_encode_codec(pkt, sizeof(pkt), 0, boot_id, seq, 1000 + seq * 100000ULL, flags,
+                                    (flags & STREAM_FLAG_BACKFILL) ? &rec_enc : &enc, &frame);
+    if (!drop) {
+        sendto(tx_sock, pkt, len, 0, (const struct sockaddr*) &rx_addr, sizeof(rx_addr));
+    }
+
+    return pkt[STREAM_PROTO_HDR_SIZE] == FRAME_CODEC_KEY;
+}
+
+static void
+on_frame(const stream_rx_frame_t* p_frame, void* arg) {
+    uint32_t tag;
+
+    (void) arg;
+    memcpy(&tag, p_frame->frame.pixels, sizeof(tag));
+    bad_payload += tag != p_frame->hdr.seq;
+    delivered_boot_id = p_frame->hdr.boot_id;
+    if (n_delivered < MAX_DELIVERED) {
+        delivered[n_delivered++] = p_frame->hdr.seq;
+    }
+}
+
+static void
+on_metrics(const stream_hdr_t* p_hdr, const metrics_t* p_metrics, void* arg) {
+    (void) p_hdr;
+    (void) arg;
+    rx_metrics = *p_metrics;
+    n_metrics++;
+}
+
+static void
+on_blobs(const stream_hdr_t* p_hdr, const detect_blob_t* p_blobs, uint8_t n_blobs, uint8_t overflow, void* arg) {
+    (void) p_hdr;
+    (void) arg;
+    memcpy(rx_blobs, p_blobs, n_blobs * sizeof(*p_blobs));
+    rx_n_blobs = n_blobs;
+    rx_overflow = overflow;
+    n_blob_pkts++;
+}
+
+static void
+on_tracks(const stream_hdr_t* p_hdr, const track_t* p_tracks, uint8_t n_tracks, void* arg) {
+    (void) p_hdr;
+    (void) arg;
+    memcpy(rx_tracks, p_tracks, n_tracks * sizeof(*p_tracks));
+    rx_n_tracks = n_tracks;
+    n_track_pkts++;
+}
+
+/* Take everything sent so far, then let the link go quiet so the gaps are given up */
+static void
+receive(void) {
+    while (stream_rx_poll(&rx, 20) > 0) {}
+}
+
+/* Delivery order since the last check */
+static void
+check_delivered(const uint32_t* p_seqs, size_t n) {
+    TEST_ASSERT_EQUAL_size_t(n, n_delivered);
+    if (n > 0) {
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(p_seqs, delivered, n);
+    }
+    n_delivered = 0;
+}
+
+void
+setUp(void) {
+    socklen_t addr_len = sizeof(rx_addr);
+
+    n_delivered = 0;
+    boot_id = BOOT_ID;
+    bad_payload = 0;
+    n_metrics = 0;
+    n_blob_pkts = 0;
+    n_track_pkts = 0;
+    frame_codec_enc_init(&enc, KEY_INTERVAL);
+    frame_codec_enc_init(&rec_enc, KEY_INTERVAL);
+    stream_rx_init(&rx, on_frame, NULL);
+    TEST_ASSERT_EQUAL_INT(0, stream_rx_open(&rx, 0));
+    TEST_ASSERT_EQUAL_INT(0, getsockname(rx.sock, (struct sockaddr*) &rx_addr, &addr_len));
+    rx_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    tx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(0, tx_sock);
+}
+
+void
+tearDown(void) {
+    stream_rx_close(&rx);
+    if (tx_sock >= 0) {
+        close(tx_sock);
+        tx_sock = -1;
+    }
+    TEST_ASSERT_EQUAL_UINT(0, bad_payload);
+}
+
+void
+test_reordered_frames_are_delivered_in_order(void) {
+    send_frame(0);
+    send_frame(2);
+    send_frame(1);
+    send_frame(3);
+    receive();
+    check_delivered((const uint32_t[]) { 0, 1, 2, 3 }, 4);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.reordered);
+}
+
+void
+test_gap_is_given_up_and_duplicate_dropped(void) {
+    send_frame(4);
+    send_frame(6);
+    send_frame(7);
+    send_frame(7);
+    receive();
+    check_delivered((const uint32_t[]) { 4, 6, 7 }, 3);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.duplicates);
+
+    /* The missing one turns up after all */
+    send_frame(5);
+    receive();
+    check_delivered(NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.late);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.restarts);
+}
+
+void
+test_without_a_boot_id_far_behind_is_a_restart(void) {
+    boot_id = 0;
+    for (uint32_t seq = 100; seq < 120; ++seq) {
+        send_frame(seq);
+    }
+    send_frame(115);
+    send_frame(0);
+    send_frame(1);
+    receive();
+    TEST_ASSERT_EQUAL_size_t(22, n_delivered);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.late);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.restarts);
+}
+
+void
+test_same_boot_far_behind_is_late(void) {
+    for (uint32_t seq = 100; seq < 120; ++seq) {
+        send_frame(seq);
+    }
+    send_frame(0);
+    send_frame(1);
+    receive();
+    TEST_ASSERT_EQUAL_size_t(20, n_delivered);
+    TEST_ASSERT_EQUAL_UINT32(2, rx.stats.late);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.restarts);
+}
+
+void
+test_reboot_inside_the_window_is_a_restart(void) {
+    for (uint32_t seq = 0; seq < 6; ++seq) {
+        send_frame(seq);
+    }
+    receive();
+    check_delivered((const uint32_t[]) { 0, 1, 2, 3, 4, 5 }, 6);
+    TEST_ASSERT_EQUAL_HEX16(BOOT_ID, delivered_boot_id);
+
+    /* A few frames in, the new sequence lands inside the window of the old one */
+    boot_id = BOOT_ID + 1;
+    send_frame(0);
+    send_frame(1);
+    send_frame(2);
+    receive();
+    check_delivered((const uint32_t[]) { 0, 1, 2 }, 3);
+    TEST_ASSERT_EQUAL_HEX16(BOOT_ID + 1, delivered_boot_id);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.restarts);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.late);
+}
+
+void
+test_deltas_after_a_lost_keyframe_are_undecodable(void) {
+    /* Key, 3 deltas, key (lost), 3 deltas, key, 1 delta */
+    for (uint32_t seq = 0; seq < 10; ++seq) {
+        TEST_ASSERT_EQUAL(seq % (KEY_INTERVAL + 1) == 0, send_codec(seq, 0, seq == 4));
+    }
+    receive();
+
+    /* Deltas of the lost keyframe are not decoded against the first one */
+    check_delivered((const uint32_t[]) { 0, 1, 2, 3, 8, 9 }, 6);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(3, rx.stats.undecodable);
+}
+
+void
+test_lost_delta_costs_only_that_frame(void) {
+    for (uint32_t seq = 0; seq < 8; ++seq) {
+        send_codec(seq, 0, seq == 2);
+    }
+    receive();
+    check_delivered((const uint32_t[]) { 0, 1, 3, 4, 5, 6, 7 }, 7);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.undecodable);
+}
+
+void
+test_backfill_is_delivered_apart_from_the_live_sequence(void) {
+    send_codec(10, 0, false);
+    send_codec(11, 0, false);
+
+    /* Recorded frames, older seq; the first keyframe went with the sector the flash ring wrapped over */
+    for (uint32_t seq = 0; seq < 6; ++seq) {
+        send_codec(seq, STREAM_FLAG_BACKFILL, seq == 0);
+    }
+    send_codec(12, 0, false);
+    receive();
+
+    check_delivered((const uint32_t[]) { 10, 11, 4, 5, 12 }, 5);
+    TEST_ASSERT_EQUAL_UINT32(2, rx.stats.backfilled);
+    TEST_ASSERT_EQUAL_UINT32(3, rx.stats.undecodable);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.late);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.restarts);
+
+    /* Recorded before the last reboot: the live sequence goes on */
+    boot_id = BOOT_ID - 1;
+    send_codec(6, STREAM_FLAG_BACKFILL, false);
+    boot_id = BOOT_ID;
+    send_codec(13, 0, false);
+    receive();
+    check_delivered((const uint32_t[]) { 6, 13 }, 2);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.restarts);
+}
+
+void
+test_metrics_are_delivered_apart_from_the_frames(void) {
+    uint8_t pkt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_METRICS_SIZE];
+    metrics_t metrics;
+    size_t len;
+
+    memset(&metrics, 0, sizeof(metrics));
+    metrics.timers[METRICS_READ].count = 100;
+    metrics.timers[METRICS_READ].sum_us = 0xDEADBEEF;
+    metrics.timers[METRICS_SEND].hist[METRICS_HIST_BUCKETS - 1] = 0xBEEF;
+    metrics.errors[METRICS_ERR_CODES - 1] = 7;
+    metrics.counters[METRICS_TX_ERRORS] = 0x12345678;
+    TEST_ASSERT_EQUAL_size_t(0, stream_proto_encode_metrics(pkt, sizeof(pkt) - 1, 0, boot_id, 0, 0, &metrics));
+    len = stream_proto_encode_metrics(pkt, sizeof(pkt), 0, boot_id, 5000, 1000, &metrics);
+    TEST_ASSERT_EQUAL_size_t(sizeof(pkt), len);
+
+    /* Dropped until asked for, then delivered whole; the frame sequence does not see them */
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(0, n_metrics);
+    stream_rx_set_metrics_cb(&rx, on_metrics);
+    send_frame(0);
+    stream_rx_push(&rx, pkt, len);
+    send_frame(1);
+    receive();
+    TEST_ASSERT_EQUAL_size_t(1, n_metrics);
+    TEST_ASSERT_EQUAL_MEMORY(&metrics, &rx_metrics, sizeof(metrics));
+    check_delivered((const uint32_t[]) { 0, 1 }, 2);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.restarts);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.invalid);
+}
+
+void
+test_blobs_round_trip_and_a_bad_count_is_invalid(void) {
+    uint8_t pkt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(DETECT_MAX_BLOBS)];
+    detect_blob_t blobs[2] = {
+        { .pixels = 12, .peak = -40, .peak_idx = 63, .cx_q8 = 0x0780, .cy_q8 = 0x0123, .heat = 0x01020304,
+          .x0 = 5, .y0 = 0, .x1 = 7, .y1 = 3 },
+        { .pixels = 3, .peak = 400, .peak_idx = 0, .cx_q8 = 0, .cy_q8 = 0x0080, .heat = 9,
+          .x0 = 0, .y0 = 0, .x1 = 1, .y1 = 1 },
+    };
+    size_t len;
+
+    TEST_ASSERT_EQUAL_size_t(0, stream_proto_encode_blobs(pkt, STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(2) - 1,
+                                                          0, boot_id, 0, 0, blobs, 2, 0));
+    len = stream_proto_encode_blobs(pkt, sizeof(pkt), 0, boot_id, 42, 1000, blobs, 2, 1);
+    TEST_ASSERT_EQUAL_size_t(STREAM_PROTO_HDR_SIZE + STREAM_PROTO_BLOBS_SIZE(2), len);
+
+    stream_rx_set_blobs_cb(&rx, on_blobs);
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(1, n_blob_pkts);
+    TEST_ASSERT_EQUAL_UINT8(2, rx_n_blobs);
+    TEST_ASSERT_EQUAL_UINT8(1, rx_overflow);
+    for (uint8_t i = 0; i < 2; ++i) {
+        TEST_ASSERT_EQUAL_UINT16(blobs[i].pixels, rx_blobs[i].pixels);
+        TEST_ASSERT_EQUAL_INT16(blobs[i].peak, rx_blobs[i].peak);
+        TEST_ASSERT_EQUAL_UINT16(blobs[i].peak_idx, rx_blobs[i].peak_idx);
+        TEST_ASSERT_EQUAL_UINT16(blobs[i].cx_q8, rx_blobs[i].cx_q8);
+        TEST_ASSERT_EQUAL_UINT16(blobs[i].cy_q8, rx_blobs[i].cy_q8);
+        TEST_ASSERT_EQUAL_UINT32(blobs[i].heat, rx_blobs[i].heat);
+        TEST_ASSERT_EQUAL_UINT8(blobs[i].x0, rx_blobs[i].x0);
+        TEST_ASSERT_EQUAL_UINT8(blobs[i].y0, rx_blobs[i].y0);
+        TEST_ASSERT_EQUAL_UINT8(blobs[i].x1, rx_blobs[i].x1);
+        TEST_ASSERT_EQUAL_UINT8(blobs[i].y1, rx_blobs[i].y1);
+    }
+
+    /* An empty scene is a packet too */
+    len = stream_proto_encode_blobs(pkt, sizeof(pkt), 0, boot_id, 43, 1100, blobs, 0, 0);
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(2, n_blob_pkts);
+    TEST_ASSERT_EQUAL_UINT8(0, rx_n_blobs);
+
+    /* A count that disagrees with the length never reaches the callback */
+    len = stream_proto_encode_blobs(pkt, sizeof(pkt), 0, boot_id, 44, 1200, blobs, 2, 0);
+    pkt[STREAM_PROTO_HDR_SIZE] = 3;
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(2, n_blob_pkts);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.invalid);
+    TEST_ASSERT_EQUAL_UINT32(2, rx.stats.blobs);
+}
+
+void
+test_only_confirmed_tracks_are_sent_and_velocities_saturate(void) {
+    uint8_t pkt[STREAM_PROTO_HDR_SIZE + STREAM_PROTO_TRACKS_SIZE(TRACK_MAX_TRACKS)];
+    track_t slots[TRACK_MAX_TRACKS];
+    size_t len;
+
+    memset(slots, 0, sizeof(slots));
+    slots[1] = (track_t) { .state = TRACK_CONFIRMED, .id = 7, .x = 3 << TRACK_FRAC_BITS, .y = 1000,
+                           .vx = 100000, .vy = -100000, .value = -5, .hits = 9 };
+    slots[2] = (track_t) { .state = TRACK_TENTATIVE, .id = 8, .x = 10 };
+    slots[5] = (track_t) { .state = TRACK_CONFIRMED, .id = 0xFFFF, .x = -1, .y = 0, .vx = -3, .vy = 4,
+                           .value = 400 };
+    len = stream_proto_encode_tracks(pkt, sizeof(pkt), 0, boot_id, 9, 1000, slots, TRACK_MAX_TRACKS);
+    TEST_ASSERT_EQUAL_size_t(STREAM_PROTO_HDR_SIZE + STREAM_PROTO_TRACKS_SIZE(2), len);
+    TEST_ASSERT_EQUAL_size_t(0, stream_proto_encode_tracks(pkt, len - 1, 0, boot_id, 9, 1000, slots, TRACK_MAX_TRACKS));
+
+    stream_rx_set_tracks_cb(&rx, on_tracks);
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(1, n_track_pkts);
+    TEST_ASSERT_EQUAL_UINT8(2, rx_n_tracks);
+    TEST_ASSERT_EQUAL_UINT16(7, rx_tracks[0].id);
+    TEST_ASSERT_EQUAL_INT32(3 << TRACK_FRAC_BITS, rx_tracks[0].x);
+    TEST_ASSERT_EQUAL_INT32(1000, rx_tracks[0].y);
+    TEST_ASSERT_EQUAL_INT32(INT16_MAX, rx_tracks[0].vx);
+    TEST_ASSERT_EQUAL_INT32(INT16_MIN, rx_tracks[0].vy);
+    TEST_ASSERT_EQUAL_INT16(-5, rx_tracks[0].value);
+    TEST_ASSERT_EQUAL_UINT16(0, rx_tracks[0].hits);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, rx_tracks[1].id);
+    TEST_ASSERT_EQUAL_INT32(-1, rx_tracks[1].x);
+    TEST_ASSERT_EQUAL_INT32(-3, rx_tracks[1].vx);
+    TEST_ASSERT_EQUAL_INT32(4, rx_tracks[1].vy);
+    TEST_ASSERT_EQUAL_INT16(400, rx_tracks[1].value);
+
+    /* More tracks than a receiver has room for never reaches the callback */
+    len = stream_proto_encode_tracks(pkt, sizeof(pkt), 0, boot_id, 10, 1100, slots, TRACK_MAX_TRACKS);
+    pkt[STREAM_PROTO_HDR_SIZE] = TRACK_MAX_TRACKS + 1;
+    stream_rx_push(&rx, pkt, len);
+    TEST_ASSERT_EQUAL_size_t(1, n_track_pkts);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.invalid);
+}
@@ -0,0 +1,88 @@
+/**
+ * \file            test_tfilter.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Temporal filter: pass-through on the first frame, IIR and Kalman gains, step restarts
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+#include "tfilter/tfilter.h"
+
+#define ONE             (1 << TFILTER_FRAC_BITS)
+
+/* Vars */
+static tfilter_t flt;
+static int16_t frame[AMG88_ARRAY_SIZE];
+
+
+static void
+fill(int16_t value) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        frame[i] = value;
+    }
+}
+
+/* Filter a flat frame, return what one pixel turned into */
+static int16_t
+feed(int16_t value) {
+    fill(value);
+    tfilter_update(&flt, frame);
+
+    return frame[AMG88_ARRAY_SIZE - 1];
+}
+
+void
+setUp(void) {
+    fill(0);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_first_frame_passes_through_and_iir_moves_a_fraction(void) {
+    tfilter_init(&flt, &(tfilter_cfg_t) { .mode = TFILTER_IIR, .iir_shift = 2, .step = 0 });
+
+    TEST_ASSERT_EQUAL_INT16(100, feed(100));
+    TEST_ASSERT_EQUAL_INT16(101, feed(104));    /* A quarter of the way */
+    TEST_ASSERT_EQUAL_INT32(101 * ONE, flt.x[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, flt.frames);
+
+    /* After a reset the next frame passes through again */
+    tfilter_reset(&flt);
+    TEST_ASSERT_EQUAL_INT16(40, feed(40));
+}
+
+void
+test_kalman_without_process_noise_is_the_running_mean(void) {
+    tfilter_init(&flt, &(tfilter_cfg_t) { .mode = TFILTER_KALMAN, .q = 0, .r = ONE, .step = 0 });
+
+    TEST_ASSERT_EQUAL_INT16(0, feed(0));
+    TEST_ASSERT_EQUAL_INT16(4, feed(8));        /* (0 + 8) / 2 */
+    TEST_ASSERT_EQUAL_INT16(5, feed(8));        /* (0 + 8 + 8) / 3 */
+    TEST_ASSERT_EQUAL_INT16(6, feed(8));        /* 24 / 4 */
+}
+
+void
+test_kalman_settles_on_noise_and_a_step_restarts(void) {
+    int16_t out;
+
+    tfilter_init(&flt, &(tfilter_cfg_t) { .mode = TFILTER_KALMAN, .q = ONE / 16, .r = 4 * ONE, .step = 8 });
+
+    /* +-2 LSB of noise around 100 ends up within one LSB */
+    srand(1);
+    for (uint16_t n = 0; n < 200; ++n) {
+        out = feed((int16_t) (100 + rand() % 5 - 2));
+    }
+    TEST_ASSERT_INT16_WITHIN(1, 100, out);
+    TEST_ASSERT_EQUAL_UINT32(0, flt.restarts);
+
+    /* A person walking in: further than `step`, taken as it is on the same frame */
+    TEST_ASSERT_EQUAL_INT16(140, feed(140));
+    TEST_ASSERT_EQUAL_UINT32(AMG88_ARRAY_SIZE, flt.restarts);
+}
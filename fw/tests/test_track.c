@@ -0,0 +1,158 @@
+/**
+ * \file            test_track.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Hotspot refinement and ordering, track confirmation, velocity across dropped frames, coasting
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <string.h>
+
+#include "unity.h"
+#include "track/track.h"
+
+#define ONE             (1 << TRACK_FRAC_BITS)  /* One pixel */
+#define PERIOD_US       100000ULL               /* 10 FPS */
+
+static const track_cfg_t cfg = {
+    .threshold = 10,
+    .refine = TRACK_REFINE_NONE,
+    .gate = 2 * ONE,
+    .alpha = 128,
+    .beta = 64,
+    .confirm_hits = 3,
+    .max_misses = 2,
+};
+
+/* Vars */
+static track_tracker_t trk;
+static int16_t grid[AMG88_ARRAY_SIZE];
+
+
+static void
+put(uint8_t x, uint8_t y, int16_t value) {
+    grid[y * AMG88_ARRAY_COLS + x] = value;
+}
+
+/* One warm pixel at column `x` of row 3, or none for `x` past the grid */
+static uint8_t
+step(uint8_t x, uint64_t ts_us) {
+    memset(grid, 0, sizeof(grid));
+    if (x < AMG88_ARRAY_COLS) {
+        put(x, 3, 100);
+    }
+
+    return track_update(&trk, grid, ts_us);
+}
+
+void
+setUp(void) {
+    memset(grid, 0, sizeof(grid));
+    track_init(&trk, &cfg);
+}
+
+void
+tearDown(void) {
+}
+
+void
+test_peaks_are_refined_to_sub_pixel(void) {
+    track_peak_t peak;
+
+    /* Row neighbours 60 and 80 pull the vertex left, equal column neighbours keep the row */
+    put(3, 4, 100);
+    put(2, 4, 60);
+    put(4, 4, 80);
+    put(3, 3, 90);
+    put(3, 5, 90);
+
+    TEST_ASSERT_EQUAL_UINT8(1, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_NONE, &peak, 1));
+    TEST_ASSERT_EQUAL_INT16(3 * ONE, peak.x);
+    TEST_ASSERT_EQUAL_INT16(4 * ONE, peak.y);
+    TEST_ASSERT_EQUAL_INT16(100, peak.value);
+
+    /* (60 - 80) / (2 * (60 - 200 + 80)) of a pixel */
+    TEST_ASSERT_EQUAL_UINT8(1, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_QUADRATIC, &peak, 1));
+    TEST_ASSERT_EQUAL_INT16(3 * ONE + (-20 * ONE) / -120, peak.x);
+    TEST_ASSERT_EQUAL_INT16(4 * ONE, peak.y);
+
+    /* Weights over the zero window minimum: 80 - 60 of 420 to the right */
+    TEST_ASSERT_EQUAL_UINT8(1, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_CENTROID, &peak, 1));
+    TEST_ASSERT_EQUAL_INT16(3 * ONE + 20 * ONE / 420, peak.x);
+    TEST_ASSERT_EQUAL_INT16(4 * ONE, peak.y);
+}
+
+void
+test_peaks_warmest_first_plateaus_once_and_the_coolest_fall_off(void) {
+    track_peak_t peaks[TRACK_MAX_PEAKS];
+
+    put(0, 0, 50);
+    put(4, 0, 70);
+    put(7, 7, 30);
+    put(2, 5, 60);
+    put(3, 5, 60);                              /* Plateau, the first pixel in raster order wins */
+    put(6, 3, 10);                              /* Not above the threshold */
+
+    TEST_ASSERT_EQUAL_UINT8(4, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_NONE, peaks, TRACK_MAX_PEAKS));
+    TEST_ASSERT_EQUAL_INT16(70, peaks[0].value);
+    TEST_ASSERT_EQUAL_INT16(60, peaks[1].value);
+    TEST_ASSERT_EQUAL_INT16(2 * ONE, peaks[1].x);
+    TEST_ASSERT_EQUAL_INT16(50, peaks[2].value);
+    TEST_ASSERT_EQUAL_INT16(30, peaks[3].value);
+
+    TEST_ASSERT_EQUAL_UINT8(2, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_NONE, peaks, 2));
+    TEST_ASSERT_EQUAL_INT16(70, peaks[0].value);
+    TEST_ASSERT_EQUAL_INT16(60, peaks[1].value);
+    TEST_ASSERT_EQUAL_UINT8(0, track_find_peaks(grid, cfg.threshold, TRACK_REFINE_NONE, peaks, 0));
+}
+
+void
+test_track_is_confirmed_and_keeps_its_velocity_across_a_dropped_frame(void) {
+    uint64_t ts = PERIOD_US;
+
+    /* One pixel per frame at 10 FPS: 10 pixels per second */
+    TEST_ASSERT_EQUAL_UINT8(0, step(0, ts));
+    TEST_ASSERT_EQUAL_UINT8(0, step(1, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_INT32(10 * ONE, trk.tracks[0].vx);
+    TEST_ASSERT_EQUAL_UINT8(1, step(2, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT16(1, trk.tracks[0].id);
+    TEST_ASSERT_EQUAL_INT32(2 * ONE, trk.tracks[0].x);
+
+    /* Frame 3 never arrives, the prediction spans both periods and the residual stays zero */
+    TEST_ASSERT_EQUAL_UINT8(1, step(4, ts += 2 * PERIOD_US));
+    TEST_ASSERT_EQUAL_INT32(4 * ONE, trk.tracks[0].x);
+    TEST_ASSERT_EQUAL_INT32(3 * ONE, trk.tracks[0].y);
+    TEST_ASSERT_EQUAL_INT32(10 * ONE, trk.tracks[0].vx);
+    TEST_ASSERT_EQUAL_INT32(0, trk.tracks[0].vy);
+    TEST_ASSERT_EQUAL_UINT16(4, trk.tracks[0].hits);
+}
+
+void
+test_confirmed_tracks_coast_tentative_ones_drop_and_ids_are_not_reused(void) {
+    uint64_t ts = PERIOD_US;
+
+    step(0, ts);
+    step(0, ts += PERIOD_US);
+    TEST_ASSERT_EQUAL_UINT8(1, step(0, ts += PERIOD_US));
+
+    /* `max_misses` empty frames are coasted through, the next one drops the track */
+    TEST_ASSERT_EQUAL_UINT8(1, step(0xFF, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT8(1, trk.tracks[0].misses);
+    TEST_ASSERT_EQUAL_UINT8(1, step(0xFF, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT8(0, step(0xFF, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT8(TRACK_FREE, trk.tracks[0].state);
+
+    /* A sighting seen once and then missed is dropped straight away */
+    TEST_ASSERT_EQUAL_UINT8(0, step(5, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT8(TRACK_TENTATIVE, trk.tracks[0].state);
+    TEST_ASSERT_EQUAL_UINT16(2, trk.tracks[0].id);
+    TEST_ASSERT_EQUAL_UINT8(0, step(0xFF, ts += PERIOD_US));
+    TEST_ASSERT_EQUAL_UINT8(TRACK_FREE, trk.tracks[0].state);
+
+    /* Out of the gate: a new track, not a jump of the old one */
+    step(0, ts += PERIOD_US);
+    step(6, ts += PERIOD_US);
+    TEST_ASSERT_EQUAL_UINT16(4, trk.tracks[0].id);
+    TEST_ASSERT_EQUAL_INT32(6 * ONE, trk.tracks[0].x);
+    TEST_ASSERT_EQUAL_UINT16(1, trk.tracks[0].hits);
+}
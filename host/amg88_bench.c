@@ -0,0 +1,408 @@
+/**
+ * \file            amg88_bench.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Driver and processing benchmark against the simulated sensor
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+#include "calib/calib.h"
+#include "detect/detect.h"
+#include "track/track.h"
+#include "tfilter/tfilter.h"
+#include "frame_codec/frame_codec.h"
+#include "frame_sync/frame_sync.h"
+#include "interp/interp.h"
+#include "metrics/metrics.h"
+#include "render/render.h"
+
+#define BENCH_FRAMES 64                         /* Frames in the simulated sequence */
+
+/**
+ * \brief           Benchmarked entry point, runs once per frame
+ */
+typedef struct {
+    const char* name;
+    void (*fn)(void);
+} bench_t;
+
+/* Vars */
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static amg88_frame_raw_t frames[BENCH_FRAMES];
+static amg88_frame_raw_t raw;
+static float temp_f[AMG88_ARRAY_SIZE];
+static int16_t temp_q[AMG88_ARRAY_SIZE];
+static int16_t upscaled[INTERP_OUT_LEN(8)];
+static int32_t scratch[INTERP_TMP_LEN(8)];
+static uint8_t image[INTERP_OUT_LEN(8) * 2];
+static uint8_t encoded[FRAME_CODEC_MAX_SIZE];
+static frame_codec_enc_t enc;
+static frame_codec_dec_t dec;
+static render_t render;
+static frame_sync_t sync_state;
+static calib_table_t calib;
+static detect_t detector;
+static track_tracker_t tracker;
+static tfilter_t temporal;
+static int16_t scene[BENCH_FRAMES][AMG88_ARRAY_SIZE];
+static volatile float sink;
+
+
+static uint64_t
+now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/* Random walk around room temperature with a warm blob, negative values included */
+static void
+make_frames(void) {
+    int16_t v[AMG88_ARRAY_SIZE];
+
+    srand(1);
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        v[i] = (int16_t) (rand() % 40 - 10);
+    }
+
+    for (size_t f = 0; f < BENCH_FRAMES; ++f) {
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            uint16_t reg;
+
+            v[i] = (int16_t) (v[i] + rand() % 3 - 1);
+            reg = (uint16_t) (v[i] + (i % 8 == f % 8 ? 48 : 0)) & 0x0FFF;
+            frames[f].pixels[2 * i] = (uint8_t) reg;
+            frames[f].pixels[2 * i + 1] = (uint8_t) (reg >> 8);
+        }
+        frames[f].thermistor[0] = 0x90;
+        frames[f].thermistor[1] = 0x01;
+    }
+}
+
+/* Driver entry points */
+
+static void
+bench_get_pixel_loop(void) {
+    for (uint8_t r = 0; r < 8; ++r) {
+        for (uint8_t c = 0; c < 8; ++c) {
+            temp_f[r * 8 + c] = amg88_get_pixel(&dev, r, c);
+        }
+    }
+    amg88_sim_next_frame(&sim);
+}
+
+static void
+bench_get_array(void) {
+    amg88_get_array(&dev, temp_f);
+    amg88_sim_next_frame(&sim);
+}
+
+static void
+bench_get_frame_raw(void) {
+    amg88_get_frame_raw(&dev, &raw, 0);
+    amg88_sim_next_frame(&sim);
+}
+
+static void
+bench_get_frame_raw_th(void) {
+    amg88_get_frame_raw(&dev, &raw, 1);
+    amg88_sim_next_frame(&sim);
+}
+
+static void
+bench_get_thermistor(void) {
+    sink = amg88_get_thermistor(&dev);
+}
+
+static void
+bench_get_frame_rate(void) {
+    sink = amg88_get_frame_rate(&dev);
+}
+
+/* Switch between two scene modes, so every call has something to write */
+static void
+bench_reconfig(bool batch) {
+    static bool alt;
+
+    alt = !alt;
+    if (batch) {
+        amg88_config_begin(&dev);
+    }
+    amg88_set_frame_rate(&dev, alt ? AMG88_FPS_1 : AMG88_FPS_10);
+    amg88_set_int_levels(&dev, alt ? 30.0f : 40.0f, 10.0f, 1.0f);
+    amg88_enable_int(&dev, alt ? AMG88_INT_ABSOLUTE : AMG88_INT_DIFFERENCE);
+    if (batch) {
+        amg88_config_commit(&dev);
+    }
+}
+
+static void
+bench_reconfig_single(void) {
+    bench_reconfig(false);
+}
+
+static void
+bench_reconfig_batch(void) {
+    bench_reconfig(true);
+}
+
+/* Processing, on the frame left in `raw` */
+
+static void
+bench_macro_decode(void) {
+    const uint8_t* p_px = raw.pixels;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i, p_px += 2) {
+        temp_f[i] = AMG88_PIXEL_2_TEMP(p_px);
+    }
+    sink = temp_f[0];
+}
+
+static void
+bench_decode_frame(void) {
+    amg88_decode_frame(&raw, temp_q);
+    sink = temp_q[0];
+}
+
+static void
+bench_calib_decode_frame(void) {
+    calib_decode_frame(&calib, &raw, temp_q);
+    sink = temp_q[0];
+}
+
+static void
+bench_decode_frame_float(void) {
+    amg88_decode_frame_float(&raw, temp_f);
+    sink = temp_f[0];
+}
+
+static void
+bench_array_macros(void) {
+    sink = AMG88_ARRAY_MIN(temp_f) + AMG88_ARRAY_MAX(temp_f) + AMG88_ARRAY_MEAN(temp_f);
+}
+
+static void
+bench_frame_stats(void) {
+    amg88_stats_t stats;
+
+    amg88_frame_stats(temp_q, AMG88_ARRAY_SIZE, &stats, NULL);
+    sink = stats.variance;
+}
+
+static void
+bench_upscale_bilinear(void) {
+    interp_upscale(temp_q, upscaled, scratch, 8, INTERP_BILINEAR);
+    sink = upscaled[0];
+}
+
+static void
+bench_upscale_bicubic(void) {
+    interp_upscale(temp_q, upscaled, scratch, 8, INTERP_BICUBIC);
+    sink = upscaled[0];
+}
+
+static void
+bench_render(void) {
+    render_frame(&render, upscaled, 64, 64, image, 64 * 2);
+    sink = image[0];
+}
+
+/* The warm column of the sequence moves every frame, so there is always a blob to label */
+static void
+bench_detect(void) {
+    static size_t f;
+
+    sink = detect_update(&detector, scene[f++ % BENCH_FRAMES]);
+}
+
+/* Same moving column, one hotspot per frame kept on a track */
+static void
+bench_track(void) {
+    static size_t f;
+    static uint64_t t_us;
+
+    t_us += 100000;
+    sink = track_update(&tracker, scene[f++ % BENCH_FRAMES], t_us);
+}
+
+/* On a copy, the scene frames are shared with the other rows */
+static void
+bench_tfilter(void) {
+    static size_t f;
+    int16_t temp[AMG88_ARRAY_SIZE];
+
+    memcpy(temp, scene[f++ % BENCH_FRAMES], sizeof(temp));
+    tfilter_update(&temporal, temp);
+    sink = temp[0];
+}
+
+static void
+bench_frame_sync(void) {
+    static uint64_t t_us;
+
+    /* Alternate new and duplicate reads */
+    t_us += 50000;
+    raw.pixels[0] ^= (uint8_t) ((t_us / 50000) & 1);
+    sink = frame_sync_check(&sync_state, &raw, t_us, t_us + 3000);
+}
+
+static void
+bench_metrics_probe(void) {
+    uint32_t cycles = METRICS_START();
+
+    METRICS_STOP(METRICS_DECODE, cycles);
+}
+
+static void
+bench_codec(void) {
+    size_t len;
+
+    raw = frames[(size_t) sink % BENCH_FRAMES];
+    len = frame_codec_encode(&enc, &raw, encoded);
+    frame_codec_decode(&dec, encoded, len, &raw);
+    sink = (float) len;
+}
+
+static const bench_t driver_benches[] = {
+    { "amg88_get_pixel x64",           bench_get_pixel_loop },
+    { "amg88_get_array",               bench_get_array },
+    { "amg88_get_frame_raw",           bench_get_frame_raw },
+    { "amg88_get_frame_raw +therm",    bench_get_frame_raw_th },
+    { "amg88_get_thermistor",          bench_get_thermistor },
+    { "amg88_get_frame_rate",          bench_get_frame_rate },
+    { "scene reconfig",                bench_reconfig_single },
+    { "scene reconfig, batched",       bench_reconfig_batch },
+};
+
+static const bench_t proc_benches[] = {
+    { "AMG88_PIXEL_2_TEMP x64",        bench_macro_decode },
+    { "amg88_decode_frame",            bench_decode_frame },
+    { "calib_decode_frame",            bench_calib_decode_frame },
+    { "amg88_decode_frame_float",      bench_decode_frame_float },
+    { "AMG88_ARRAY_MIN/MAX/MEAN",      bench_array_macros },
+    { "amg88_frame_stats",             bench_frame_stats },
+    { "interp_upscale x8 bilinear",    bench_upscale_bilinear },
+    { "interp_upscale x8 bicubic",     bench_upscale_bicubic },
+    { "render_frame 64x64 rgb565",     bench_render },
+    { "frame_codec encode+decode",     bench_codec },
+    { "frame_sync_check",              bench_frame_sync },
+    { "detect_update",                 bench_detect },
+    { "track_update quadratic",        bench_track },
+    { "tfilter_update kalman",         bench_tfilter },
+    { "METRICS_START/STOP",            bench_metrics_probe },
+};
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint64_t
+run_cpu(const bench_t* p_bench, uint32_t iters) {
+    uint64_t start;
+
+    p_bench->fn();                              /* Warm up */
+    start = now_ns();
+    for (uint32_t i = 0; i < iters; ++i) {
+        p_bench->fn();
+    }
+
+    return (now_ns() - start) / iters;
+}
+
+static void
+run_driver(const bench_t* p_bench, uint32_t iters, uint32_t xfer_ns) {
+    static const uint32_t bus_hz[] = { 100000, 400000 };
+    double bus_us[ARRAY_LEN(bus_hz)];
+    double xfers = 0;
+    uint64_t cpu_ns;
+
+    for (size_t b = 0; b < ARRAY_LEN(bus_hz); ++b) {
+        amg88_sim_set_bus(&sim, bus_hz[b], xfer_ns, false);
+        amg88_sim_reset_stats(&sim);
+        for (uint32_t i = 0; i < iters; ++i) {
+            p_bench->fn();
+        }
+        xfers = (double) (sim.stats.reads + sim.stats.writes) / iters;
+        bus_us[b] = (double) sim.stats.bus_ns / iters / 1000.0;
+    }
+
+    /* Host CPU time of the driver itself, without modelled bus time */
+    amg88_sim_set_bus(&sim, 0, 0, false);
+    cpu_ns = run_cpu(p_bench, iters);
+
+    printf("%-30s %10.1f %14.1f %14.1f %14llu\n", p_bench->name, xfers, bus_us[0], bus_us[1],
+           (unsigned long long) cpu_ns);
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-n iterations] [-x transaction_overhead_ns]\n", name);
+}
+
+int
+main(int argc, char** argv) {
+    uint32_t iters = 100000, xfer_ns = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:x:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iters = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'x':
+                xfer_ns = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iters == 0) {
+        iters = 1;
+    }
+
+    make_frames();
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    amg88_sim_set_frames(&sim, frames, BENCH_FRAMES);
+    amg88_sim_attach(&sim, &dev);
+
+    frame_sync_init(&sync_state, 100000, 0);
+    frame_codec_enc_init(&enc, 10);
+    frame_codec_dec_init(&dec);
+    calib_init(&calib);
+    render_init(&render, RENDER_PALETTE_IRON, RENDER_RGB565);
+    render_set_window(&render, 0, 160);
+    detect_init(&detector, &(detect_cfg_t) { .bg_shift = 6, .fg_shift = 10, .threshold = 6, .min_pixels = 1 });
+    tfilter_init(&temporal, &(tfilter_cfg_t) { .mode = TFILTER_KALMAN, .q = 16, .r = 256, .step = 8 });
+    track_init(&tracker, &(track_cfg_t) { .threshold = 0, .refine = TRACK_REFINE_QUADRATIC, .gate = 2 << 8,
+                                          .alpha = 128, .beta = 32, .confirm_hits = 3, .max_misses = 3 });
+    for (size_t f = 0; f < BENCH_FRAMES; ++f) {
+        amg88_decode_frame(&frames[f], scene[f]);
+    }
+
+    printf("%-30s %10s %14s %14s %14s\n", "driver entry point", "xfer/frame", "bus us @100k", "bus us @400k",
+           "cpu ns/frame");
+    for (size_t i = 0; i < ARRAY_LEN(driver_benches); ++i) {
+        run_driver(&driver_benches[i], iters, xfer_ns);
+    }
+
+    printf("\n%-30s %14s\n", "processing", "cpu ns/frame");
+    amg88_get_frame_raw(&dev, &raw, 1);
+    amg88_decode_frame_float(&raw, temp_f);
+    amg88_decode_frame(&raw, temp_q);
+    interp_upscale(temp_q, upscaled, scratch, 8, INTERP_BICUBIC);
+    for (size_t i = 0; i < ARRAY_LEN(proc_benches); ++i) {
+        printf("%-30s %14llu\n", proc_benches[i].name, (unsigned long long) run_cpu(&proc_benches[i], iters));
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * \file            async_bench.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Blocking vs non-blocking frame reads against a simulated bus with real latency
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amg88/amg88_async.h"
+#include "amg88_sim.h"
+#include "i2c_async/i2c_async.h"
+#include "interp/interp.h"
+#include "render/render.h"
+
+#define BENCH_FRAMES    16                      /* Frames in the simulated sequence */
+#define BENCH_SCALE     8                       /* Upscale factor of the processing stage */
+
+/* Vars */
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static i2c_async_t worker;
+static amg88_frame_raw_t frames[BENCH_FRAMES];
+static amg88_frame_raw_t raw[2];
+static int16_t temp_q[AMG88_ARRAY_SIZE];
+static int16_t upscaled[INTERP_OUT_LEN(BENCH_SCALE)];
+static int32_t scratch[INTERP_TMP_LEN(BENCH_SCALE)];
+static uint8_t image[INTERP_OUT_LEN(BENCH_SCALE) * 2];
+static render_t render;
+
+
+static uint64_t
+now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void
+make_frames(void) {
+    srand(1);
+    for (size_t f = 0; f < BENCH_FRAMES; ++f) {
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            uint16_t reg = (uint16_t) (80 + rand() % 40 + (i % 8 == f % 8 ? 48 : 0));
+
+            frames[f].pixels[2 * i] = (uint8_t) reg;
+            frames[f].pixels[2 * i + 1] = (uint8_t) (reg >> 8);
+        }
+        frames[f].thermistor[0] = 0x90;
+        frames[f].thermistor[1] = 0x01;
+    }
+}
+
+/* Decode, upscale and render over and over for a fixed time, the result only depends on the frame */
+static uint32_t
+process(const amg88_frame_raw_t* p_raw, uint32_t compute_us) {
+    uint64_t end_ns = now_ns() + (uint64_t) compute_us * 1000;
+    uint32_t sum = 0;
+
+    do {
+        amg88_decode_frame(p_raw, temp_q);
+        interp_upscale(temp_q, upscaled, scratch, BENCH_SCALE, INTERP_BICUBIC);
+        render_frame(&render, upscaled, AMG88_ARRAY_COLS * BENCH_SCALE, AMG88_ARRAY_ROWS * BENCH_SCALE, image,
+                     AMG88_ARRAY_COLS * BENCH_SCALE * 2);
+    } while (now_ns() < end_ns);
+
+    for (size_t i = 0; i < sizeof(image); ++i) {
+        sum = sum * 31 + image[i];
+    }
+
+    return sum;
+}
+
+/* Runs on the bus worker once both bursts are in, the next read sees the next frame */
+static void
+frame_done(amg88_err_t err, void* arg) {
+    (void) err;
+    (void) arg;
+    amg88_sim_next_frame(&sim);
+}
+
+static uint64_t
+run_blocking(uint32_t n, uint32_t compute_us, uint32_t* p_sum) {
+    uint64_t t0 = now_ns();
+
+    *p_sum = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (amg88_get_frame_raw(&dev, &raw[0], 1) != AMG88_OK) {
+            fprintf(stderr, "Blocking read %u failed\n", i);
+        }
+        amg88_sim_next_frame(&sim);
+        *p_sum += process(&raw[0], compute_us);
+    }
+
+    return now_ns() - t0;
+}
+
+/* Double buffered: frame i+1 is on the wire while frame i is processed */
+static uint64_t
+run_async(uint32_t n, uint32_t compute_us, uint32_t* p_sum, uint32_t* p_ready) {
+    amg88_xfer_t xfer[2];
+    amg88_err_t err;
+    uint64_t t0 = now_ns();
+
+    *p_sum = 0;
+    *p_ready = 0;
+    amg88_xfer_init(&xfer[0]);
+    amg88_xfer_init(&xfer[1]);
+
+    amg88_get_frame_raw_async(&dev, &xfer[0], &raw[0], 1, frame_done, NULL);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint8_t cur = i % 2;
+
+        /* Poll first, only block when the bus is the bottleneck */
+        if (amg88_xfer_poll(&xfer[cur], &err)) {
+            ++*p_ready;
+        } else {
+            err = amg88_xfer_wait(&xfer[cur], OSAL_WAIT_FOREVER);
+        }
+        if (err != AMG88_OK) {
+            fprintf(stderr, "Async read %u failed: %d\n", i, err);
+        }
+        if (i + 1 < n) {
+            amg88_get_frame_raw_async(&dev, &xfer[!cur], &raw[!cur], 1, frame_done, NULL);
+        }
+        *p_sum += process(&raw[cur], compute_us);
+    }
+
+    return now_ns() - t0;
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-n frames] [-b bus_hz] [-c compute_us]\n", name);
+}
+
+int
+main(int argc, char** argv) {
+    uint32_t n = 50, bus_hz = 100000, compute_us = 8000;
+    uint32_t sum_sync, sum_async, ready;
+    uint64_t bus_ns, sync_ns, async_ns;
+    double read_us, per_sync, per_async, best;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:b:c:")) != -1) {
+        switch (opt) {
+            case 'n': n = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'b': bus_hz = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'c': compute_us = (uint32_t) strtoul(optarg, NULL, 0); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    make_frames();
+    render_init(&render, RENDER_PALETTE_IRON, RENDER_RGB565);
+    render_set_window(&render, 0, 200);
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    amg88_sim_set_frames(&sim, frames, BENCH_FRAMES);
+    amg88_sim_set_bus(&sim, bus_hz, 50000, true);
+    if (amg88_sim_attach(&sim, &dev) != AMG88_OK
+        || i2c_async_init(&worker, 0, amg88_sim_read, 0, OSAL_CORE_ANY) != OSAL_OK) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+    dev.read_async = i2c_async_read;
+
+    amg88_sim_reset_stats(&sim);
+    sync_ns = run_blocking(n, compute_us, &sum_sync);
+    bus_ns = sim.stats.bus_ns;
+    amg88_sim_set_frames(&sim, frames, BENCH_FRAMES);
+    async_ns = run_async(n, compute_us, &sum_async, &ready);
+
+    read_us = (double) bus_ns / n / 1000.0;
+    per_sync = (double) sync_ns / n / 1000.0;
+    per_async = (double) async_ns / n / 1000.0;
+    best = read_us > compute_us ? read_us : compute_us;
+
+    printf("%u frames, bus %u Hz: read %.0f us/frame, compute %u us/frame\n", n, bus_hz, read_us, compute_us);
+    printf("%-24s %12s %10s\n", "mode", "us/frame", "fps");
+    printf("%-24s %12.0f %10.1f\n", "blocking", per_sync, 1e6 / per_sync);
+    printf("%-24s %12.0f %10.1f\n", "non-blocking", per_async, 1e6 / per_async);
+    printf("%-24s %12.0f %10.1f\n", "bound max(read, compute)", best, 1e6 / best);
+    printf("Bus time hidden: %.0f%% of the shorter stage, frame ready on arrival %u/%u\n",
+           100.0 * (per_sync - per_async) / (read_us < compute_us ? read_us : compute_us), ready, n);
+    printf("Outputs %s\n", sum_sync == sum_async ? "match" : "DIFFER");
+
+    return sum_sync == sum_async ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * \file            codec_bench.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame codec on synthetic scenes: compression ratio and encode/decode throughput
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "frame_codec/frame_codec.h"
+
+#define BENCH_RAW_SIZE  (AMG88_ARRAY_SIZE * 2 + 2) /* Frame as read from the sensor, pixels + thermistor */
+#define BENCH_KEY_EVERY 10                      /* Keyframe interval, CFG_STREAM_KEY_INTERVAL in the firmware */
+#define BENCH_BASE      (25 * 4)                /* Background, 25 C in 0.25 C LSB */
+
+/* Synthetic scene, fills frame `n` */
+typedef void (*scene_fn)(uint32_t n, amg88_frame_raw_t* p_frame);
+
+typedef struct {
+    const char* name;
+    scene_fn fn;
+} scene_t;
+
+/* Vars */
+static volatile uint8_t sink;
+
+
+static uint64_t
+now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void
+set_px(amg88_frame_raw_t* p_frame, size_t i, int32_t val) {
+    val = val > 2047 ? 2047 : val < -2048 ? -2048 : val;
+    p_frame->pixels[2 * i] = (uint8_t) val;
+    p_frame->pixels[2 * i + 1] = (uint8_t) (val >> 8) & 0x0F;
+}
+
+/* +-1 LSB of sensor noise, about what a still room shows */
+static int32_t
+noise(void) {
+    return rand() % 3 - 1;
+}
+
+static void
+scene_static(uint32_t n, amg88_frame_raw_t* p_frame) {
+    (void) n;
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        set_px(p_frame, i, BENCH_BASE + (int32_t) (i % 8) + noise());
+    }
+}
+
+/* Whole room warming up, 1 LSB every 50 frames */
+static void
+scene_drift(uint32_t n, amg88_frame_raw_t* p_frame) {
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        set_px(p_frame, i, BENCH_BASE + (int32_t) (n / 50) + (int32_t) (i % 8) + noise());
+    }
+}
+
+/* A person (about 34 C) walking across the array, one column every 5 frames */
+static void
+scene_hotspot(uint32_t n, amg88_frame_raw_t* p_frame) {
+    double cx = (double) ((n / 5) % 12) - 2.0, cy = 3.5;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        double dx = (double) (i % 8) - cx, dy = (double) (i / 8) - cy;
+        double heat = 36.0 * exp(-(dx * dx + dy * dy) / 3.0);
+
+        set_px(p_frame, i, BENCH_BASE + (int32_t) heat + noise());
+    }
+}
+
+/* Worst case: every pixel all over the place, should fall back to keyframes */
+static void
+scene_noisy(uint32_t n, amg88_frame_raw_t* p_frame) {
+    (void) n;
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        set_px(p_frame, i, BENCH_BASE + rand() % 400 - 200);
+    }
+}
+
+static void
+bench_scene(const scene_t* p_scene, uint32_t n_frames) {
+    amg88_frame_raw_t* p_frames = malloc(n_frames * sizeof(*p_frames));
+    uint8_t* p_enc = malloc((size_t) n_frames * FRAME_CODEC_MAX_SIZE);
+    size_t* p_len = malloc(n_frames * sizeof(*p_len));
+    frame_codec_enc_t enc;
+    frame_codec_dec_t dec;
+    amg88_frame_raw_t back;
+    uint64_t start, enc_ns, dec_ns, bytes = 0;
+    uint32_t deltas = 0, bad = 0;
+
+    if (p_frames == NULL || p_enc == NULL || p_len == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    srand(1);
+    for (uint32_t n = 0; n < n_frames; ++n) {
+        memset(&p_frames[n], 0, sizeof(p_frames[n]));
+        p_scene->fn(n, &p_frames[n]);
+        p_frames[n].thermistor[0] = 0x90;       /* 25 C, constant over a run */
+    }
+
+    frame_codec_enc_init(&enc, BENCH_KEY_EVERY);
+    start = now_ns();
+    for (uint32_t n = 0; n < n_frames; ++n) {
+        p_len[n] = frame_codec_encode(&enc, &p_frames[n], &p_enc[(size_t) n * FRAME_CODEC_MAX_SIZE]);
+    }
+    enc_ns = now_ns() - start;
+
+    frame_codec_dec_init(&dec);
+    start = now_ns();
+    for (uint32_t n = 0; n < n_frames; ++n) {
+        bad += frame_codec_decode(&dec, &p_enc[(size_t) n * FRAME_CODEC_MAX_SIZE], p_len[n], &back)
+               != FRAME_CODEC_OK;
+        sink = back.pixels[n % sizeof(back.pixels)];
+    }
+    dec_ns = now_ns() - start;
+
+    /* Checked apart from the timed loop */
+    frame_codec_dec_init(&dec);
+    for (uint32_t n = 0; n < n_frames; ++n) {
+        bytes += p_len[n];
+        deltas += p_enc[(size_t) n * FRAME_CODEC_MAX_SIZE] == FRAME_CODEC_DELTA;
+        bad += frame_codec_decode(&dec, &p_enc[(size_t) n * FRAME_CODEC_MAX_SIZE], p_len[n], &back) != FRAME_CODEC_OK
+               || memcmp(&back, &p_frames[n], sizeof(back)) != 0;
+    }
+
+    /* Throughput is on the raw frame size, the bytes the sensor hands over */
+    printf("%-10s %8.2f %8.2f %7.1f%% %10.1f %10.1f %6u\n", p_scene->name,
+           (double) BENCH_RAW_SIZE * n_frames / bytes, (double) FRAME_CODEC_MAX_SIZE * n_frames / bytes,
+           100.0 * deltas / n_frames, (double) BENCH_RAW_SIZE * n_frames * 1000.0 / (enc_ns ? enc_ns : 1),
+           (double) BENCH_RAW_SIZE * n_frames * 1000.0 / (dec_ns ? dec_ns : 1), bad);
+
+    free(p_frames);
+    free(p_enc);
+    free(p_len);
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-n frames]\n", name);
+}
+
+int
+main(int argc, char** argv) {
+    static const scene_t scenes[] = {
+        { "static", scene_static },
+        { "drift", scene_drift },
+        { "hotspot", scene_hotspot },
+        { "noisy", scene_noisy },
+    };
+    uint32_t n_frames = 200000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                n_frames = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (n_frames == 0) {
+        n_frames = 1;
+    }
+
+    printf("%u frames per scene, keyframe every %u, ratios vs raw (%u B) and packed (%u B) frames\n", n_frames,
+           BENCH_KEY_EVERY, BENCH_RAW_SIZE, FRAME_CODEC_MAX_SIZE);
+    printf("%-10s %8s %8s %8s %10s %10s %6s\n", "scene", "raw:enc", "pack:enc", "deltas", "enc MB/s", "dec MB/s",
+           "bad");
+    for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); ++i) {
+        bench_scene(&scenes[i], n_frames);
+    }
+
+    return 0;
+}
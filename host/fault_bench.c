@@ -0,0 +1,211 @@
+/**
+ * \file            fault_bench.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame read retry policies against a simulated bus with injected NACKs and stuck buses
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amg88/amg88.h"
+#include "amg88_sim.h"
+#include "osal/osal.h"
+
+#define BENCH_FRAMES    16                      /* Frames in the simulated sequence */
+#define BENCH_MAX_N     10000                   /* Most frames per policy */
+#define BENCH_SEED      7                       /* Fault injection seed, same for every policy */
+
+/**
+ * \brief           Read policy under test
+ */
+typedef struct {
+    const char* name;
+    amg88_retry_t retry;
+    uint8_t frame_retries;                      /* Whole frame read again on any error, the old way */
+    bool recover;                               /* Bus recovery hooked */
+} policy_t;
+
+/**
+ * \brief           Outcome of a policy run
+ */
+typedef struct {
+    uint32_t complete;                          /* Every pixel and the thermistor read */
+    uint32_t partial;                           /* Some pixels read */
+    uint32_t lost;                              /* Nothing usable */
+    uint32_t corrupt;                           /* Pixels flagged valid that are not the frame's */
+    uint64_t pixels_lost;
+    uint32_t retries;
+    uint32_t recoveries;
+    uint32_t faults;                            /* Injected failures, NACKs and timeouts */
+    uint32_t stuck;                             /* Bus hold downs */
+    double p50_us, p99_us, max_us;
+} result_t;
+
+/* Vars */
+static amg88_sim_t sim;
+static amg88_dev_t dev;
+static amg88_frame_raw_t frames[BENCH_FRAMES];
+static double lat_us[BENCH_MAX_N];
+
+static const policy_t policies[] = {
+    { "single burst",       { 1, 0, 0 },        0, false },
+    { "frame retry x2",     { 1, 0, 0 },        2, false },
+    { "8 bursts, recovery", { 8, 2, 30000 },    0, true },
+};
+
+
+static uint64_t
+now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void
+make_frames(void) {
+    srand(1);
+    for (size_t f = 0; f < BENCH_FRAMES; ++f) {
+        for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            uint16_t reg = (uint16_t) (80 + rand() % 40 + f);
+
+            frames[f].pixels[2 * i] = (uint8_t) reg;
+            frames[f].pixels[2 * i + 1] = (uint8_t) (reg >> 8);
+        }
+        frames[f].thermistor[0] = 0x90;
+        frames[f].thermistor[1] = 0x01;
+    }
+}
+
+static int
+cmp_double(const void* a, const void* b) {
+    double x = *(const double*) a, y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+static void
+run(const policy_t* p_pol, uint32_t n, uint32_t nack_ppm, uint32_t stuck_ppm, result_t* p_res) {
+    amg88_frame_raw_t raw;
+    amg88_frame_status_t status;
+
+    memset(p_res, 0, sizeof(*p_res));
+    dev.retry = p_pol->retry;
+    dev.recover = p_pol->recover ? amg88_sim_recover : NULL;
+    dev.clock_us = osal_time_us;
+    amg88_sim_set_frames(&sim, frames, BENCH_FRAMES);
+    amg88_sim_inject_random(&sim, AMG88_ERR_I2C, nack_ppm, BENCH_SEED);
+    amg88_sim_inject_stuck(&sim, stuck_ppm, 64);
+    sim.stuck_left = 0;
+    amg88_sim_reset_stats(&sim);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const amg88_frame_raw_t* p_ref = &frames[i % BENCH_FRAMES];
+        uint64_t t0 = now_ns();
+
+        memset(&raw, 0, sizeof(raw));
+        for (uint8_t attempt = 0; attempt <= p_pol->frame_retries; ++attempt) {
+            if (amg88_get_frame_raw_status(&dev, &raw, 1, &status) == AMG88_OK) {
+                break;
+            }
+        }
+        lat_us[i] = (double) (now_ns() - t0) / 1000.0;
+        amg88_sim_next_frame(&sim);
+
+        if (status.err == AMG88_OK) {
+            p_res->complete++;
+        } else if (status.valid != 0) {
+            p_res->partial++;
+        } else {
+            p_res->lost++;
+        }
+        for (size_t px = 0; px < AMG88_ARRAY_SIZE; ++px) {
+            if (!(status.valid >> px & 1)) {
+                p_res->pixels_lost++;
+            } else if (memcmp(&raw.pixels[2 * px], &p_ref->pixels[2 * px], 2) != 0) {
+                p_res->corrupt++;
+            }
+        }
+        p_res->retries += status.retries;
+    }
+
+    p_res->recoveries = sim.stats.recoveries;
+    p_res->faults = sim.stats.errors;
+    p_res->stuck = sim.stats.stuck;
+    qsort(lat_us, n, sizeof(lat_us[0]), cmp_double);
+    p_res->p50_us = lat_us[n / 2];
+    p_res->p99_us = lat_us[(n * 99) / 100];
+    p_res->max_us = lat_us[n - 1];
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-n frames] [-b bus_hz] [-e nack_ppm] [-s stuck_ppm] [-t timeout_us]\n", name);
+}
+
+int
+main(int argc, char** argv) {
+    uint32_t n = 300, bus_hz = 400000, nack_ppm = 150, stuck_ppm = 20, timeout_us = 20000;
+    const size_t n_pol = sizeof(policies) / sizeof(policies[0]);
+    result_t res[sizeof(policies) / sizeof(policies[0])];
+    const result_t* p_base;
+    const result_t* p_new;
+    bool better;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:b:e:s:t:")) != -1) {
+        switch (opt) {
+            case 'n': n = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'b': bus_hz = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'e': nack_ppm = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 's': stuck_ppm = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 't': timeout_us = (uint32_t) strtoul(optarg, NULL, 0); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (n == 0 || n > BENCH_MAX_N) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    make_frames();
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    amg88_sim_set_bus(&sim, bus_hz, 50000, true);
+    sim.timeout_us = timeout_us;
+    if (amg88_sim_attach(&sim, &dev) != AMG88_OK) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+
+    printf("%u frames, bus %u Hz, NACK %u ppm/byte, stuck %u ppm/byte, timeout %u us\n", n, bus_hz, nack_ppm,
+           stuck_ppm, timeout_us);
+    printf("%-20s %8s %8s %6s %8s %7s %7s %6s %9s %9s %9s\n", "policy", "complete", "partial", "lost", "px lost",
+           "retries", "recov", "stuck", "p50 us", "p99 us", "max us");
+    for (size_t p = 0; p < n_pol; ++p) {
+        run(&policies[p], n, nack_ppm, stuck_ppm, &res[p]);
+        printf("%-20s %8u %8u %6u %8llu %7u %7u %6u %9.0f %9.0f %9.0f\n", policies[p].name, res[p].complete,
+               res[p].partial, res[p].lost, (unsigned long long) res[p].pixels_lost, res[p].retries,
+               res[p].recoveries, res[p].stuck, res[p].p50_us, res[p].p99_us, res[p].max_us);
+        if (res[p].corrupt != 0) {
+            printf("  %u pixels flagged valid but wrong\n", res[p].corrupt);
+        }
+    }
+
+    /* Fewer pixels lost than the single burst read, and a latency bound unlike the frame retry */
+    p_base = &res[0];
+    p_new = &res[n_pol - 1];
+    better = p_new->corrupt == 0 && p_new->pixels_lost <= p_base->pixels_lost && p_new->lost <= p_base->lost
+             && p_new->max_us <= policies[n_pol - 1].retry.budget_us + timeout_us + 5000.0;
+    printf("Burst retry with recovery: %.2f%% of pixels lost (single burst %.2f%%), worst frame %.1f ms -> %s\n",
+           100.0 * (double) p_new->pixels_lost / ((double) n * AMG88_ARRAY_SIZE),
+           100.0 * (double) p_base->pixels_lost / ((double) n * AMG88_ARRAY_SIZE), p_new->max_us / 1000.0,
+           better ? "PASS" : "FAIL");
+
+    return better ? 0 : 1;
+}
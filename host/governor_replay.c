@@ -0,0 +1,277 @@
+/**
+ * \file            governor_replay.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Replays scripted scenes through the activity governor and a simulated sensor, shows its decisions
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "amg88/amg88.h"
+#include "calib/calib.h"
+#include "governor/governor.h"
+#include "amg88_sim.h"
+
+#define REPLAY_BG       88                      /* 22 degrees, 1/4 degree units */
+#define REPLAY_BODY     128                     /* 32 degrees */
+#define REPLAY_S(s)     ((uint64_t) (s) * 1000000)
+
+/**
+ * \brief           A scripted scene and what the governor is expected to do with it
+ */
+typedef struct {
+    const char* name;                           /* Scene name */
+    const char* desc;                           /* What happens */
+    uint32_t duration_s;                        /* Replay length */
+    void (*render)(uint64_t t_us, int16_t* p_temp);
+    uint32_t max_switches;                      /* Level changes allowed */
+    gov_level_t final;                          /* Level at the end of the replay */
+    uint32_t motion_s;                          /* Motion starts here, `0` for none */
+    uint32_t max_latency_ms;                    /* Max time from the motion start to GOV_ACTIVE */
+} replay_scene_t;
+
+/* Vars */
+static uint32_t rng = 1;
+static int16_t pattern[AMG88_ARRAY_SIZE];
+static bool verbose;
+
+
+static int16_t
+noise(int16_t amplitude) {
+    rng = rng * 1103515245u + 12345u;
+
+    return (int16_t) ((int32_t) ((rng >> 16) % (2 * amplitude + 1)) - amplitude);
+}
+
+/* Static room: fixed pattern plus one LSB of read noise */
+static void
+render_room(int16_t* p_temp, int16_t offset) {
+    for (uint8_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        p_temp[i] = (int16_t) (REPLAY_BG + offset + pattern[i] + noise(1));
+    }
+}
+
+/* Person 2 pixels wide and 4 tall, `x` in 1/1000 pixel */
+static void
+render_body(int16_t* p_temp, int32_t x) {
+    int32_t col = (x + 500) / 1000;
+
+    for (uint8_t row = 2; row < 6; ++row) {
+        for (int32_t c = col; c < col + 2; ++c) {
+            if (c >= 0 && c < AMG88_ARRAY_ROWS) {
+                p_temp[row * AMG88_ARRAY_ROWS + c] = (int16_t) (REPLAY_BODY + noise(1));
+            }
+        }
+    }
+}
+
+static void
+scene_empty(uint64_t t_us, int16_t* p_temp) {
+    (void) t_us;
+    render_room(p_temp, 0);
+}
+
+/* Empty until 93 s, walks in at 1 pixel/s, sits still from 99 s, walks out at 200 s */
+static void
+scene_visitor(uint64_t t_us, int16_t* p_temp) {
+    render_room(p_temp, 0);
+    if (t_us >= REPLAY_S(93) && t_us < REPLAY_S(99)) {
+        render_body(p_temp, -1000 + (int32_t) ((t_us - REPLAY_S(93)) / 1000));
+    } else if (t_us >= REPLAY_S(99) && t_us < REPLAY_S(200)) {
+        render_body(p_temp, 5000);
+    } else if (t_us >= REPLAY_S(200) && t_us < REPLAY_S(204)) {
+        render_body(p_temp, 5000 + (int32_t) ((t_us - REPLAY_S(200)) / 1000));
+    }
+}
+
+/* Single pixel spikes every few seconds, below the on threshold */
+static void
+scene_flicker(uint64_t t_us, int16_t* p_temp) {
+    render_room(p_temp, 0);
+    if ((t_us / 100000) % 37 == 0) {
+        p_temp[(t_us / 100000) % AMG88_ARRAY_SIZE] += 20;
+    }
+}
+
+/* Heating warms the whole room by 2 degrees over 5 minutes */
+static void
+scene_drift(uint64_t t_us, int16_t* p_temp) {
+    render_room(p_temp, (int16_t) (t_us * 8 / REPLAY_S(300)));
+}
+
+/* Someone working at a desk: short bursts of motion every 25 s */
+static void
+scene_desk(uint64_t t_us, int16_t* p_temp) {
+    uint64_t phase_us = t_us % REPLAY_S(25);
+
+    render_room(p_temp, 0);
+    render_body(p_temp, phase_us < REPLAY_S(2) ? 3000 + (int32_t) (phase_us / 1000) : 3000);
+}
+
+static const replay_scene_t scenes[] = {
+    { "empty", "static room", 300, scene_empty, 2, GOV_STANDBY, 0, 0 },
+    { "visitor", "walks in from stand-by, sits still, walks out", 400, scene_visitor, 8, GOV_STANDBY, 93, 10100 },
+    { "flicker", "single pixel spikes", 300, scene_flicker, 2, GOV_STANDBY, 0, 0 },
+    { "drift", "room warming by 2 degrees", 300, scene_drift, 2, GOV_STANDBY, 0, 0 },
+    { "desk", "2 s of motion every 25 s", 300, scene_desk, 30, GOV_IDLE, 0, 0 },
+};
+
+static const char*
+level_name(gov_level_t level) {
+    static const char* names[GOV_LEVELS] = { "ACTIVE", "IDLE", "STANDBY" };
+
+    return level < GOV_LEVELS ? names[level] : "?";
+}
+
+/* The sensor is read once per frame period of the current level, as the synced pipeline does */
+static bool
+replay(const replay_scene_t* p_scene, const governor_cfg_t* p_cfg) {
+    static amg88_frame_raw_t frame;
+    amg88_sim_t sim;
+    amg88_dev_t dev = { 0 };
+    governor_t gov;
+    int16_t temp[AMG88_ARRAY_SIZE];
+    uint64_t t_us = 0, end_us = REPLAY_S(p_scene->duration_s), active_us = 0;
+    uint64_t baseline_bytes, bytes;
+    bool ok = true;
+
+    rng = 1;
+    amg88_sim_detach_all();
+    amg88_sim_init(&sim, 0, AMG88_I2C_ADDR_LOW);
+    amg88_sim_attach(&sim, &dev);
+    governor_init(&gov, p_cfg);
+    governor_apply(&gov, &dev);
+
+    printf("\n== %s: %s, %u s\n", p_scene->name, p_scene->desc, p_scene->duration_s);
+    while (t_us < end_us) {
+        p_scene->render(t_us, temp);
+        calib_pack_frame(temp, &frame);
+        amg88_sim_set_frames(&sim, &frame, 1);
+        if (amg88_get_frame_raw(&dev, &frame, false) != AMG88_OK) {
+            fprintf(stderr, "Read failed\n");
+            return false;
+        }
+        amg88_decode_frame(&frame, temp);
+
+        if (governor_update(&gov, temp, t_us)) {
+            governor_apply(&gov, &dev);
+            printf("  %8.1f s  -> %-8s (%u changed pixels)\n", t_us / 1e6, level_name(gov.level), gov.changed);
+            if (gov.level == GOV_ACTIVE && active_us == 0 && p_scene->motion_s != 0
+                && t_us >= REPLAY_S(p_scene->motion_s)) {
+                active_us = t_us;
+            }
+        } else if (verbose) {
+            printf("  %8.1f s     %-8s (%u changed pixels)\n", t_us / 1e6, level_name(gov.level), gov.changed);
+        }
+        t_us += governor_period_us(gov.level);
+    }
+
+    /* What the same replay costs at a fixed 10 FPS */
+    bytes = sim.stats.bytes_read + sim.stats.bytes_written;
+    baseline_bytes = (uint64_t) sim.stats.bytes_read / gov.stats.frames * (end_us / governor_period_us(GOV_ACTIVE));
+    printf("  frames %u (%llu at 10 FPS), I2C bytes %llu (%.1f%%), switches %u\n", gov.stats.frames,
+           (unsigned long long) (end_us / governor_period_us(GOV_ACTIVE)), (unsigned long long) bytes,
+           100.0 * bytes / baseline_bytes, gov.stats.switches);
+    printf("  time ACTIVE %.1f s, IDLE %.1f s, STANDBY %.1f s\n", gov.stats.level_us[GOV_ACTIVE] / 1e6,
+           gov.stats.level_us[GOV_IDLE] / 1e6, gov.stats.level_us[GOV_STANDBY] / 1e6);
+
+    if (gov.stats.switches > p_scene->max_switches) {
+        printf("  FAIL: %u switches, expected at most %u\n", gov.stats.switches, p_scene->max_switches);
+        ok = false;
+    }
+    if (gov.level != p_scene->final) {
+        printf("  FAIL: ends %s, expected %s\n", level_name(gov.level), level_name(p_scene->final));
+        ok = false;
+    }
+    if (p_scene->motion_s != 0) {
+        if (active_us == 0) {
+            printf("  FAIL: motion at %u s never detected\n", p_scene->motion_s);
+            ok = false;
+        } else {
+            printf("  motion detected after %.1f s\n", (active_us - REPLAY_S(p_scene->motion_s)) / 1e6);
+            if (active_us - REPLAY_S(p_scene->motion_s) > (uint64_t) p_scene->max_latency_ms * 1000) {
+                printf("  FAIL: expected within %u ms\n", p_scene->max_latency_ms);
+                ok = false;
+            }
+        }
+    }
+    if ((sim.regs[AMG88_REG_PCTL] == AMG88_OP_10) != (gov.level == GOV_STANDBY)
+        || (sim.regs[AMG88_REG_FPSC] == AMG88_FPS_1) != (gov.level != GOV_ACTIVE)) {
+        printf("  FAIL: sensor mode 0x%02x/0x%02x does not match the level\n", sim.regs[AMG88_REG_PCTL],
+               sim.regs[AMG88_REG_FPSC]);
+        ok = false;
+    }
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-d pixel_delta] [-o on_pixels] [-f off_pixels] [-i idle_ms] [-s standby_ms] "
+                    "[-v] [scene...]\n", name);
+}
+
+int
+main(int argc, char** argv) {
+    governor_cfg_t cfg = {
+        .pixel_delta = 6,
+        .on_pixels = 2,
+        .off_pixels = 0,
+        .idle_after_ms = 10000,
+        .standby_after_ms = 60000,
+    };
+    uint32_t failed = 0, run = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:o:f:i:s:vh")) != -1) {
+        switch (opt) {
+            case 'd':
+                cfg.pixel_delta = (uint16_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                cfg.on_pixels = (uint8_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                cfg.off_pixels = (uint8_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'i':
+                cfg.idle_after_ms = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                cfg.standby_after_ms = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    for (uint8_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        pattern[i] = noise(2);
+    }
+
+    printf("pixel delta %u, on %u pixels, off %u pixels, idle after %u ms, standby after %u ms\n",
+           cfg.pixel_delta, cfg.on_pixels, cfg.off_pixels, cfg.idle_after_ms, cfg.standby_after_ms);
+    for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); ++i) {
+        bool selected = optind >= argc;
+
+        for (int a = optind; a < argc; ++a) {
+            selected |= strcmp(argv[a], scenes[i].name) == 0;
+        }
+        if (selected) {
+            run++;
+            failed += !replay(&scenes[i], &cfg);
+        }
+    }
+    printf("\n%u of %u scenes passed\n", run - failed, run);
+
+    return failed != 0;
+}
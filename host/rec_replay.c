@@ -0,0 +1,441 @@
+/**
+ * \file            rec_replay.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Replays a frame recording through every processing stage and through the pipeline
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <fcntl.h>
+#include <math.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "amg88/amg88.h"
+#include "amg88_replay.h"
+#include "crc32/crc32.h"
+#include "detect/detect.h"
+#include "frame_rec/frame_rec.h"
+#include "osal/osal.h"
+#include "pipeline/pipeline.h"
+#include "tfilter/tfilter.h"
+#include "track/track.h"
+
+#define REPLAY_PERIOD_US    100000              /* Frame period of generated recordings, 10 FPS */
+#define REPLAY_POLL_MS      10                  /* End of recording polling */
+#define REPLAY_DRAIN_MS     1000                /* Max wait for the last frame to go through the pipeline */
+
+/**
+ * \brief           Processing stages, each one is digested on its own so a change points at its stage
+ */
+typedef enum {
+    STAGE_DECODE,
+    STAGE_FILTER,
+    STAGE_DETECT,
+    STAGE_TRACK,
+    STAGE_COUNT,
+} stage_t;
+
+/**
+ * \brief           Processing chain, the firmware defaults of user_config.h
+ */
+typedef struct {
+    int16_t temp[AMG88_ARRAY_SIZE];
+    tfilter_t filter;
+    detect_t detector;
+    track_tracker_t tracker;
+    uint32_t digest[STAGE_COUNT];
+    uint32_t frames;
+} chain_t;
+
+/* Vars */
+static const char* stage_names[STAGE_COUNT] = { "decode", "filter", "detect", "track" };
+static chain_t direct;
+static chain_t piped;
+static amg88_dev_t dev;
+static amg88_replay_t replay;
+static pipeline_t pipeline;
+static uint8_t out_buf[FRAME_RING_SLOTS];
+static atomic_uint processed;
+static uint32_t rng = 1;
+
+
+static void
+chain_init(chain_t* p_chain) {
+    static const tfilter_cfg_t flt_cfg = { .mode = TFILTER_KALMAN, .iir_shift = 2, .q = 16, .r = 256, .step = 8 };
+    static const detect_cfg_t det_cfg = {
+        .bg_shift = 6, .fg_shift = 10, .threshold = 6, .min_pixels = 1, .warmup = 20,
+    };
+    static const track_cfg_t trk_cfg = {
+        .threshold = 6, .refine = TRACK_REFINE_QUADRATIC, .gate = 2 << TRACK_FRAC_BITS, .alpha = 128, .beta = 32,
+        .confirm_hits = 3, .max_misses = 3,
+    };
+
+    memset(p_chain, 0, sizeof(*p_chain));
+    tfilter_init(&p_chain->filter, &flt_cfg);
+    detect_init(&p_chain->detector, &det_cfg);
+    track_init(&p_chain->tracker, &trk_cfg);
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        p_chain->digest[s] = CRC32_INIT;
+    }
+}
+
+static void
+chain_run(chain_t* p_chain, const amg88_frame_raw_t* p_raw, uint64_t ts_us) {
+    track_tracker_t* p_trk = &p_chain->tracker;
+    detect_t* p_det = &p_chain->detector;
+
+    amg88_decode_frame(p_raw, p_chain->temp);
+    p_chain->digest[STAGE_DECODE] = crc32_update(p_chain->digest[STAGE_DECODE], p_chain->temp, sizeof(p_chain->temp));
+
+    tfilter_update(&p_chain->filter, p_chain->temp);
+    p_chain->digest[STAGE_FILTER] = crc32_update(p_chain->digest[STAGE_FILTER], p_chain->temp, sizeof(p_chain->temp));
+
+    detect_update(p_det, p_chain->temp);
+    p_chain->digest[STAGE_DETECT] = crc32_update(p_chain->digest[STAGE_DETECT], p_det->excess, sizeof(p_det->excess));
+    p_chain->digest[STAGE_DETECT] = crc32_update(p_chain->digest[STAGE_DETECT], p_det->blobs,
+                                                 p_det->n_blobs * sizeof(p_det->blobs[0]));
+
+    track_update(p_trk, p_det->excess, ts_us);
+    p_chain->digest[STAGE_TRACK] = crc32_update(p_chain->digest[STAGE_TRACK], p_trk->tracks, sizeof(p_trk->tracks));
+
+    p_chain->frames++;
+}
+
+static bool
+process(const pipeline_frame_t* p_frame, void* p_out, void* arg) {
+    (void) p_out;
+    chain_run((chain_t*) arg, &p_frame->raw, p_frame->ts_us);
+    atomic_fetch_add(&processed, 1);
+
+    return false;
+}
+
+/* Lockstep: the next record only goes out once the processing task took the last one, nothing is dropped and
+   the read of the next frame still overlaps the processing of this one */
+static void
+pace(void* arg) {
+    pipeline_stats_t stats;
+
+    do {
+        pipeline_get_stats((pipeline_t*) arg, &stats);
+        if (stats.raw.consumed >= stats.raw.published) {
+            break;
+        }
+        sched_yield();
+    } while (true);
+}
+
+static int16_t
+noise(int16_t amplitude) {
+    rng = rng * 1103515245u + 12345u;
+
+    return (int16_t) ((int32_t) ((rng >> 16) % (2 * amplitude + 1)) - amplitude);
+}
+
+/* A room at 22 degrees, one person walking across and back, a second one standing in for a while */
+static void
+make_frame(uint32_t f, amg88_frame_raw_t* p_frame) {
+    double t = f * (REPLAY_PERIOD_US / 1e6);
+    double x0 = 3.5 + 3.0 * sin(t * 0.4), y0 = 3.0 + 0.8 * sin(t * 0.9);
+    bool second = t > 8.0 && t < 20.0;
+
+    for (size_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        double x = (double) (i % AMG88_ARRAY_COLS), y = (double) (i / AMG88_ARRAY_COLS);
+        double v = 88.0 + 0.5 * y;
+
+        v += 40.0 * exp(-((x - x0) * (x - x0) + (y - y0) * (y - y0)) / (2 * 0.7 * 0.7));
+        if (second) {
+            v += 28.0 * exp(-((x - 1.2) * (x - 1.2) + (y - 6.1) * (y - 6.1)) / (2 * 0.8 * 0.8));
+        }
+        uint16_t reg = (uint16_t) ((int16_t) lround(v) + noise(2));
+        p_frame->pixels[2 * i] = (uint8_t) reg;
+        p_frame->pixels[2 * i + 1] = (uint8_t) ((reg >> 8) & 0x0F);
+    }
+    p_frame->thermistor[0] = 0x90 + (uint8_t) (f / 600);
+    p_frame->thermistor[1] = 0x01;
+}
+
+/* Streaming appends, each record goes out as soon as it is built like it would from a live sensor */
+static int
+generate(const char* path, uint32_t n) {
+    uint8_t buf[FRAME_REC_RECORD_SIZE];
+    amg88_frame_raw_t frame;
+    uint64_t ts_us = 1000000;
+    FILE* p_file = fopen(path, "wb");
+
+    if (p_file == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    fwrite(buf, 1, frame_rec_encode_hdr(buf, REPLAY_PERIOD_US), p_file);
+    for (uint32_t f = 0; f < n; ++f) {
+        make_frame(f, &frame);
+        fwrite(buf, 1, frame_rec_encode(buf, ts_us, f, &frame), p_file);
+        fflush(p_file);
+        ts_us += REPLAY_PERIOD_US + noise(200);
+    }
+    if (fclose(p_file) != 0) {
+        perror(path);
+        return 1;
+    }
+    printf("%u frames written to %s\n", n, path);
+
+    return 0;
+}
+
+/* Every record through every stage in order, the reference the golden digests are taken from */
+static uint32_t
+run_direct(const frame_rec_t* p_rec) {
+    amg88_frame_raw_t frame;
+    uint64_t ts_us;
+    uint32_t crc_errors = 0;
+
+    chain_init(&direct);
+    for (size_t i = 0; i < p_rec->n_records; ++i) {
+        if (frame_rec_get(p_rec, i, &ts_us, NULL, &frame) != FRAME_REC_OK) {
+            crc_errors++;
+            continue;
+        }
+        chain_run(&direct, &frame, ts_us);
+    }
+
+    return crc_errors;
+}
+
+/* Same chain behind the real pipeline, fed by the replayed sensor */
+static int
+run_pipeline(const frame_rec_t* p_rec, uint32_t speed, double* p_elapsed_s, pipeline_stats_t* p_stats) {
+    uint64_t t0_us;
+    pipeline_cfg_t cfg = {
+        .p_dev = &dev,
+        .read_thermistor = true,
+        .sync = speed != AMG88_REPLAY_ASAP,
+        .acq_core = OSAL_CORE_ANY,
+        .proc_core = OSAL_CORE_ANY,
+        .acq_prio = 5,
+        .proc_prio = 4,
+        .process = process,
+        .process_arg = &piped,
+        .p_out_buf = out_buf,
+        .out_size = 1,
+    };
+
+    /* As fast as possible: the pipeline reads again as soon as a read is done, the replay paces it */
+    if (speed != AMG88_REPLAY_ASAP) {
+        uint64_t period_us = p_rec->period_us;
+
+        /* Recorded off the stream, the mean spacing stands for the sensor period */
+        if (period_us == 0) {
+            period_us = p_rec->n_records > 1 ? (p_rec->last_us - p_rec->first_us) / (p_rec->n_records - 1)
+                                             : REPLAY_PERIOD_US;
+        }
+
+        cfg.period_us = (uint32_t) (period_us / speed > 0 ? period_us / speed : 1);
+    }
+
+    chain_init(&piped);
+    amg88_replay_init(&replay, 0, AMG88_I2C_ADDR_LOW, p_rec, speed, osal_time_us);
+    if (amg88_replay_attach(&replay, &dev) != AMG88_OK) {
+        return 1;
+    }
+    if (speed == AMG88_REPLAY_ASAP) {
+        amg88_replay_set_pace(&replay, pace, &pipeline);
+    }
+    atomic_store(&processed, 0);
+
+    t0_us = osal_time_us();
+    amg88_replay_start(&replay);
+    if (pipeline_start(&pipeline, &cfg) != OSAL_OK) {
+        fprintf(stderr, "pipeline_start failed\n");
+        return 1;
+    }
+    while (!amg88_replay_done(&replay)) {
+        osal_delay_ms(REPLAY_POLL_MS);
+    }
+    for (uint32_t waited = 0; waited < REPLAY_DRAIN_MS; waited += REPLAY_POLL_MS) {
+        pipeline_get_stats(&pipeline, p_stats);
+        if (atomic_load(&processed) >= p_stats->raw.published) {
+            break;
+        }
+        osal_delay_ms(REPLAY_POLL_MS);
+    }
+    pipeline_stop(&pipeline);
+    *p_elapsed_s = (double) (osal_time_us() - t0_us) / 1e6;
+    pipeline_get_stats(&pipeline, p_stats);
+
+    return 0;
+}
+
+/* Golden file: the frame count, then one "stage digest" line per stage */
+static int
+golden_check(const char* path) {
+    char name[32], text[32];
+    unsigned long val;
+    int mismatches = 0, stages = 0, found = 0;
+    FILE* p_file = fopen(path, "r");
+
+    if (p_file == NULL) {
+        perror(path);
+        return 1;
+    }
+    while (fscanf(p_file, "%31s %31s", name, text) == 2) {
+        val = strtoul(text, NULL, strcmp(name, "frames") == 0 ? 10 : 16);
+        if (strcmp(name, "frames") == 0) {
+            found++;
+            if (val != direct.frames) {
+                printf("  frames: %u, expected %lu\n", direct.frames, val);
+                mismatches++;
+            }
+            continue;
+        }
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            if (strcmp(name, stage_names[s]) == 0) {
+                found++;
+                if (val != direct.digest[s]) {
+                    printf("  %s: %08x, expected %08lx%s\n", name, direct.digest[s], val,
+                           stages == 0 ? ", first stage to differ" : "");
+                    stages++;
+                }
+            }
+        }
+    }
+    fclose(p_file);
+
+    return mismatches + stages > 0 || found != STAGE_COUNT + 1;
+}
+
+static int
+golden_write(const char* path) {
+    FILE* p_file = fopen(path, "w");
+
+    if (p_file == NULL) {
+        perror(path);
+        return 1;
+    }
+    fprintf(p_file, "frames %u\n", direct.frames);
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        fprintf(p_file, "%s %08x\n", stage_names[s], direct.digest[s]);
+    }
+
+    return fclose(p_file) != 0;
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s -g out.tcr [-n frames]\n", name);
+    fprintf(stderr, "       %s [-x speed] [-c golden | -u golden] rec.tcr\n", name);
+    fprintf(stderr, "  -g file    Write a synthetic recording\n");
+    fprintf(stderr, "  -n frames  Frames to generate (default 300)\n");
+    fprintf(stderr, "  -x speed   Pipeline replay speed: 1 real time, N times real time, 0 as fast as possible"
+                    " (default 0)\n");
+    fprintf(stderr, "  -c file    Check the stage digests against a golden file\n");
+    fprintf(stderr, "  -u file    Write the stage digests to a golden file\n");
+}
+
+int
+main(int argc, char** argv) {
+    const char *gen_path = NULL, *check_path = NULL, *update_path = NULL;
+    uint32_t n = 300, speed = AMG88_REPLAY_ASAP, crc_errors;
+    pipeline_stats_t stats;
+    struct stat st;
+    frame_rec_t rec;
+    const uint8_t* p_map;
+    double rec_s, elapsed_s;
+    int fd, opt, ret = 0;
+
+    while ((opt = getopt(argc, argv, "g:n:x:c:u:h")) != -1) {
+        switch (opt) {
+            case 'g': gen_path = optarg; break;
+            case 'n': n = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'x': speed = (uint32_t) strtoul(optarg, NULL, 0); break;
+            case 'c': check_path = optarg; break;
+            case 'u': update_path = optarg; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (gen_path != NULL) {
+        return generate(gen_path, n);
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* The recording is read in place, whatever its size */
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    p_map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    if (frame_rec_open(&rec, p_map, (size_t) st.st_size) != FRAME_REC_OK || rec.n_records == 0) {
+        fprintf(stderr, "%s: not a recording, or an empty one\n", argv[optind]);
+        return 1;
+    }
+    rec_s = (double) (rec.last_us - rec.first_us) / 1e6;
+    printf("%s: %zu frames, %.1f s, period %u us\n", argv[optind], rec.n_records, rec_s, rec.period_us);
+
+    crc_errors = run_direct(&rec);
+    printf("Stages, %u frames%s:\n", direct.frames, crc_errors > 0 ? " (corrupted records left out)" : "");
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        printf("  %-8s %08x\n", stage_names[s], direct.digest[s]);
+    }
+    if (crc_errors > 0) {
+        printf("  %u corrupted records\n", crc_errors);
+    }
+    if (check_path != NULL) {
+        ret = golden_check(check_path);
+        printf("Golden %s: %s\n", check_path, ret == 0 ? "match" : "MISMATCH");
+    }
+    if (update_path != NULL && golden_write(update_path) != 0) {
+        perror(update_path);
+        ret = 1;
+    }
+
+    if (run_pipeline(&rec, speed, &elapsed_s, &stats) != 0) {
+        return 1;
+    }
+    if (speed == AMG88_REPLAY_ASAP) {
+        printf("Pipeline, as fast as possible:\n");
+    } else {
+        printf("Pipeline, %ux real time:\n", speed);
+    }
+    printf("  %.2f s for %.1f s of recording (%.1fx), %u frames processed, %.0f frames/s\n", elapsed_s, rec_s,
+           rec_s / elapsed_s, piped.frames, piped.frames / elapsed_s);
+    printf("  replay: %u served, %u skipped; pipeline: %u dropped late, %u duplicates, %u torn\n",
+           replay.stats.frames, replay.stats.skipped, stats.raw.overruns, stats.duplicates, stats.torn);
+
+    /* Flat out, every record must have made it to the pipeline, and lossless the result is the reference */
+    if (speed == AMG88_REPLAY_ASAP) {
+        bool lossless = stats.raw.overruns == 0 && piped.frames == direct.frames;
+
+        if (replay.stats.frames + replay.stats.crc_errors != rec.n_records) {
+            printf("  Replay missed records\n");
+            ret = 1;
+        }
+        if (lossless) {
+            /* Tracks are left out, the pipeline timestamps them at read time */
+            bool same = memcmp(piped.digest, direct.digest, STAGE_TRACK * sizeof(direct.digest[0])) == 0;
+
+            printf("  Pipeline output %s the stage reference\n", same ? "matches" : "DIFFERS from");
+            ret |= !same;
+        }
+    }
+
+    munmap((void*) p_map, (size_t) st.st_size);
+
+    return ret;
+}
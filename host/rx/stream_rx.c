@@ -0,0 +1,275 @@
+/**
+ * \file            stream_rx.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame stream receiver (reordering and gap detection)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include "stream_rx.h"
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/* Advance the delivery point by one sequence number, delivering or counting it as lost */
+static void
+stream_rx_step(stream_rx_t* p_rx, stream_rx_sensor_t* p_sensor) {
+    size_t idx = p_sensor->next_seq % STREAM_RX_WINDOW;
+    stream_rx_pkt_t* p_pkt = &p_sensor->window[idx];
+    stream_rx_frame_t frame;
+
+    if (p_sensor->present[idx]) {
+        p_sensor->present[idx] = false;
+        if (stream_proto_decode_frame(&p_pkt->hdr, p_pkt->payload, &p_sensor->dec, &frame.frame) == STREAM_PROTO_OK) {
+            frame.hdr = p_pkt->hdr;
+            p_rx->stats.delivered++;
+            p_rx->cb(&frame, p_rx->arg);
+        } else {
+            p_rx->stats.undecodable++;
+        }
+    } else {
+        p_rx->stats.lost++;
+    }
+    p_sensor->next_seq++;
+}
+
+/* Deliver the consecutive frames available from the delivery point */
+static void
+stream_rx_drain(stream_rx_t* p_rx, stream_rx_sensor_t* p_sensor) {
+    while (p_sensor->present[p_sensor->next_seq % STREAM_RX_WINDOW]) {
+        stream_rx_step(p_rx, p_sensor);
+    }
+}
+
+/* Deliver everything up to the highest received sequence number */
+static void
+stream_rx_flush_sensor(stream_rx_t* p_rx, stream_rx_sensor_t* p_sensor) {
+    if (!p_sensor->synced) {
+        return;
+    }
+    while ((int32_t) (p_sensor->highest_seq - p_sensor->next_seq) >= 0) {
+        stream_rx_step(p_rx, p_sensor);
+    }
+}
+
+/* The device started over: deliver what the old sequence left, then resync on the next packet */
+static void
+stream_rx_restart(stream_rx_t* p_rx, stream_rx_sensor_t* p_sensor) {
+    stream_rx_flush_sensor(p_rx, p_sensor);
+    memset(p_sensor, 0, sizeof(*p_sensor));
+    p_rx->stats.restarts++;
+}
+
+void
+stream_rx_init(stream_rx_t* p_rx, stream_rx_cb cb, void* arg) {
+    memset(p_rx, 0, sizeof(*p_rx));
+    p_rx->sock = -1;
+    p_rx->cb = cb;
+    p_rx->arg = arg;
+}
+
+void
+stream_rx_set_metrics_cb(stream_rx_t* p_rx, stream_rx_metrics_cb cb) {
+    p_rx->metrics_cb = cb;
+}
+
+void
+stream_rx_set_blobs_cb(stream_rx_t* p_rx, stream_rx_blobs_cb cb) {
+    p_rx->blobs_cb = cb;
+}
+
+void
+stream_rx_set_tracks_cb(stream_rx_t* p_rx, stream_rx_tracks_cb cb) {
+    p_rx->tracks_cb = cb;
+}
+
+int
+stream_rx_open(stream_rx_t* p_rx, uint16_t port) {
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+
+    p_rx->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (p_rx->sock < 0) {
+        return -1;
+    }
+    if (bind(p_rx->sock, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+        stream_rx_close(p_rx);
+        return -1;
+    }
+
+    return 0;
+}
+
+void
+stream_rx_close(stream_rx_t* p_rx) {
+    if (p_rx->sock >= 0) {
+        close(p_rx->sock);
+        p_rx->sock = -1;
+    }
+}
+
+int
+stream_rx_poll(stream_rx_t* p_rx, int timeout_ms) {
+    uint8_t buf[STREAM_PROTO_MAX_PACKET];
+    struct pollfd pfd = {
+        .fd = p_rx->sock,
+        .events = POLLIN,
+    };
+    int received = 0;
+    ssize_t len;
+    int ret;
+
+    ret = poll(&pfd, 1, timeout_ms);
+    if (ret < 0) {
+        return errno == EINTR ? 0 : -1;
+    } else if (ret == 0) {
+        /* The link went quiet, do not hold frames back for a packet that is not coming */
+        stream_rx_flush(p_rx);
+        return 0;
+    }
+
+    while ((len = recv(p_rx->sock, buf, sizeof(buf), MSG_DONTWAIT)) >= 0) {
+        stream_rx_push(p_rx, buf, (size_t) len);
+        received++;
+    }
+
+    return received;
+}
+
+void
+stream_rx_push(stream_rx_t* p_rx, const uint8_t* p_pkt, size_t len) {
+    stream_rx_sensor_t* p_sensor;
+    const uint8_t* p_payload;
+    stream_rx_pkt_t* p_slot;
+    stream_hdr_t hdr;
+    int32_t dist;
+    size_t idx;
+
+    p_rx->stats.packets++;
+
+    if (stream_proto_parse(p_pkt, len, &hdr, &p_payload) != STREAM_PROTO_OK) {
+        p_rx->stats.invalid++;
+        return;
+    }
+
+    /* Metrics are not frames, no sequence to keep */
+    if (hdr.type == STREAM_TYPE_METRICS) {
+        metrics_t metrics;
+
+        if (stream_proto_decode_metrics(&hdr, p_payload, &metrics) != STREAM_PROTO_OK) {
+            p_rx->stats.invalid++;
+        } else if (p_rx->metrics_cb != NULL) {
+            p_rx->stats.metrics++;
+            p_rx->metrics_cb(&hdr, &metrics, p_rx->arg);
+        }
+        return;
+    }
+
+    /* Blobs and tracks are events, a late one is still worth having */
+    if (hdr.type == STREAM_TYPE_BLOBS) {
+        detect_blob_t blobs[DETECT_MAX_BLOBS];
+        uint8_t n_blobs, overflow;
+
+        if (stream_proto_decode_blobs(&hdr, p_payload, blobs, &n_blobs, &overflow) != STREAM_PROTO_OK) {
+            p_rx->stats.invalid++;
+        } else if (p_rx->blobs_cb != NULL) {
+            p_rx->stats.blobs++;
+            p_rx->blobs_cb(&hdr, blobs, n_blobs, overflow, p_rx->arg);
+        }
+        return;
+    }
+    if (hdr.type == STREAM_TYPE_TRACKS) {
+        track_t tracks[TRACK_MAX_TRACKS];
+        uint8_t n_tracks;
+
+        if (stream_proto_decode_tracks(&hdr, p_payload, tracks, &n_tracks) != STREAM_PROTO_OK) {
+            p_rx->stats.invalid++;
+        } else if (p_rx->tracks_cb != NULL) {
+            p_rx->stats.tracks++;
+            p_rx->tracks_cb(&hdr, tracks, n_tracks, p_rx->arg);
+        }
+        return;
+    }
+    if (hdr.len > STREAM_RX_MAX_PAYLOAD) {
+        p_rx->stats.invalid++;
+        return;
+    }
+    p_sensor = &p_rx->sensors[hdr.sensor_id];
+
+    /* Recorded frames come in order from the device flash, outside of the live sequence */
+    if (hdr.flags & STREAM_FLAG_BACKFILL) {
+        stream_rx_frame_t frame;
+
+        if (stream_proto_decode_frame(&hdr, p_payload, &p_sensor->backfill_dec, &frame.frame) == STREAM_PROTO_OK) {
+            frame.hdr = hdr;
+            p_rx->stats.backfilled++;
+            p_rx->cb(&frame, p_rx->arg);
+        } else {
+            p_rx->stats.undecodable++;
+        }
+        return;
+    }
+
+    /* A new boot ID is a device restart, however close the new sequence numbers are to the old ones */
+    if (p_sensor->synced && hdr.boot_id != p_sensor->boot_id) {
+        stream_rx_restart(p_rx, p_sensor);
+    }
+
+    dist = (int32_t) (hdr.seq - (p_sensor->synced ? p_sensor->next_seq : hdr.seq));
+    if (dist < -(int32_t) STREAM_RX_WINDOW && hdr.boot_id == 0) {
+        /* No boot ID to go by, far behind the delivery point is taken as a restart */
+        stream_rx_restart(p_rx, p_sensor);
+    } else if (dist < 0) {
+        p_rx->stats.late++;
+        return;
+    }
+    if (!p_sensor->synced) {
+        p_sensor->synced = true;
+        p_sensor->boot_id = hdr.boot_id;
+        p_sensor->next_seq = hdr.seq;
+        p_sensor->highest_seq = hdr.seq;
+    }
+
+    /* Make room in the window, giving up the oldest gaps; past a full window it is empty, so jump */
+    for (size_t i = 0; i < STREAM_RX_WINDOW && (uint32_t) (hdr.seq - p_sensor->next_seq) >= STREAM_RX_WINDOW; ++i) {
+        stream_rx_step(p_rx, p_sensor);
+    }
+    if ((uint32_t) (hdr.seq - p_sensor->next_seq) >= STREAM_RX_WINDOW) {
+        p_rx->stats.lost += hdr.seq - p_sensor->next_seq - (STREAM_RX_WINDOW - 1);
+        p_sensor->next_seq = hdr.seq - (STREAM_RX_WINDOW - 1);
+    }
+
+    idx = hdr.seq % STREAM_RX_WINDOW;
+    if (p_sensor->present[idx]) {
+        p_rx->stats.duplicates++;
+        return;
+    }
+
+    p_slot = &p_sensor->window[idx];
+    p_slot->hdr = hdr;
+    memcpy(p_slot->payload, p_payload, hdr.len);
+    p_sensor->present[idx] = true;
+
+    if ((int32_t) (hdr.seq - p_sensor->highest_seq) < 0) {
+        p_rx->stats.reordered++;
+    } else {
+        p_sensor->highest_seq = hdr.seq;
+    }
+
+    stream_rx_drain(p_rx, p_sensor);
+}
+
+void
+stream_rx_flush(stream_rx_t* p_rx) {
+    for (size_t i = 0; i < STREAM_RX_MAX_SENSORS; ++i) {
+        stream_rx_flush_sensor(p_rx, &p_rx->sensors[i]);
+    }
+}
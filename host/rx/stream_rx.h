@@ -0,0 +1,199 @@
+/**
+ * \file            stream_rx.h
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame stream receiver (reordering and gap detection)
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#ifndef STREAM_RX_H
+#define STREAM_RX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "amg88/amg88_defs.h"
+#include "stream_proto/stream_proto_analytics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define STREAM_RX_WINDOW      8                 /*!< Reorder window, in frames */
+#define STREAM_RX_MAX_SENSORS 256               /*!< One reorder state per sensor ID */
+#define STREAM_RX_MAX_PAYLOAD STREAM_PROTO_FRAME_RAW_SIZE /*!< Largest frame payload among the supported types */
+
+/**
+ * \brief           Received frame
+ */
+typedef struct {
+    stream_hdr_t hdr;                           /*!< Packet header */
+    amg88_frame_raw_t frame;                    /*!< Raw frame */
+} stream_rx_frame_t;
+
+/**
+ * \brief           Frame delivery callback, called in sequence order per sensor
+ * \note            Recorded frames (\ref STREAM_FLAG_BACKFILL in `hdr.flags`) are delivered as they arrive,
+ *                  interleaved with the live ones
+ * \param[in]       p_frame: Received frame
+ * \param[in]       arg: User argument
+ */
+typedef void (*stream_rx_cb)(const stream_rx_frame_t* p_frame, void* arg);
+
+/**
+ * \brief           Metrics delivery callback, called as the packets arrive
+ * \param[in]       p_hdr: Packet header
+ * \param[in]       p_metrics: Cumulative snapshot of the device
+ * \param[in]       arg: User argument
+ */
+typedef void (*stream_rx_metrics_cb)(const stream_hdr_t* p_hdr, const metrics_t* p_metrics, void* arg);
+
+/**
+ * \brief           Blobs delivery callback, called as the packets arrive
+ * \param[in]       p_hdr: Packet header, `seq` is the frame the blobs were found in
+ * \param[in]       p_blobs: Blobs, largest first
+ * \param[in]       n_blobs: Blobs in `p_blobs`
+ * \param[in]       overflow: Blobs left out by the device
+ * \param[in]       arg: User argument
+ */
+typedef void (*stream_rx_blobs_cb)(const stream_hdr_t* p_hdr, const detect_blob_t* p_blobs, uint8_t n_blobs,
+                                   uint8_t overflow, void* arg);
+
+/**
+ * \brief           Tracks delivery callback, called as the packets arrive
+ * \param[in]       p_hdr: Packet header, `seq` is the frame the tracks were updated with
+ * \param[in]       p_tracks: Confirmed tracks
+ * \param[in]       n_tracks: Tracks in `p_tracks`
+ * \param[in]       arg: User argument
+ */
+typedef void (*stream_rx_tracks_cb)(const stream_hdr_t* p_hdr, const track_t* p_tracks, uint8_t n_tracks, void* arg);
+
+/**
+ * \brief           Receiver statistics
+ */
+typedef struct {
+    uint32_t packets;                           /*!< Datagrams received */
+    uint32_t invalid;                           /*!< Datagrams that failed to parse */
+    uint32_t undecodable;                       /*!< Frames that failed to decode (e.g. delta whose keyframe was lost) */
+    uint32_t delivered;                         /*!< Frames delivered */
+    uint32_t lost;                              /*!< Sequence numbers never received (gaps) */
+    uint32_t reordered;                         /*!< Frames received out of order but delivered in order */
+    uint32_t duplicates;                        /*!< Frames received more than once */
+    uint32_t late;                              /*!< Frames received after their slot was given up */
+    uint32_t restarts;                          /*!< Device reboots, from a new boot ID (or, for senders without
+                                                     one, a sequence number far behind) */
+    uint32_t backfilled;                        /*!< Recorded frames delivered, see \ref STREAM_FLAG_BACKFILL */
+    uint32_t metrics;                           /*!< Metrics packets delivered */
+    uint32_t blobs;                             /*!< Blobs packets delivered */
+    uint32_t tracks;                            /*!< Tracks packets delivered */
+} stream_rx_stats_t;
+
+/**
+ * \brief           Packet held in the reorder window
+ * \note            Payloads are decoded on delivery, encoded frames depend on the previous keyframe
+ */
+typedef struct {
+    stream_hdr_t hdr;                           /*!< Packet header */
+    uint8_t payload[STREAM_RX_MAX_PAYLOAD];     /*!< Packet payload */
+} stream_rx_pkt_t;
+
+/**
+ * \brief           Per-sensor reorder state
+ */
+typedef struct {
+    bool synced;                                /*!< `next_seq` and `boot_id` are valid */
+    uint16_t boot_id;                           /*!< Boot ID of the device the sequence belongs to */
+    uint32_t next_seq;                          /*!< Next sequence number to deliver */
+    uint32_t highest_seq;                       /*!< Highest sequence number received */
+    bool present[STREAM_RX_WINDOW];             /*!< Window slot holds a packet */
+    stream_rx_pkt_t window[STREAM_RX_WINDOW];   /*!< Packets waiting for a missing predecessor */
+    frame_codec_dec_t dec;                      /*!< Frame decoder state */
+    frame_codec_dec_t backfill_dec;             /*!< Decoder state of the recorded frames */
+} stream_rx_sensor_t;
+
+/**
+ * \brief           Receiver handler
+ */
+typedef struct {
+    int sock;                                   /*!< UDP socket, `-1` when not opened */
+    stream_rx_cb cb;                            /*!< Delivery callback */
+    void* arg;                                  /*!< Delivery callback user argument */
+    stream_rx_metrics_cb metrics_cb;            /*!< Metrics callback, `NULL` to drop them */
+    stream_rx_blobs_cb blobs_cb;                /*!< Blobs callback, `NULL` to drop them */
+    stream_rx_tracks_cb tracks_cb;              /*!< Tracks callback, `NULL` to drop them */
+    stream_rx_stats_t stats;                    /*!< Statistics */
+    stream_rx_sensor_t sensors[STREAM_RX_MAX_SENSORS]; /*!< Per-sensor state */
+} stream_rx_t;
+
+/**
+ * \brief           Init the receiver without a socket (packets fed with \ref stream_rx_push)
+ * \param[out]      p_rx: Receiver handler
+ * \param[in]       cb: Delivery callback
+ * \param[in]       arg: Delivery callback user argument
+ */
+void stream_rx_init(stream_rx_t* p_rx, stream_rx_cb cb, void* arg);
+
+/**
+ * \brief           Receive the metrics packets too
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       cb: Metrics callback, gets the delivery callback user argument
+ */
+void stream_rx_set_metrics_cb(stream_rx_t* p_rx, stream_rx_metrics_cb cb);
+
+/**
+ * \brief           Receive the blobs packets too
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       cb: Blobs callback, gets the delivery callback user argument
+ */
+void stream_rx_set_blobs_cb(stream_rx_t* p_rx, stream_rx_blobs_cb cb);
+
+/**
+ * \brief           Receive the tracks packets too
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       cb: Tracks callback, gets the delivery callback user argument
+ */
+void stream_rx_set_tracks_cb(stream_rx_t* p_rx, stream_rx_tracks_cb cb);
+
+/**
+ * \brief           Open and bind the UDP socket
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       port: UDP port
+ * \return          `0` on success, `-1` on error (see `errno`)
+ */
+int stream_rx_open(stream_rx_t* p_rx, uint16_t port);
+
+/**
+ * \brief           Close the UDP socket
+ * \param[in]       p_rx: Receiver handler
+ */
+void stream_rx_close(stream_rx_t* p_rx);
+
+/**
+ * \brief           Receive the pending datagrams
+ * \note            On timeout, frames held back by a gap are delivered and the gap is given up
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       timeout_ms: Max time to wait for a datagram
+ * \return          Number of datagrams received, `-1` on error
+ */
+int stream_rx_poll(stream_rx_t* p_rx, int timeout_ms);
+
+/**
+ * \brief           Feed one datagram to the receiver
+ * \param[in]       p_rx: Receiver handler
+ * \param[in]       p_pkt: Datagram
+ * \param[in]       len: Datagram length
+ */
+void stream_rx_push(stream_rx_t* p_rx, const uint8_t* p_pkt, size_t len);
+
+/**
+ * \brief           Deliver every buffered frame, giving up the gaps before them
+ * \param[in]       p_rx: Receiver handler
+ */
+void stream_rx_flush(stream_rx_t* p_rx);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* STREAM_RX_H */
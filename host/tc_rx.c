@@ -0,0 +1,235 @@
+/**
+ * \file            tc_rx.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Frame stream receiver CLI
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "amg88/amg88.h"
+#include "frame_rec/frame_rec.h"
+#include "stream_proto/stream_proto.h"
+#include "metrics/metrics.h"
+#include "rx/stream_rx.h"
+
+/* Vars */
+static volatile sig_atomic_t running = 1;
+static stream_rx_t rx;
+static metrics_t metrics_prev[STREAM_RX_MAX_SENSORS];
+static bool metrics_primed[STREAM_RX_MAX_SENSORS];
+static FILE* p_rec_file;
+static uint8_t rec_sensor;
+static uint32_t rec_frames;
+static uint64_t rec_last_us;
+
+
+static void
+on_signal(int sig) {
+    (void) sig;
+    running = 0;
+}
+
+/* Live frames of one sensor only, so the timestamps keep going forward, a record hits the disk as it comes */
+static void
+record(const stream_rx_frame_t* p_frame) {
+    uint8_t buf[FRAME_REC_RECORD_SIZE];
+
+    if (p_rec_file == NULL || p_frame->hdr.sensor_id != rec_sensor || (p_frame->hdr.flags & STREAM_FLAG_BACKFILL)
+        || p_frame->hdr.ts_us < rec_last_us) {
+        return;
+    }
+    rec_last_us = p_frame->hdr.ts_us;
+    if (fwrite(buf, 1, frame_rec_encode(buf, p_frame->hdr.ts_us, p_frame->hdr.seq, &p_frame->frame), p_rec_file)
+            != FRAME_REC_RECORD_SIZE
+        || fflush(p_rec_file) != 0) {
+        perror("record");
+        fclose(p_rec_file);
+        p_rec_file = NULL;
+        return;
+    }
+    rec_frames++;
+}
+
+static void
+on_frame(const stream_rx_frame_t* p_frame, void* arg) {
+    int16_t temp[AMG88_ARRAY_SIZE];
+    amg88_stats_t stats;
+    int quiet = *(int*) arg;
+
+    record(p_frame);
+    if (quiet) {
+        return;
+    }
+
+    amg88_decode_frame(&p_frame->frame, temp);
+    amg88_frame_stats(temp, AMG88_ARRAY_SIZE, &stats, NULL);
+
+    printf("%3u %10" PRIu32 " %14" PRIu64 "%s th %6.2f min %6.2f max %6.2f mean %6.2f\n",
+           p_frame->hdr.sensor_id, p_frame->hdr.seq, p_frame->hdr.ts_us,
+           (p_frame->hdr.flags & STREAM_FLAG_BACKFILL) ? " (backfill)" : "",
+           AMG88_THERMISTOR_FROM_FIXED(amg88_decode_thermistor(&p_frame->frame)),
+           AMG88_TEMP_FROM_FIXED(stats.min), AMG88_TEMP_FROM_FIXED(stats.max), AMG88_TEMP_FROM_FIXED(stats.mean));
+}
+
+/* Metrics are cumulative on the device, show what happened since the previous packet */
+static void
+on_metrics(const stream_hdr_t* p_hdr, const metrics_t* p_metrics, void* arg) {
+    static const char* stages[METRICS_STAGES] = { "read", "decode", "process", "encode", "send" };
+    static const char* counters[METRICS_COUNTERS] = { "frames", "dropped", "duplicates", "torn", "tx_errors",
+                                                      "retries", "recoveries", "partial" };
+    const metrics_timer_t* p_timer;
+    metrics_t delta;
+    int quiet = *(int*) arg;
+
+    if (!metrics_primed[p_hdr->sensor_id]) {
+        memset(&metrics_prev[p_hdr->sensor_id], 0, sizeof(metrics_prev[0]));
+        metrics_primed[p_hdr->sensor_id] = true;
+    }
+    metrics_delta(p_metrics, &metrics_prev[p_hdr->sensor_id], &delta);
+    metrics_prev[p_hdr->sensor_id] = *p_metrics;
+    if (quiet) {
+        return;
+    }
+
+    printf("%3u metrics %14" PRIu64 "\n", p_hdr->sensor_id, p_hdr->ts_us);
+    for (uint8_t s = 0; s < METRICS_STAGES; ++s) {
+        p_timer = &delta.timers[s];
+        printf("    %-8s n %6u mean %8.1f us p50 <%7u us p99 <%7u us\n", stages[s], p_timer->count,
+               p_timer->count ? (double) p_timer->sum_us / p_timer->count : 0.0,
+               metrics_percentile_us(p_timer, 50), metrics_percentile_us(p_timer, 99));
+    }
+    printf("    errors  ");
+    for (uint8_t i = AMG88_ERR; i < METRICS_ERR_CODES; ++i) {
+        printf(" %u", delta.errors[i]);
+    }
+    printf("\n    counters");
+    for (uint8_t i = 0; i < METRICS_COUNTERS; ++i) {
+        printf(" %s %u", counters[i], delta.counters[i]);
+    }
+    printf("\n");
+}
+
+static void
+on_blobs(const stream_hdr_t* p_hdr, const detect_blob_t* p_blobs, uint8_t n_blobs, uint8_t overflow, void* arg) {
+    int quiet = *(int*) arg;
+
+    if (quiet) {
+        return;
+    }
+
+    printf("%3u %10" PRIu32 " %14" PRIu64 " blobs %u (+%u)", p_hdr->sensor_id, p_hdr->seq, p_hdr->ts_us, n_blobs,
+           overflow);
+    for (uint8_t i = 0; i < n_blobs; ++i) {
+        printf(" [%u px at %.2f,%.2f peak %.2f]", p_blobs[i].pixels, p_blobs[i].cx_q8 / 256.0,
+               p_blobs[i].cy_q8 / 256.0, AMG88_TEMP_FROM_FIXED(p_blobs[i].peak));
+    }
+    printf("\n");
+}
+
+static void
+on_tracks(const stream_hdr_t* p_hdr, const track_t* p_tracks, uint8_t n_tracks, void* arg) {
+    int quiet = *(int*) arg;
+
+    if (quiet) {
+        return;
+    }
+
+    printf("%3u %10" PRIu32 " %14" PRIu64 " tracks %u", p_hdr->sensor_id, p_hdr->seq, p_hdr->ts_us, n_tracks);
+    for (uint8_t i = 0; i < n_tracks; ++i) {
+        printf(" [#%u at %.2f,%.2f moving %.2f,%.2f px/s]", p_tracks[i].id, p_tracks[i].x / 256.0,
+               p_tracks[i].y / 256.0, p_tracks[i].vx / 256.0, p_tracks[i].vy / 256.0);
+    }
+    printf("\n");
+}
+
+static void
+print_stats(const stream_rx_stats_t* p_stats) {
+    fprintf(stderr, "packets %u invalid %u undecodable %u delivered %u lost %u reordered %u duplicates %u late %u restarts %u"
+            " backfilled %u metrics %u blobs %u tracks %u\n",
+            p_stats->packets, p_stats->invalid, p_stats->undecodable, p_stats->delivered, p_stats->lost,
+            p_stats->reordered, p_stats->duplicates, p_stats->late, p_stats->restarts, p_stats->backfilled, p_stats->metrics,
+            p_stats->blobs, p_stats->tracks);
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-p port] [-q] [-w file [-s sensor]]\n", name);
+    fprintf(stderr, "  -p port  UDP port to listen on (default %d)\n", STREAM_PROTO_PORT);
+    fprintf(stderr, "  -q       Only print the statistics on exit\n");
+    fprintf(stderr, "  -w file  Record the raw frames, see rec_replay\n");
+    fprintf(stderr, "  -s id    Sensor to record (default 0)\n");
+}
+
+int
+main(int argc, char** argv) {
+    uint16_t port = STREAM_PROTO_PORT;
+    const char* rec_path = NULL;
+    uint8_t hdr[FRAME_REC_HDR_SIZE];
+    int quiet = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:qw:s:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                port = (uint16_t) atoi(optarg);
+                break;
+            case 'q':
+                quiet = 1;
+                break;
+            case 'w':
+                rec_path = optarg;
+                break;
+            case 's':
+                rec_sensor = (uint8_t) atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    /* The frame period is not known here, the replay works it out from the timestamps */
+    if (rec_path != NULL) {
+        p_rec_file = fopen(rec_path, "wb");
+        if (p_rec_file == NULL || fwrite(hdr, 1, frame_rec_encode_hdr(hdr, 0), p_rec_file) != FRAME_REC_HDR_SIZE) {
+            perror(rec_path);
+            return 1;
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    stream_rx_init(&rx, on_frame, &quiet);
+    stream_rx_set_metrics_cb(&rx, on_metrics);
+    stream_rx_set_blobs_cb(&rx, on_blobs);
+    stream_rx_set_tracks_cb(&rx, on_tracks);
+    if (stream_rx_open(&rx, port) < 0) {
+        perror("stream_rx_open");
+        return 1;
+    }
+
+    while (running) {
+        if (stream_rx_poll(&rx, 200) < 0) {
+            perror("stream_rx_poll");
+            break;
+        }
+    }
+
+    stream_rx_flush(&rx);
+    stream_rx_close(&rx);
+    print_stats(&rx.stats);
+    if (p_rec_file != NULL) {
+        fclose(p_rec_file);
+        printf("%u frames recorded to %s\n", rec_frames, rec_path);
+    }
+
+    return 0;
+}
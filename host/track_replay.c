@@ -0,0 +1,298 @@
+/**
+ * \file            track_replay.c
+ * \author          Mario Rubio (mario@mrrb.eu)
+ * \brief           Replays synthetic hotspots with known sub-pixel positions through the tracker, checks its accuracy
+ * \version         0.1
+ * \date            2026-10-17
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amg88/amg88.h"
+#include "track/track.h"
+
+#define REPLAY_TARGETS  2                       /* Targets per scene, at most */
+#define REPLAY_AMP      40                      /* Target peak over the background, 10 degrees */
+#define REPLAY_SIGMA    0.7                     /* Target spread, pixels */
+#define REPLAY_Q        ((double) (1 << TRACK_FRAC_BITS))
+
+/**
+ * \brief           A scripted scene and the accuracy expected from the tracker
+ */
+typedef struct {
+    const char* name;                           /* Scene name */
+    const char* desc;                           /* What happens */
+    uint32_t duration_ms;                       /* Replay length */
+    uint32_t period_ms;                         /* Frame period */
+    uint8_t targets;                            /* Targets in the scene */
+    void (*truth)(uint8_t target, double t, double* p_x, double* p_y);
+    double max_track_err;                       /* Max RMS distance between a confirmed track and its target */
+    double max_vel_err;                         /* Max RMS velocity error in pixels per second, after settling */
+} replay_scene_t;
+
+/* Vars */
+static uint32_t rng = 1;
+static int16_t grid[AMG88_ARRAY_SIZE];
+static int16_t noise_amp = 1;
+static bool verbose;
+
+
+static uint64_t
+now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static int16_t
+noise(int16_t amplitude) {
+    rng = rng * 1103515245u + 12345u;
+
+    return (int16_t) ((int32_t) ((rng >> 16) % (2 * amplitude + 1)) - amplitude);
+}
+
+/* Constant 1.5 px/s across the grid, slightly off the pixel rows */
+static void
+truth_linear(uint8_t target, double t, double* p_x, double* p_y) {
+    (void) target;
+    *p_x = 0.6 + 1.5 * t;
+    *p_y = 3.3 + 0.2 * t;
+}
+
+/* Radius 2 around the centre, one turn every 6 s */
+static void
+truth_circle(uint8_t target, double t, double* p_x, double* p_y) {
+    (void) target;
+    *p_x = 3.5 + 2.0 * cos(2.0 * M_PI * t / 6.0);
+    *p_y = 3.5 + 2.0 * sin(2.0 * M_PI * t / 6.0);
+}
+
+/* Two targets walking past each other two and a half rows apart */
+static void
+truth_crossing(uint8_t target, double t, double* p_x, double* p_y) {
+    *p_x = target == 0 ? 0.4 + 1.4 * t : 6.6 - 1.4 * t;
+    *p_y = target == 0 ? 2.2 : 4.7;
+}
+
+static const replay_scene_t scenes[] = {
+    { "linear",   "one target crossing the grid at 1.5 px/s", 4000, 100, 1, truth_linear,   0.25, 0.5 },
+    { "circle",   "one target on a 2 px circle, 6 s a turn",   12000, 100, 1, truth_circle,   0.35, 1.0 },
+    { "crossing", "two targets passing each other",            4400, 100, 2, truth_crossing, 0.30, 0.6 },
+    { "slow",     "linear at 2.5 FPS",                         4000, 400, 1, truth_linear,   0.30, 0.6 },
+};
+
+static void
+render(const replay_scene_t* p_scene, double t) {
+    for (uint8_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+        grid[i] = noise(noise_amp);
+    }
+    for (uint8_t k = 0; k < p_scene->targets; ++k) {
+        double tx, ty;
+
+        p_scene->truth(k, t, &tx, &ty);
+        for (uint8_t i = 0; i < AMG88_ARRAY_SIZE; ++i) {
+            double dx = i % AMG88_ARRAY_COLS - tx, dy = i / AMG88_ARRAY_COLS - ty;
+
+            grid[i] += (int16_t) lround(REPLAY_AMP * exp(-(dx * dx + dy * dy) / (2 * REPLAY_SIGMA * REPLAY_SIGMA)));
+        }
+    }
+}
+
+/* Distance from a hotspot to the closest target */
+static double
+closest(const replay_scene_t* p_scene, double t, double x, double y, uint8_t* p_target) {
+    double best = 1e9;
+
+    for (uint8_t k = 0; k < p_scene->targets; ++k) {
+        double tx, ty, d;
+
+        p_scene->truth(k, t, &tx, &ty);
+        d = hypot(x - tx, y - ty);
+        if (d < best) {
+            best = d;
+            *p_target = k;
+        }
+    }
+
+    return best;
+}
+
+/* Localization only: every hotspot against its target, per refinement method */
+static double
+peak_error(const replay_scene_t* p_scene, track_refine_t refine) {
+    track_peak_t peaks[TRACK_MAX_PEAKS];
+    double sq = 0;
+    uint32_t n = 0;
+
+    rng = 1;
+    for (uint32_t t_ms = 0; t_ms < p_scene->duration_ms; t_ms += p_scene->period_ms) {
+        uint8_t found, target;
+
+        render(p_scene, t_ms / 1000.0);
+        found = track_find_peaks(grid, REPLAY_AMP / 4, refine, peaks, TRACK_MAX_PEAKS);
+        for (uint8_t p = 0; p < found; ++p) {
+            double d = closest(p_scene, t_ms / 1000.0, peaks[p].x / REPLAY_Q, peaks[p].y / REPLAY_Q, &target);
+
+            sq += d * d;
+            ++n;
+        }
+    }
+
+    return n > 0 ? sqrt(sq / n) : 1e9;
+}
+
+static bool
+run(const replay_scene_t* p_scene, const track_cfg_t* p_cfg) {
+    static const char* names[] = { "none", "quadratic", "centroid" };
+    uint16_t ids[REPLAY_TARGETS] = { 0 };
+    track_tracker_t trk;
+    uint64_t busy_ns = 0, worst_ns = 0;
+    double pos_sq = 0, vel_sq = 0, err[3];
+    uint32_t frames = 0, pos_n = 0, vel_n = 0, switches = 0, spurious = 0;
+    bool ok = true;
+
+    printf("\n== %s: %s, %u ms at %u ms a frame\n", p_scene->name, p_scene->desc, p_scene->duration_ms,
+           p_scene->period_ms);
+    for (uint8_t r = 0; r < 3; ++r) {
+        err[r] = peak_error(p_scene, (track_refine_t) r);
+        printf("  hotspot RMS error %-10s %.3f px\n", names[r], err[r]);
+    }
+
+    rng = 1;
+    track_init(&trk, p_cfg);
+    for (uint32_t t_ms = 0; t_ms < p_scene->duration_ms; t_ms += p_scene->period_ms, ++frames) {
+        double t = t_ms / 1000.0;
+        uint64_t t0, dt;
+
+        render(p_scene, t);
+        t0 = now_ns();
+        track_update(&trk, grid, (uint64_t) t_ms * 1000 + 1);
+        dt = now_ns() - t0;
+        busy_ns += dt;
+        worst_ns = dt > worst_ns ? dt : worst_ns;
+
+        for (uint8_t s = 0; s < TRACK_MAX_TRACKS; ++s) {
+            const track_t* p_t = &trk.tracks[s];
+            double x = p_t->x / REPLAY_Q, y = p_t->y / REPLAY_Q, d, tx0, ty0, tx1, ty1, vx, vy;
+            uint8_t k = 0;
+
+            if (p_t->state != TRACK_CONFIRMED) {
+                continue;
+            }
+            d = closest(p_scene, t, x, y, &k);
+            if (d > 1.5) {
+                ++spurious;
+                continue;
+            }
+            if (ids[k] != 0 && ids[k] != p_t->id) {
+                ++switches;
+                if (verbose) {
+                    printf("  %6.1f s  target %u: track %u -> %u\n", t, k, ids[k], p_t->id);
+                }
+            }
+            ids[k] = p_t->id;
+            pos_sq += d * d;
+            ++pos_n;
+
+            /* Velocity once the filter had a second to settle */
+            if (t_ms >= 1000) {
+                p_scene->truth(k, t - 0.001, &tx0, &ty0);
+                p_scene->truth(k, t + 0.001, &tx1, &ty1);
+                vx = p_t->vx / REPLAY_Q - (tx1 - tx0) / 0.002;
+                vy = p_t->vy / REPLAY_Q - (ty1 - ty0) / 0.002;
+                vel_sq += vx * vx + vy * vy;
+                ++vel_n;
+            }
+        }
+        if (verbose) {
+            for (uint8_t s = 0; s < TRACK_MAX_TRACKS; ++s) {
+                const track_t* p_t = &trk.tracks[s];
+
+                if (p_t->state == TRACK_CONFIRMED) {
+                    printf("  %6.1f s  track %u at (%.2f, %.2f) moving (%.2f, %.2f) px/s\n", t, p_t->id,
+                           p_t->x / REPLAY_Q, p_t->y / REPLAY_Q, p_t->vx / REPLAY_Q, p_t->vy / REPLAY_Q);
+                }
+            }
+        }
+    }
+
+    printf("  track RMS error %.3f px over %u samples, velocity RMS error %.2f px/s, %u id switches, %u spurious\n",
+           pos_n > 0 ? sqrt(pos_sq / pos_n) : 0.0, pos_n, vel_n > 0 ? sqrt(vel_sq / vel_n) : 0.0, switches,
+           spurious);
+    printf("  track_update %.0f ns/frame on average, %llu ns worst\n", (double) busy_ns / frames,
+           (unsigned long long) worst_ns);
+
+    if (err[TRACK_REFINE_QUADRATIC] >= err[TRACK_REFINE_NONE] || err[TRACK_REFINE_CENTROID] >= err[TRACK_REFINE_NONE]) {
+        printf("  FAIL: sub-pixel refinement is not better than the integer maximum\n");
+        ok = false;
+    }
+    if (pos_n < frames * p_scene->targets / 2 || sqrt(pos_sq / pos_n) > p_scene->max_track_err) {
+        printf("  FAIL: expected an RMS track error below %.2f px on most frames\n", p_scene->max_track_err);
+        ok = false;
+    }
+    if (vel_n == 0 || sqrt(vel_sq / vel_n) > p_scene->max_vel_err) {
+        printf("  FAIL: expected a velocity RMS error below %.2f px/s\n", p_scene->max_vel_err);
+        ok = false;
+    }
+    if (switches != 0 || spurious != 0) {
+        printf("  FAIL: expected one steady track per target\n");
+        ok = false;
+    }
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-r none|quadratic|centroid] [-a alpha] [-b beta] [-g gate_px] [-n noise] [-v]\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    track_cfg_t cfg = {
+        .threshold = REPLAY_AMP / 4,
+        .refine = TRACK_REFINE_QUADRATIC,
+        .gate = 2 << TRACK_FRAC_BITS,
+        .alpha = 128,
+        .beta = 32,
+        .confirm_hits = 3,
+        .max_misses = 3,
+    };
+    uint32_t failed = 0, run_n = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:a:b:g:n:vh")) != -1) {
+        switch (opt) {
+            case 'r':
+                cfg.refine = optarg[0] == 'n' ? TRACK_REFINE_NONE
+                           : optarg[0] == 'c' ? TRACK_REFINE_CENTROID : TRACK_REFINE_QUADRATIC;
+                break;
+            case 'a': cfg.alpha = (uint8_t) strtoul(optarg, NULL, 0); break;
+            case 'b': cfg.beta = (uint8_t) strtoul(optarg, NULL, 0); break;
+            case 'g': cfg.gate = (uint16_t) (strtod(optarg, NULL) * REPLAY_Q); break;
+            case 'n': noise_amp = (int16_t) strtol(optarg, NULL, 0); break;
+            case 'v': verbose = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    printf("refine %u, alpha %u/256, beta %u/256, gate %.2f px, noise +-%d\n", cfg.refine, cfg.alpha, cfg.beta,
+           cfg.gate / REPLAY_Q, noise_amp);
+    for (size_t s = 0; s < sizeof(scenes) / sizeof(scenes[0]); ++s, ++run_n) {
+        failed += !run(&scenes[s], &cfg);
+    }
+    printf("\n%u of %u scenes passed\n", run_n - failed, run_n);
+
+    return failed != 0;
+}